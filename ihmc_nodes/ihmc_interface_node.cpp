@@ -24,8 +24,49 @@ IHMCInterfaceNode::IHMCInterfaceNode(const ros::NodeHandle& nh) {
               std::string("controllers/output/ihmc/controller_status"));
     nh_.param("hand_pose_command_topic", hand_pose_command_topic_,
               std::string("controllers/output/ihmc/cartesian_hand_targets"));
+    nh_.param("bimanual_hand_pose_command_topic", bimanual_hand_pose_command_topic_,
+              std::string("controllers/output/ihmc/bimanual_hand_targets"));
     nh_.param("receive_cartesian_goals_topic", receive_cartesian_goals_topic_,
               std::string("controllers/output/ihmc/receive_cartesian_goals"));
+    nh_.param("finger_position_command_topic", finger_position_command_topic_,
+              std::string("controllers/output/ihmc/finger_position_commands"));
+    nh_.param("wholebody_output_topics", wholebody_output_topics_, IHMCMsgUtils::IHMCCommandPublisher::getDefaultWholeBodyOutputTopics());
+    nh_.param("input_log_file", input_log_file_, std::string(""));
+    int input_log_keyframe_interval;
+    nh_.param("input_log_keyframe_interval", input_log_keyframe_interval, 100);
+    nh_.param("monitor_tracking", monitor_tracking_, false);
+    nh_.param("stop_on_stop_listening", stop_on_stop_listening_, true);
+    nh_.param("partial_deserialization", partial_deserialization_, true);
+    double stream_integration_duration;
+    nh_.param("stream_integration_duration", stream_integration_duration, 0.13);
+    nh_.param("stream_rate", stream_rate_, 10.0);
+    if( stream_rate_ <= 0.0 ) {
+        ROS_WARN("[IHMC Interface Node] Invalid stream_rate %f Hz, using 10 Hz", stream_rate_);
+        stream_rate_ = 10.0;
+    }
+    std::map<std::string, double> body_part_stream_rates;
+    nh_.param("body_part_stream_rates", body_part_stream_rates, std::map<std::string, double>());
+    std::map<std::string, double> body_part_stream_integration_durations;
+    nh_.param("body_part_stream_integration_durations", body_part_stream_integration_durations, std::map<std::string, double>());
+    std::string command_filter;
+    nh_.param("command_filter", command_filter, std::string("none"));
+    IHMCMsgUtils::IHMCCommandFilterParams filter_params;
+    nh_.param("filter_min_cutoff", filter_params.min_cutoff, filter_params.min_cutoff);
+    nh_.param("filter_beta", filter_params.beta, filter_params.beta);
+    nh_.param("filter_derivative_cutoff", filter_params.derivative_cutoff, filter_params.derivative_cutoff);
+    nh_.param("filter_natural_frequency", filter_params.natural_frequency, filter_params.natural_frequency);
+    if( !IHMCMsgUtils::getCommandFilterType(command_filter, filter_params.type) ) {
+        ROS_WARN("[IHMC Interface Node] Unknown command filter %s, commands will not be filtered", command_filter.c_str());
+        filter_params.type = IHMCMsgUtils::COMMAND_FILTER_NONE;
+    }
+    double finger_stream_min_interval;
+    nh_.param("finger_stream_min_interval", finger_stream_min_interval, 0.02);
+    double finger_stream_integration_duration;
+    nh_.param("finger_stream_integration_duration", finger_stream_integration_duration, 0.05);
+    nh_.param("pose_library_file", pose_library_file_, std::string(""));
+    nh_.param("transition_blend_duration", transition_blend_duration_, 0.5);
+    nh_.param("robot_configuration_topic", robot_configuration_topic_,
+              std::string("/ihmc/valkyrie/humanoid_control/output/robot_configuration_data"));
 
     // if coming from controllers, update topic names to come from managing node
     if( commands_from_controllers_ ) {
@@ -34,56 +75,51 @@ IHMCInterfaceNode::IHMCInterfaceNode(const ros::NodeHandle& nh) {
         joint_command_topic_ = managing_node + joint_command_topic_;
         status_topic_ = managing_node + status_topic_;
         hand_pose_command_topic_ = managing_node + hand_pose_command_topic_;
+        bimanual_hand_pose_command_topic_ = managing_node + bimanual_hand_pose_command_topic_;
         receive_cartesian_goals_topic_ = managing_node + receive_cartesian_goals_topic_;
+        finger_position_command_topic_ = managing_node + finger_position_command_topic_;
+    }
+
+    // create streamer; messages it builds are published by this node, inputs are captured using ROS time
+    streamer_ = std::make_unique<IHMCMsgUtils::IHMCCommandStreamer>(commands_from_controllers_);
+    streamer_->setClock([]() { return static_cast<int64_t>(ros::Time::now().toNSec()); });
+    streamer_->setTrackingMonitorEnabled(monitor_tracking_);
+    streamer_->setStopOnStopListening(stop_on_stop_listening_);
+    streamer_->setCommandFilterParams(filter_params);
+    streamer_->setStreamIntegrationDuration(stream_integration_duration);
+    for( std::map<std::string, double>::iterator it = body_part_stream_rates.begin() ; it != body_part_stream_rates.end() ; ++it ) {
+        int link_id;
+        if( !IHMCMsgUtils::getControlledLinkId(it->first, link_id) ) {
+            ROS_WARN("[IHMC Interface Node] Unknown body part %s in body_part_stream_rates, streaming it at loop rate", it->first.c_str());
+            continue;
+        }
+        // parts streamed faster than the loop are limited to the loop rate
+        if( it->second > stream_rate_ ) {
+            ROS_WARN("[IHMC Interface Node] Body part %s stream rate %f Hz is faster than stream_rate %f Hz", it->first.c_str(), it->second, stream_rate_);
+        }
+        std::map<std::string, double>::iterator dt = body_part_stream_integration_durations.find(it->first);
+        double part_integration_duration = (dt != body_part_stream_integration_durations.end()) ? dt->second : 0.0;
+        streamer_->setBodyPartStreamRate(link_id, it->second, part_integration_duration);
+    }
+    streamer_->setFingerStreamParameters(finger_stream_min_interval, finger_stream_integration_duration);
+    streamer_->setTransitionBlendDuration(transition_blend_duration_);
+
+    // prebuild whole-body messages for named poses, if given
+    if( !pose_library_file_.empty() && !streamer_->loadPoseLibrary(pose_library_file_) ) {
+        ROS_WARN("[IHMC Interface Node] Errors reading pose library %s, some poses may be missing", pose_library_file_.c_str());
     }
 
     initializeConnections();
 
-    // initialize flags for receiving and publishing messages
-    if( commands_from_controllers_ ) {
-        receive_pelvis_transform_ = false;
-        receive_joint_command_ = false;
-        receive_link_ids_ = false;
-        received_link_ids_ = false;
-    }
-    else {
-        receive_pelvis_transform_ = true;
-        receive_joint_command_ = true;
-        receive_link_ids_ = false;
-        received_link_ids_ = true;
-        // will not wait for link ids, assume all links controlled
-        controlled_links_.clear();
-        controlled_links_.push_back(valkyrie_link::pelvis);
-        controlled_links_.push_back(valkyrie_link::torso);
-        controlled_links_.push_back(valkyrie_link::rightCOP_Frame);
-        controlled_links_.push_back(valkyrie_link::leftCOP_Frame);
-        controlled_links_.push_back(valkyrie_link::rightPalm);
-        controlled_links_.push_back(valkyrie_link::leftPalm);
-        controlled_links_.push_back(valkyrie_link::head);
+    // open input capture log, if requested
+    if( !input_log_file_.empty() ) {
+        if( streamer_->openInputLog(input_log_file_, input_log_keyframe_interval) ) {
+            ROS_INFO("[IHMC Interface Node] Capturing inputs to %s", input_log_file_.c_str());
+        }
+        else {
+            ROS_WARN("[IHMC Interface Node] Could not open input log %s, inputs will not be captured", input_log_file_.c_str());
+        }
     }
-    cartesian_hand_goals_ = false;
-    received_pelvis_transform_ = false;
-    received_joint_command_ = false;
-    received_left_hand_goal_ = false;
-    received_right_hand_goal_ = false;
-    publish_commands_ = false;
-    stop_node_ = false;
-
-    home_left_arm_ = false;
-    home_right_arm_ = false;
-    home_chest_ = false;
-    home_pelvis_ = false;
-    publish_go_home_command_ = false;
-
-    open_left_hand_ = false;
-    close_left_hand_ = false;
-    open_right_hand_ = false;
-    close_right_hand_ = false;
-    publish_finger_command_ = false;
-    publish_hand_command_ = false;
-
-    // set initial empty status
-    status_ = std::string("");
 
     std::cout << "[IHMC Interface Node] Constructed" << std::endl;
 }
@@ -95,785 +131,142 @@ IHMCInterfaceNode::~IHMCInterfaceNode() {
 // CONNECTIONS
 bool IHMCInterfaceNode::initializeConnections() {
     // subscribers for receiving whole-body information
-    pelvis_transform_sub_ = nh_.subscribe(pelvis_tf_topic_, 1, &IHMCInterfaceNode::transformCallback, this);
-    joint_command_sub_ = nh_.subscribe(joint_command_topic_, 1, &IHMCInterfaceNode::jointCommandCallback, this);
+    if( partial_deserialization_ ) {
+        // only read the fields that are used; names, velocities, efforts, and headers are skipped in place
+        pelvis_transform_sub_ = nh_.subscribe(pelvis_tf_topic_, 1, &IHMCInterfaceNode::partialTransformCallback, this);
+        joint_command_sub_ = nh_.subscribe(joint_command_topic_, 1, &IHMCInterfaceNode::partialJointCommandCallback, this);
+    }
+    else {
+        pelvis_transform_sub_ = nh_.subscribe(pelvis_tf_topic_, 1, &IHMCInterfaceNode::transformCallback, this);
+        joint_command_sub_ = nh_.subscribe(joint_command_topic_, 1, &IHMCInterfaceNode::jointCommandCallback, this);
+    }
     if( commands_from_controllers_ ) {
         controlled_link_sub_ = nh_.subscribe(controlled_link_topic_, 1, &IHMCInterfaceNode::controlledLinkIdsCallback, this);
-        status_sub_ = nh_.subscribe(status_topic_, 20, &IHMCInterfaceNode::statusCallback, this);
+        // statuses have their own queue, which is checked while waiting between cycles
+        // callback takes message event, so stop latency is measured from when status arrived rather than when it is handled
+        ros::SubscribeOptions status_ops;
+        status_ops.initByFullCallbackType<const ros::MessageEvent<std_msgs::String const>&>(
+            status_topic_, 20, [this](const ros::MessageEvent<std_msgs::String const>& status_event) { statusCallback(status_event); });
+        status_ops.callback_queue = &status_queue_;
+        status_sub_ = nh_.subscribe(status_ops);
         hand_pose_command_sub_ = nh_.subscribe(hand_pose_command_topic_, 1, &IHMCInterfaceNode::handPoseCommandCallback, this);
+        bimanual_hand_pose_command_sub_ = nh_.subscribe(bimanual_hand_pose_command_topic_, 1, &IHMCInterfaceNode::bimanualHandPoseCommandCallback, this);
         receive_cartesian_goals_sub_ = nh_.subscribe(receive_cartesian_goals_topic_, 1, &IHMCInterfaceNode::receiveCartesianGoalsCallback, this);
+        // queue holds commands for both hands, so a command for one hand does not drop the other
+        finger_position_command_sub_ = nh_.subscribe(finger_position_command_topic_, 10, &IHMCInterfaceNode::fingerPositionCommandCallback, this);
     }
 
-    // publishers for sending whole-body messages
-    wholebody_pub_ = nh_.advertise<controller_msgs::WholeBodyTrajectoryMessage>("/ihmc/valkyrie/humanoid_control/input/whole_body_trajectory", 1);
-    go_home_pub_ = nh_.advertise<controller_msgs::GoHomeMessage>("/ihmc/valkyrie/humanoid_control/input/go_home", 20);
-    finger_pub_ = nh_.advertise<controller_msgs::ValkyrieHandFingerTrajectoryMessage>("/ihmc/valkyrie/humanoid_control/input/valkyrie_hand_finger_trajectory", 10);
+    // measured configurations for closed-loop tracking error and for starting transition blends
+    if( monitor_tracking_ || (transition_blend_duration_ > 0.0) ) {
+        robot_configuration_sub_ = nh_.subscribe(robot_configuration_topic_, 1, &IHMCInterfaceNode::robotConfigurationDataCallback, this);
+    }
+
+    // publisher for closed-loop tracking error, if monitoring
+    if( monitor_tracking_ ) {
+        tracking_error_pub_ = nh_.advertise<std_msgs::Float64MultiArray>("tracking_error", 10);
+    }
+
+    // publishers for sending messages built by streamer
+    // whole-body messages may go to several output targets (e.g., SCS, logger, visualization)
+    if( !command_pub_.connect(nh_, *streamer_, wholebody_output_topics_) ) {
+        ROS_WARN("[IHMC Interface Node] No output topics given for whole-body messages");
+    }
 
     return true;
 }
 
 // CALLBACKS
 void IHMCInterfaceNode::transformCallback(const geometry_msgs::TransformStamped& tf_msg) {
-    if( receive_pelvis_transform_ ) {
-        // set pelvis translation based on message
-        tf_pelvis_wrt_world_.setOrigin(tf::Vector3(tf_msg.transform.translation.x,
-                                                   tf_msg.transform.translation.y,
-                                                   tf_msg.transform.translation.z));
-        // set pelvis orientation based on message
-        tf::Quaternion quat_pelvis_wrt_world(tf_msg.transform.rotation.x,
-                                             tf_msg.transform.rotation.y,
-                                             tf_msg.transform.rotation.z,
-                                             tf_msg.transform.rotation.w);
-        tf_pelvis_wrt_world_.setRotation(quat_pelvis_wrt_world);
-
-        // set flag indicating pelvis transform has been received
-        received_pelvis_transform_ = true;
-
-        // set flag to no longer receive transform messages
-        if( !commands_from_controllers_ ) {
-            receive_pelvis_transform_ = false;
-        }
-    }
-
-    // update flag to publish commands
-    updatePublishCommandsFlag();
-
-    // update flag to stop node
-    updateStopNodeFlag();
-
+    streamer_->processPelvisTransform(tf_msg);
     return;
 }
 
 void IHMCInterfaceNode::controlledLinkIdsCallback(const std_msgs::Int32MultiArray& arr_msg) {
-    if( receive_link_ids_ ) {
-        // clear vector of controlled links
-        controlled_links_.clear();
-
-        // set controlled links
-        for( int i = 0 ; i < arr_msg.data.size() ; i++ ) {
-            controlled_links_.push_back(arr_msg.data[i]);
-        }
-
-        // set flag indicating link ids have been received
-        received_link_ids_ = true;
-
-        // set flag to no longer receive link ids
-        if( !commands_from_controllers_ ) {
-            receive_link_ids_ = false;
-        }
-    }
-
-    // update flag to publish commands
-    updatePublishCommandsFlag();
-
-    // update flag to stop node
-    updateStopNodeFlag();
-
+    streamer_->processControlledLinkIds(arr_msg);
     return;
 }
 
 void IHMCInterfaceNode::jointCommandCallback(const sensor_msgs::JointState& js_msg) {
-    if( receive_joint_command_ ) {
-        // resize vector for joint positions
-        q_joint_.resize(valkyrie::num_act_joint);
-        q_joint_.setZero();
-
-        // set positions for each joint
-        for( int i = 0 ; i < js_msg.position.size(); i++ ) {
-            // joint state message may contain joints we don't care about, especially when coming from IHMC
-            // messages coming from ControllerManager will not have this problem, but it's good to be safe
-            // check if joint is one of Valkyrie's action joints
-            std::map<std::string, int>::iterator it;
-            it = val::joint_names_to_indices.find(js_msg.name[i]);
-            if( it != val::joint_names_to_indices.end() ) {
-                // joint state message may publish joints in an order not expected by configuration vector
-                // set index for joint based on joint name; add offset to ignoring virtual joints
-                int jidx = val::joint_names_to_indices[js_msg.name[i]] - valkyrie::num_virtual;
-                q_joint_[jidx] = js_msg.position[i];
-            }
-            // if joint name is not one of Valkyrie's action joints, ignore it
-        }
-
-        // set flag indicating joint command has been received
-        received_joint_command_ = true;
-
-        // set flag to no longer receive joint command messages
-        if( !commands_from_controllers_ ) {
-            receive_joint_command_ = false;
-        }
-    }
-
-    // update flag to publish commands
-    updatePublishCommandsFlag();
-
-    // update flag to stop node
-    updateStopNodeFlag();
-
+    streamer_->processJointCommand(js_msg);
     return;
 }
 
-void IHMCInterfaceNode::statusCallback(const std_msgs::String& status_msg) {
-    if( status_msg.data == std::string("STOP-LISTENING") ) {
-        // set status
-        status_ = status_msg.data;
-
-        // controllers have converged, do not receive any more messages
-        receive_pelvis_transform_ = false;
-        received_pelvis_transform_ = false;
-        receive_link_ids_ = false;
-        received_link_ids_ = false;
-        receive_joint_command_ = false;
-        received_joint_command_ = false;
-
-        // update flag to publish commands
-        updatePublishCommandsFlag();
-
-        // update flag to stop node
-        updateStopNodeFlag();
-
-        ROS_INFO("[IHMC Interface Node] Controllers stopped, no longer publishing whole-body messages");
-        ROS_INFO("[IHMC Interface Node] Waiting for status change to receive more joint commands...");
-        // stream of messages can be ended with message with velocity of 0
-        // all messages sent with velocity 0, so ending on any message is fine
-    }
-    else if( status_msg.data == std::string("START-LISTENING") ) {
-        // set status
-        status_ = status_msg.data;
-
-        // controllers are started, prepare to receive messages
-        receive_pelvis_transform_ = true;
-        received_pelvis_transform_ = false;
-        receive_link_ids_ = true;
-        received_link_ids_ = false;
-        receive_joint_command_ = true;
-        received_joint_command_ = false;
-
-        // update flag to publish commands
-        updatePublishCommandsFlag();
-
-        // update flag to stop node
-        updateStopNodeFlag();
-
-        ROS_INFO("[IHMC Interface Node] Controllers started, waiting for joint commands...");
-    }
-    else if( status_msg.data == std::string("HOME-LEFTARM") ) {
-        // set status
-        status_ = status_msg.data;
-
-        // set flag
-        home_left_arm_ = true;
-
-        // update flag to publish go home message
-        updatePublishGoHomeCommandFlag();
-
-        ROS_INFO("[IHMC Interface Node] Homing left arm...");
-    }
-    else if( status_msg.data == std::string("HOME-RIGHTARM") ) {
-        // set status
-        status_ = status_msg.data;
-
-        // set flag
-        home_right_arm_ = true;
-
-        // update flag to publish go home message
-        updatePublishGoHomeCommandFlag();
-
-        ROS_INFO("[IHMC Interface Node] Homing right arm...");
-    }
-    else if( status_msg.data == std::string("HOME-CHEST") ) {
-        // set status
-        status_ = status_msg.data;
-
-        // set flag
-        home_chest_ = true;
-
-        // update flag to publish go home message
-        updatePublishGoHomeCommandFlag();
-
-        ROS_INFO("[IHMC Interface Node] Homing chest...");
-    }
-    else if( status_msg.data == std::string("HOME-PELVIS") ) {
-        // set status
-        status_ = status_msg.data;
-
-        // set flag
-        home_pelvis_ = true;
-
-        // update flag to publish go home message
-        updatePublishGoHomeCommandFlag();
-
-        ROS_INFO("[IHMC Interface Node] Homing pelvis...");
-    }
-    else if( status_msg.data == std::string("OPEN-LEFT-HAND") ) {
-        // set status
-        status_ = status_msg.data;
-
-        // set flag
-        open_left_hand_ = true;
-
-        // update flag to publish finger message
-        updatePublishFingerCommandFlag();
-
-        ROS_INFO("[IHMC Interface Node] Opening left hand...");
-    }
-    else if( status_msg.data == std::string("CLOSE-LEFT-HAND") ) {
-        // set status
-        status_ = status_msg.data;
-
-        // set flag
-        close_left_hand_ = true;
-
-        // update flag to publish finger message
-        updatePublishFingerCommandFlag();
-
-        ROS_INFO("[IHMC Interface Node] Closing left hand...");
-    }
-    else if( status_msg.data == std::string("OPEN-RIGHT-HAND") ) {
-        // set status
-        status_ = status_msg.data;
-
-        // set flag
-        open_right_hand_ = true;
-
-        // update flag to publish finger message
-        updatePublishFingerCommandFlag();
-
-        ROS_INFO("[IHMC Interface Node] Opening right hand...");
-    }
-    else if( status_msg.data == std::string("CLOSE-RIGHT-HAND") ) {
-        // set status
-        status_ = status_msg.data;
-
-        // set flag
-        close_right_hand_ = true;
-
-        // update flag to publish finger message
-        updatePublishFingerCommandFlag();
-
-        ROS_INFO("[IHMC Interface Node] Closing right hand...");
-    }
-    else {
-        ROS_WARN("[IHMC Interface Node] Unrecognized status %s, ignoring status message", status_msg.data.c_str());
-    }
+void IHMCInterfaceNode::partialTransformCallback(const IHMCMsgUtils::IHMCPartialTransformStamped& tf_msg) {
+    streamer_->processPartialPelvisTransform(tf_msg);
     return;
 }
 
-void IHMCInterfaceNode::handPoseCommandCallback(const geometry_msgs::TransformStamped& tf_msg) {
-    if( cartesian_hand_goals_ ) {
-        // check for left hand goal
-        if( tf_msg.child_frame_id.find(std::string("left")) != std::string::npos ) {
-            // store left target
-            left_hand_target_ = tf_msg;
-            // set flag indicating hand goal has been received
-            received_left_hand_goal_ = true;
-        }
-        // check for right hand goal
-        else if( tf_msg.child_frame_id.find(std::string("right")) != std::string::npos ) {
-            // store right target
-            right_hand_target_ = tf_msg;
-            // set flag indicating hand goal has been received
-            received_right_hand_goal_ = true;
-        }
-        else {
-            ROS_WARN("[IHMC Interface Node] Unrecognized child frame id %s, ignoring hand pose command message", tf_msg.child_frame_id.c_str());
-            return;
-        }
-    }
-
-    // update flag to publish hand commands
-    updatePublishHandCommandFlag();
-
-    return;
-}
-
-void IHMCInterfaceNode::receiveCartesianGoalsCallback(const std_msgs::Bool& bool_msg) {
-    // update Cartesian goals flag based on message
-    cartesian_hand_goals_ = bool_msg.data;
-
-    // status of Cartesian goals has changed; reset targets
-    geometry_msgs::TransformStamped empty_tf_msg;
-    left_hand_target_ = empty_tf_msg;
-    right_hand_target_ = empty_tf_msg;
-
-    // update flags
-    if( cartesian_hand_goals_ ) {
-        // prepare to receive Cartesian hand goals
-        received_left_hand_goal_ = false;
-        received_right_hand_goal_ = false;
-
-        // update flag to publish hand commands
-        updatePublishHandCommandFlag();
-
-        ROS_INFO("[IHMC Interface Node] Accepting Cartesian hand goals");
-    }
-    else {
-        // not receiving Cartesian hand goals
-        received_left_hand_goal_ = false;
-        received_right_hand_goal_ = false;
-
-        // update flag to publish hand commands
-        updatePublishHandCommandFlag();
-
-        // update flag to stop node
-        updateStopNodeFlag();
-
-        ROS_INFO("[IHMC Interface Node] Not accepting Cartesian hand goals");
-    }
-
+void IHMCInterfaceNode::partialJointCommandCallback(const IHMCMsgUtils::IHMCPartialJointState& js_msg) {
+    streamer_->processPartialJointCommand(js_msg);
     return;
 }
 
-// PUBLISH MESSAGE
-void IHMCInterfaceNode::publishWholeBodyMessage() {
-    // prepare configuration vector based on received pelvis transform and joint command
-    prepareConfigurationVector();
-
-    // initialize struct of default IHMC message parameters
-    IHMCMsgUtils::IHMCMessageParameters msg_params;
-    // set controlled links
-    msg_params.controlled_links = controlled_links_;
-
-    // if commands are coming from controllers, default message parameters will need to be changed
-    if( commands_from_controllers_ ) {
-        // set execution mode to streaming (0 override; 1 queue; 2 stream)
-        msg_params.queueable_params.execution_mode = 2;
-        // set stream integration duration (equal or slightly longer than interval between two consecutive messages, which should be coming in at 10 Hz or 0.1 secs)
-        msg_params.queueable_params.stream_integration_duration = 0.13; // TODO?
-        // set time to achieve trajectory point messages (1.0 for queueing, 0.0 for streaming)
-        msg_params.traj_point_params.time = 0.0;
-    }
-
-    // create whole-body message
-    controller_msgs::WholeBodyTrajectoryMessage wholebody_msg;
-    IHMCMsgUtils::makeIHMCWholeBodyTrajectoryMessage(q_, wholebody_msg, msg_params);
-
-    // publish message
-    wholebody_pub_.publish(wholebody_msg);
-
+void IHMCInterfaceNode::statusCallback(const ros::MessageEvent<std_msgs::String const>& status_event) {
+    // receipt time is taken when status arrives, before it waits in status queue;
+    // streamer measures latency on steady clock, so move back from now by age of status
+    ros::Duration status_age = ros::Time::now() - status_event.getReceiptTime();
+    std::chrono::steady_clock::time_point receipt_time = std::chrono::steady_clock::now() -
+        std::chrono::nanoseconds(std::max<int64_t>(0, status_age.toNSec()));
+    streamer_->processStatus(*status_event.getConstMessage(), receipt_time);
     return;
 }
 
-void IHMCInterfaceNode::publishWholeBodyMessageCartesianHandGoals() {
-    // initialize left and right hand goals, frame id, and controlled links
-    dynacore::Vect3 left_pos;
-    dynacore::Quaternion left_quat;
-    dynacore::Vect3 right_pos;
-    dynacore::Quaternion right_quat;
-    std::string cartesian_frame_id;
-    std::vector<int> controlled_links;
-
-    // prepare left and right goals
-    bool proceed = prepareCartesianHandGoals(left_pos, left_quat, right_pos, right_quat, cartesian_frame_id, controlled_links);
-
-    if( !proceed ) {
-        ROS_WARN("[IHMC Interface Node] Not publishing whole-body message");
-        return;
-    }
-
-    // initialize struct of default IHMC message parameters
-    IHMCMsgUtils::IHMCMessageParameters msg_params;
-    // set controlled links
-    msg_params.controlled_links = controlled_links;
-
-    // update message parameters for Cartesian goals
-    msg_params.cartesian_hand_goals = cartesian_hand_goals_;
-    msg_params.frame_params.cartesian_goal_reference_frame_name = cartesian_frame_id;
-
-    // get transform from pelvis to world
-    tf::StampedTransform tf_pelvis_wrt_world;
-    ROS_INFO("[IHMC Interface Node] Trying to get transform from pelvis to world...");
-    // try getting transformation
-    try {
-        // wait for most recent transform
-        tf_.waitForTransform("world", "pelvis", ros::Time(0), ros::Duration(2.0));
-        // lookup transform
-        tf_.lookupTransform("world", "pelvis", ros::Time(0), tf_pelvis_wrt_world);
-    }
-    catch (tf2::TransformException ex) {
-        ROS_WARN("[IHMC Interface Node] No transform from pelvis to world.");
-        return;
-    }
-
-    ROS_INFO("[IHMC Interface Node] Got transform from pelvis to world!");
-
-    // create whole-body message
-    controller_msgs::WholeBodyTrajectoryMessage wholebody_msg;
-    IHMCMsgUtils::makeIHMCWholeBodyTrajectoryMessage(q_, left_pos, left_quat, right_pos, right_quat,
-                                                     wholebody_msg, msg_params, tf_pelvis_wrt_world);
-    // configuration vector q_ will not be used
-
-    // publish message
-    wholebody_pub_.publish(wholebody_msg);
-
-    // reset flags since received targets have been processed
-    received_left_hand_goal_ = false;
-    received_right_hand_goal_ = false;
-
-    // update flag to publish hand message
-    updatePublishHandCommandFlag();
-
+void IHMCInterfaceNode::handPoseCommandCallback(const geometry_msgs::TransformStamped& tf_msg) {
+    streamer_->processHandPoseCommand(tf_msg);
     return;
 }
 
-void IHMCInterfaceNode::publishGoHomeMessage() {
-    // initialize struct of default IHMC message parameters
-    IHMCMsgUtils::IHMCMessageParameters msg_params;
-
-    // home left arm
-    if( home_left_arm_ ) {
-        // create go home message
-        controller_msgs::GoHomeMessage go_home_msg;
-        IHMCMsgUtils::makeIHMCHomeLeftArmMessage(go_home_msg, msg_params);
-
-        // publish message
-        go_home_pub_.publish(go_home_msg);
-
-        // reset flag
-        home_left_arm_ = false;
-    }
-
-    // home right arm
-    if( home_right_arm_ ) {
-        // create go home message
-        controller_msgs::GoHomeMessage go_home_msg;
-        IHMCMsgUtils::makeIHMCHomeRightArmMessage(go_home_msg, msg_params);
-
-        // publish message
-        go_home_pub_.publish(go_home_msg);
-
-        // reset flag
-        home_right_arm_ = false;
-    }
-
-    // home chest
-    if( home_chest_ ) {
-        // create go home message
-        controller_msgs::GoHomeMessage go_home_msg;
-        IHMCMsgUtils::makeIHMCHomeChestMessage(go_home_msg, msg_params);
-
-        // publish message
-        go_home_pub_.publish(go_home_msg);
-
-        // reset flag
-        home_chest_ = false;
-    }
-
-    // home pelvis
-    if( home_pelvis_ ) {
-        // create go home message
-        controller_msgs::GoHomeMessage go_home_msg;
-        IHMCMsgUtils::makeIHMCHomePelvisMessage(go_home_msg, msg_params);
-
-        // publish message
-        go_home_pub_.publish(go_home_msg);
-
-        // reset flag
-        home_pelvis_ = false;
-    }
-
-    // update flag to publish go home message
-    updatePublishGoHomeCommandFlag();
-
+void IHMCInterfaceNode::bimanualHandPoseCommandCallback(const IHMCMsgInterface::BimanualHandGoal& goal_msg) {
+    streamer_->processBimanualHandPoseCommand(goal_msg);
     return;
 }
 
-void IHMCInterfaceNode::publishHandFingerMessage() {
-    // open left hand
-    if( open_left_hand_ ) {
-        // publish message
-        publishFingerOpenLeftMessage();
-
-        // reset flag
-        open_left_hand_ = false;
-    }
-
-    // close left hand
-    if( close_left_hand_ ) {
-        // publish message
-        publishFingerCloseLeftMessage();
-
-        // reset flag
-        close_left_hand_ = false;
-    }
-
-    // open right hand
-    if( open_right_hand_ ) {
-        // publish message
-        publishFingerOpenRightMessage();
-
-        // reset flag
-        open_right_hand_ = false;
-    }
-
-    // close right hand
-    if( close_right_hand_ ) {
-        // publish message
-        publishFingerCloseRightMessage();
-
-        // reset flag
-        close_right_hand_ = false;
-    }
-
-    // update flag to publish hand message
-    updatePublishFingerCommandFlag();
-
+void IHMCInterfaceNode::receiveCartesianGoalsCallback(const std_msgs::Bool& bool_msg) {
+    streamer_->processReceiveCartesianGoals(bool_msg);
     return;
 }
 
-void IHMCInterfaceNode::publishFingerOpenLeftMessage() {
-    // initialize struct of default IHMC message parameters
-    IHMCMsgUtils::IHMCMessageParameters msg_params;
-    // modify default parameters for finger messages
-    msg_params.setParametersForFingerMessages();
-    // set time for trajectory
-    msg_params.traj_point_params.time = msg_params.finger_traj_params.open_hand_time;
-
-    // create finger message
-    controller_msgs::ValkyrieHandFingerTrajectoryMessage finger_msg;
-    IHMCMsgUtils::makeIHMCValkyrieHandFingerTrajectoryMessage(finger_msg, finger_msg.ROBOT_SIDE_LEFT, true, msg_params);
-
-    // publish message
-    finger_pub_.publish(finger_msg);
-
+void IHMCInterfaceNode::robotConfigurationDataCallback(const controller_msgs::RobotConfigurationData& config_msg) {
+    streamer_->processRobotConfigurationData(config_msg);
     return;
 }
 
-void IHMCInterfaceNode::publishFingerCloseLeftMessage() {
-    // initialize struct of default IHMC message parameters
-    IHMCMsgUtils::IHMCMessageParameters msg_params;
-    // modify default parameters for finger messages
-    msg_params.setParametersForFingerMessages();
-    // set time for trajectory
-    msg_params.traj_point_params.time = msg_params.finger_traj_params.close_hand_time;
-
-    // create finger message
-    controller_msgs::ValkyrieHandFingerTrajectoryMessage finger_msg;
-    IHMCMsgUtils::makeIHMCValkyrieHandFingerTrajectoryMessage(finger_msg, finger_msg.ROBOT_SIDE_LEFT, false, msg_params);
-
-    // publish message
-    finger_pub_.publish(finger_msg);
-
+void IHMCInterfaceNode::fingerPositionCommandCallback(const IHMCMsgInterface::FingerPositionCommand& finger_msg) {
+    streamer_->processFingerPositionCommand(finger_msg);
     return;
 }
 
-void IHMCInterfaceNode::publishFingerOpenRightMessage() {
-    // initialize struct of default IHMC message parameters
-    IHMCMsgUtils::IHMCMessageParameters msg_params;
-    // modify default parameters for finger messages
-    msg_params.setParametersForFingerMessages();
-    // set time for trajectory
-    msg_params.traj_point_params.time = msg_params.finger_traj_params.open_hand_time;
-
-    // create finger message
-    controller_msgs::ValkyrieHandFingerTrajectoryMessage finger_msg;
-    IHMCMsgUtils::makeIHMCValkyrieHandFingerTrajectoryMessage(finger_msg, finger_msg.ROBOT_SIDE_RIGHT, true, msg_params);
+// UPDATE
+bool IHMCInterfaceNode::update() {
+    bool keep_running = streamer_->update();
 
-    // publish message
-    finger_pub_.publish(finger_msg);
+    // publish tracking error statistics once measurements have been compared
+    if( monitor_tracking_ && streamer_->getTrackingMonitor().getNumMeasurements() > 0 ) {
+        std_msgs::Float64MultiArray stats_msg;
+        streamer_->getTrackingMonitor().makeStatsMessage(stats_msg);
+        tracking_error_pub_.publish(stats_msg);
+    }
 
-    return;
+    return keep_running;
 }
 
-void IHMCInterfaceNode::publishFingerCloseRightMessage() {
-    // initialize struct of default IHMC message parameters
-    IHMCMsgUtils::IHMCMessageParameters msg_params;
-    // modify default parameters for finger messages
-    msg_params.setParametersForFingerMessages();
-    // set time for trajectory
-    msg_params.traj_point_params.time = msg_params.finger_traj_params.close_hand_time;
-
-    // create finger message
-    controller_msgs::ValkyrieHandFingerTrajectoryMessage finger_msg;
-    IHMCMsgUtils::makeIHMCValkyrieHandFingerTrajectoryMessage(finger_msg, finger_msg.ROBOT_SIDE_RIGHT, false, msg_params);
-
-    // publish message
-    finger_pub_.publish(finger_msg);
+void IHMCInterfaceNode::waitForStatus(ros::Time until) {
+    // wait in short slices, so waiting also ends on time when using simulated time
+    while( ros::ok() && (ros::Time::now() < until) ) {
+        double remaining = (until - ros::Time::now()).toSec();
+        status_queue_.callAvailable(ros::WallDuration(std::min(std::max(remaining, 0.0), 0.01)));
+    }
 
     return;
 }
 
 // HELPER FUNCTIONS
-std::string IHMCInterfaceNode::getStatus() {
-    return status_;
-}
-
 bool IHMCInterfaceNode::getCommandsFromControllersFlag() {
     return commands_from_controllers_;
 }
 
-bool IHMCInterfaceNode::getPublishCommandsFlag() {
-    return publish_commands_;
-}
-
-void IHMCInterfaceNode::updatePublishCommandsFlag() {
-    // if pelvis and joint command both received, then commands can be published
-    publish_commands_ = received_pelvis_transform_ && received_link_ids_ && received_joint_command_;
-
-    return;
-}
-
-bool IHMCInterfaceNode::getStopNodeFlag() {
-    return stop_node_;
-}
-
-void IHMCInterfaceNode::updateStopNodeFlag() {
-    // if both pelvis and joint commands no longer being received, then prepare to stop node
-    stop_node_ = !receive_pelvis_transform_ && !receive_joint_command_;
-
-    return;
-}
-
-bool IHMCInterfaceNode::getPublishGoHomeCommandFlag() {
-    return publish_go_home_command_;
-}
-
-void IHMCInterfaceNode::updatePublishGoHomeCommandFlag() {
-    // if any body parts need to be homed, then go home message(s) need to be published
-    publish_go_home_command_ = home_left_arm_ || home_right_arm_ || home_chest_ || home_pelvis_;
-
-    return;
-}
-
-bool IHMCInterfaceNode::getPublishFingerCommandFlag() {
-    return publish_finger_command_;
-}
-
-void IHMCInterfaceNode::updatePublishFingerCommandFlag() {
-    // if any hand message needs to be opened/closed, then finger message needs to be published
-    publish_finger_command_ = open_left_hand_ || close_left_hand_ || open_right_hand_ || close_right_hand_;
-
-    return;
-}
-
-bool IHMCInterfaceNode::getPublishHandCommandFlag() {
-    return publish_hand_command_;
-}
-
-void IHMCInterfaceNode::updatePublishHandCommandFlag() {
-    // if Cartesian goals are being accepted and either left or right goal received, then hand message needs to be published
-    publish_hand_command_ = cartesian_hand_goals_ && (received_left_hand_goal_ || received_right_hand_goal_);
-
-    return;
-}
-
-void IHMCInterfaceNode::prepareEmptyPose(dynacore::Vect3& pos, dynacore::Quaternion& quat) {
-    // set position to zero
-    pos.setZero();
-    // set quaternion to identity
-    quat.setIdentity();
-
-    return;
-}
-
-void IHMCInterfaceNode::preparePoseFromTransform(dynacore::Vect3& pos, dynacore::Quaternion& quat,
-                                                 geometry_msgs::TransformStamped tf_msg) {
-    // set position from transform
-    pos << tf_msg.transform.translation.x, tf_msg.transform.translation.y, tf_msg.transform.translation.z;
-    // set quaternion from transform
-    quat.x() = tf_msg.transform.rotation.x;
-    quat.y() = tf_msg.transform.rotation.y;
-    quat.z() = tf_msg.transform.rotation.z;
-    quat.w() = tf_msg.transform.rotation.w;
-
-    return;
-}
-
-bool IHMCInterfaceNode::prepareCartesianHandGoals(dynacore::Vect3& left_pos, dynacore::Quaternion& left_quat,
-                                                  dynacore::Vect3& right_pos, dynacore::Quaternion& right_quat,
-                                                  std::string& frame_id, std::vector<int>& controlled_links) {
-    // clear controlled links vector
-    controlled_links.clear();
-
-    // check if left target received
-    if( !received_left_hand_goal_ ) {
-        // no target received
-        prepareEmptyPose(left_pos, left_quat);
-    }
-    else {
-        // set target from transform
-        preparePoseFromTransform(left_pos, left_quat, left_hand_target_);
-    }
-
-    // check if right target received
-    if( !received_right_hand_goal_ ) {
-        // no target received
-        prepareEmptyPose(right_pos, right_quat);
-    }
-    else {
-        // set target from transform
-        preparePoseFromTransform(right_pos, right_quat, right_hand_target_);
-    }
-
-    // set frame id
-    if( !received_left_hand_goal_ && !received_right_hand_goal_ ) {
-        // neither pose set
-        frame_id = std::string("");
-        return false;
-    }
-    else if( received_left_hand_goal_ && !received_right_hand_goal_ ) {
-        // left pose set, right pose not
-        frame_id = std::string(left_hand_target_.header.frame_id);
-        controlled_links.push_back(valkyrie_link::leftPalm);
-        return true;
-    }
-    else if( !received_left_hand_goal_ && received_right_hand_goal_ ) {
-        // right pose set, left pose not
-        frame_id = std::string(right_hand_target_.header.frame_id);
-        controlled_links.push_back(valkyrie_link::rightPalm);
-        return true;
-    }
-    else { // received_left_hand_goal_ && received_right_hand_goal_
-        // make sure frames are the same
-        if( left_hand_target_.header.frame_id.compare(right_hand_target_.header.frame_id) == 0 ) {
-            // frames are the same
-            frame_id = std::string(left_hand_target_.header.frame_id);
-            controlled_links.push_back(valkyrie_link::leftPalm);
-            controlled_links.push_back(valkyrie_link::rightPalm);
-            return true;
-        }
-        else {
-            // frames are not the same; cannot confidently set frame
-            ROS_WARN("[IHMC Interface Node] Received left hand target in frame %s and right hand target in frame %s; cannot send Cartesian hand targets due to ambiguity",
-                      left_hand_target_.header.frame_id.c_str(), right_hand_target_.header.frame_id.c_str());
-            frame_id = std::string("");
-            return false;
-        }
-    }
-}
-
-void IHMCInterfaceNode::prepareConfigurationVector() {
-    // pelvis transform and joint command received, so prepare configuration vector
-    // resize configuration vector
-    q_.resize(valkyrie::num_q);
-    q_.setZero();
-
-    // get pelvis transform
-    tf::Vector3 pelvis_origin = tf_pelvis_wrt_world_.getOrigin();
-    tf::Quaternion pelvis_tfrotation = tf_pelvis_wrt_world_.getRotation();
-
-    // set pelvis position
-    q_[valkyrie_joint::virtual_X] = pelvis_origin.getX();
-    q_[valkyrie_joint::virtual_Y] = pelvis_origin.getY();
-    q_[valkyrie_joint::virtual_Z] = pelvis_origin.getZ();
-
-    // convert pelvis orientation to dynacore (Eigen) quaternion
-    dynacore::Quaternion pelvis_rotation;
-    dynacore::convert(pelvis_tfrotation, pelvis_rotation);
-
-    // set pelvis rotation
-    q_[valkyrie_joint::virtual_Rx] = pelvis_rotation.x();
-    q_[valkyrie_joint::virtual_Ry] = pelvis_rotation.y();
-    q_[valkyrie_joint::virtual_Rz] = pelvis_rotation.z();
-    q_[valkyrie_joint::virtual_Rw] = pelvis_rotation.w();
-
-    // set joints
-    for( int i = 0 ; i < q_joint_.size() ; i++ ) {
-        // set index for joint, add offset to account for virtual joints
-        int jidx = i + valkyrie::num_virtual;
-        q_[jidx] = q_joint_[i];
-    }
-
-    return;
+double IHMCInterfaceNode::getStreamRate() {
+    return stream_rate_;
 }
 
 int main(int argc, char **argv) {
@@ -893,49 +286,23 @@ int main(int argc, char **argv) {
         ROS_INFO("[IHMC Interface Node] Node started, waiting for joint commands...");
     }
 
-    ros::Rate rate(10);
+    ros::Duration cycle_time(1.0 / ihmc_interface_node.getStreamRate());
+    ros::Time next_cycle = ros::Time::now() + cycle_time;
     while( ros::ok() ) {
-        // check if commands coming from controllers
-        if( ihmc_interface_node.getCommandsFromControllersFlag() ) {
-            // consistently publish messages until controllers converge
-            if( ihmc_interface_node.getPublishCommandsFlag() ) {
-                // ready to publish commands
-                ROS_INFO("[IHMC Interface Node] Preparing and streaming whole-body message...");
-                ihmc_interface_node.publishWholeBodyMessage();
-            }
-
-            // check if any body parts need to be homed
-            if( ihmc_interface_node.getPublishGoHomeCommandFlag() ) {
-                // ready to publish homing message
-                ROS_INFO("[IHMC Interface Node] Publishing go home message...");
-                ihmc_interface_node.publishGoHomeMessage();
-            }
-
-            // check if any hands need to be opened/closed
-            if( ihmc_interface_node.getPublishFingerCommandFlag() ) {
-                // ready to publish finger message
-                ROS_INFO("[IHMC Interface Node] Publishing hand finger trajectory message...");
-                ihmc_interface_node.publishHandFingerMessage();
-            }
-
-            // check if any hands need to be moved to target
-            if( ihmc_interface_node.getPublishHandCommandFlag() ) {
-                // ready to publish hand message
-                ROS_INFO("[IHMC Interface Node] Publishing hand trajectory message...");
-                ihmc_interface_node.publishWholeBodyMessageCartesianHandGoals();
-            }
-        }
-        else {
-            // otherwise, publish single whole-body message and exit node
-            if( ihmc_interface_node.getPublishCommandsFlag() && ihmc_interface_node.getStopNodeFlag() ) {
-                ROS_INFO("[IHMC Interface Node] Preparing and executing whole-body message...");
-                ihmc_interface_node.publishWholeBodyMessage();
-                ros::Duration(3.0).sleep();
-                break; // only publish one message, then stop
-            }
+        // publish any messages that are ready
+        if( !ihmc_interface_node.update() ) {
+            // not streaming from controllers, single whole-body message published
+            ros::Duration(3.0).sleep();
+            break; // only publish one message, then stop
         }
         ros::spinOnce();
-        rate.sleep();
+        // wait for next cycle at stream rate, handling statuses (e.g., stops) as soon as they arrive
+        ihmc_interface_node.waitForStatus(next_cycle);
+        next_cycle = next_cycle + cycle_time;
+        if( next_cycle < ros::Time::now() ) {
+            // fell behind, restart cycle timing from now
+            next_cycle = ros::Time::now() + cycle_time;
+        }
     }
 
     ROS_INFO("[IHMC Interface Node] Published whole-body message, all done!");
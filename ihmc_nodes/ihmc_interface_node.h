@@ -6,18 +6,26 @@
 #ifndef _IHMC_INTERFACE_NODE_H_
 #define _IHMC_INTERFACE_NODE_H_
 
+#include <algorithm>
+#include <map>
+#include <memory>
 #include <vector>
 #include <Valkyrie/Valkyrie_Definition.h>
 #include <Valkyrie/Valkyrie_Model.hpp>
 #include <ros/ros.h>
+#include <ros/callback_queue.h>
 #include <std_msgs/Bool.h>
 #include <std_msgs/Int32MultiArray.h>
 #include <std_msgs/String.h>
+#include <std_msgs/Float64MultiArray.h>
 #include <sensor_msgs/JointState.h>
 #include <geometry_msgs/TransformStamped.h>
-#include <tf/tf.h>
-#include <tf/transform_listener.h>
+#include <controller_msgs/RobotConfigurationData.h>
 #include <ihmc_utils/ihmc_msg_utilities.h>
+#include <ihmc_utils/ihmc_command_streamer.h>
+#include <IHMCMsgInterface/BimanualHandGoal.h>
+#include <IHMCMsgInterface/FingerPositionCommand.h>
+#include <ihmc_utils/ihmc_command_publisher.h>
 
 class IHMCInterfaceNode
 {
@@ -33,40 +41,27 @@ public:
     void transformCallback(const geometry_msgs::TransformStamped& tf_msg);
     void controlledLinkIdsCallback(const std_msgs::Int32MultiArray& arr_msg);
     void jointCommandCallback(const sensor_msgs::JointState& js_msg);
-    void statusCallback(const std_msgs::String& status_msg);
+    void statusCallback(const ros::MessageEvent<std_msgs::String const>& status_event);
     void handPoseCommandCallback(const geometry_msgs::TransformStamped& tf_msg);
+    void bimanualHandPoseCommandCallback(const IHMCMsgInterface::BimanualHandGoal& goal_msg);
     void receiveCartesianGoalsCallback(const std_msgs::Bool& bool_msg);
-
-    // PUBLISH MESSAGE
-    void publishWholeBodyMessage();
-    void publishWholeBodyMessageCartesianHandGoals();
-    void publishGoHomeMessage();
-    void publishHandFingerMessage();
-    void publishFingerOpenLeftMessage();
-    void publishFingerCloseLeftMessage();
-    void publishFingerOpenRightMessage();
-    void publishFingerCloseRightMessage();
+    void robotConfigurationDataCallback(const controller_msgs::RobotConfigurationData& config_msg);
+    void fingerPositionCommandCallback(const IHMCMsgInterface::FingerPositionCommand& finger_msg);
+    void partialTransformCallback(const IHMCMsgUtils::IHMCPartialTransformStamped& tf_msg);
+    void partialJointCommandCallback(const IHMCMsgUtils::IHMCPartialJointState& js_msg);
+
+    // UPDATE
+    bool update();
+    /*
+     * handles statuses as soon as they arrive until the given time, so stops are not delayed until the next cycle
+     * @param until, the time to stop waiting (e.g., start of next cycle)
+     * @return none
+     */
+    void waitForStatus(ros::Time until);
 
     // HELPER FUNCTIONS
-    std::string getStatus();
     bool getCommandsFromControllersFlag();
-    bool getPublishCommandsFlag();
-    void updatePublishCommandsFlag();
-    bool getStopNodeFlag();
-    void updateStopNodeFlag();
-    bool getPublishGoHomeCommandFlag();
-    void updatePublishGoHomeCommandFlag();
-    bool getPublishFingerCommandFlag();
-    void updatePublishFingerCommandFlag();
-    bool getPublishHandCommandFlag();
-    void updatePublishHandCommandFlag();
-    void prepareEmptyPose(dynacore::Vect3& pos, dynacore::Quaternion& quat);
-    void preparePoseFromTransform(dynacore::Vect3& pos, dynacore::Quaternion& quat,
-                                  geometry_msgs::TransformStamped tf_msg);
-    bool prepareCartesianHandGoals(dynacore::Vect3& left_pos, dynacore::Quaternion& left_quat,
-                                   dynacore::Vect3& right_pos, dynacore::Quaternion& right_quat,
-                                   std::string& frame_id, std::vector<int>& controlled_links);
-    void prepareConfigurationVector();
+    double getStreamRate();
 
 private:
     ros::NodeHandle nh_; // node handler
@@ -79,50 +74,32 @@ private:
     ros::Subscriber joint_command_sub_; // subscriber for listening for joint commands
     std::string hand_pose_command_topic_; // topic to subscribe to for listening to Cartesian hand goals
     ros::Subscriber hand_pose_command_sub_; // subscriber for listening for Cartesian hand goals
+    std::string bimanual_hand_pose_command_topic_; // topic to subscribe to for listening to Cartesian goals for both hands
+    ros::Subscriber bimanual_hand_pose_command_sub_; // subscriber for listening for Cartesian goals for both hands
     std::string status_topic_; // topic to subscribe to for listening to statuses
     ros::Subscriber status_sub_; // subscriber for listening to statuses
+    ros::CallbackQueue status_queue_; // queue for status callbacks, checked between cycles
     std::string receive_cartesian_goals_topic_; // topic to subscribe to for listening to Cartesian goal updates
     ros::Subscriber receive_cartesian_goals_sub_; // subscriber for listening to Cartesian goal updates
-    std::string status_; // string indicating current status
-
-    ros::Publisher wholebody_pub_; // publisher for wholebody messages
-    ros::Publisher go_home_pub_; // publisher for go home messages
-    ros::Publisher finger_pub_; // publisher for finger messages
+    std::string finger_position_command_topic_; // topic to subscribe to for listening to streamed finger positions
+    ros::Subscriber finger_position_command_sub_; // subscriber for listening to streamed finger positions
+    std::string robot_configuration_topic_; // topic to subscribe to for listening to measured robot configurations
+    ros::Subscriber robot_configuration_sub_; // subscriber for listening to measured robot configurations
+
+    std::vector<std::string> wholebody_output_topics_; // topics to publish wholebody messages to (e.g., IHMC, logger, visualization)
+    IHMCMsgUtils::IHMCCommandPublisher command_pub_; // publishers for messages built by streamer
+    ros::Publisher tracking_error_pub_; // publisher for tracking error statistics
+
+    std::string input_log_file_; // file to capture consumed inputs to for offline replay (empty disables capture)
+    std::string pose_library_file_; // file of named poses published on status "POSE:<name>" (empty disables poses)
+    bool partial_deserialization_; // flag indicating whether joint commands and pelvis transforms are only partially deserialized
+    bool stop_on_stop_listening_; // flag indicating whether to stop robot as soon as controllers stop
+    double stream_rate_; // rate (Hz) of update loop, and so of body parts without their own stream rates
+    bool monitor_tracking_; // flag indicating whether to compare commands against measured robot configurations
+    double transition_blend_duration_; // duration (s) of blends from poses and go home messages into streamed commands
 
     bool commands_from_controllers_; // flag indicating whether joint commands are coming from controllers (affects queueing properties of messages)
-    bool cartesian_hand_goals_; // flag indicating whether arm commands are in Cartesian space or joint space (affects which fields of messages get set)
-    bool receive_pelvis_transform_; // flag indicating whether to accept pelvis transforms
-    bool received_pelvis_transform_; // flag indicating whether pelvis transform has been received
-    bool receive_link_ids_; // flag indicating whether to accept link ids
-    bool received_link_ids_; // flag indicating whether link ids have been received
-    bool receive_joint_command_; // flag indicating whether to accept new joint commands
-    bool received_joint_command_; // flag indicating whether joint command has been received
-    bool received_left_hand_goal_; // flag indicating whether Cartesian left hand goal has been received
-    bool received_right_hand_goal_; // flag indicating whether Cartesian right hand goal has been received
-    bool publish_commands_; // flag indicating if joint and pelvis information has been received and whole body message can be published
-    bool stop_node_; // flag indicating when to publish whole body messages
-
-    bool home_left_arm_; // flag indicating if homing message for left arm should be published
-    bool home_right_arm_; // flag indicating if homing message for right arm should be published
-    bool home_chest_; // flag indicating if homing message for ches should be published
-    bool home_pelvis_; // flag indicating if homing message for pelvis should be published
-    bool publish_go_home_command_; // flag indicating if any homing messages need to be published
-
-    bool open_left_hand_; // flag indicating if open left hand message should be published
-    bool close_left_hand_; // flag indicating if close left hand message should be published
-    bool open_right_hand_; // flag indicating if open right hand message should be published
-    bool close_right_hand_; // flag indicating if close right hand message should be published
-    bool publish_finger_command_; // flag indicating if any finger messages need to be published
-    bool publish_hand_command_; // flag indicating if any hand messages need to be published
-
-    dynacore::Vector q_joint_; // vector of commanded joint positions
-    tf::Transform tf_pelvis_wrt_world_; // transform of pelvis in world frame
-    dynacore::Vector q_; // full configuration vector, including virtual joints
-    std::vector<int> controlled_links_; // vector of controlled links
-    geometry_msgs::TransformStamped left_hand_target_; // target pose for left hand
-    geometry_msgs::TransformStamped right_hand_target_; // target pose for right hand
-
-    tf::TransformListener tf_;
+    std::unique_ptr<IHMCMsgUtils::IHMCCommandStreamer> streamer_; // stream state and message building, independent of ROS transport
 };
 
 #endif
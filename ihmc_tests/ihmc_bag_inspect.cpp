@@ -0,0 +1,657 @@
+#include <cstdio>
+#include <cmath>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <chrono>
+
+#include <ros/ros.h>
+#include <ros/serialization.h>
+#include <rosbag/bag.h>
+#include <rosbag/view.h>
+
+#include <ihmc_utils/ihmc_msg_utilities.h>
+#include <ihmc_utils/ihmc_msg_visitor.h>
+
+/*
+ * Inspection and diff tool for recorded IHMC messages.
+ * Streams whole-body, go home, and finger trajectory messages from a bag in time order, decoding one message at a time
+ * into reused messages, and prints a compact table with one row per message: time since start of bag, topic, sequence
+ * id, execution mode, trajectory time, and the final trajectory point of each controlled body part.
+ * With --diff 1, prints the fields that changed since the previous message on the same topic instead of the table;
+ * with --compare FILE, prints the fields that differ between the n-th messages on each topic of the two bags.
+ * Sequence ids and creation timestamps change on every message, so they are left out of diffs unless --stamps 1.
+ *
+ * usage: ihmc_bag_inspect --bag FILE [--compare FILE] [--diff 0|1] [--topic TOPIC] [--start S] [--end S]
+ *                         [--every N] [--stamps 0|1] [--tolerance EPS] [--max-fields N] [--quiet 0|1]
+ *   --topic TOPIC, only inspect messages on topic (default all topics with supported message types)
+ *   --start S, --end S, only inspect messages between S and S seconds after start of bag
+ *   --every N, print every N-th table row (default 1)
+ *   --tolerance EPS, smallest difference between field values reported in diffs (default 1e-9)
+ *   --max-fields N, most fields printed per diff (default 20)
+ *   --quiet 1, decode every message but only print the summary, for timing a bag
+ */
+
+// SUPPORTED MESSAGE TYPES
+enum RecordedType {
+    RECORDED_WHOLEBODY = 0,
+    RECORDED_GO_HOME,
+    RECORDED_FINGER,
+    NUM_RECORDED_TYPES,
+    RECORDED_UNSUPPORTED
+};
+
+const char* RECORDED_TYPE_NAMES[NUM_RECORDED_TYPES] = {"wb", "home", "finger"};
+
+std::vector<std::string> getSupportedDataTypes() {
+    std::vector<std::string> datatypes(NUM_RECORDED_TYPES);
+    datatypes[RECORDED_WHOLEBODY] = ros::message_traits::datatype<controller_msgs::WholeBodyTrajectoryMessage>();
+    datatypes[RECORDED_GO_HOME] = ros::message_traits::datatype<controller_msgs::GoHomeMessage>();
+    datatypes[RECORDED_FINGER] = ros::message_traits::datatype<controller_msgs::ValkyrieHandFingerTrajectoryMessage>();
+    return datatypes;
+}
+
+int getRecordedType(const std::string& datatype, const std::vector<std::string>& supported_datatypes) {
+    for( int i = 0 ; i < NUM_RECORDED_TYPES ; i++ ) {
+        if( datatype == supported_datatypes[i] ) {
+            return i;
+        }
+    }
+    return RECORDED_UNSUPPORTED;
+}
+
+// OPTIONS
+struct InspectOptions {
+    std::string bag_file;
+    std::string compare_file;
+    std::string topic;
+    bool diff;
+    bool stamps;
+    bool quiet;
+    double start;
+    double end;
+    int every;
+    double tolerance;
+    int max_fields;
+
+    InspectOptions() {
+        diff = false;
+        stamps = false;
+        quiet = false;
+        start = 0.0;
+        end = -1.0;
+        every = 1;
+        tolerance = 1e-9;
+        max_fields = 20;
+    }
+};
+
+// RECORDED MESSAGE
+// kept serialized, so messages of any supported type can wait for comparison and are only decoded when compared
+struct RecordedMessage {
+    int type;
+    std::string topic;
+    double time; // seconds since start of bag
+    uint64_t index; // index of message on topic
+    std::vector<uint8_t> bytes;
+};
+
+// BAG READER
+class BagReader
+{
+public:
+    BagReader(const std::string& bag_file, const InspectOptions& options) {
+        bag_.open(bag_file, rosbag::bagmode::Read);
+        supported_datatypes_ = getSupportedDataTypes();
+
+        // find start of bag among inspected messages, then limit view to requested time window
+        rosbag::View full_view;
+        addQuery(full_view, options, ros::TIME_MIN, ros::TIME_MAX);
+        begin_time_ = full_view.getBeginTime();
+        ros::Time end_time = (options.end >= 0.0) ? begin_time_ + ros::Duration(options.end) : full_view.getEndTime();
+        addQuery(view_, options, begin_time_ + ros::Duration(options.start), end_time);
+
+        it_ = view_.begin();
+        num_messages_ = 0;
+        num_bytes_ = 0;
+    }
+
+    ~BagReader() {
+    }
+
+    /*
+     * reads next supported message from bag into reused buffer, without decoding it
+     * @param msg, the recorded message that will be updated
+     * @return bool indicating if a message was read (false at end of bag)
+     */
+    bool next(RecordedMessage& msg) {
+        for( ; it_ != view_.end() ; ++it_ ) {
+            const rosbag::MessageInstance& instance = *it_;
+            int type = getRecordedType(instance.getDataType(), supported_datatypes_);
+            if( type == RECORDED_UNSUPPORTED ) {
+                continue;
+            }
+
+            msg.type = type;
+            msg.topic = instance.getTopic();
+            msg.time = (instance.getTime() - begin_time_).toSec();
+            msg.index = topic_counts_[msg.topic]++;
+
+            // copy serialized message straight out of bag; buffer keeps its capacity between messages
+            msg.bytes.resize(instance.size());
+            ros::serialization::OStream stream(msg.bytes.data(), msg.bytes.size());
+            instance.write(stream);
+
+            num_messages_++;
+            num_bytes_ += msg.bytes.size();
+            ++it_;
+            return true;
+        }
+        return false;
+    }
+
+    uint64_t getNumMessages() { return num_messages_; }
+    uint64_t getNumBytes() { return num_bytes_; }
+
+private:
+    void addQuery(rosbag::View& view, const InspectOptions& options, const ros::Time& start_time, const ros::Time& end_time) {
+        // query by topic if requested (unsupported types on topic are skipped), otherwise by supported types
+        if( options.topic.empty() ) {
+            view.addQuery(bag_, rosbag::TypeQuery(supported_datatypes_), start_time, end_time);
+        }
+        else {
+            view.addQuery(bag_, rosbag::TopicQuery(options.topic), start_time, end_time);
+        }
+        return;
+    }
+
+    rosbag::Bag bag_;
+    rosbag::View view_;
+    rosbag::View::iterator it_;
+    std::vector<std::string> supported_datatypes_;
+    ros::Time begin_time_;
+    std::map<std::string, uint64_t> topic_counts_;
+    uint64_t num_messages_;
+    uint64_t num_bytes_;
+};
+
+// DECODING
+template <class M>
+void decodeMessage(const RecordedMessage& recorded_msg, M& msg) {
+    ros::serialization::IStream stream(const_cast<uint8_t*>(recorded_msg.bytes.data()), recorded_msg.bytes.size());
+    ros::serialization::deserialize(stream, msg);
+    return;
+}
+
+// TABLE
+const char* getExecutionModeName(int execution_mode) {
+    switch( execution_mode ) {
+        case 0:
+            return "override";
+        case 1:
+            return "queue";
+        case 2:
+            return "stream";
+        default:
+            return "?";
+    }
+}
+
+const char* getTopicName(const std::string& topic) {
+    // last component of topic keeps rows short
+    size_t pos = topic.find_last_of('/');
+    return (pos == std::string::npos) ? topic.c_str() : topic.c_str() + pos + 1;
+}
+
+void printRowStart(const RecordedMessage& recorded_msg, uint32_t sequence_id,
+                   const controller_msgs::QueueableMessage* queueing_properties, double trajectory_time) {
+    std::printf("%10.3f  %-24s %-6s %8u  %-8s %6.3f ",
+                recorded_msg.time, getTopicName(recorded_msg.topic), RECORDED_TYPE_NAMES[recorded_msg.type], sequence_id,
+                (queueing_properties != nullptr) ? getExecutionModeName(queueing_properties->execution_mode) : "-",
+                trajectory_time);
+    return;
+}
+
+bool printJointspace(const char* name, const controller_msgs::JointspaceTrajectoryMessage& js_msg) {
+    // final position of each joint
+    if( js_msg.joint_trajectory_messages.empty() ) {
+        return false;
+    }
+    std::printf(" %s=[", name);
+    for( int i = 0 ; i < js_msg.joint_trajectory_messages.size() ; i++ ) {
+        const std::vector<controller_msgs::TrajectoryPoint1DMessage>& points = js_msg.joint_trajectory_messages[i].trajectory_points;
+        if( points.empty() ) {
+            std::printf(i > 0 ? " -" : "-");
+        }
+        else {
+            std::printf(i > 0 ? " %.3f" : "%.3f", points.back().position);
+        }
+    }
+    std::printf("]");
+    return true;
+}
+
+bool printSE3(const char* name, const controller_msgs::SE3TrajectoryMessage& se3_msg) {
+    // final position and orientation
+    if( se3_msg.taskspace_trajectory_points.empty() ) {
+        return false;
+    }
+    const controller_msgs::SE3TrajectoryPointMessage& point = se3_msg.taskspace_trajectory_points.back();
+    std::printf(" %s=[%.3f %.3f %.3f|%.3f %.3f %.3f %.3f]", name,
+                point.position.x, point.position.y, point.position.z,
+                point.orientation.x, point.orientation.y, point.orientation.z, point.orientation.w);
+    return true;
+}
+
+bool printSO3(const char* name, const controller_msgs::SO3TrajectoryMessage& so3_msg) {
+    // final orientation
+    if( so3_msg.taskspace_trajectory_points.empty() ) {
+        return false;
+    }
+    const controller_msgs::SO3TrajectoryPointMessage& point = so3_msg.taskspace_trajectory_points.back();
+    std::printf(" %s=[%.3f %.3f %.3f %.3f]", name,
+                point.orientation.x, point.orientation.y, point.orientation.z, point.orientation.w);
+    return true;
+}
+
+void getTrajectoryTiming(const controller_msgs::JointspaceTrajectoryMessage& js_msg,
+                         const controller_msgs::QueueableMessage*& queueing_properties, double& trajectory_time) {
+    // first controlled body part sets execution mode and trajectory time of row
+    if( queueing_properties == nullptr && !js_msg.joint_trajectory_messages.empty() ) {
+        queueing_properties = &js_msg.queueing_properties;
+        const std::vector<controller_msgs::TrajectoryPoint1DMessage>& points = js_msg.joint_trajectory_messages[0].trajectory_points;
+        trajectory_time = points.empty() ? 0.0 : points.back().time;
+    }
+    return;
+}
+
+template <class T>
+void getTaskspaceTrajectoryTiming(const T& taskspace_msg,
+                                  const controller_msgs::QueueableMessage*& queueing_properties, double& trajectory_time) {
+    if( queueing_properties == nullptr && !taskspace_msg.taskspace_trajectory_points.empty() ) {
+        queueing_properties = &taskspace_msg.queueing_properties;
+        trajectory_time = taskspace_msg.taskspace_trajectory_points.back().time;
+    }
+    return;
+}
+
+void printTableRow(const RecordedMessage& recorded_msg, controller_msgs::WholeBodyTrajectoryMessage& wholebody_msg) {
+    decodeMessage(recorded_msg, wholebody_msg);
+
+    const controller_msgs::QueueableMessage* queueing_properties = nullptr;
+    double trajectory_time = 0.0;
+    getTaskspaceTrajectoryTiming(wholebody_msg.pelvis_trajectory_message.se3_trajectory, queueing_properties, trajectory_time);
+    getTaskspaceTrajectoryTiming(wholebody_msg.chest_trajectory_message.so3_trajectory, queueing_properties, trajectory_time);
+    getTrajectoryTiming(wholebody_msg.spine_trajectory_message.jointspace_trajectory, queueing_properties, trajectory_time);
+    getTrajectoryTiming(wholebody_msg.left_arm_trajectory_message.jointspace_trajectory, queueing_properties, trajectory_time);
+    getTrajectoryTiming(wholebody_msg.right_arm_trajectory_message.jointspace_trajectory, queueing_properties, trajectory_time);
+    getTrajectoryTiming(wholebody_msg.neck_trajectory_message.jointspace_trajectory, queueing_properties, trajectory_time);
+    getTaskspaceTrajectoryTiming(wholebody_msg.head_trajectory_message.so3_trajectory, queueing_properties, trajectory_time);
+    getTaskspaceTrajectoryTiming(wholebody_msg.left_hand_trajectory_message.se3_trajectory, queueing_properties, trajectory_time);
+    getTaskspaceTrajectoryTiming(wholebody_msg.right_hand_trajectory_message.se3_trajectory, queueing_properties, trajectory_time);
+    getTaskspaceTrajectoryTiming(wholebody_msg.left_foot_trajectory_message.se3_trajectory, queueing_properties, trajectory_time);
+    getTaskspaceTrajectoryTiming(wholebody_msg.right_foot_trajectory_message.se3_trajectory, queueing_properties, trajectory_time);
+
+    printRowStart(recorded_msg, wholebody_msg.sequence_id, queueing_properties, trajectory_time);
+    bool any = false;
+    any = printSE3("pelvis", wholebody_msg.pelvis_trajectory_message.se3_trajectory) || any;
+    any = printSO3("chest", wholebody_msg.chest_trajectory_message.so3_trajectory) || any;
+    any = printJointspace("spine", wholebody_msg.spine_trajectory_message.jointspace_trajectory) || any;
+    any = printJointspace("larm", wholebody_msg.left_arm_trajectory_message.jointspace_trajectory) || any;
+    any = printJointspace("rarm", wholebody_msg.right_arm_trajectory_message.jointspace_trajectory) || any;
+    any = printJointspace("neck", wholebody_msg.neck_trajectory_message.jointspace_trajectory) || any;
+    any = printSO3("head", wholebody_msg.head_trajectory_message.so3_trajectory) || any;
+    any = printSE3("lhand", wholebody_msg.left_hand_trajectory_message.se3_trajectory) || any;
+    any = printSE3("rhand", wholebody_msg.right_hand_trajectory_message.se3_trajectory) || any;
+    any = printSE3("lfoot", wholebody_msg.left_foot_trajectory_message.se3_trajectory) || any;
+    any = printSE3("rfoot", wholebody_msg.right_foot_trajectory_message.se3_trajectory) || any;
+    std::printf(any ? "\n" : " (empty)\n");
+
+    return;
+}
+
+void printTableRow(const RecordedMessage& recorded_msg, controller_msgs::GoHomeMessage& go_home_msg) {
+    decodeMessage(recorded_msg, go_home_msg);
+
+    // body parts are 0 (arm), 1 (chest), 2 (pelvis); sides are 0 (left), 1 (right)
+    const char* part_names[3] = {"arm", "chest", "pelvis"};
+    printRowStart(recorded_msg, go_home_msg.sequence_id, nullptr, go_home_msg.trajectory_time);
+    std::printf(" part=%s", (go_home_msg.humanoid_body_part < 3) ? part_names[go_home_msg.humanoid_body_part] : "?");
+    if( go_home_msg.humanoid_body_part == 0 ) {
+        std::printf(" side=%s", (go_home_msg.robot_side == 0) ? "left" : "right");
+    }
+    std::printf("\n");
+
+    return;
+}
+
+void printTableRow(const RecordedMessage& recorded_msg, controller_msgs::ValkyrieHandFingerTrajectoryMessage& finger_msg) {
+    decodeMessage(recorded_msg, finger_msg);
+
+    const controller_msgs::QueueableMessage* queueing_properties = nullptr;
+    double trajectory_time = 0.0;
+    getTrajectoryTiming(finger_msg.jointspace_trajectory, queueing_properties, trajectory_time);
+
+    printRowStart(recorded_msg, finger_msg.sequence_id, queueing_properties, trajectory_time);
+    std::printf(" side=%s", (finger_msg.robot_side == 0) ? "left" : "right");
+    printJointspace("motors", finger_msg.jointspace_trajectory);
+    std::printf("\n");
+
+    return;
+}
+
+// DIFFS
+// collects leaf field values (and paths, only when needed) of a message
+class FieldCollector
+{
+public:
+    FieldCollector(bool stamps, std::vector<double>& values, std::vector<std::string>* paths)
+        : stamps_(stamps), values_(values), paths_(paths) {
+        values_.clear();
+        if( paths_ != nullptr ) {
+            paths_->clear();
+        }
+    }
+
+    template <class T, class F>
+    void operator()(const IHMCMsgUtils::IHMCFieldPath& path, const T& value, F field) {
+        if( !stamps_ && isStampField(field) ) {
+            return;
+        }
+        values_.push_back(static_cast<double>(value));
+        if( paths_ != nullptr ) {
+            paths_->push_back(path.toString());
+        }
+        return;
+    }
+
+private:
+    template <class F>
+    static bool isStampField(F field) {
+        return false;
+    }
+
+    static bool isStampField(IHMCMsgUtils::IHMCSequenceIdField field) {
+        return true;
+    }
+
+    static bool isStampField(IHMCMsgUtils::IHMCTimestampField field) {
+        return true;
+    }
+
+    bool stamps_;
+    std::vector<double>& values_;
+    std::vector<std::string>* paths_;
+};
+
+template <class M>
+void collectFields(const RecordedMessage& recorded_msg, bool stamps, M& msg,
+                   std::vector<double>& values, std::vector<std::string>* paths) {
+    decodeMessage(recorded_msg, msg);
+    FieldCollector collector(stamps, values, paths);
+    IHMCMsgUtils::visitFields(collector, static_cast<const M&>(msg));
+    return;
+}
+
+class MessageDiffer
+{
+public:
+    MessageDiffer(const InspectOptions& options) : options_(options), num_diffs_(0) {}
+
+    /*
+     * prints fields that differ between two recorded messages of the same type
+     * @param before, the earlier (or first bag's) message
+     * @param after, the later (or second bag's) message
+     * @return bool indicating if messages differ
+     */
+    bool diff(const RecordedMessage& before, const RecordedMessage& after) {
+        if( before.type != after.type ) {
+            std::printf("%10.3f  %-24s #%llu type %s -> %s\n", after.time, getTopicName(after.topic),
+                        static_cast<unsigned long long>(after.index),
+                        RECORDED_TYPE_NAMES[before.type], RECORDED_TYPE_NAMES[after.type]);
+            num_diffs_++;
+            return true;
+        }
+
+        // cheap pass over values only; most consecutive stream messages differ, but identical ones are skipped here
+        collect(before, values_before_, nullptr);
+        collect(after, values_after_, nullptr);
+        if( values_before_.size() == values_after_.size() ) {
+            bool same = true;
+            for( int i = 0 ; i < values_before_.size() && same ; i++ ) {
+                same = std::fabs(values_before_[i] - values_after_[i]) <= options_.tolerance;
+            }
+            if( same ) {
+                return false;
+            }
+        }
+
+        // collect again with paths, and match fields by path in case arrays changed length
+        collect(before, values_before_, &paths_before_);
+        collect(after, values_after_, &paths_after_);
+        std::unordered_map<std::string, int> after_index;
+        for( int i = 0 ; i < paths_after_.size() ; i++ ) {
+            after_index[paths_after_[i]] = i;
+        }
+
+        std::printf("%10.3f  %-24s #%llu\n", after.time, getTopicName(after.topic), static_cast<unsigned long long>(after.index));
+        int num_fields = 0;
+        std::unordered_set<std::string> before_paths;
+        for( int i = 0 ; i < paths_before_.size() ; i++ ) {
+            before_paths.insert(paths_before_[i]);
+            std::unordered_map<std::string, int>::const_iterator it = after_index.find(paths_before_[i]);
+            if( it == after_index.end() ) {
+                printField(num_fields, paths_before_[i], formatValue(values_before_[i]) + " -> (removed)");
+            }
+            else if( std::fabs(values_before_[i] - values_after_[it->second]) > options_.tolerance ) {
+                printField(num_fields, paths_before_[i], formatValue(values_before_[i]) + " -> " + formatValue(values_after_[it->second]));
+            }
+        }
+        for( int i = 0 ; i < paths_after_.size() ; i++ ) {
+            if( before_paths.count(paths_after_[i]) == 0 ) {
+                printField(num_fields, paths_after_[i], "(added) -> " + formatValue(values_after_[i]));
+            }
+        }
+        if( num_fields > options_.max_fields ) {
+            std::printf("            ... %d more fields\n", num_fields - options_.max_fields);
+        }
+        num_diffs_++;
+
+        return true;
+    }
+
+    uint64_t getNumDiffs() { return num_diffs_; }
+
+private:
+    void collect(const RecordedMessage& recorded_msg, std::vector<double>& values, std::vector<std::string>* paths) {
+        switch( recorded_msg.type ) {
+            case RECORDED_WHOLEBODY:
+                collectFields(recorded_msg, options_.stamps, wholebody_msg_, values, paths);
+                break;
+            case RECORDED_GO_HOME:
+                collectFields(recorded_msg, options_.stamps, go_home_msg_, values, paths);
+                break;
+            case RECORDED_FINGER:
+                collectFields(recorded_msg, options_.stamps, finger_msg_, values, paths);
+                break;
+        }
+        return;
+    }
+
+    void printField(int& num_fields, const std::string& path, const std::string& change) {
+        if( num_fields++ < options_.max_fields ) {
+            std::printf("            %s: %s\n", path.c_str(), change.c_str());
+        }
+        return;
+    }
+
+    static std::string formatValue(double value) {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.9g", value);
+        return std::string(buffer);
+    }
+
+    const InspectOptions& options_;
+    uint64_t num_diffs_;
+
+    // reused messages and field buffers
+    controller_msgs::WholeBodyTrajectoryMessage wholebody_msg_;
+    controller_msgs::GoHomeMessage go_home_msg_;
+    controller_msgs::ValkyrieHandFingerTrajectoryMessage finger_msg_;
+    std::vector<double> values_before_, values_after_;
+    std::vector<std::string> paths_before_, paths_after_;
+};
+
+// MODES
+uint64_t printTable(BagReader& reader, const InspectOptions& options) {
+    if( !options.quiet ) {
+        std::printf("%10s  %-24s %-6s %8s  %-8s %6s  %s\n", "time", "topic", "type", "seq", "mode", "traj", "final points");
+    }
+
+    controller_msgs::WholeBodyTrajectoryMessage wholebody_msg;
+    controller_msgs::GoHomeMessage go_home_msg;
+    controller_msgs::ValkyrieHandFingerTrajectoryMessage finger_msg;
+    RecordedMessage recorded_msg;
+    uint64_t num_rows = 0;
+    while( reader.next(recorded_msg) ) {
+        bool print = !options.quiet && (num_rows++ % options.every == 0);
+        switch( recorded_msg.type ) {
+            case RECORDED_WHOLEBODY:
+                if( print ) { printTableRow(recorded_msg, wholebody_msg); }
+                else { decodeMessage(recorded_msg, wholebody_msg); }
+                break;
+            case RECORDED_GO_HOME:
+                if( print ) { printTableRow(recorded_msg, go_home_msg); }
+                else { decodeMessage(recorded_msg, go_home_msg); }
+                break;
+            case RECORDED_FINGER:
+                if( print ) { printTableRow(recorded_msg, finger_msg); }
+                else { decodeMessage(recorded_msg, finger_msg); }
+                break;
+        }
+    }
+
+    return num_rows;
+}
+
+uint64_t diffConsecutive(BagReader& reader, const InspectOptions& options) {
+    // previous message on each topic
+    MessageDiffer differ(options);
+    std::map<std::string, RecordedMessage> previous;
+    RecordedMessage recorded_msg;
+    while( reader.next(recorded_msg) ) {
+        std::map<std::string, RecordedMessage>::iterator it = previous.find(recorded_msg.topic);
+        if( it == previous.end() ) {
+            previous[recorded_msg.topic] = recorded_msg;
+            continue;
+        }
+        differ.diff(it->second, recorded_msg);
+        std::swap(it->second, recorded_msg);
+    }
+
+    return differ.getNumDiffs();
+}
+
+uint64_t diffBags(BagReader& reader, BagReader& compare_reader, const InspectOptions& options) {
+    // messages on each topic from the bag that is ahead, waiting for the n-th message on that topic from the other bag
+    MessageDiffer differ(options);
+    std::map<std::string, std::deque<RecordedMessage> > pending[2];
+    BagReader* readers[2] = {&reader, &compare_reader};
+    RecordedMessage next_msgs[2];
+    bool has_next[2] = {reader.next(next_msgs[0]), compare_reader.next(next_msgs[1])};
+    while( has_next[0] || has_next[1] ) {
+        // take earliest message (relative to start of its bag) so both bags are read in step
+        int side = (!has_next[1] || (has_next[0] && next_msgs[0].time <= next_msgs[1].time)) ? 0 : 1;
+        RecordedMessage& msg = next_msgs[side];
+        std::deque<RecordedMessage>& other_pending = pending[1 - side][msg.topic];
+        if( other_pending.empty() ) {
+            pending[side][msg.topic].push_back(msg);
+        }
+        else {
+            if( side == 0 ) { differ.diff(msg, other_pending.front()); }
+            else { differ.diff(other_pending.front(), msg); }
+            other_pending.pop_front();
+        }
+        has_next[side] = readers[side]->next(msg);
+    }
+
+    // messages without a counterpart in the other bag
+    for( int side = 0 ; side < 2 ; side++ ) {
+        for( std::map<std::string, std::deque<RecordedMessage> >::iterator it = pending[side].begin() ; it != pending[side].end() ; ++it ) {
+            if( !it->second.empty() ) {
+                std::printf("%s: %zu extra messages in %s bag\n", it->first.c_str(), it->second.size(), (side == 0) ? "first" : "second");
+            }
+        }
+    }
+
+    return differ.getNumDiffs();
+}
+
+int main(int argc, char **argv) {
+    InspectOptions options;
+
+    // parse arguments
+    for( int i = 1 ; i + 1 < argc ; i += 2 ) {
+        std::string arg(argv[i]);
+        if( arg == "--bag" ) { options.bag_file = argv[i+1]; }
+        else if( arg == "--compare" ) { options.compare_file = argv[i+1]; }
+        else if( arg == "--diff" ) { options.diff = (std::stoi(argv[i+1]) != 0); }
+        else if( arg == "--topic" ) { options.topic = argv[i+1]; }
+        else if( arg == "--start" ) { options.start = std::max(0.0, std::stod(argv[i+1])); }
+        else if( arg == "--end" ) { options.end = std::stod(argv[i+1]); }
+        else if( arg == "--every" ) { options.every = std::max(1, std::stoi(argv[i+1])); }
+        else if( arg == "--stamps" ) { options.stamps = (std::stoi(argv[i+1]) != 0); }
+        else if( arg == "--tolerance" ) { options.tolerance = std::max(0.0, std::stod(argv[i+1])); }
+        else if( arg == "--max-fields" ) { options.max_fields = std::max(0, std::stoi(argv[i+1])); }
+        else if( arg == "--quiet" ) { options.quiet = (std::stoi(argv[i+1]) != 0); }
+        else { std::fprintf(stderr, "[Bag Inspect] Unrecognized argument %s\n", arg.c_str()); return 1; }
+    }
+    if( options.bag_file.empty() ) {
+        std::fprintf(stderr, "[Bag Inspect] No bag given, use --bag FILE\n");
+        return 1;
+    }
+
+    // rows are small and many; a large output buffer keeps printing from dominating
+    std::setvbuf(stdout, nullptr, _IOFBF, 1 << 20);
+
+    std::chrono::steady_clock::time_point t_start = std::chrono::steady_clock::now();
+    uint64_t num_messages = 0, num_bytes = 0, num_results = 0;
+    try {
+        BagReader reader(options.bag_file, options);
+        if( !options.compare_file.empty() ) {
+            BagReader compare_reader(options.compare_file, options);
+            num_results = diffBags(reader, compare_reader, options);
+            num_messages = compare_reader.getNumMessages();
+            num_bytes = compare_reader.getNumBytes();
+        }
+        else if( options.diff ) {
+            num_results = diffConsecutive(reader, options);
+        }
+        else {
+            printTable(reader, options);
+        }
+        num_messages += reader.getNumMessages();
+        num_bytes += reader.getNumBytes();
+    }
+    catch( const std::exception& e ) {
+        std::fflush(stdout);
+        std::fprintf(stderr, "[Bag Inspect] Could not read bag: %s\n", e.what());
+        return 1;
+    }
+    std::fflush(stdout);
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t_start).count();
+
+    // summary goes to stderr, so table and diffs can be piped
+    std::fprintf(stderr, "[Bag Inspect] %llu messages, %.1f MB in %.2f s (%.1f MB/s)",
+                 static_cast<unsigned long long>(num_messages), num_bytes / 1e6, elapsed, (elapsed > 0.0) ? num_bytes / 1e6 / elapsed : 0.0);
+    if( options.diff || !options.compare_file.empty() ) {
+        std::fprintf(stderr, ", %llu differing messages", static_cast<unsigned long long>(num_results));
+    }
+    std::fprintf(stderr, "\n");
+
+    return 0;
+}
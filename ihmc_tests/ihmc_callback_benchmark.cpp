@@ -0,0 +1,462 @@
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+#include <functional>
+#include <chrono>
+#include <random>
+#include <cmath>
+
+#include <ros/serialization.h>
+#include <ihmc_utils/ihmc_command_streamer.h>
+#include <ihmc_utils/ihmc_partial_msgs.h>
+#include <ihmc_utils/ihmc_tracking_monitor.h>
+#include <ihmc_tests/ihmc_msg_test_utilities.h>
+
+/*
+ * Per-callback microbenchmark for the IHMC Interface Node.
+ * Every node callback hands its message to IHMCCommandStreamer, so each callback is driven directly on a streamer
+ * without ROS transport.  Joint commands are measured with controller-sized messages (actuated joints in configuration
+ * order), IHMC-sized messages (extra finger, wrist, and sensor joints, with velocities and efforts, in IHMC's own order),
+ * and messages whose joint order changes from message to message; statuses are delivered in bursts, as from a script.
+ * Each callback is timed on already decoded messages ("callback"), and joint commands and pelvis transforms are also
+ * timed including deserialization from the wire, into full messages ("full") and partial messages ("partial", as the
+ * node does with partial_deserialization).  Reports the median and minimum ns per message over several repeats.
+ *
+ * usage: ihmc_callback_benchmark [--iterations N] [--repeats N] [--csv FILE]
+ */
+
+// JOINTS IN JOINT STATES FROM IHMC THAT ARE NOT ACTUATED JOINTS IN VALKYRIE DEFINITION
+const std::vector<std::string> EXTRA_JOINT_NAMES{
+    "leftWristRoll", "leftWristPitch", "rightWristRoll", "rightWristPitch", "hokuyo_joint",
+    "leftIndexFingerPitch1", "leftIndexFingerPitch2", "leftIndexFingerPitch3",
+    "leftMiddleFingerPitch1", "leftMiddleFingerPitch2", "leftMiddleFingerPitch3",
+    "leftPinkyPitch1", "leftPinkyPitch2", "leftPinkyPitch3",
+    "leftThumbRoll", "leftThumbPitch1", "leftThumbPitch2", "leftThumbPitch3",
+    "rightIndexFingerPitch1", "rightIndexFingerPitch2", "rightIndexFingerPitch3",
+    "rightMiddleFingerPitch1", "rightMiddleFingerPitch2", "rightMiddleFingerPitch3",
+    "rightPinkyPitch1", "rightPinkyPitch2", "rightPinkyPitch3",
+    "rightThumbRoll", "rightThumbPitch1", "rightThumbPitch2", "rightThumbPitch3"};
+
+// STATUSES SENT IN BURSTS; size of a burst is the status queue size of the node
+const std::vector<std::string> BURST_STATUSES{
+    "START-LISTENING", "HOME-LEFTARM", "HOME-RIGHTARM", "HOME-CHEST", "HOME-PELVIS",
+    "OPEN-LEFT-HAND", "CLOSE-LEFT-HAND", "OPEN-RIGHT-HAND", "CLOSE-RIGHT-HAND", "STOP-LISTENING"};
+const int BURST_SIZE = 20;
+
+// DISTINCT MESSAGES PER TRAFFIC TYPE, AND DISTINCT JOINT ORDERS FOR SHUFFLED TRAFFIC
+const int NUM_MESSAGES = 64;
+const int NUM_JOINT_ORDERS = 16;
+
+// STRUCT FOR ONE BENCHMARK CASE
+struct CallbackResult {
+    std::string callback;
+    std::string traffic;
+    std::string path;
+    uint32_t num_bytes;
+    double median_ns;
+    double min_ns;
+};
+
+// STRUCT FOR TIMING SETTINGS
+struct TimingSettings {
+    int num_iterations; // messages per repeat
+    int num_repeats;
+};
+
+// TIMING
+/*
+ * times a function handling message i % NUM_MESSAGES, after one untimed pass over all messages
+ * @return median ns per message over repeats; min_ns is set to the fastest repeat
+ */
+double timeMessages(const std::function<void(int)>& handle, const TimingSettings& settings, double& min_ns) {
+    for( int i = 0 ; i < NUM_MESSAGES ; i++ ) {
+        handle(i);
+    }
+
+    std::vector<double> ns_per_msg;
+    for( int r = 0 ; r < settings.num_repeats ; r++ ) {
+        auto t0 = std::chrono::steady_clock::now();
+        for( int i = 0 ; i < settings.num_iterations ; i++ ) {
+            handle(i % NUM_MESSAGES);
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        ns_per_msg.push_back(std::chrono::duration<double, std::nano>(t1 - t0).count() / settings.num_iterations);
+    }
+    std::sort(ns_per_msg.begin(), ns_per_msg.end());
+    min_ns = ns_per_msg.front();
+
+    return ns_per_msg[ns_per_msg.size() / 2];
+}
+
+template <class M>
+void serializeMessages(const std::vector<M>& msgs, std::vector<std::vector<uint8_t> >& buffers) {
+    buffers.resize(msgs.size());
+    for( int i = 0 ; i < msgs.size() ; i++ ) {
+        IHMCMsgTestUtils::serializeToBuffer(msgs[i], buffers[i]);
+    }
+    return;
+}
+
+// times a callback on already decoded messages
+template <class M>
+void benchmarkCallback(const std::string& callback, const std::string& traffic, const std::vector<M>& msgs,
+                       const std::function<void(const M&)>& process, const TimingSettings& settings,
+                       std::vector<CallbackResult>& results) {
+    CallbackResult result;
+    result.callback = callback;
+    result.traffic = traffic;
+    result.path = "callback";
+    result.num_bytes = ros::serialization::serializationLength(msgs[0]);
+    result.median_ns = timeMessages([&](int i) { process(msgs[i]); }, settings, result.min_ns);
+    results.push_back(result);
+    return;
+}
+
+// times a callback on messages deserialized from the wire into type D, a new message for each as roscpp does
+template <class D>
+void benchmarkDeserializedCallback(const std::string& callback, const std::string& traffic, const std::string& path,
+                                   std::vector<std::vector<uint8_t> >& buffers, const std::function<void(const D&)>& process,
+                                   const TimingSettings& settings, std::vector<CallbackResult>& results) {
+    CallbackResult result;
+    result.callback = callback;
+    result.traffic = traffic;
+    result.path = path;
+    result.num_bytes = buffers[0].size();
+    result.median_ns = timeMessages([&](int i) {
+        D msg;
+        ros::serialization::IStream stream(buffers[i].data(), buffers[i].size());
+        ros::serialization::deserialize(stream, msg);
+        process(msg);
+    }, settings, result.min_ns);
+    results.push_back(result);
+    return;
+}
+
+// STREAMER
+void prepareStreamer(IHMCMsgUtils::IHMCCommandStreamer& streamer) {
+    // streaming from controllers with all links controlled; sinks drop messages
+    streamer.setVerbose(false);
+    streamer.setWholeBodyMessageSink([](const controller_msgs::WholeBodyTrajectoryMessage& msg) {});
+    streamer.setGoHomeMessageSink([](const controller_msgs::GoHomeMessage& msg) {});
+    streamer.setHandFingerMessageSink([](const controller_msgs::ValkyrieHandFingerTrajectoryMessage& msg) {});
+    streamer.setStopAllTrajectoryMessageSink([](const controller_msgs::StopAllTrajectoryMessage& msg) {});
+    streamer.setStatus("START-LISTENING");
+    streamer.setControlledLinks({valkyrie_link::pelvis, valkyrie_link::torso,
+                                 valkyrie_link::rightCOP_Frame, valkyrie_link::leftCOP_Frame,
+                                 valkyrie_link::rightPalm, valkyrie_link::leftPalm, valkyrie_link::head});
+    return;
+}
+
+// TRAFFIC
+void makeJointCommands(const std::string& traffic, std::vector<sensor_msgs::JointState>& msgs) {
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<double> position_distribution(-1.0, 1.0);
+
+    // controller traffic has actuated joints only; IHMC traffic adds extra joints in IHMC's own (fixed) order
+    std::vector<std::string> names;
+    IHMCMsgTestUtils::getActuatedJointNames(names);
+    bool ihmc_sized = (traffic != std::string("controller"));
+    if( ihmc_sized ) {
+        names.insert(names.end(), EXTRA_JOINT_NAMES.begin(), EXTRA_JOINT_NAMES.end());
+        std::shuffle(names.begin(), names.end(), generator);
+    }
+
+    // shuffled traffic cycles through several joint orders
+    std::vector<std::vector<std::string> > orders(1, names);
+    if( traffic == std::string("shuffled") ) {
+        for( int k = 1 ; k < NUM_JOINT_ORDERS ; k++ ) {
+            std::shuffle(names.begin(), names.end(), generator);
+            orders.push_back(names);
+        }
+    }
+
+    msgs.resize(NUM_MESSAGES);
+    for( int i = 0 ; i < NUM_MESSAGES ; i++ ) {
+        sensor_msgs::JointState& js_msg = msgs[i];
+        js_msg.header.seq = i;
+        js_msg.header.frame_id = "pelvis";
+        js_msg.name = orders[i % orders.size()];
+        for( int j = 0 ; j < js_msg.name.size() ; j++ ) {
+            js_msg.position.push_back(position_distribution(generator));
+        }
+        if( ihmc_sized ) {
+            // IHMC fills velocities and efforts
+            js_msg.velocity.assign(js_msg.name.size(), 0.1);
+            js_msg.effort.assign(js_msg.name.size(), 1.0);
+        }
+    }
+
+    return;
+}
+
+void makePelvisTransforms(std::vector<geometry_msgs::TransformStamped>& msgs) {
+    msgs.resize(NUM_MESSAGES);
+    for( int i = 0 ; i < NUM_MESSAGES ; i++ ) {
+        msgs[i].header.seq = i;
+        msgs[i].header.frame_id = "world";
+        msgs[i].child_frame_id = "pelvis";
+        msgs[i].transform.translation.x = 0.01 * i;
+        msgs[i].transform.translation.z = 1.0;
+        msgs[i].transform.rotation.z = std::sin(0.005 * i);
+        msgs[i].transform.rotation.w = std::cos(0.005 * i);
+    }
+    return;
+}
+
+// BENCHMARKS
+void benchmarkJointCommands(const TimingSettings& settings, std::vector<CallbackResult>& results) {
+    const std::vector<std::string> traffics{"controller", "ihmc", "shuffled"};
+    for( int t = 0 ; t < traffics.size() ; t++ ) {
+        std::vector<sensor_msgs::JointState> msgs;
+        makeJointCommands(traffics[t], msgs);
+        std::vector<std::vector<uint8_t> > buffers;
+        serializeMessages(msgs, buffers);
+
+        IHMCMsgUtils::IHMCCommandStreamer streamer(true);
+        prepareStreamer(streamer);
+        std::function<void(const sensor_msgs::JointState&)> process =
+            [&](const sensor_msgs::JointState& msg) { streamer.processJointCommand(msg); };
+        std::function<void(const IHMCMsgUtils::IHMCPartialJointState&)> process_partial =
+            [&](const IHMCMsgUtils::IHMCPartialJointState& msg) { streamer.processPartialJointCommand(msg); };
+        benchmarkCallback("jointCommand", traffics[t], msgs, process, settings, results);
+        benchmarkDeserializedCallback("jointCommand", traffics[t], "full", buffers, process, settings, results);
+        benchmarkDeserializedCallback("jointCommand", traffics[t], "partial", buffers, process_partial, settings, results);
+    }
+
+    return;
+}
+
+void benchmarkPelvisTransforms(const TimingSettings& settings, std::vector<CallbackResult>& results) {
+    std::vector<geometry_msgs::TransformStamped> msgs;
+    makePelvisTransforms(msgs);
+    std::vector<std::vector<uint8_t> > buffers;
+    serializeMessages(msgs, buffers);
+
+    IHMCMsgUtils::IHMCCommandStreamer streamer(true);
+    prepareStreamer(streamer);
+    std::function<void(const geometry_msgs::TransformStamped&)> process =
+        [&](const geometry_msgs::TransformStamped& msg) { streamer.processPelvisTransform(msg); };
+    std::function<void(const IHMCMsgUtils::IHMCPartialTransformStamped&)> process_partial =
+        [&](const IHMCMsgUtils::IHMCPartialTransformStamped& msg) { streamer.processPartialPelvisTransform(msg); };
+    benchmarkCallback("transform", "controller", msgs, process, settings, results);
+    benchmarkDeserializedCallback("transform", "controller", "full", buffers, process, settings, results);
+    benchmarkDeserializedCallback("transform", "controller", "partial", buffers, process_partial, settings, results);
+
+    return;
+}
+
+void benchmarkStatusBursts(const TimingSettings& settings, std::vector<CallbackResult>& results) {
+    // a burst of statuses is handled back to back, then the streamer update consumes the flags they set (not timed)
+    std::vector<std_msgs::String> msgs(BURST_SIZE);
+    for( int i = 0 ; i < BURST_SIZE ; i++ ) {
+        msgs[i].data = BURST_STATUSES[i % BURST_STATUSES.size()];
+    }
+
+    IHMCMsgUtils::IHMCCommandStreamer streamer(true);
+    prepareStreamer(streamer);
+    std::vector<double> ns_per_msg;
+    for( int r = 0 ; r < settings.num_repeats + 1 ; r++ ) {
+        double total_ns = 0.0;
+        int num_bursts = std::max(1, settings.num_iterations / BURST_SIZE);
+        for( int b = 0 ; b < num_bursts ; b++ ) {
+            auto t0 = std::chrono::steady_clock::now();
+            for( int i = 0 ; i < BURST_SIZE ; i++ ) {
+                streamer.processStatus(msgs[i]);
+            }
+            auto t1 = std::chrono::steady_clock::now();
+            total_ns += std::chrono::duration<double, std::nano>(t1 - t0).count();
+            streamer.update();
+        }
+        // first repeat warms up
+        if( r > 0 ) {
+            ns_per_msg.push_back(total_ns / (num_bursts * BURST_SIZE));
+        }
+    }
+    std::sort(ns_per_msg.begin(), ns_per_msg.end());
+
+    CallbackResult result;
+    result.callback = "status";
+    result.traffic = "burst";
+    result.path = "callback";
+    result.num_bytes = ros::serialization::serializationLength(msgs[0]);
+    result.median_ns = ns_per_msg[ns_per_msg.size() / 2];
+    result.min_ns = ns_per_msg.front();
+    results.push_back(result);
+
+    return;
+}
+
+void benchmarkOtherCallbacks(const TimingSettings& settings, std::vector<CallbackResult>& results) {
+    // controlled link ids, a different subset of links in each message
+    {
+        const std::vector<int> links{valkyrie_link::pelvis, valkyrie_link::torso, valkyrie_link::rightPalm,
+                                     valkyrie_link::leftPalm, valkyrie_link::head};
+        std::vector<std_msgs::Int32MultiArray> msgs(NUM_MESSAGES);
+        for( int i = 0 ; i < NUM_MESSAGES ; i++ ) {
+            for( int j = 0 ; j < links.size() ; j++ ) {
+                if( (i + 1) & (1 << j) ) {
+                    msgs[i].data.push_back(links[j]);
+                }
+            }
+        }
+        IHMCMsgUtils::IHMCCommandStreamer streamer(true);
+        prepareStreamer(streamer);
+        benchmarkCallback<std_msgs::Int32MultiArray>("controlledLinkIds", "controller", msgs,
+            [&](const std_msgs::Int32MultiArray& msg) { streamer.processControlledLinkIds(msg); }, settings, results);
+    }
+
+    // Cartesian goal flag, alternating on and off
+    {
+        std::vector<std_msgs::Bool> msgs(NUM_MESSAGES);
+        for( int i = 0 ; i < NUM_MESSAGES ; i++ ) {
+            msgs[i].data = (i % 2 == 0);
+        }
+        IHMCMsgUtils::IHMCCommandStreamer streamer(true);
+        prepareStreamer(streamer);
+        benchmarkCallback<std_msgs::Bool>("receiveCartesianGoals", "controller", msgs,
+            [&](const std_msgs::Bool& msg) { streamer.processReceiveCartesianGoals(msg); }, settings, results);
+    }
+
+    // hand poses, alternating hands, and bimanual goal pairs; streamer accepts Cartesian goals
+    {
+        std::vector<geometry_msgs::TransformStamped> hand_msgs;
+        makePelvisTransforms(hand_msgs);
+        std::vector<IHMCMsgInterface::BimanualHandGoal> goal_msgs(NUM_MESSAGES);
+        for( int i = 0 ; i < NUM_MESSAGES ; i++ ) {
+            hand_msgs[i].child_frame_id = (i % 2 == 0) ? "leftPalm" : "rightPalm";
+            goal_msgs[i].header.frame_id = "world";
+            goal_msgs[i].cycle_id = i;
+            goal_msgs[i].left_hand_goal_valid = true;
+            goal_msgs[i].left_hand_pose.orientation.w = 1.0;
+            goal_msgs[i].right_hand_goal_valid = true;
+            goal_msgs[i].right_hand_pose.orientation.w = 1.0;
+        }
+        IHMCMsgUtils::IHMCCommandStreamer streamer(true);
+        prepareStreamer(streamer);
+        std_msgs::Bool cartesian_msg;
+        cartesian_msg.data = true;
+        streamer.processReceiveCartesianGoals(cartesian_msg);
+        benchmarkCallback<geometry_msgs::TransformStamped>("handPoseCommand", "controller", hand_msgs,
+            [&](const geometry_msgs::TransformStamped& msg) { streamer.processHandPoseCommand(msg); }, settings, results);
+        benchmarkCallback<IHMCMsgInterface::BimanualHandGoal>("bimanualHandPoseCommand", "controller", goal_msgs,
+            [&](const IHMCMsgInterface::BimanualHandGoal& msg) { streamer.processBimanualHandPoseCommand(msg); }, settings, results);
+    }
+
+    // robot configuration data, compared against a published command by the tracking monitor
+    {
+        std::vector<controller_msgs::RobotConfigurationData> msgs(NUM_MESSAGES);
+        for( int i = 0 ; i < NUM_MESSAGES ; i++ ) {
+            dynacore::Vector q = dynacore::Vector::Constant(valkyrie::num_q, 0.001 * i);
+            q[valkyrie_joint::virtual_Rx] = 0.0;
+            q[valkyrie_joint::virtual_Ry] = 0.0;
+            q[valkyrie_joint::virtual_Rz] = 0.0;
+            q[valkyrie_joint::virtual_Rw] = 1.0;
+            IHMCMsgUtils::makeRobotConfigurationData(q, msgs[i]);
+        }
+        IHMCMsgUtils::IHMCCommandStreamer streamer(true);
+        prepareStreamer(streamer);
+        streamer.setTrackingMonitorEnabled(true);
+        dynacore::Vector q_cmd = dynacore::Vector::Zero(valkyrie::num_q);
+        q_cmd[valkyrie_joint::virtual_Rw] = 1.0;
+        streamer.setCommandedConfiguration(q_cmd);
+        streamer.update();
+        benchmarkCallback<controller_msgs::RobotConfigurationData>("robotConfigurationData", "ihmc", msgs,
+            [&](const controller_msgs::RobotConfigurationData& msg) { streamer.processRobotConfigurationData(msg); }, settings, results);
+    }
+
+    // finger positions for all motors of alternating hands, as streamed from a data glove
+    {
+        std::vector<IHMCMsgInterface::FingerPositionCommand> msgs(NUM_MESSAGES);
+        for( int i = 0 ; i < NUM_MESSAGES ; i++ ) {
+            msgs[i].robot_side = i % 2;
+            for( uint8_t motor = 0 ; motor < 6 ; motor++ ) {
+                msgs[i].valkyrie_finger_motor_names.push_back(motor);
+                msgs[i].motor_positions.push_back((i % 10) / 10.0);
+            }
+        }
+        IHMCMsgUtils::IHMCCommandStreamer streamer(true);
+        prepareStreamer(streamer);
+        benchmarkCallback<IHMCMsgInterface::FingerPositionCommand>("fingerPositionCommand", "controller", msgs,
+            [&](const IHMCMsgInterface::FingerPositionCommand& msg) { streamer.processFingerPositionCommand(msg); }, settings, results);
+    }
+
+    return;
+}
+
+const CallbackResult* findResult(const std::vector<CallbackResult>& results, const std::string& callback,
+                                 const std::string& traffic, const std::string& path) {
+    for( int i = 0 ; i < results.size() ; i++ ) {
+        if( (results[i].callback == callback) && (results[i].traffic == traffic) && (results[i].path == path) ) {
+            return &results[i];
+        }
+    }
+    return NULL;
+}
+
+int main(int argc, char **argv) {
+    // default benchmark settings
+    TimingSettings settings;
+    settings.num_iterations = 100000;
+    settings.num_repeats = 5;
+    std::string csv_filename;
+
+    // parse arguments
+    for( int i = 1 ; i + 1 < argc ; i += 2 ) {
+        std::string arg(argv[i]);
+        if( arg == "--iterations" ) { settings.num_iterations = std::max(1, std::stoi(argv[i+1])); }
+        else if( arg == "--repeats" ) { settings.num_repeats = std::max(1, std::stoi(argv[i+1])); }
+        else if( arg == "--csv" ) { csv_filename = std::string(argv[i+1]); }
+        else { std::cout << "[Callback Benchmark] Unrecognized argument " << arg << std::endl; return 1; }
+    }
+
+    std::cout << "[Callback Benchmark] Timing IHMC Interface Node callbacks, " << settings.num_iterations
+              << " messages per repeat, " << settings.num_repeats << " repeats" << std::endl;
+
+    std::vector<CallbackResult> results;
+    benchmarkJointCommands(settings, results);
+    benchmarkPelvisTransforms(settings, results);
+    benchmarkStatusBursts(settings, results);
+    benchmarkOtherCallbacks(settings, results);
+
+    // report each case
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << std::left << std::setw(26) << "callback" << std::setw(12) << "traffic" << std::setw(10) << "path"
+              << std::right << std::setw(8) << "bytes" << std::setw(12) << "ns/msg" << std::setw(12) << "min ns/msg" << std::endl;
+    for( int i = 0 ; i < results.size() ; i++ ) {
+        const CallbackResult& result = results[i];
+        std::cout << std::left << std::setw(26) << result.callback << std::setw(12) << result.traffic << std::setw(10) << result.path
+                  << std::right << std::setw(8) << result.num_bytes << std::setw(12) << result.median_ns
+                  << std::setw(12) << result.min_ns << std::endl;
+    }
+
+    // compare partial and full deserialization for each joint command traffic
+    const std::vector<std::string> traffics{"controller", "ihmc", "shuffled"};
+    for( int t = 0 ; t < traffics.size() ; t++ ) {
+        const CallbackResult* full = findResult(results, "jointCommand", traffics[t], "full");
+        const CallbackResult* partial = findResult(results, "jointCommand", traffics[t], "partial");
+        if( full && partial ) {
+            std::cout << "[Callback Benchmark] Joint commands (" << traffics[t] << "): " << full->median_ns << " ns full, "
+                      << partial->median_ns << " ns partial (" << std::setprecision(2) << full->median_ns / partial->median_ns
+                      << "x)" << std::setprecision(1) << std::endl;
+        }
+    }
+
+    // write every case for tracking over time
+    if( !csv_filename.empty() ) {
+        std::ofstream csv(csv_filename.c_str());
+        if( !csv.is_open() ) {
+            std::cout << "[Callback Benchmark] Could not open " << csv_filename << std::endl;
+            return 1;
+        }
+        csv << "callback,traffic,path,bytes,ns_per_msg,min_ns_per_msg" << std::endl;
+        for( int i = 0 ; i < results.size() ; i++ ) {
+            const CallbackResult& result = results[i];
+            csv << result.callback << "," << result.traffic << "," << result.path << "," << result.num_bytes << ","
+                << result.median_ns << "," << result.min_ns << std::endl;
+        }
+        std::cout << "[Callback Benchmark] Wrote " << results.size() << " cases to " << csv_filename << std::endl;
+    }
+
+    return 0;
+}
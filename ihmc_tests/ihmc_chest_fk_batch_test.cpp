@@ -0,0 +1,174 @@
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+
+#include <ihmc_utils/ihmc_msg_utilities.h>
+#include <ihmc_utils/ihmc_chest_fk_batch.h>
+
+/*
+ * Check and benchmark for batched chest orientation forward kinematics.
+ * Generates random configurations (random pelvis orientations and torso joint angles over a full turn, to exercise
+ * range reduction), checks the AVX2 kernel against the scalar kernel, checks both kernels against Valkyrie_Model
+ * (through getChestOrientation), and reports configurations per second for the model, scalar, and AVX2 kernels.
+ *
+ * usage: ihmc_chest_fk_batch_test [--configs N] [--model-checks N] [--iterations N]
+ *   --configs N, number of configurations in the batch (default 100000)
+ *   --model-checks N, number of configurations checked against Valkyrie_Model (default 2000)
+ *   --iterations N, number of times each kernel is run over the batch for timing (default 20)
+ */
+
+// TOLERANCES
+// kernels use different sine/cosine implementations, so agree to a few ulps
+const double KERNEL_TOLERANCE = 1e-12;
+// difference between kernel and model quaternions; model goes through rotation matrices
+const double MODEL_TOLERANCE = 1e-9;
+
+void makeRandomConfigurations(int num_configs, std::vector<dynacore::Vector>& q_batch) {
+    std::mt19937 generator(0);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    std::uniform_real_distribution<double> angle(-M_PI, M_PI);
+
+    q_batch.resize(num_configs);
+    for( int i = 0 ; i < num_configs ; i++ ) {
+        dynacore::Vector& q = q_batch[i];
+        q.resize(valkyrie::num_q);
+        q.setZero();
+        q[valkyrie_joint::virtual_Z] = 1.0;
+
+        // uniformly random unit pelvis quaternion
+        dynacore::Quaternion pelvis_quat(normal(generator), normal(generator), normal(generator), normal(generator));
+        pelvis_quat.normalize();
+        q[valkyrie_joint::virtual_Rx] = pelvis_quat.x();
+        q[valkyrie_joint::virtual_Ry] = pelvis_quat.y();
+        q[valkyrie_joint::virtual_Rz] = pelvis_quat.z();
+        q[valkyrie_joint::virtual_Rw] = pelvis_quat.w();
+
+        // torso joints over a full turn, other joints within a small range
+        q[valkyrie_joint::torsoYaw] = angle(generator);
+        q[valkyrie_joint::torsoPitch] = angle(generator);
+        q[valkyrie_joint::torsoRoll] = angle(generator);
+        for( int j = valkyrie::num_virtual ; j < valkyrie::num_virtual + valkyrie::num_act_joint ; j++ ) {
+            if( j != valkyrie_joint::torsoYaw && j != valkyrie_joint::torsoPitch && j != valkyrie_joint::torsoRoll ) {
+                q[j] = 0.3 * angle(generator) / M_PI;
+            }
+        }
+    }
+
+    return;
+}
+
+double getQuaternionDifference(const dynacore::Quaternion& quat1, const dynacore::Quaternion& quat2) {
+    // q and -q are the same orientation
+    double diff = (quat1.coeffs() - quat2.coeffs()).cwiseAbs().maxCoeff();
+    double diff_neg = (quat1.coeffs() + quat2.coeffs()).cwiseAbs().maxCoeff();
+    return std::min(diff, diff_neg);
+}
+
+double getMaxOutputDifference(const IHMCMsgUtils::IHMCChestFKBatch& batch1, const IHMCMsgUtils::IHMCChestFKBatch& batch2) {
+    double max_diff = 0.0;
+    for( int i = 0 ; i < batch1.size() ; i++ ) {
+        max_diff = std::max(max_diff, std::fabs(batch1.chest_qx[i] - batch2.chest_qx[i]));
+        max_diff = std::max(max_diff, std::fabs(batch1.chest_qy[i] - batch2.chest_qy[i]));
+        max_diff = std::max(max_diff, std::fabs(batch1.chest_qz[i] - batch2.chest_qz[i]));
+        max_diff = std::max(max_diff, std::fabs(batch1.chest_qw[i] - batch2.chest_qw[i]));
+    }
+
+    return max_diff;
+}
+
+double timeKernel(void (*kernel)(IHMCMsgUtils::IHMCChestFKBatch&), IHMCMsgUtils::IHMCChestFKBatch& batch, int num_iterations) {
+    auto t0 = std::chrono::steady_clock::now();
+    for( int i = 0 ; i < num_iterations ; i++ ) {
+        kernel(batch);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+
+    // configurations per second
+    return (static_cast<double>(batch.size()) * num_iterations) / std::chrono::duration<double>(t1 - t0).count();
+}
+
+int main(int argc, char **argv) {
+    // default test settings
+    int num_configs = 100000;
+    int num_model_checks = 2000;
+    int num_iterations = 20;
+
+    // parse arguments
+    for( int i = 1 ; i + 1 < argc ; i += 2 ) {
+        std::string arg(argv[i]);
+        if( arg == "--configs" ) { num_configs = std::max(1, std::stoi(argv[i+1])); }
+        else if( arg == "--model-checks" ) { num_model_checks = std::max(0, std::stoi(argv[i+1])); }
+        else if( arg == "--iterations" ) { num_iterations = std::max(1, std::stoi(argv[i+1])); }
+        else { std::cout << "[Chest FK Batch Test] Unrecognized argument " << arg << std::endl; return 1; }
+    }
+    num_model_checks = std::min(num_model_checks, num_configs);
+
+    // make batch of random configurations
+    std::vector<dynacore::Vector> q_batch;
+    makeRandomConfigurations(num_configs, q_batch);
+    IHMCMsgUtils::IHMCChestFKBatch scalar_batch;
+    scalar_batch.resize(num_configs);
+    for( int i = 0 ; i < num_configs ; i++ ) {
+        scalar_batch.setConfiguration(i, q_batch[i]);
+    }
+    IHMCMsgUtils::IHMCChestFKBatch avx2_batch = scalar_batch;
+
+    bool avx2_available = IHMCMsgUtils::isChestFKBatchAVX2Available();
+    std::cout << "[Chest FK Batch Test] " << num_configs << " configurations, AVX2 kernel "
+              << (avx2_available ? "available" : "not available (scalar fallback)") << std::endl;
+
+    // check AVX2 kernel against scalar kernel
+    bool passed = true;
+    IHMCMsgUtils::computeChestOrientationsBatchScalar(scalar_batch);
+    IHMCMsgUtils::computeChestOrientationsBatchAVX2(avx2_batch);
+    double kernel_diff = getMaxOutputDifference(scalar_batch, avx2_batch);
+    std::cout << "[Chest FK Batch Test] AVX2 vs scalar: max difference " << kernel_diff << std::endl;
+    if( kernel_diff > KERNEL_TOLERANCE ) {
+        std::cout << "[Chest FK Batch Test] FAILED: AVX2 kernel differs from scalar kernel" << std::endl;
+        passed = false;
+    }
+
+    // check kernels against Valkyrie_Model
+    double max_model_diff = 0.0;
+    auto t0 = std::chrono::steady_clock::now();
+    for( int i = 0 ; i < num_model_checks ; i++ ) {
+        dynacore::Quaternion model_quat;
+        IHMCMsgUtils::getChestOrientation(q_batch[i], model_quat);
+        dynacore::Quaternion scalar_quat;
+        dynacore::Quaternion avx2_quat;
+        scalar_batch.getChestOrientation(i, scalar_quat);
+        avx2_batch.getChestOrientation(i, avx2_quat);
+        max_model_diff = std::max(max_model_diff, getQuaternionDifference(model_quat, scalar_quat));
+        max_model_diff = std::max(max_model_diff, getQuaternionDifference(model_quat, avx2_quat));
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    if( num_model_checks > 0 ) {
+        std::cout << "[Chest FK Batch Test] Kernels vs Valkyrie_Model (" << num_model_checks << " configurations): "
+                  << "max difference " << max_model_diff << std::endl;
+        if( max_model_diff > MODEL_TOLERANCE ) {
+            std::cout << "[Chest FK Batch Test] FAILED: kernels differ from Valkyrie_Model" << std::endl;
+            passed = false;
+        }
+    }
+
+    // benchmark
+    std::cout << std::fixed << std::setprecision(0);
+    if( num_model_checks > 0 ) {
+        std::cout << "[Chest FK Batch Test] Valkyrie_Model: "
+                  << num_model_checks / std::chrono::duration<double>(t1 - t0).count() << " configurations/s" << std::endl;
+    }
+    double scalar_rate = timeKernel(IHMCMsgUtils::computeChestOrientationsBatchScalar, scalar_batch, num_iterations);
+    std::cout << "[Chest FK Batch Test] Scalar kernel: " << scalar_rate << " configurations/s" << std::endl;
+    if( avx2_available ) {
+        double avx2_rate = timeKernel(IHMCMsgUtils::computeChestOrientationsBatchAVX2, avx2_batch, num_iterations);
+        std::cout << "[Chest FK Batch Test] AVX2 kernel: " << avx2_rate << " configurations/s ("
+                  << std::setprecision(2) << avx2_rate / scalar_rate << "x scalar)" << std::endl;
+    }
+
+    std::cout << "[Chest FK Batch Test] " << (passed ? "PASSED" : "FAILED") << std::endl;
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,153 @@
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <cmath>
+
+#include <Valkyrie/Valkyrie_Definition.h>
+#include <ihmc_utils/ihmc_command_filter.h>
+
+/*
+ * Test for command smoothing filters.
+ * For each filter type, feeds all joints a noisy sinusoid at the controller rate and checks that filtering reduces
+ * jerkiness (RMS of second differences), that the error against the noise-free motion (noise left plus lag) stays
+ * within the filter's bound, and that a constant input is reached.  The pelvis orientation filter gets a noisy rotation
+ * whose quaternion sign flips every sample, and must stay a unit quaternion within its error bound without sign flips.
+ * Error bounds are for the default rate and noise.
+ *
+ * usage: ihmc_command_filter_test [--rate HZ] [--noise STDDEV]
+ */
+
+// MOTION
+const double DURATION = 10.0;
+const double AMPLITUDE = 0.5;
+const double FREQUENCY = 0.5;
+
+// RMS ERROR BOUNDS (rad) FOR JOINTS AND PELVIS, FOR EACH FILTER TYPE (none, one-euro, critically damped)
+const double MAX_JOINT_RMS_ERROR[3] = {0.015, 0.06, 0.05};
+const double MAX_PELVIS_RMS_ERROR[3] = {0.025, 0.04, 0.03};
+
+double getMotion(double t, int i) {
+    return AMPLITUDE * std::sin(2.0 * M_PI * FREQUENCY * t + 0.3 * i);
+}
+
+dynacore::Quaternion getRotation(double t) {
+    return dynacore::Quaternion(Eigen::AngleAxisd(0.5 * t, Eigen::Vector3d(0.0, 0.6, 0.8)));
+}
+
+bool testJointFilter(const IHMCMsgUtils::IHMCCommandFilterParams& params, const char* name, double rate, double noise) {
+    IHMCMsgUtils::IHMCVectorFilter filter(params);
+    std::mt19937 generator(0);
+    std::normal_distribution<double> noise_distribution(0.0, noise);
+
+    // noisy motion on all joints at once
+    int n = valkyrie::num_act_joint;
+    Eigen::VectorXd x(n), x_filtered(n), prev(n), prev2(n), raw_prev(n), raw_prev2(n);
+    double sq_error = 0.0, sq_jerk = 0.0, sq_raw_jerk = 0.0;
+    int num_steps = static_cast<int>(DURATION * rate);
+    for( int k = 0 ; k < num_steps ; k++ ) {
+        double t = k / rate;
+        Eigen::VectorXd clean(n);
+        for( int i = 0 ; i < n ; i++ ) {
+            clean[i] = getMotion(t, i);
+            x[i] = clean[i] + noise_distribution(generator);
+        }
+        filter.filter(t, x, x_filtered);
+
+        sq_error += (x_filtered - clean).squaredNorm();
+        if( k >= 2 ) {
+            sq_jerk += (x_filtered - 2.0 * prev + prev2).squaredNorm();
+            sq_raw_jerk += (x - 2.0 * raw_prev + raw_prev2).squaredNorm();
+        }
+        prev2 = prev;
+        prev = x_filtered;
+        raw_prev2 = raw_prev;
+        raw_prev = x;
+    }
+    double rms_error = std::sqrt(sq_error / (num_steps * n));
+    double jerk_ratio = std::sqrt(sq_jerk / sq_raw_jerk);
+
+    // constant input is reached
+    Eigen::VectorXd target = Eigen::VectorXd::Constant(n, 0.25);
+    for( int k = 0 ; k < static_cast<int>(5.0 * rate) ; k++ ) {
+        filter.filter(DURATION + k / rate, target, x_filtered);
+    }
+    double settle_error = (x_filtered - target).cwiseAbs().maxCoeff();
+
+    bool passed = (settle_error < 1e-6) && (rms_error < MAX_JOINT_RMS_ERROR[params.type]) &&
+                  (params.type == IHMCMsgUtils::COMMAND_FILTER_NONE || jerk_ratio < 1.0);
+    std::cout << std::left << std::setw(20) << name << std::right << std::fixed << std::setprecision(4)
+              << "  joints: rms error " << rms_error << " rad, jerk " << jerk_ratio << "x raw, settle error "
+              << std::scientific << std::setprecision(1) << settle_error << (passed ? "" : "  FAILED") << std::endl;
+
+    return passed;
+}
+
+bool testPelvisFilter(const IHMCMsgUtils::IHMCCommandFilterParams& params, const char* name, double rate, double noise) {
+    IHMCMsgUtils::IHMCQuaternionFilter filter(params);
+    std::mt19937 generator(1);
+    std::normal_distribution<double> noise_distribution(0.0, noise);
+
+    // noisy rotation, with quaternion sign flipped every other sample
+    dynacore::Quaternion quat_filtered = dynacore::Quaternion::Identity();
+    dynacore::Quaternion quat_prev = dynacore::Quaternion::Identity();
+    double sq_error = 0.0;
+    double max_norm_error = 0.0;
+    int num_sign_flips = 0;
+    int num_steps = static_cast<int>(DURATION * rate);
+    for( int k = 0 ; k < num_steps ; k++ ) {
+        double t = k / rate;
+        dynacore::Quaternion clean = getRotation(t);
+        Eigen::Vector3d noise_rot(noise_distribution(generator), noise_distribution(generator), noise_distribution(generator));
+        dynacore::Quaternion quat = clean * dynacore::Quaternion(Eigen::AngleAxisd(noise_rot.norm(), noise_rot.normalized()));
+        if( k % 2 == 1 ) {
+            quat.coeffs() *= -1.0;
+        }
+        filter.filter(t, quat, quat_filtered);
+
+        double angle = Eigen::AngleAxisd(clean.conjugate() * quat_filtered).angle();
+        angle = std::min(angle, 2.0 * M_PI - angle);
+        sq_error += angle * angle;
+        max_norm_error = std::max(max_norm_error, std::fabs(quat_filtered.norm() - 1.0));
+        if( k > 0 && quat_filtered.dot(quat_prev) < 0.0 ) {
+            num_sign_flips++;
+        }
+        quat_prev = quat_filtered;
+    }
+    double rms_error = std::sqrt(sq_error / num_steps);
+
+    // filtered output stays close, never flips sign (except unfiltered pass-through), and stays unit
+    bool passed = (max_norm_error < 1e-9) && (rms_error < MAX_PELVIS_RMS_ERROR[params.type]) &&
+                  (params.type == IHMCMsgUtils::COMMAND_FILTER_NONE || num_sign_flips == 0);
+    std::cout << std::left << std::setw(20) << name << std::right << std::fixed << std::setprecision(4)
+              << "  pelvis: rms error " << rms_error << " rad, sign flips " << num_sign_flips
+              << (passed ? "" : "  FAILED") << std::endl;
+
+    return passed;
+}
+
+int main(int argc, char **argv) {
+    // default test settings, controller output rate and noise
+    double rate = 100.0;
+    double noise = 0.01;
+
+    // parse arguments
+    for( int i = 1 ; i + 1 < argc ; i += 2 ) {
+        std::string arg(argv[i]);
+        if( arg == "--rate" ) { rate = std::max(1.0, std::stod(argv[i+1])); }
+        else if( arg == "--noise" ) { noise = std::max(0.0, std::stod(argv[i+1])); }
+        else { std::cout << "[Command Filter Test] Unrecognized argument " << arg << std::endl; return 1; }
+    }
+
+    const char* names[3] = {"none", "one_euro", "critically_damped"};
+    bool passed = true;
+    for( int i = 0 ; i < 3 ; i++ ) {
+        IHMCMsgUtils::IHMCCommandFilterParams params;
+        IHMCMsgUtils::getCommandFilterType(names[i], params.type);
+        passed = testJointFilter(params, names[i], rate, noise) && passed;
+        passed = testPelvisFilter(params, names[i], rate, noise) && passed;
+    }
+
+    std::cout << "[Command Filter Test] " << (passed ? "PASSED" : "FAILED") << std::endl;
+
+    return passed ? 0 : 1;
+}
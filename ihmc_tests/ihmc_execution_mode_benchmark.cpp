@@ -0,0 +1,419 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <thread>
+#include <atomic>
+#include <deque>
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include <ros/serialization.h>
+#include <ihmc_utils/ihmc_msg_utilities.h>
+#include <ihmc_utils/ihmc_input_log.h>
+#include <ihmc_tests/ihmc_mock_endpoint.h>
+
+/*
+ * Execution-mode comparison benchmark on the mock IHMC endpoint.
+ * Drives the same motion (recorded in an input capture log, or a synthetic motion) through override, queue, and stream
+ * execution modes at several message rates and stream integration durations.  Since message builders send zero
+ * velocities, streaming is also run with finite-difference velocities filled into each streamed point, which is what
+ * the integration duration acts on.  Each setting runs in simulated time
+ * against a fresh IHMCMockEndpoint, and reports tracking error of the arms, neck, and pelvis against the commanded
+ * motion along with messages and bytes sent.  Settings on the Pareto front of bytes sent and joint tracking error
+ * are marked, so operating points can be chosen from measurements.
+ *
+ * usage: ihmc_execution_mode_benchmark [--session FILE] [--duration S] [--delay S] [--loss P] [--bandwidth WN] [--threads N] [--csv FILE]
+ *   --session FILE, input capture log whose joint commands and pelvis transforms give the motion
+ *                   (default is a synthetic motion of the arms, neck, and pelvis)
+ *   --duration S, length (s) of synthetic motion (default 20)
+ *   --delay S, transport delay (s) between sending and receiving each message (default 0)
+ *   --loss P, fraction of messages dropped in transport, with the same drops for every setting (default 0)
+ *   --bandwidth WN, natural frequency (rad/s) of mock endpoint tracking model (default 15)
+ */
+
+// EXPERIMENT GRID
+// stream+vel streams points with finite-difference velocities; message builders send zero velocities
+const int NUM_MODES = 4;
+const char* MODE_NAMES[NUM_MODES] = {"override", "queue", "stream", "stream+vel"};
+const std::vector<double> RATES{5.0, 10.0, 20.0, 50.0, 100.0};
+// stream integration durations, as multiples of the interval between messages
+const std::vector<double> INTEGRATION_MULTIPLIERS{0.5, 1.0, 1.3, 2.0, 3.0};
+
+// SIMULATION
+const double SIM_DT = 0.001;
+const int ROS_FRAMING_BYTES = 4;
+
+// STRUCT FOR ONE SETTING AND ITS RESULT
+struct ModeSetting {
+    int mode;
+    double rate;
+    double stream_integration_duration;
+
+    long num_messages = 0;
+    long num_bytes = 0;
+    int num_rejected = 0;
+    double joint_rms_error = 0.0;
+    double joint_max_error = 0.0;
+    double pelvis_rms_error = 0.0;
+    bool pareto = false;
+};
+
+// MOTION
+void getArmNeckJointIndices(std::vector<int>& joint_indices) {
+    // arm and neck joints in valkyrie definition; special index -1 (wrist joints) is skipped
+    joint_indices.clear();
+    IHMCMockEndpoint endpoint;
+    for( int part = IHMCMockEndpoint::LEFT_ARM ; part <= IHMCMockEndpoint::NECK ; part++ ) {
+        const std::vector<int>& part_indices = endpoint.getJointIndices(part);
+        for( int i = 0 ; i < part_indices.size() ; i++ ) {
+            if( part_indices[i] != -1 ) {
+                joint_indices.push_back(part_indices[i]);
+            }
+        }
+    }
+
+    return;
+}
+
+// commanded motion as sample-and-hold configurations
+struct Motion {
+    std::vector<double> times;
+    std::vector<dynacore::Vector> configs;
+    double duration;
+
+    const dynacore::Vector& sample(double t) const {
+        // latest configuration at or before time
+        std::vector<double>::const_iterator it = std::upper_bound(times.begin(), times.end(), t);
+        int idx = std::max(0, static_cast<int>(it - times.begin()) - 1);
+        return configs[idx];
+    }
+};
+
+void makeSyntheticMotion(double duration, Motion& motion) {
+    std::vector<int> arm_neck_indices;
+    getArmNeckJointIndices(arm_neck_indices);
+
+    // controller output at 100 Hz: slow sinusoids on each joint and a pelvis sway
+    motion.duration = duration;
+    for( double t = 0.0 ; t <= duration ; t += 0.01 ) {
+        dynacore::Vector q;
+        q.resize(valkyrie::num_q);
+        q.setZero();
+        q[valkyrie_joint::virtual_Y] = 0.03 * std::sin(2.0 * M_PI * 0.25 * t);
+        q[valkyrie_joint::virtual_Z] = 1.0 + 0.02 * std::sin(2.0 * M_PI * 0.5 * t);
+        q[valkyrie_joint::virtual_Rw] = 1.0;
+        for( int i = 0 ; i < arm_neck_indices.size() ; i++ ) {
+            q[arm_neck_indices[i]] = 0.4 * std::sin(2.0 * M_PI * 0.5 * t + 0.7 * i);
+        }
+        motion.times.push_back(t);
+        motion.configs.push_back(q);
+    }
+
+    return;
+}
+
+bool loadRecordedMotion(const std::string& filename, Motion& motion) {
+    IHMCMsgUtils::IHMCInputLogReader reader;
+    if( !reader.open(filename) ) {
+        return false;
+    }
+
+    // configuration is assembled the same way as the IHMC Interface Node: latest pelvis transform and joint command
+    dynacore::Vector q;
+    q.resize(valkyrie::num_q);
+    q.setZero();
+    q[valkyrie_joint::virtual_Rw] = 1.0;
+    int64_t start_time = 0;
+    bool started = false;
+    IHMCMsgUtils::IHMCInputLogRecord record;
+    while( reader.readNext(record) ) {
+        if( record.type == IHMCMsgUtils::INPUT_LOG_PELVIS_TRANSFORM ) {
+            q[valkyrie_joint::virtual_X] = record.transform.transform.translation.x;
+            q[valkyrie_joint::virtual_Y] = record.transform.transform.translation.y;
+            q[valkyrie_joint::virtual_Z] = record.transform.transform.translation.z;
+            q[valkyrie_joint::virtual_Rx] = record.transform.transform.rotation.x;
+            q[valkyrie_joint::virtual_Ry] = record.transform.transform.rotation.y;
+            q[valkyrie_joint::virtual_Rz] = record.transform.transform.rotation.z;
+            q[valkyrie_joint::virtual_Rw] = record.transform.transform.rotation.w;
+        }
+        else if( record.type == IHMCMsgUtils::INPUT_LOG_JOINT_COMMAND ) {
+            // joint states with fewer names than positions only give positions for the named joints
+            int num_joints = std::min(record.joint_command.name.size(), record.joint_command.position.size());
+            for( int i = 0 ; i < num_joints ; i++ ) {
+                std::map<std::string, int>::iterator it = val::joint_names_to_indices.find(record.joint_command.name[i]);
+                if( it != val::joint_names_to_indices.end() ) {
+                    q[it->second] = record.joint_command.position[i];
+                }
+            }
+        }
+        else {
+            continue;
+        }
+
+        // motion starts with first pose input
+        if( !started ) {
+            start_time = record.timestamp;
+            started = true;
+        }
+        motion.times.push_back((record.timestamp - start_time) / 1e9);
+        motion.configs.push_back(q);
+    }
+
+    if( motion.times.empty() ) {
+        std::cout << "[Execution Mode Benchmark] No joint commands or pelvis transforms in " << filename << std::endl;
+        return false;
+    }
+    motion.duration = motion.times.back();
+
+    return true;
+}
+
+// EXPERIMENT
+bool isStreamingMode(int mode) {
+    return mode >= 2;
+}
+
+void setJointspaceVelocities(controller_msgs::JointspaceTrajectoryMessage& js_msg, const std::vector<int>& joint_indices,
+                             const dynacore::Vector& q, const dynacore::Vector& q_prev, double period) {
+    for( int i = 0 ; i < js_msg.joint_trajectory_messages.size() && i < joint_indices.size() ; i++ ) {
+        // special index -1 (wrist joints) is not in valkyrie definition; keep zero velocity
+        if( joint_indices[i] != -1 ) {
+            for( int j = 0 ; j < js_msg.joint_trajectory_messages[i].trajectory_points.size() ; j++ ) {
+                js_msg.joint_trajectory_messages[i].trajectory_points[j].velocity = (q[joint_indices[i]] - q_prev[joint_indices[i]]) / period;
+            }
+        }
+    }
+
+    return;
+}
+
+void setStreamVelocities(controller_msgs::WholeBodyTrajectoryMessage& wholebody_msg, const IHMCMockEndpoint& endpoint,
+                         const dynacore::Vector& q, const dynacore::Vector& q_prev, double period) {
+    // arm and neck joint velocities
+    setJointspaceVelocities(wholebody_msg.left_arm_trajectory_message.jointspace_trajectory,
+                            endpoint.getJointIndices(IHMCMockEndpoint::LEFT_ARM), q, q_prev, period);
+    setJointspaceVelocities(wholebody_msg.right_arm_trajectory_message.jointspace_trajectory,
+                            endpoint.getJointIndices(IHMCMockEndpoint::RIGHT_ARM), q, q_prev, period);
+    setJointspaceVelocities(wholebody_msg.neck_trajectory_message.jointspace_trajectory,
+                            endpoint.getJointIndices(IHMCMockEndpoint::NECK), q, q_prev, period);
+
+    // pelvis linear velocity
+    std::vector<controller_msgs::SE3TrajectoryPointMessage>& pelvis_points = wholebody_msg.pelvis_trajectory_message.se3_trajectory.taskspace_trajectory_points;
+    for( int j = 0 ; j < pelvis_points.size() ; j++ ) {
+        pelvis_points[j].linear_velocity.x = (q[valkyrie_joint::virtual_X] - q_prev[valkyrie_joint::virtual_X]) / period;
+        pelvis_points[j].linear_velocity.y = (q[valkyrie_joint::virtual_Y] - q_prev[valkyrie_joint::virtual_Y]) / period;
+        pelvis_points[j].linear_velocity.z = (q[valkyrie_joint::virtual_Z] - q_prev[valkyrie_joint::virtual_Z]) / period;
+    }
+
+    return;
+}
+
+void runSetting(const Motion& motion, double delay, double loss, IHMCMockTrackingParams tracking_params, ModeSetting& setting) {
+    IHMCMockEndpoint endpoint(tracking_params);
+    endpoint.reset(motion.sample(0.0));
+
+    // tracked coordinates
+    std::vector<int> joint_indices;
+    getArmNeckJointIndices(joint_indices);
+
+    // message parameters for this setting
+    IHMCMsgUtils::IHMCMessageParameters msg_params;
+    msg_params.controlled_links = {valkyrie_link::pelvis, valkyrie_link::rightPalm, valkyrie_link::leftPalm, valkyrie_link::head};
+    msg_params.queueable_params.execution_mode = isStreamingMode(setting.mode) ? 2 : setting.mode;
+    double period = 1.0 / setting.rate;
+    if( isStreamingMode(setting.mode) ) {
+        // streamed points take effect immediately and are held for the integration duration
+        msg_params.traj_point_params.time = 0.0;
+        msg_params.queueable_params.stream_integration_duration = setting.stream_integration_duration;
+    }
+    else {
+        // each point is reached when the next message is sent
+        msg_params.traj_point_params.time = period;
+    }
+
+    // run in simulated time; messages are delivered after transport delay
+    std::deque<std::pair<double, controller_msgs::WholeBodyTrajectoryMessage>> in_flight;
+    double next_send = 0.0;
+    dynacore::Vector q_prev_sent = motion.sample(0.0);
+    std::mt19937 loss_generator(0);
+    std::uniform_real_distribution<double> loss_distribution(0.0, 1.0);
+    double joint_sq_error = 0.0;
+    double pelvis_sq_error = 0.0;
+    long num_samples = 0;
+    for( double t = 0.0 ; t <= motion.duration ; t += SIM_DT ) {
+        const dynacore::Vector& q_ref = motion.sample(t);
+
+        // send message from latest commanded configuration
+        if( t >= next_send ) {
+            if( setting.mode == 1 ) {
+                // queued messages are chained by id
+                msg_params.queueable_params.previous_message_id = setting.num_messages;
+                msg_params.queueable_params.message_id = setting.num_messages + 1;
+            }
+            msg_params.sequence_id = setting.num_messages;
+            controller_msgs::WholeBodyTrajectoryMessage wholebody_msg;
+            IHMCMsgUtils::makeIHMCWholeBodyTrajectoryMessage(q_ref, wholebody_msg, msg_params);
+            if( setting.mode == 3 ) {
+                setStreamVelocities(wholebody_msg, endpoint, q_ref, q_prev_sent, period);
+            }
+            q_prev_sent = q_ref;
+            setting.num_bytes += ros::serialization::serializationLength(wholebody_msg) + ROS_FRAMING_BYTES;
+            setting.num_messages++;
+            if( loss_distribution(loss_generator) >= loss ) {
+                in_flight.push_back(std::make_pair(t + delay, wholebody_msg));
+            }
+            next_send += period;
+        }
+
+        // deliver messages that have arrived
+        while( !in_flight.empty() && in_flight.front().first <= t ) {
+            endpoint.receiveWholeBodyMessage(in_flight.front().second, t);
+            in_flight.pop_front();
+        }
+
+        // step endpoint and measure tracking error against commanded motion
+        endpoint.update(t, SIM_DT);
+        const dynacore::Vector& q_actual = endpoint.getActualConfiguration();
+        for( int i = 0 ; i < joint_indices.size() ; i++ ) {
+            double err = q_actual[joint_indices[i]] - q_ref[joint_indices[i]];
+            joint_sq_error += err * err;
+            setting.joint_max_error = std::max(setting.joint_max_error, std::fabs(err));
+        }
+        for( int i = valkyrie_joint::virtual_X ; i <= valkyrie_joint::virtual_Z ; i++ ) {
+            double err = q_actual[i] - q_ref[i];
+            pelvis_sq_error += err * err;
+        }
+        num_samples++;
+    }
+
+    setting.joint_rms_error = std::sqrt(joint_sq_error / (num_samples * joint_indices.size()));
+    setting.pelvis_rms_error = std::sqrt(pelvis_sq_error / (num_samples * 3));
+    setting.num_rejected = endpoint.getNumRejectedMessages();
+
+    return;
+}
+
+void markParetoFront(std::vector<ModeSetting>& settings) {
+    // a setting is on the front if no other setting sends fewer (or equal) bytes with lower error
+    for( int i = 0 ; i < settings.size() ; i++ ) {
+        settings[i].pareto = true;
+        for( int j = 0 ; j < settings.size() ; j++ ) {
+            bool dominated = (settings[j].num_bytes <= settings[i].num_bytes) &&
+                             (settings[j].joint_rms_error <= settings[i].joint_rms_error) &&
+                             ((settings[j].num_bytes < settings[i].num_bytes) ||
+                              (settings[j].joint_rms_error < settings[i].joint_rms_error));
+            if( dominated ) {
+                settings[i].pareto = false;
+                break;
+            }
+        }
+    }
+
+    return;
+}
+
+int main(int argc, char **argv) {
+    // default benchmark settings
+    std::string session_filename;
+    double duration = 20.0;
+    double delay = 0.0;
+    double loss = 0.0;
+    IHMCMockTrackingParams tracking_params;
+    int num_threads = std::max(1u, std::thread::hardware_concurrency());
+    std::string csv_filename;
+
+    // parse arguments
+    for( int i = 1 ; i + 1 < argc ; i += 2 ) {
+        std::string arg(argv[i]);
+        if( arg == "--session" ) { session_filename = std::string(argv[i+1]); }
+        else if( arg == "--duration" ) { duration = std::stod(argv[i+1]); }
+        else if( arg == "--delay" ) { delay = std::max(0.0, std::stod(argv[i+1])); }
+        else if( arg == "--loss" ) { loss = std::max(0.0, std::min(1.0, std::stod(argv[i+1]))); }
+        else if( arg == "--bandwidth" ) { tracking_params.natural_frequency = std::stod(argv[i+1]); }
+        else if( arg == "--threads" ) { num_threads = std::max(1, std::stoi(argv[i+1])); }
+        else if( arg == "--csv" ) { csv_filename = std::string(argv[i+1]); }
+        else { std::cout << "[Execution Mode Benchmark] Unrecognized argument " << arg << std::endl; return 1; }
+    }
+
+    // load or make motion
+    Motion motion;
+    if( !session_filename.empty() ) {
+        if( !loadRecordedMotion(session_filename, motion) ) {
+            return 1;
+        }
+        std::cout << "[Execution Mode Benchmark] Loaded " << motion.times.size() << " commands ("
+                  << motion.duration << " s) from " << session_filename << std::endl;
+    }
+    else {
+        makeSyntheticMotion(duration, motion);
+        std::cout << "[Execution Mode Benchmark] Using " << duration << " s synthetic motion" << std::endl;
+    }
+
+    // build experiment grid; integration duration only applies to streaming
+    std::vector<ModeSetting> settings;
+    for( int mode = 0 ; mode < NUM_MODES ; mode++ ) {
+        for( int r = 0 ; r < RATES.size() ; r++ ) {
+            int num_durations = isStreamingMode(mode) ? INTEGRATION_MULTIPLIERS.size() : 1;
+            for( int d = 0 ; d < num_durations ; d++ ) {
+                ModeSetting setting;
+                setting.mode = mode;
+                setting.rate = RATES[r];
+                setting.stream_integration_duration = isStreamingMode(mode) ? INTEGRATION_MULTIPLIERS[d] / RATES[r] : 0.0;
+                settings.push_back(setting);
+            }
+        }
+    }
+
+    // run settings across worker threads
+    std::atomic<int> next_setting{0};
+    std::vector<std::thread> workers;
+    for( int t = 0 ; t < num_threads ; t++ ) {
+        workers.push_back(std::thread([&]() {
+            int idx;
+            while( (idx = next_setting++) < settings.size() ) {
+                runSetting(motion, delay, loss, tracking_params, settings[idx]);
+            }
+        }));
+    }
+    for( int t = 0 ; t < workers.size() ; t++ ) {
+        workers[t].join();
+    }
+    markParetoFront(settings);
+
+    // report
+    std::cout << std::fixed;
+    std::cout << std::left << std::setw(12) << "mode" << std::right << std::setw(8) << "rate" << std::setw(12) << "integ (s)"
+              << std::setw(10) << "messages" << std::setw(12) << "kB sent" << std::setw(10) << "rejected"
+              << std::setw(16) << "joint rms (rad)" << std::setw(16) << "joint max (rad)" << std::setw(16) << "pelvis rms (m)"
+              << "  pareto" << std::endl;
+    for( int i = 0 ; i < settings.size() ; i++ ) {
+        const ModeSetting& setting = settings[i];
+        std::cout << std::left << std::setw(12) << MODE_NAMES[setting.mode] << std::right
+                  << std::setprecision(0) << std::setw(8) << setting.rate
+                  << std::setprecision(3) << std::setw(12) << setting.stream_integration_duration
+                  << std::setw(10) << setting.num_messages
+                  << std::setprecision(1) << std::setw(12) << setting.num_bytes / 1000.0
+                  << std::setw(10) << setting.num_rejected
+                  << std::setprecision(4) << std::setw(16) << setting.joint_rms_error
+                  << std::setw(16) << setting.joint_max_error << std::setw(16) << setting.pelvis_rms_error
+                  << (setting.pareto ? "  *" : "") << std::endl;
+    }
+
+    // write CSV, if requested
+    if( !csv_filename.empty() ) {
+        std::ofstream csv_file(csv_filename.c_str());
+        csv_file << "mode,rate,stream_integration_duration,messages,bytes,rejected,joint_rms_error,joint_max_error,pelvis_rms_error,pareto" << std::endl;
+        for( int i = 0 ; i < settings.size() ; i++ ) {
+            const ModeSetting& setting = settings[i];
+            csv_file << MODE_NAMES[setting.mode] << "," << setting.rate << "," << setting.stream_integration_duration << ","
+                     << setting.num_messages << "," << setting.num_bytes << "," << setting.num_rejected << ","
+                     << setting.joint_rms_error << "," << setting.joint_max_error << "," << setting.pelvis_rms_error << ","
+                     << (setting.pareto ? 1 : 0) << std::endl;
+        }
+        std::cout << "[Execution Mode Benchmark] Wrote results to " << csv_filename << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,149 @@
+#include <iostream>
+#include <cstdio>
+#include <cmath>
+
+#include <ihmc_utils/ihmc_command_streamer.h>
+#include <ihmc_utils/ihmc_input_log.h>
+#include <ihmc_tests/ihmc_msg_test_utilities.h>
+
+/*
+ * Test for seeking in input capture logs.
+ * Writes a session where controllers start listening, a one-shot status (go home) follows, and joint commands stream
+ * for several keyframe intervals.  Replays the session from the start and from a seek past the one-shot status,
+ * and checks that both replays publish the same whole-body messages after the seek time; a snapshot that lost the
+ * listening state would drop every joint command after the seek.
+ *
+ * usage: ihmc_input_log_test
+ */
+
+const char* TEST_FILENAME = "/tmp/ihmc_input_log_test.ilog";
+const int KEYFRAME_INTERVAL = 10;
+const int NUM_CYCLES = 40;
+const int64_t STREAM_PERIOD = 100000000; // 10 Hz, same as node
+
+// SESSION
+void writeSession() {
+    IHMCMsgUtils::IHMCInputLogWriter writer;
+    writer.open(TEST_FILENAME, KEYFRAME_INTERVAL);
+
+    std_msgs::String status_msg;
+    status_msg.data = "START-LISTENING";
+    writer.logStatus(0, status_msg);
+
+    std_msgs::Int32MultiArray links_msg;
+    links_msg.data = {valkyrie_link::rightPalm, valkyrie_link::leftPalm, valkyrie_link::head};
+    writer.logControlledLinkIds(1000000, links_msg);
+
+    // one-shot status after controllers started listening
+    status_msg.data = "HOME-LEFTARM";
+    writer.logStatus(2000000, status_msg);
+
+    // controllers stream pelvis transforms and joint commands
+    geometry_msgs::TransformStamped tf_msg;
+    tf_msg.transform.translation.z = 1.0;
+    tf_msg.transform.rotation.w = 1.0;
+    sensor_msgs::JointState js_msg;
+    IHMCMsgTestUtils::getActuatedJointNames(js_msg.name);
+    js_msg.position.resize(valkyrie::num_act_joint);
+    for( int k = 0 ; k < NUM_CYCLES ; k++ ) {
+        int64_t time = (k + 1) * STREAM_PERIOD + 5000000;
+        for( int i = 0 ; i < js_msg.position.size() ; i++ ) {
+            js_msg.position[i] = 0.3 * std::sin(0.2 * k + 0.1 * i);
+        }
+        writer.logPelvisTransform(time, tf_msg);
+        writer.logJointCommand(time + 1000000, js_msg);
+    }
+
+    writer.close();
+    return;
+}
+
+// REPLAY
+int replaySession(int64_t seek_time, bool use_seek, uint64_t& digest) {
+    IHMCMsgUtils::IHMCInputLogReader reader;
+    if( !reader.open(TEST_FILENAME) ) {
+        return -1;
+    }
+
+    // streamer on simulated clock; whole-body messages after the seek time are counted and digested
+    int64_t sim_time = 0;
+    int num_outputs = 0;
+    digest = 14695981039346656037ull; // FNV-1a offset basis
+    std::vector<uint8_t> buffer;
+    IHMCMsgUtils::IHMCCommandStreamer streamer(true);
+    streamer.setVerbose(false);
+    streamer.setClock([&sim_time]() { return sim_time; });
+    streamer.setWholeBodyMessageSink([&](const controller_msgs::WholeBodyTrajectoryMessage& msg) {
+        if( sim_time <= seek_time ) {
+            return;
+        }
+        controller_msgs::WholeBodyTrajectoryMessage cleared_msg = msg;
+        IHMCMsgTestUtils::clearTimestamps(cleared_msg);
+        IHMCMsgTestUtils::serializeToBuffer(cleared_msg, buffer);
+        for( int i = 0 ; i < buffer.size() ; i++ ) {
+            digest ^= buffer[i];
+            digest *= 1099511628211ull;
+        }
+        num_outputs++;
+    });
+    streamer.setGoHomeMessageSink([](const controller_msgs::GoHomeMessage& msg) {});
+    streamer.setStopAllTrajectoryMessageSink([](const controller_msgs::StopAllTrajectoryMessage& msg) {});
+
+    // seek replays the keyframe snapshot at the keyframe time
+    int64_t next_tick = STREAM_PERIOD;
+    if( use_seek ) {
+        std::vector<IHMCMsgUtils::IHMCInputLogRecord> snapshot;
+        if( !reader.seek(seek_time, snapshot) ) {
+            return -1;
+        }
+        for( int i = 0 ; i < snapshot.size() ; i++ ) {
+            sim_time = snapshot[i].timestamp;
+            streamer.processInputLogRecord(snapshot[i]);
+        }
+        while( next_tick <= sim_time ) {
+            next_tick += STREAM_PERIOD;
+        }
+    }
+
+    // inputs at their recorded times, with streaming loop at node rate
+    IHMCMsgUtils::IHMCInputLogRecord record;
+    while( reader.readNext(record) ) {
+        while( record.timestamp >= next_tick ) {
+            sim_time = next_tick;
+            streamer.update();
+            next_tick += STREAM_PERIOD;
+        }
+        sim_time = record.timestamp;
+        streamer.processInputLogRecord(record);
+    }
+    sim_time = next_tick;
+    streamer.update();
+
+    return num_outputs;
+}
+
+int main(int argc, char **argv) {
+    std::cout << "[Input Log Test] Testing seek after one-shot status" << std::endl;
+
+    writeSession();
+
+    // seek to a keyframe well after the one-shot status
+    IHMCMsgUtils::IHMCInputLogReader reader;
+    bool passed = reader.open(TEST_FILENAME) && (reader.getIndex().size() >= 3);
+    int64_t seek_time = passed ? reader.getIndex()[2].timestamp : 0;
+    reader.close();
+
+    uint64_t full_digest;
+    uint64_t seek_digest;
+    int full_outputs = replaySession(seek_time, false, full_digest);
+    int seek_outputs = replaySession(seek_time, true, seek_digest);
+    std::remove(TEST_FILENAME);
+
+    // replay from seek publishes the same whole-body messages as replay from the start
+    passed = passed && (full_outputs > 0) && (seek_outputs == full_outputs) && (seek_digest == full_digest);
+    std::cout << "[Input Log Test] seek to " << seek_time / 1e9 << " s: " << full_outputs << " whole-body messages from start, "
+              << seek_outputs << " from seek" << std::endl;
+    std::cout << "[Input Log Test] " << (passed ? "PASSED" : "FAILED") << std::endl;
+
+    return passed ? 0 : 1;
+}
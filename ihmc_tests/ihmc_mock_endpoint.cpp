@@ -0,0 +1,250 @@
+/**
+ * Mock IHMC Endpoint
+ * Emily Sheetz, NSTGRO VTE 2021
+ **/
+
+#include <ihmc_tests/ihmc_mock_endpoint.h>
+
+// CONSTRUCTORS/DESTRUCTORS
+IHMCMockEndpoint::IHMCMockEndpoint(IHMCMockTrackingParams tracking_params) {
+    tracking_params_ = tracking_params;
+
+    // set up tracked body parts, using same joint ordering as IHMC messages
+    body_parts_.resize(NUM_BODY_PARTS);
+    IHMCMsgUtils::getRelevantJointIndicesLeftArm(body_parts_[LEFT_ARM].joint_indices);
+    IHMCMsgUtils::getRelevantJointIndicesRightArm(body_parts_[RIGHT_ARM].joint_indices);
+    IHMCMsgUtils::getRelevantJointIndicesNeck(body_parts_[NECK].joint_indices);
+    IHMCMsgUtils::getRelevantJointIndicesPelvis(body_parts_[PELVIS].joint_indices);
+
+    // start at zero configuration with identity pelvis orientation
+    dynacore::Vector q;
+    q.resize(valkyrie::num_q);
+    q.setZero();
+    q[valkyrie_joint::virtual_Rw] = 1.0;
+    reset(q);
+}
+
+IHMCMockEndpoint::~IHMCMockEndpoint() {
+}
+
+void IHMCMockEndpoint::reset(const dynacore::Vector& q) {
+    q_desired_ = q;
+    q_actual_ = q;
+    qdot_actual_.resize(q.size());
+    qdot_actual_.setZero();
+
+    // clear trajectories
+    for( int i = 0 ; i < body_parts_.size() ; i++ ) {
+        body_parts_[i].segments.clear();
+        body_parts_[i].streaming = false;
+        body_parts_[i].last_message_id = -1;
+    }
+
+    num_received_messages_ = 0;
+    num_rejected_messages_ = 0;
+
+    return;
+}
+
+// MESSAGES
+void IHMCMockEndpoint::receiveWholeBodyMessage(const controller_msgs::WholeBodyTrajectoryMessage& wholebody_msg, double time) {
+    num_received_messages_++;
+
+    dynacore::Vector target;
+    dynacore::Vector velocity;
+    double trajectory_time;
+
+    // ARM AND NECK TRAJECTORIES
+    if( getJointspaceCommand(wholebody_msg.left_arm_trajectory_message.jointspace_trajectory,
+                             body_parts_[LEFT_ARM].joint_indices.size(), target, velocity, trajectory_time) ) {
+        receiveBodyPartCommand(LEFT_ARM, target, velocity, trajectory_time,
+                               wholebody_msg.left_arm_trajectory_message.jointspace_trajectory.queueing_properties, time);
+    }
+    if( getJointspaceCommand(wholebody_msg.right_arm_trajectory_message.jointspace_trajectory,
+                             body_parts_[RIGHT_ARM].joint_indices.size(), target, velocity, trajectory_time) ) {
+        receiveBodyPartCommand(RIGHT_ARM, target, velocity, trajectory_time,
+                               wholebody_msg.right_arm_trajectory_message.jointspace_trajectory.queueing_properties, time);
+    }
+    if( getJointspaceCommand(wholebody_msg.neck_trajectory_message.jointspace_trajectory,
+                             body_parts_[NECK].joint_indices.size(), target, velocity, trajectory_time) ) {
+        receiveBodyPartCommand(NECK, target, velocity, trajectory_time,
+                               wholebody_msg.neck_trajectory_message.jointspace_trajectory.queueing_properties, time);
+    }
+
+    // PELVIS TRAJECTORY
+    const controller_msgs::SE3TrajectoryMessage& pelvis_msg = wholebody_msg.pelvis_trajectory_message.se3_trajectory;
+    if( !pelvis_msg.taskspace_trajectory_points.empty() ) {
+        // only final point is followed
+        const controller_msgs::SE3TrajectoryPointMessage& point = pelvis_msg.taskspace_trajectory_points.back();
+        target.resize(7);
+        target << point.position.x, point.position.y, point.position.z,
+                  point.orientation.x, point.orientation.y, point.orientation.z, point.orientation.w;
+        velocity.resize(7);
+        velocity << point.linear_velocity.x, point.linear_velocity.y, point.linear_velocity.z, 0.0, 0.0, 0.0, 0.0;
+        receiveBodyPartCommand(PELVIS, target, velocity, point.time, pelvis_msg.queueing_properties, time);
+    }
+
+    return;
+}
+
+void IHMCMockEndpoint::receiveBodyPartCommand(int body_part, const dynacore::Vector& target, const dynacore::Vector& velocity,
+                                              double trajectory_time, const controller_msgs::QueueableMessage& q_msg, double time) {
+    BodyPartState& part = body_parts_[body_part];
+
+    // current desired position of body part
+    dynacore::Vector current;
+    IHMCMsgUtils::selectRelevantJointsConfiguration(q_desired_, part.joint_indices, current);
+
+    if( q_msg.execution_mode == controller_msgs::QueueableMessage::EXECUTION_MODE_STREAM ) {
+        // streamed point replaces any trajectory and is extrapolated with its velocity for the integration duration
+        part.segments.clear();
+        part.streaming = true;
+        part.stream_receive_time = time;
+        part.stream_integration_duration = q_msg.stream_integration_duration;
+        part.stream_target = target;
+        part.stream_velocity = velocity;
+    }
+    else if( q_msg.execution_mode == controller_msgs::QueueableMessage::EXECUTION_MODE_QUEUE && !part.segments.empty() &&
+             part.segments.back().start_time + part.segments.back().duration > time ) {
+        // queued message must follow last queued message
+        if( q_msg.previous_message_id != part.last_message_id ) {
+            num_rejected_messages_++;
+            return;
+        }
+
+        // start when last queued segment ends
+        const Segment& last = part.segments.back();
+        Segment segment;
+        segment.start_time = last.start_time + last.duration;
+        segment.duration = trajectory_time;
+        segment.start = last.target;
+        segment.target = target;
+        segment.message_id = q_msg.message_id;
+        part.segments.push_back(segment);
+        part.last_message_id = q_msg.message_id;
+    }
+    else {
+        // override (or queue with nothing left to follow) starts now from current desired position
+        part.segments.clear();
+        part.streaming = false;
+        Segment segment;
+        segment.start_time = time;
+        segment.duration = trajectory_time;
+        segment.start = current;
+        segment.target = target;
+        segment.message_id = q_msg.message_id;
+        part.segments.push_back(segment);
+        part.last_message_id = q_msg.message_id;
+    }
+
+    return;
+}
+
+bool IHMCMockEndpoint::getJointspaceCommand(const controller_msgs::JointspaceTrajectoryMessage& js_msg, int num_joints,
+                                            dynacore::Vector& target, dynacore::Vector& velocity, double& trajectory_time) {
+    // body part not in message
+    if( js_msg.joint_trajectory_messages.size() != num_joints ) {
+        return false;
+    }
+
+    // only final point of each joint is followed
+    target.resize(num_joints);
+    velocity.resize(num_joints);
+    trajectory_time = 0.0;
+    for( int i = 0 ; i < num_joints ; i++ ) {
+        if( js_msg.joint_trajectory_messages[i].trajectory_points.empty() ) {
+            return false;
+        }
+        const controller_msgs::TrajectoryPoint1DMessage& point = js_msg.joint_trajectory_messages[i].trajectory_points.back();
+        target[i] = point.position;
+        velocity[i] = point.velocity;
+        trajectory_time = std::max(trajectory_time, point.time);
+    }
+
+    return true;
+}
+
+// SIMULATION
+void IHMCMockEndpoint::update(double time, double dt) {
+    // update desired configuration of each body part
+    for( int i = 0 ; i < body_parts_.size() ; i++ ) {
+        updateDesired(body_parts_[i], time);
+    }
+
+    // critically damped second-order tracking with velocity limit
+    double wn = tracking_params_.natural_frequency;
+    for( int i = 0 ; i < q_actual_.size() ; i++ ) {
+        double qddot = wn * wn * (q_desired_[i] - q_actual_[i]) - 2.0 * wn * qdot_actual_[i];
+        qdot_actual_[i] += qddot * dt;
+        qdot_actual_[i] = std::max(-tracking_params_.max_velocity, std::min(tracking_params_.max_velocity, qdot_actual_[i]));
+        q_actual_[i] += qdot_actual_[i] * dt;
+    }
+
+    return;
+}
+
+void IHMCMockEndpoint::updateDesired(BodyPartState& part, double time) {
+    dynacore::Vector desired;
+
+    if( part.streaming ) {
+        // extrapolate streamed point for integration duration, then hold
+        double elapsed = std::min(time - part.stream_receive_time, part.stream_integration_duration);
+        desired = part.stream_target + part.stream_velocity * std::max(0.0, elapsed);
+    }
+    else {
+        // drop finished segments once the next one has started
+        while( part.segments.size() > 1 && time >= part.segments[1].start_time ) {
+            part.segments.pop_front();
+        }
+        if( part.segments.empty() || time < part.segments.front().start_time ) {
+            return;
+        }
+
+        // cubic interpolation with zero end velocities
+        const Segment& segment = part.segments.front();
+        double u = (segment.duration > 0.0) ? std::min(1.0, (time - segment.start_time) / segment.duration) : 1.0;
+        double s = u * u * (3.0 - 2.0 * u);
+        desired = segment.start + s * (segment.target - segment.start);
+    }
+
+    for( int i = 0 ; i < part.joint_indices.size() ; i++ ) {
+        // special index -1 (wrist joints) is not in valkyrie definition
+        if( part.joint_indices[i] != -1 ) {
+            q_desired_[part.joint_indices[i]] = desired[i];
+        }
+    }
+
+    return;
+}
+
+// HELPER FUNCTIONS
+const dynacore::Vector& IHMCMockEndpoint::getDesiredConfiguration() {
+    return q_desired_;
+}
+
+const dynacore::Vector& IHMCMockEndpoint::getActualConfiguration() {
+    return q_actual_;
+}
+
+const std::vector<int>& IHMCMockEndpoint::getJointIndices(int body_part) const {
+    return body_parts_[body_part].joint_indices;
+}
+
+int IHMCMockEndpoint::getNumReceivedMessages() {
+    return num_received_messages_;
+}
+
+int IHMCMockEndpoint::getNumRejectedMessages() {
+    return num_rejected_messages_;
+}
+
+int IHMCMockEndpoint::getNumPendingSegments(int body_part, double time) const {
+    const std::deque<Segment>& segments = body_parts_[body_part].segments;
+    int num_pending = 0;
+    for( int i = 0 ; i < segments.size() ; i++ ) {
+        if( time < segments[i].start_time + segments[i].duration ) {
+            num_pending++;
+        }
+    }
+    return num_pending;
+}
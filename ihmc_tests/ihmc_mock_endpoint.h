@@ -0,0 +1,130 @@
+/**
+ * Mock IHMC Endpoint
+ * Emily Sheetz, NSTGRO VTE 2021
+ **/
+
+#ifndef _IHMC_MOCK_ENDPOINT_H_
+#define _IHMC_MOCK_ENDPOINT_H_
+
+#include <deque>
+#include <vector>
+#include <ihmc_utils/ihmc_msg_utilities.h>
+
+/*
+ * stand-in for the IHMC whole-body controller, for experiments that cannot use SCS or the robot;
+ * receives whole-body messages, keeps a desired trajectory for the arms, neck, and pelvis following IHMC's
+ * override, queue, and stream execution modes, and tracks the desired configuration with a simple
+ * critically damped second-order model with a velocity limit
+ *
+ * simplifications: chest and spine trajectories are ignored (tracking them needs the robot's IK),
+ * trajectories are cubic interpolations with zero end velocities, and orientations are interpolated componentwise
+ */
+
+// STRUCT FOR TRACKING MODEL PARAMETERS
+struct IHMCMockTrackingParams {
+    // natural frequency (rad/s) of second-order tracking model
+    double natural_frequency;
+
+    // velocity limit for each tracked coordinate (rad/s or m/s)
+    double max_velocity;
+
+    // DEFAULT CONSTRUCTOR; sets all parameters to default values
+    IHMCMockTrackingParams() {
+        natural_frequency = 15.0;
+        max_velocity = 2.0;
+    }
+};
+
+class IHMCMockEndpoint
+{
+public:
+    // BODY PARTS TRACKED BY MOCK ENDPOINT
+    enum BodyPart {
+        LEFT_ARM = 0,
+        RIGHT_ARM,
+        NECK,
+        PELVIS,
+        NUM_BODY_PARTS
+    };
+
+    // CONSTRUCTORS/DESTRUCTORS
+    IHMCMockEndpoint(IHMCMockTrackingParams tracking_params = IHMCMockTrackingParams());
+    ~IHMCMockEndpoint();
+
+    /*
+     * sets desired and actual configuration, clearing any trajectories
+     * @param q, the configuration vector (valkyrie::num_q values)
+     * @return none
+     */
+    void reset(const dynacore::Vector& q);
+
+    // MESSAGES
+    /*
+     * receives a whole-body message; each body part in the message is executed according to its queueing properties
+     * @param wholebody_msg, the received message
+     * @param time, the time (s) at which the message is received
+     * @return none
+     */
+    void receiveWholeBodyMessage(const controller_msgs::WholeBodyTrajectoryMessage& wholebody_msg, double time);
+
+    // SIMULATION
+    /*
+     * advances desired trajectories and tracking model
+     * @param time, the time (s) at the end of the step
+     * @param dt, the length (s) of the step
+     * @return none
+     */
+    void update(double time, double dt);
+
+    // HELPER FUNCTIONS
+    const dynacore::Vector& getDesiredConfiguration();
+    const dynacore::Vector& getActualConfiguration();
+    const std::vector<int>& getJointIndices(int body_part) const;
+    int getNumReceivedMessages();
+    int getNumRejectedMessages();
+    /*
+     * gets the queue depth of a body part: trajectory segments that are executing or queued
+     * @param body_part, the body part
+     * @param time, the current time (s)
+     * @return number of segments of body part that have not finished by time
+     */
+    int getNumPendingSegments(int body_part, double time) const;
+
+private:
+    // STRUCT FOR ONE TRAJECTORY SEGMENT
+    struct Segment {
+        double start_time;
+        double duration;
+        dynacore::Vector start;
+        dynacore::Vector target;
+        int64_t message_id;
+    };
+
+    // STRUCT FOR STATE OF ONE BODY PART
+    struct BodyPartState {
+        std::vector<int> joint_indices; // indices of body part in configuration vector
+        std::deque<Segment> segments; // active and queued trajectory segments
+        bool streaming; // flag indicating whether body part is following a streamed point
+        double stream_receive_time; // time at which streamed point was received
+        double stream_integration_duration; // duration (s) to integrate streamed velocity
+        dynacore::Vector stream_target; // streamed position
+        dynacore::Vector stream_velocity; // streamed velocity
+        int64_t last_message_id; // id of last queued message, for checking previous message ids
+    };
+
+    void receiveBodyPartCommand(int body_part, const dynacore::Vector& target, const dynacore::Vector& velocity,
+                                double trajectory_time, const controller_msgs::QueueableMessage& q_msg, double time);
+    bool getJointspaceCommand(const controller_msgs::JointspaceTrajectoryMessage& js_msg, int num_joints,
+                              dynacore::Vector& target, dynacore::Vector& velocity, double& trajectory_time);
+    void updateDesired(BodyPartState& part, double time);
+
+    IHMCMockTrackingParams tracking_params_; // parameters of tracking model
+    std::vector<BodyPartState> body_parts_; // state of each tracked body part
+    dynacore::Vector q_desired_; // desired configuration
+    dynacore::Vector q_actual_; // actual (tracked) configuration
+    dynacore::Vector qdot_actual_; // actual velocity
+    int num_received_messages_; // number of whole-body messages received
+    int num_rejected_messages_; // number of body part commands rejected (e.g., queued out of order)
+};
+
+#endif
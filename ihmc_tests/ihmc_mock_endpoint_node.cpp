@@ -0,0 +1,124 @@
+/**
+ * Mock IHMC Endpoint Node
+ * Emily Sheetz, NSTGRO VTE 2021
+ **/
+
+#include <ros/ros.h>
+#include <controller_msgs/RobotConfigurationData.h>
+#include <controller_msgs/WholeBodyTrajectoryMessage.h>
+#include <ihmc_utils/ihmc_tracking_monitor.h>
+#include <ihmc_tests/ihmc_mock_endpoint.h>
+
+/*
+ * stands in for the IHMC controller when neither SCS nor the robot is available:
+ * receives whole-body messages on the IHMC input topic, tracks them with the mock endpoint,
+ * and publishes the tracked configuration as robot configuration data on the IHMC output topic
+ */
+class IHMCMockEndpointNode
+{
+public:
+    // CONSTRUCTORS/DESTRUCTORS
+    IHMCMockEndpointNode(const ros::NodeHandle& nh) {
+        nh_ = nh;
+
+        // set up parameters
+        nh_.param("rate", rate_, 100.0);
+        nh_.param("wholebody_topic", wholebody_topic_,
+                  std::string("/ihmc/valkyrie/humanoid_control/input/whole_body_trajectory"));
+        nh_.param("robot_configuration_topic", robot_configuration_topic_,
+                  std::string("/ihmc/valkyrie/humanoid_control/output/robot_configuration_data"));
+        IHMCMockTrackingParams tracking_params;
+        nh_.param("natural_frequency", tracking_params.natural_frequency, tracking_params.natural_frequency);
+        nh_.param("max_velocity", tracking_params.max_velocity, tracking_params.max_velocity);
+
+        // start standing at zero joint configuration
+        endpoint_ = IHMCMockEndpoint(tracking_params);
+        dynacore::Vector q;
+        q.resize(valkyrie::num_q);
+        q.setZero();
+        q[valkyrie_joint::virtual_Z] = 1.0;
+        q[valkyrie_joint::virtual_Rw] = 1.0;
+        endpoint_.reset(q);
+        start_time_ = ros::Time::now();
+        sequence_id_ = 0;
+
+        initializeConnections();
+
+        std::cout << "[Mock IHMC Endpoint Node] Constructed" << std::endl;
+    }
+
+    ~IHMCMockEndpointNode() {
+        std::cout << "[Mock IHMC Endpoint Node] Destroyed" << std::endl;
+    }
+
+    // CONNECTIONS
+    bool initializeConnections() {
+        wholebody_sub_ = nh_.subscribe(wholebody_topic_, 10, &IHMCMockEndpointNode::wholeBodyCallback, this);
+        robot_configuration_pub_ = nh_.advertise<controller_msgs::RobotConfigurationData>(robot_configuration_topic_, 1);
+
+        return true;
+    }
+
+    // CALLBACKS
+    void wholeBodyCallback(const controller_msgs::WholeBodyTrajectoryMessage& wholebody_msg) {
+        endpoint_.receiveWholeBodyMessage(wholebody_msg, getTime());
+        return;
+    }
+
+    // UPDATE
+    void update() {
+        // advance tracking model and publish tracked configuration
+        endpoint_.update(getTime(), 1.0 / rate_);
+
+        controller_msgs::RobotConfigurationData config_msg;
+        IHMCMsgUtils::makeRobotConfigurationData(endpoint_.getActualConfiguration(), config_msg);
+        config_msg.sequence_id = sequence_id_++;
+        robot_configuration_pub_.publish(config_msg);
+
+        return;
+    }
+
+    // HELPER FUNCTIONS
+    double getRate() {
+        return rate_;
+    }
+
+    double getTime() {
+        return (ros::Time::now() - start_time_).toSec();
+    }
+
+private:
+    ros::NodeHandle nh_; // node handler
+
+    std::string wholebody_topic_; // topic to subscribe to for listening to whole-body messages
+    ros::Subscriber wholebody_sub_; // subscriber for listening to whole-body messages
+    std::string robot_configuration_topic_; // topic to publish robot configuration data to
+    ros::Publisher robot_configuration_pub_; // publisher for robot configuration data
+
+    double rate_; // rate (Hz) to update tracking model and publish robot configuration data
+    IHMCMockEndpoint endpoint_; // mock endpoint following whole-body messages
+    ros::Time start_time_; // time node started
+    uint32_t sequence_id_; // sequence id of robot configuration data
+};
+
+int main(int argc, char **argv) {
+    // initialize node
+    ros::init(argc, argv, "MockIHMCEndpointNode");
+
+    // initialize node handler
+    ros::NodeHandle nh("~");
+
+    // create node
+    IHMCMockEndpointNode mock_endpoint_node(nh);
+
+    ROS_INFO("[Mock IHMC Endpoint Node] Node started, waiting for whole-body messages...");
+
+    ros::Rate rate(mock_endpoint_node.getRate());
+    while( ros::ok() ) {
+        ros::spinOnce();
+        mock_endpoint_node.update();
+        rate.sleep();
+    }
+
+    return 0;
+}
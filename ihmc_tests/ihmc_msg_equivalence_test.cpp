@@ -0,0 +1,603 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <random>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <type_traits>
+
+#include <ros/serialization.h>
+#include <ihmc_utils/ihmc_msg_utilities.h>
+#include <ihmc_tests/ihmc_msg_reference_builders.h>
+#include <ihmc_tests/ihmc_msg_test_utilities.h>
+
+/*
+ * Differential equivalence harness for IHMC Message Utilities.
+ * Feeds the same randomized or recorded Valkyrie configurations, controlled-link sets, and parameter presets
+ * to the frozen reference builders (IHMCMsgReference) and the live builders (IHMCMsgUtils),
+ * then compares the serialized messages byte for byte; if bytes differ, compares fields within a tolerance.
+ * Creation timestamps are cleared before comparing, since they are taken from the wall clock.
+ *
+ * usage: ihmc_msg_equivalence_test [--cases N] [--threads N] [--seed N] [--tolerance TOL] [--configs FILE]
+ *   --configs FILE, a text file of recorded configurations, one configuration vector (valkyrie::num_q values) per line;
+ *                   recorded configurations are used in order before randomized configurations
+ */
+
+// PARAMETER PRESETS
+enum ParameterPreset {
+    PRESET_DEFAULT = 0,         // default parameters (override)
+    PRESET_STREAM,              // parameters used when commands come from controllers
+    PRESET_QUEUE,               // queued messages
+    PRESET_CARTESIAN_WORLD,     // Cartesian hand goals in world frame
+    PRESET_CARTESIAN_PELVIS,    // Cartesian hand goals in pelvis frame
+    PRESET_CARTESIAN_NAMED,     // Cartesian hand goals in a named IHMC frame
+    NUM_PRESETS
+};
+
+// STRUCT FOR ONE EQUIVALENCE CASE
+struct EquivalenceCase {
+    dynacore::Vector q;
+    dynacore::Vect3 left_hand_pos;
+    dynacore::Quaternion left_hand_quat;
+    dynacore::Vect3 right_hand_pos;
+    dynacore::Quaternion right_hand_quat;
+    int preset;
+    IHMCMsgUtils::IHMCMessageParameters msg_params;
+};
+
+// STRUCT FOR FIELD COMPARISON STATE
+struct FieldComparison {
+    double tolerance;
+    std::string first_difference;
+};
+
+// FIELD COMPARISON
+// declared up front so nested message comparisons can refer to each other
+bool compareField(double a, double b, const std::string& path, FieldComparison& cmp);
+template <class T>
+typename std::enable_if<std::is_integral<T>::value, bool>::type
+compareField(T a, T b, const std::string& path, FieldComparison& cmp);
+template <class T>
+bool compareField(const std::vector<T>& a, const std::vector<T>& b, const std::string& path, FieldComparison& cmp);
+bool compareField(const geometry_msgs::Point& a, const geometry_msgs::Point& b, const std::string& path, FieldComparison& cmp);
+bool compareField(const geometry_msgs::Quaternion& a, const geometry_msgs::Quaternion& b, const std::string& path, FieldComparison& cmp);
+bool compareField(const geometry_msgs::Vector3& a, const geometry_msgs::Vector3& b, const std::string& path, FieldComparison& cmp);
+bool compareField(const geometry_msgs::Pose& a, const geometry_msgs::Pose& b, const std::string& path, FieldComparison& cmp);
+bool compareField(const controller_msgs::QueueableMessage& a, const controller_msgs::QueueableMessage& b, const std::string& path, FieldComparison& cmp);
+bool compareField(const controller_msgs::FrameInformation& a, const controller_msgs::FrameInformation& b, const std::string& path, FieldComparison& cmp);
+bool compareField(const controller_msgs::SelectionMatrix3DMessage& a, const controller_msgs::SelectionMatrix3DMessage& b, const std::string& path, FieldComparison& cmp);
+bool compareField(const controller_msgs::WeightMatrix3DMessage& a, const controller_msgs::WeightMatrix3DMessage& b, const std::string& path, FieldComparison& cmp);
+bool compareField(const controller_msgs::TrajectoryPoint1DMessage& a, const controller_msgs::TrajectoryPoint1DMessage& b, const std::string& path, FieldComparison& cmp);
+bool compareField(const controller_msgs::OneDoFJointTrajectoryMessage& a, const controller_msgs::OneDoFJointTrajectoryMessage& b, const std::string& path, FieldComparison& cmp);
+bool compareField(const controller_msgs::JointspaceTrajectoryMessage& a, const controller_msgs::JointspaceTrajectoryMessage& b, const std::string& path, FieldComparison& cmp);
+bool compareField(const controller_msgs::SE3TrajectoryPointMessage& a, const controller_msgs::SE3TrajectoryPointMessage& b, const std::string& path, FieldComparison& cmp);
+bool compareField(const controller_msgs::SO3TrajectoryPointMessage& a, const controller_msgs::SO3TrajectoryPointMessage& b, const std::string& path, FieldComparison& cmp);
+bool compareField(const controller_msgs::SE3TrajectoryMessage& a, const controller_msgs::SE3TrajectoryMessage& b, const std::string& path, FieldComparison& cmp);
+bool compareField(const controller_msgs::SO3TrajectoryMessage& a, const controller_msgs::SO3TrajectoryMessage& b, const std::string& path, FieldComparison& cmp);
+bool compareField(const controller_msgs::WholeBodyTrajectoryMessage& a, const controller_msgs::WholeBodyTrajectoryMessage& b, const std::string& path, FieldComparison& cmp);
+bool compareField(const controller_msgs::GoHomeMessage& a, const controller_msgs::GoHomeMessage& b, const std::string& path, FieldComparison& cmp);
+bool compareField(const controller_msgs::ValkyrieHandFingerTrajectoryMessage& a, const controller_msgs::ValkyrieHandFingerTrajectoryMessage& b, const std::string& path, FieldComparison& cmp);
+
+// compare one named field of messages a and b, stopping at the first difference
+#define COMPARE_MSG_FIELD(field) \
+    if( !compareField(a.field, b.field, path + "." #field, cmp) ) { return false; }
+
+bool compareField(double a, double b, const std::string& path, FieldComparison& cmp) {
+    if( std::abs(a - b) <= cmp.tolerance ) {
+        return true;
+    }
+    std::ostringstream ss;
+    ss << path << ": " << a << " != " << b;
+    cmp.first_difference = ss.str();
+    return false;
+}
+
+template <class T>
+typename std::enable_if<std::is_integral<T>::value, bool>::type
+compareField(T a, T b, const std::string& path, FieldComparison& cmp) {
+    if( a == b ) {
+        return true;
+    }
+    std::ostringstream ss;
+    ss << path << ": " << (long long) a << " != " << (long long) b;
+    cmp.first_difference = ss.str();
+    return false;
+}
+
+template <class T>
+bool compareField(const std::vector<T>& a, const std::vector<T>& b, const std::string& path, FieldComparison& cmp) {
+    if( a.size() != b.size() ) {
+        std::ostringstream ss;
+        ss << path << ": size " << a.size() << " != " << b.size();
+        cmp.first_difference = ss.str();
+        return false;
+    }
+    for( int i = 0 ; i < a.size() ; i++ ) {
+        if( !compareField(a[i], b[i], path + "[" + std::to_string(i) + "]", cmp) ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool compareField(const geometry_msgs::Point& a, const geometry_msgs::Point& b, const std::string& path, FieldComparison& cmp) {
+    COMPARE_MSG_FIELD(x) COMPARE_MSG_FIELD(y) COMPARE_MSG_FIELD(z)
+    return true;
+}
+
+bool compareField(const geometry_msgs::Quaternion& a, const geometry_msgs::Quaternion& b, const std::string& path, FieldComparison& cmp) {
+    COMPARE_MSG_FIELD(x) COMPARE_MSG_FIELD(y) COMPARE_MSG_FIELD(z) COMPARE_MSG_FIELD(w)
+    return true;
+}
+
+bool compareField(const geometry_msgs::Vector3& a, const geometry_msgs::Vector3& b, const std::string& path, FieldComparison& cmp) {
+    COMPARE_MSG_FIELD(x) COMPARE_MSG_FIELD(y) COMPARE_MSG_FIELD(z)
+    return true;
+}
+
+bool compareField(const geometry_msgs::Pose& a, const geometry_msgs::Pose& b, const std::string& path, FieldComparison& cmp) {
+    COMPARE_MSG_FIELD(position) COMPARE_MSG_FIELD(orientation)
+    return true;
+}
+
+bool compareField(const controller_msgs::QueueableMessage& a, const controller_msgs::QueueableMessage& b, const std::string& path, FieldComparison& cmp) {
+    COMPARE_MSG_FIELD(sequence_id) COMPARE_MSG_FIELD(execution_mode) COMPARE_MSG_FIELD(message_id)
+    COMPARE_MSG_FIELD(previous_message_id) COMPARE_MSG_FIELD(execution_delay_time)
+    COMPARE_MSG_FIELD(stream_integration_duration) COMPARE_MSG_FIELD(timestamp)
+    return true;
+}
+
+bool compareField(const controller_msgs::FrameInformation& a, const controller_msgs::FrameInformation& b, const std::string& path, FieldComparison& cmp) {
+    COMPARE_MSG_FIELD(sequence_id) COMPARE_MSG_FIELD(trajectory_reference_frame_id) COMPARE_MSG_FIELD(data_reference_frame_id)
+    return true;
+}
+
+bool compareField(const controller_msgs::SelectionMatrix3DMessage& a, const controller_msgs::SelectionMatrix3DMessage& b, const std::string& path, FieldComparison& cmp) {
+    COMPARE_MSG_FIELD(sequence_id) COMPARE_MSG_FIELD(selection_frame_id)
+    COMPARE_MSG_FIELD(x_selected) COMPARE_MSG_FIELD(y_selected) COMPARE_MSG_FIELD(z_selected)
+    return true;
+}
+
+bool compareField(const controller_msgs::WeightMatrix3DMessage& a, const controller_msgs::WeightMatrix3DMessage& b, const std::string& path, FieldComparison& cmp) {
+    COMPARE_MSG_FIELD(sequence_id) COMPARE_MSG_FIELD(weight_frame_id)
+    COMPARE_MSG_FIELD(x_weight) COMPARE_MSG_FIELD(y_weight) COMPARE_MSG_FIELD(z_weight)
+    return true;
+}
+
+bool compareField(const controller_msgs::TrajectoryPoint1DMessage& a, const controller_msgs::TrajectoryPoint1DMessage& b, const std::string& path, FieldComparison& cmp) {
+    COMPARE_MSG_FIELD(sequence_id) COMPARE_MSG_FIELD(time) COMPARE_MSG_FIELD(position) COMPARE_MSG_FIELD(velocity)
+    return true;
+}
+
+bool compareField(const controller_msgs::OneDoFJointTrajectoryMessage& a, const controller_msgs::OneDoFJointTrajectoryMessage& b, const std::string& path, FieldComparison& cmp) {
+    COMPARE_MSG_FIELD(sequence_id) COMPARE_MSG_FIELD(trajectory_points) COMPARE_MSG_FIELD(weight)
+    return true;
+}
+
+bool compareField(const controller_msgs::JointspaceTrajectoryMessage& a, const controller_msgs::JointspaceTrajectoryMessage& b, const std::string& path, FieldComparison& cmp) {
+    COMPARE_MSG_FIELD(sequence_id) COMPARE_MSG_FIELD(joint_trajectory_messages) COMPARE_MSG_FIELD(queueing_properties)
+    return true;
+}
+
+bool compareField(const controller_msgs::SE3TrajectoryPointMessage& a, const controller_msgs::SE3TrajectoryPointMessage& b, const std::string& path, FieldComparison& cmp) {
+    COMPARE_MSG_FIELD(sequence_id) COMPARE_MSG_FIELD(time) COMPARE_MSG_FIELD(position) COMPARE_MSG_FIELD(orientation)
+    COMPARE_MSG_FIELD(linear_velocity) COMPARE_MSG_FIELD(angular_velocity)
+    return true;
+}
+
+bool compareField(const controller_msgs::SO3TrajectoryPointMessage& a, const controller_msgs::SO3TrajectoryPointMessage& b, const std::string& path, FieldComparison& cmp) {
+    COMPARE_MSG_FIELD(sequence_id) COMPARE_MSG_FIELD(time) COMPARE_MSG_FIELD(orientation) COMPARE_MSG_FIELD(angular_velocity)
+    return true;
+}
+
+bool compareField(const controller_msgs::SE3TrajectoryMessage& a, const controller_msgs::SE3TrajectoryMessage& b, const std::string& path, FieldComparison& cmp) {
+    COMPARE_MSG_FIELD(sequence_id) COMPARE_MSG_FIELD(taskspace_trajectory_points)
+    COMPARE_MSG_FIELD(angular_selection_matrix) COMPARE_MSG_FIELD(linear_selection_matrix)
+    COMPARE_MSG_FIELD(frame_information)
+    COMPARE_MSG_FIELD(angular_weight_matrix) COMPARE_MSG_FIELD(linear_weight_matrix)
+    COMPARE_MSG_FIELD(use_custom_control_frame) COMPARE_MSG_FIELD(control_frame_pose)
+    COMPARE_MSG_FIELD(queueing_properties)
+    return true;
+}
+
+bool compareField(const controller_msgs::SO3TrajectoryMessage& a, const controller_msgs::SO3TrajectoryMessage& b, const std::string& path, FieldComparison& cmp) {
+    COMPARE_MSG_FIELD(sequence_id) COMPARE_MSG_FIELD(taskspace_trajectory_points)
+    COMPARE_MSG_FIELD(selection_matrix) COMPARE_MSG_FIELD(frame_information) COMPARE_MSG_FIELD(weight_matrix)
+    COMPARE_MSG_FIELD(use_custom_control_frame) COMPARE_MSG_FIELD(control_frame_pose)
+    COMPARE_MSG_FIELD(queueing_properties)
+    return true;
+}
+
+bool compareField(const controller_msgs::WholeBodyTrajectoryMessage& a, const controller_msgs::WholeBodyTrajectoryMessage& b, const std::string& path, FieldComparison& cmp) {
+    COMPARE_MSG_FIELD(sequence_id)
+    COMPARE_MSG_FIELD(left_hand_trajectory_message.sequence_id) COMPARE_MSG_FIELD(left_hand_trajectory_message.robot_side)
+    COMPARE_MSG_FIELD(left_hand_trajectory_message.se3_trajectory)
+    COMPARE_MSG_FIELD(right_hand_trajectory_message.sequence_id) COMPARE_MSG_FIELD(right_hand_trajectory_message.robot_side)
+    COMPARE_MSG_FIELD(right_hand_trajectory_message.se3_trajectory)
+    COMPARE_MSG_FIELD(left_arm_trajectory_message.sequence_id) COMPARE_MSG_FIELD(left_arm_trajectory_message.force_execution)
+    COMPARE_MSG_FIELD(left_arm_trajectory_message.robot_side) COMPARE_MSG_FIELD(left_arm_trajectory_message.jointspace_trajectory)
+    COMPARE_MSG_FIELD(right_arm_trajectory_message.sequence_id) COMPARE_MSG_FIELD(right_arm_trajectory_message.force_execution)
+    COMPARE_MSG_FIELD(right_arm_trajectory_message.robot_side) COMPARE_MSG_FIELD(right_arm_trajectory_message.jointspace_trajectory)
+    COMPARE_MSG_FIELD(chest_trajectory_message.sequence_id) COMPARE_MSG_FIELD(chest_trajectory_message.so3_trajectory)
+    COMPARE_MSG_FIELD(spine_trajectory_message.sequence_id) COMPARE_MSG_FIELD(spine_trajectory_message.jointspace_trajectory)
+    COMPARE_MSG_FIELD(pelvis_trajectory_message.sequence_id) COMPARE_MSG_FIELD(pelvis_trajectory_message.force_execution)
+    COMPARE_MSG_FIELD(pelvis_trajectory_message.enable_user_pelvis_control)
+    COMPARE_MSG_FIELD(pelvis_trajectory_message.enable_user_pelvis_control_during_walking)
+    COMPARE_MSG_FIELD(pelvis_trajectory_message.se3_trajectory)
+    COMPARE_MSG_FIELD(left_foot_trajectory_message.sequence_id) COMPARE_MSG_FIELD(left_foot_trajectory_message.robot_side)
+    COMPARE_MSG_FIELD(left_foot_trajectory_message.se3_trajectory)
+    COMPARE_MSG_FIELD(right_foot_trajectory_message.sequence_id) COMPARE_MSG_FIELD(right_foot_trajectory_message.robot_side)
+    COMPARE_MSG_FIELD(right_foot_trajectory_message.se3_trajectory)
+    COMPARE_MSG_FIELD(neck_trajectory_message.sequence_id) COMPARE_MSG_FIELD(neck_trajectory_message.jointspace_trajectory)
+    COMPARE_MSG_FIELD(head_trajectory_message.sequence_id) COMPARE_MSG_FIELD(head_trajectory_message.so3_trajectory)
+    return true;
+}
+
+bool compareField(const controller_msgs::GoHomeMessage& a, const controller_msgs::GoHomeMessage& b, const std::string& path, FieldComparison& cmp) {
+    COMPARE_MSG_FIELD(sequence_id) COMPARE_MSG_FIELD(humanoid_body_part) COMPARE_MSG_FIELD(robot_side)
+    COMPARE_MSG_FIELD(trajectory_time) COMPARE_MSG_FIELD(execution_delay_time)
+    return true;
+}
+
+bool compareField(const controller_msgs::ValkyrieHandFingerTrajectoryMessage& a, const controller_msgs::ValkyrieHandFingerTrajectoryMessage& b, const std::string& path, FieldComparison& cmp) {
+    COMPARE_MSG_FIELD(sequence_id) COMPARE_MSG_FIELD(robot_side)
+    COMPARE_MSG_FIELD(valkyrie_finger_motor_names) COMPARE_MSG_FIELD(jointspace_trajectory)
+    return true;
+}
+
+#undef COMPARE_MSG_FIELD
+
+// STRUCT FOR HARNESS RESULTS
+struct EquivalenceResults {
+    std::atomic<long> num_cases{0};
+    std::atomic<long> num_messages{0};
+    std::atomic<long> num_byte_equal{0};
+    std::atomic<long> num_tolerance_equal{0};
+    std::atomic<long> num_mismatches{0};
+    std::mutex report_mutex;
+};
+
+template <class M>
+void compareMessages(M& ref_msg, M& live_msg, const std::string& description,
+                     double tolerance, EquivalenceResults& results) {
+    // clear wall-clock timestamps
+    IHMCMsgTestUtils::clearTimestamps(ref_msg);
+    IHMCMsgTestUtils::clearTimestamps(live_msg);
+
+    results.num_messages++;
+
+    // compare serialized bytes
+    std::vector<uint8_t> ref_buffer;
+    std::vector<uint8_t> live_buffer;
+    IHMCMsgTestUtils::serializeToBuffer(ref_msg, ref_buffer);
+    IHMCMsgTestUtils::serializeToBuffer(live_msg, live_buffer);
+    if( ref_buffer.size() == live_buffer.size() &&
+        std::memcmp(ref_buffer.data(), live_buffer.data(), ref_buffer.size()) == 0 ) {
+        results.num_byte_equal++;
+        return;
+    }
+
+    // bytes differ, compare fields within tolerance
+    FieldComparison cmp;
+    cmp.tolerance = tolerance;
+    if( compareField(ref_msg, live_msg, std::string("msg"), cmp) ) {
+        results.num_tolerance_equal++;
+        return;
+    }
+
+    // report mismatch (only the first few, to keep output readable)
+    long num_mismatches = ++results.num_mismatches;
+    if( num_mismatches <= 10 ) {
+        std::lock_guard<std::mutex> lock(results.report_mutex);
+        std::cout << "[Equivalence Test] MISMATCH in " << description << ": " << cmp.first_difference << std::endl;
+    }
+
+    return;
+}
+
+// CASE GENERATION
+void makeRandomConfiguration(std::mt19937_64& rng, dynacore::Vector& q) {
+    std::uniform_real_distribution<double> pos_dist(-1.0, 1.0);
+    std::uniform_real_distribution<double> joint_dist(-M_PI/2.0, M_PI/2.0);
+    std::normal_distribution<double> quat_dist(0.0, 1.0);
+
+    q.resize(valkyrie::num_q);
+    q.setZero();
+
+    // random pelvis pose
+    q[valkyrie_joint::virtual_X] = pos_dist(rng);
+    q[valkyrie_joint::virtual_Y] = pos_dist(rng);
+    q[valkyrie_joint::virtual_Z] = 1.0 + 0.1 * pos_dist(rng);
+    dynacore::Quaternion pelvis_quat(quat_dist(rng), quat_dist(rng), quat_dist(rng), quat_dist(rng));
+    pelvis_quat.normalize();
+    q[valkyrie_joint::virtual_Rx] = pelvis_quat.x();
+    q[valkyrie_joint::virtual_Ry] = pelvis_quat.y();
+    q[valkyrie_joint::virtual_Rz] = pelvis_quat.z();
+    q[valkyrie_joint::virtual_Rw] = pelvis_quat.w();
+
+    // random joint positions
+    for( int i = 0 ; i < valkyrie::num_act_joint ; i++ ) {
+        q[valkyrie::num_virtual + i] = joint_dist(rng);
+    }
+
+    return;
+}
+
+void makeRandomPose(std::mt19937_64& rng, dynacore::Vect3& pos, dynacore::Quaternion& quat) {
+    std::uniform_real_distribution<double> pos_dist(-1.0, 1.0);
+    std::normal_distribution<double> quat_dist(0.0, 1.0);
+
+    pos << pos_dist(rng), pos_dist(rng), pos_dist(rng);
+    quat = dynacore::Quaternion(quat_dist(rng), quat_dist(rng), quat_dist(rng), quat_dist(rng));
+    quat.normalize();
+
+    return;
+}
+
+void makeRandomCase(std::mt19937_64& rng, EquivalenceCase& eq_case) {
+    // random sequence id and controlled-link subset of the seven links used by the whole-body message
+    std::uniform_int_distribution<int> seq_dist(0, 1000000);
+    std::uniform_int_distribution<int> links_dist(0, 127);
+    std::uniform_int_distribution<int> preset_dist(0, NUM_PRESETS - 1);
+    std::vector<int> all_links{valkyrie_link::pelvis, valkyrie_link::torso,
+                               valkyrie_link::rightCOP_Frame, valkyrie_link::leftCOP_Frame,
+                               valkyrie_link::rightPalm, valkyrie_link::leftPalm,
+                               valkyrie_link::head};
+
+    // random hand goals
+    makeRandomPose(rng, eq_case.left_hand_pos, eq_case.left_hand_quat);
+    makeRandomPose(rng, eq_case.right_hand_pos, eq_case.right_hand_quat);
+
+    // reset parameters to defaults
+    eq_case.msg_params = IHMCMsgUtils::IHMCMessageParameters();
+    eq_case.msg_params.sequence_id = seq_dist(rng);
+
+    // select controlled links
+    int link_mask = links_dist(rng);
+    for( int i = 0 ; i < all_links.size() ; i++ ) {
+        if( link_mask & (1 << i) ) {
+            eq_case.msg_params.controlled_links.push_back(all_links[i]);
+        }
+    }
+
+    // apply parameter preset
+    eq_case.preset = preset_dist(rng);
+    switch( eq_case.preset ) {
+        case PRESET_STREAM:
+            eq_case.msg_params.queueable_params.execution_mode = 2;
+            eq_case.msg_params.queueable_params.stream_integration_duration = 0.13;
+            eq_case.msg_params.traj_point_params.time = 0.0;
+            break;
+        case PRESET_QUEUE:
+            eq_case.msg_params.queueable_params.execution_mode = 1;
+            eq_case.msg_params.queueable_params.message_id = seq_dist(rng);
+            eq_case.msg_params.queueable_params.previous_message_id = seq_dist(rng);
+            eq_case.msg_params.traj_point_params.time = 1.0;
+            break;
+        case PRESET_CARTESIAN_WORLD:
+            eq_case.msg_params.cartesian_hand_goals = true;
+            eq_case.msg_params.frame_params.cartesian_goal_reference_frame_name = std::string("world");
+            break;
+        case PRESET_CARTESIAN_PELVIS:
+            eq_case.msg_params.cartesian_hand_goals = true;
+            eq_case.msg_params.frame_params.cartesian_goal_reference_frame_name = std::string("pelvis");
+            break;
+        case PRESET_CARTESIAN_NAMED:
+            eq_case.msg_params.cartesian_hand_goals = true;
+            eq_case.msg_params.frame_params.cartesian_goal_reference_frame_name = std::string("World:pelvis");
+            break;
+        default: // PRESET_DEFAULT
+            break;
+    }
+
+    return;
+}
+
+// RUN CASE
+void runCase(EquivalenceCase& eq_case, double tolerance, EquivalenceResults& results) {
+    std::string description = std::string("preset ") + std::to_string(eq_case.preset);
+
+    // whole-body message
+    controller_msgs::WholeBodyTrajectoryMessage ref_wb_msg;
+    controller_msgs::WholeBodyTrajectoryMessage live_wb_msg;
+    if( eq_case.msg_params.cartesian_hand_goals ) {
+        IHMCMsgReference::makeIHMCWholeBodyTrajectoryMessage(eq_case.q,
+                                                             eq_case.left_hand_pos, eq_case.left_hand_quat,
+                                                             eq_case.right_hand_pos, eq_case.right_hand_quat,
+                                                             ref_wb_msg, eq_case.msg_params);
+        IHMCMsgUtils::makeIHMCWholeBodyTrajectoryMessage(eq_case.q,
+                                                         eq_case.left_hand_pos, eq_case.left_hand_quat,
+                                                         eq_case.right_hand_pos, eq_case.right_hand_quat,
+                                                         live_wb_msg, eq_case.msg_params);
+    }
+    else {
+        IHMCMsgReference::makeIHMCWholeBodyTrajectoryMessage(eq_case.q, ref_wb_msg, eq_case.msg_params);
+        IHMCMsgUtils::makeIHMCWholeBodyTrajectoryMessage(eq_case.q, live_wb_msg, eq_case.msg_params);
+    }
+    compareMessages(ref_wb_msg, live_wb_msg, description + " whole-body", tolerance, results);
+
+    // messages made on their own, as outside callers make them
+    controller_msgs::QueueableMessage ref_q_msg;
+    controller_msgs::QueueableMessage live_q_msg;
+    IHMCMsgReference::makeIHMCQueueableMessage(ref_q_msg, eq_case.msg_params);
+    IHMCMsgUtils::makeIHMCQueueableMessage(live_q_msg, eq_case.msg_params);
+    compareMessages(ref_q_msg, live_q_msg, description + " queueable", tolerance, results);
+    controller_msgs::SE3TrajectoryMessage ref_se3_msg;
+    controller_msgs::SE3TrajectoryMessage live_se3_msg;
+    IHMCMsgReference::makeIHMCSE3TrajectoryMessage(eq_case.left_hand_pos, eq_case.left_hand_quat, ref_se3_msg,
+                                                   IHMCMsgUtils::IHMC_WORLD_FRAME_ID, IHMCMsgUtils::IHMC_WORLD_FRAME_ID,
+                                                   eq_case.msg_params);
+    IHMCMsgUtils::makeIHMCSE3TrajectoryMessage(eq_case.left_hand_pos, eq_case.left_hand_quat, live_se3_msg,
+                                               IHMCMsgUtils::IHMC_WORLD_FRAME_ID, IHMCMsgUtils::IHMC_WORLD_FRAME_ID,
+                                               eq_case.msg_params);
+    compareMessages(ref_se3_msg, live_se3_msg, description + " SE3 trajectory", tolerance, results);
+    controller_msgs::SO3TrajectoryMessage ref_so3_msg;
+    controller_msgs::SO3TrajectoryMessage live_so3_msg;
+    IHMCMsgReference::makeIHMCSO3TrajectoryMessage(eq_case.right_hand_quat, ref_so3_msg,
+                                                   IHMCMsgUtils::IHMC_PELVIS_ZUP_FRAME_ID, IHMCMsgUtils::IHMC_WORLD_FRAME_ID,
+                                                   eq_case.msg_params);
+    IHMCMsgUtils::makeIHMCSO3TrajectoryMessage(eq_case.right_hand_quat, live_so3_msg,
+                                               IHMCMsgUtils::IHMC_PELVIS_ZUP_FRAME_ID, IHMCMsgUtils::IHMC_WORLD_FRAME_ID,
+                                               eq_case.msg_params);
+    compareMessages(ref_so3_msg, live_so3_msg, description + " SO3 trajectory", tolerance, results);
+    controller_msgs::JointspaceTrajectoryMessage ref_js_msg;
+    controller_msgs::JointspaceTrajectoryMessage live_js_msg;
+    IHMCMsgReference::makeIHMCJointspaceTrajectoryMessage(eq_case.q, ref_js_msg, eq_case.msg_params);
+    IHMCMsgUtils::makeIHMCJointspaceTrajectoryMessage(eq_case.q, live_js_msg, eq_case.msg_params);
+    compareMessages(ref_js_msg, live_js_msg, description + " jointspace trajectory", tolerance, results);
+
+    // go home messages
+    controller_msgs::GoHomeMessage ref_home_msg;
+    controller_msgs::GoHomeMessage live_home_msg;
+    IHMCMsgReference::makeIHMCHomeLeftArmMessage(ref_home_msg, eq_case.msg_params);
+    IHMCMsgUtils::makeIHMCHomeLeftArmMessage(live_home_msg, eq_case.msg_params);
+    compareMessages(ref_home_msg, live_home_msg, description + " home left arm", tolerance, results);
+    ref_home_msg = controller_msgs::GoHomeMessage();
+    live_home_msg = controller_msgs::GoHomeMessage();
+    IHMCMsgReference::makeIHMCHomeRightArmMessage(ref_home_msg, eq_case.msg_params);
+    IHMCMsgUtils::makeIHMCHomeRightArmMessage(live_home_msg, eq_case.msg_params);
+    compareMessages(ref_home_msg, live_home_msg, description + " home right arm", tolerance, results);
+    ref_home_msg = controller_msgs::GoHomeMessage();
+    live_home_msg = controller_msgs::GoHomeMessage();
+    IHMCMsgReference::makeIHMCHomeChestMessage(ref_home_msg, eq_case.msg_params);
+    IHMCMsgUtils::makeIHMCHomeChestMessage(live_home_msg, eq_case.msg_params);
+    compareMessages(ref_home_msg, live_home_msg, description + " home chest", tolerance, results);
+    ref_home_msg = controller_msgs::GoHomeMessage();
+    live_home_msg = controller_msgs::GoHomeMessage();
+    IHMCMsgReference::makeIHMCHomePelvisMessage(ref_home_msg, eq_case.msg_params);
+    IHMCMsgUtils::makeIHMCHomePelvisMessage(live_home_msg, eq_case.msg_params);
+    compareMessages(ref_home_msg, live_home_msg, description + " home pelvis", tolerance, results);
+
+    // finger messages, with finger message parameters
+    IHMCMsgUtils::IHMCMessageParameters finger_params = eq_case.msg_params;
+    finger_params.setParametersForFingerMessages();
+    for( int side = 0 ; side < 2 ; side++ ) {
+        for( int open = 0 ; open < 2 ; open++ ) {
+            controller_msgs::ValkyrieHandFingerTrajectoryMessage ref_finger_msg;
+            controller_msgs::ValkyrieHandFingerTrajectoryMessage live_finger_msg;
+            IHMCMsgReference::makeIHMCValkyrieHandFingerTrajectoryMessage(ref_finger_msg, side, open == 1, finger_params);
+            IHMCMsgUtils::makeIHMCValkyrieHandFingerTrajectoryMessage(live_finger_msg, side, open == 1, finger_params);
+            compareMessages(ref_finger_msg, live_finger_msg, description + " finger", tolerance, results);
+        }
+    }
+
+    results.num_cases++;
+
+    return;
+}
+
+// RECORDED CONFIGURATIONS
+bool loadRecordedConfigurations(const std::string& filename, std::vector<dynacore::Vector>& configs) {
+    std::ifstream config_file(filename);
+    if( !config_file.is_open() ) {
+        std::cout << "[Equivalence Test] Could not open recorded configurations file " << filename << std::endl;
+        return false;
+    }
+
+    // each line holds one configuration vector
+    std::string line;
+    while( std::getline(config_file, line) ) {
+        std::istringstream line_stream(line);
+        std::vector<double> values;
+        double value;
+        while( line_stream >> value ) {
+            values.push_back(value);
+        }
+        if( values.empty() ) {
+            continue;
+        }
+        if( values.size() != valkyrie::num_q ) {
+            std::cout << "[Equivalence Test] Skipping recorded configuration with " << values.size()
+                      << " values, expected " << valkyrie::num_q << std::endl;
+            continue;
+        }
+        dynacore::Vector q(valkyrie::num_q);
+        for( int i = 0 ; i < values.size() ; i++ ) {
+            q[i] = values[i];
+        }
+        configs.push_back(q);
+    }
+
+    return true;
+}
+
+int main(int argc, char **argv) {
+    // default harness settings
+    long num_cases = 100000;
+    int num_threads = std::max(1u, std::thread::hardware_concurrency());
+    unsigned long seed = 2021;
+    double tolerance = 1e-9;
+    std::string configs_filename;
+
+    // parse arguments
+    for( int i = 1 ; i + 1 < argc ; i += 2 ) {
+        std::string arg(argv[i]);
+        if( arg == "--cases" ) { num_cases = std::stol(argv[i+1]); }
+        else if( arg == "--threads" ) { num_threads = std::max(1, std::stoi(argv[i+1])); }
+        else if( arg == "--seed" ) { seed = std::stoul(argv[i+1]); }
+        else if( arg == "--tolerance" ) { tolerance = std::stod(argv[i+1]); }
+        else if( arg == "--configs" ) { configs_filename = std::string(argv[i+1]); }
+        else { std::cout << "[Equivalence Test] Unrecognized argument " << arg << std::endl; return 1; }
+    }
+
+    std::cout << "[Equivalence Test] Comparing reference and live IHMC message builders" << std::endl;
+
+    // load recorded configurations, if given
+    std::vector<dynacore::Vector> recorded_configs;
+    if( !configs_filename.empty() ) {
+        if( !loadRecordedConfigurations(configs_filename, recorded_configs) ) {
+            return 1;
+        }
+        std::cout << "[Equivalence Test] Loaded " << recorded_configs.size() << " recorded configurations" << std::endl;
+    }
+
+    // run cases across worker threads; case i uses recorded configuration i if it exists
+    // each case is seeded by its index, so cases are the same whichever thread claims them
+    EquivalenceResults results;
+    std::atomic<long> next_case{0};
+    auto start_time = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for( int t = 0 ; t < num_threads ; t++ ) {
+        workers.push_back(std::thread([&]() {
+            EquivalenceCase eq_case;
+            long case_idx;
+            while( (case_idx = next_case++) < num_cases ) {
+                std::mt19937_64 rng(seed + case_idx);
+                makeRandomCase(rng, eq_case);
+                if( case_idx < recorded_configs.size() ) {
+                    eq_case.q = recorded_configs[case_idx];
+                }
+                else {
+                    makeRandomConfiguration(rng, eq_case.q);
+                }
+                runCase(eq_case, tolerance, results);
+            }
+        }));
+    }
+    for( int t = 0 ; t < workers.size() ; t++ ) {
+        workers[t].join();
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+
+    // report results
+    std::cout << "[Equivalence Test] Cases: " << results.num_cases
+              << ", messages: " << results.num_messages
+              << ", byte-equal: " << results.num_byte_equal
+              << ", equal within tolerance: " << results.num_tolerance_equal
+              << ", mismatches: " << results.num_mismatches << std::endl;
+    std::cout << "[Equivalence Test] " << num_threads << " threads, " << elapsed << " s, "
+              << (elapsed > 0.0 ? results.num_cases / elapsed : 0.0) << " cases/s" << std::endl;
+
+    if( results.num_mismatches > 0 ) {
+        std::cout << "[Equivalence Test] FAILED" << std::endl;
+        return 1;
+    }
+
+    std::cout << "[Equivalence Test] PASSED" << std::endl;
+
+    return 0;
+}
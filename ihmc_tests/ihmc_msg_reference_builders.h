@@ -0,0 +1,168 @@
+/**
+ * Frozen Reference Copy of IHMC Message Builders
+ * Emily Sheetz, NSTGRO VTE 2021
+ **/
+
+#ifndef _IHMC_MSG_REFERENCE_BUILDERS_H_
+#define _IHMC_MSG_REFERENCE_BUILDERS_H_
+
+#include <ihmc_utils/ihmc_msg_utilities.h>
+
+/*
+ * frozen reference copies of the IHMC message builders in IHMCMsgUtils;
+ * functions have the same signatures and documentation as those in ihmc_utils/ihmc_msg_utilities.h
+ */
+namespace IHMCMsgReference {
+
+    void makeIHMCArmTrajectoryMessage(dynacore::Vector q_joints,
+                                      controller_msgs::ArmTrajectoryMessage& arm_msg,
+                                      int robot_side,
+                                      IHMCMsgUtils::IHMCMessageParameters msg_params);
+
+    void makeIHMCChestTrajectoryMessage(dynacore::Quaternion quat,
+                                        controller_msgs::ChestTrajectoryMessage& chest_msg,
+                                        IHMCMsgUtils::IHMCMessageParameters msg_params);
+
+    void makeIHMCFootTrajectoryMessage(dynacore::Vect3 pos,
+                                       dynacore::Quaternion quat,
+                                       controller_msgs::FootTrajectoryMessage& foot_msg,
+                                       int robot_side,
+                                       IHMCMsgUtils::IHMCMessageParameters msg_params);
+
+    void makeIHMCFrameInformationMessage(controller_msgs::FrameInformation& frame_msg,
+                                         int trajectory_reference_frame_id,
+                                         int data_reference_frame_id,
+                                         IHMCMsgUtils::IHMCMessageParameters msg_params);
+
+    void makeIHMCHandTrajectoryMessage(dynacore::Vect3 pos,
+                                       dynacore::Quaternion quat,
+                                       controller_msgs::HandTrajectoryMessage& hand_msg,
+                                       int robot_side,
+                                       IHMCMsgUtils::IHMCMessageParameters msg_params);
+
+    void makeIHMCJointspaceTrajectoryMessage(dynacore::Vector q_joints,
+                                             controller_msgs::JointspaceTrajectoryMessage& js_msg,
+                                             IHMCMsgUtils::IHMCMessageParameters msg_params);
+
+    void makeIHMCJointspaceTrajectoryMessage(std::vector<double> q_joints_vector,
+                                             controller_msgs::JointspaceTrajectoryMessage& js_msg,
+                                             IHMCMsgUtils::IHMCMessageParameters msg_params);
+
+    void makeIHMCNeckTrajectoryMessage(dynacore::Vector q_joints,
+                                       controller_msgs::NeckTrajectoryMessage& neck_msg,
+                                       IHMCMsgUtils::IHMCMessageParameters msg_params);
+
+    void makeIHMCOneDoFJointTrajectoryMessage(double q_joint,
+                                              controller_msgs::OneDoFJointTrajectoryMessage& j_msg,
+                                              IHMCMsgUtils::IHMCMessageParameters msg_params);
+
+    void makeIHMCPelvisTrajectoryMessage(dynacore::Vector q_joints,
+                                         controller_msgs::PelvisTrajectoryMessage& pelvis_msg,
+                                         IHMCMsgUtils::IHMCMessageParameters msg_params);
+
+    void makeIHMCQueueableMessage(controller_msgs::QueueableMessage& q_msg,
+                                  IHMCMsgUtils::IHMCMessageParameters msg_params);
+
+    void makeIHMCSE3TrajectoryMessage(dynacore::Vect3 pos, dynacore::Quaternion quat,
+                                      controller_msgs::SE3TrajectoryMessage& se3_msg,
+                                      int trajectory_reference_frame_id,
+                                      int data_reference_frame_id,
+                                      IHMCMsgUtils::IHMCMessageParameters msg_params);
+
+    void makeIHMCSE3TrajectoryPointMessage(dynacore::Vect3 pos, dynacore::Quaternion quat,
+                                           controller_msgs::SE3TrajectoryPointMessage& se3_point_msg,
+                                           IHMCMsgUtils::IHMCMessageParameters msg_params);
+
+    void makeIHMCSelectionMatrix3DMessage(controller_msgs::SelectionMatrix3DMessage& selmat_msg,
+                                          IHMCMsgUtils::IHMCMessageParameters msg_params);
+
+    void makeIHMCSO3TrajectoryMessage(dynacore::Quaternion quat,
+                                      controller_msgs::SO3TrajectoryMessage& so3_msg,
+                                      int trajectory_reference_frame_id,
+                                      int data_reference_frame_id,
+                                      IHMCMsgUtils::IHMCMessageParameters msg_params);
+
+    void makeIHMCSO3TrajectoryPointMessage(dynacore::Quaternion quat,
+                                           controller_msgs::SO3TrajectoryPointMessage& so3_point_msg,
+                                           IHMCMsgUtils::IHMCMessageParameters msg_params);
+
+    void makeIHMCSpineTrajectoryMessage(dynacore::Vector q_joints,
+                                        controller_msgs::SpineTrajectoryMessage& spine_msg,
+                                        IHMCMsgUtils::IHMCMessageParameters msg_params);
+
+    void makeIHMCTrajectoryPoint1DMessage(double q_joint,
+                                          controller_msgs::TrajectoryPoint1DMessage& point_msg,
+                                          IHMCMsgUtils::IHMCMessageParameters msg_params);
+
+    void makeIHMCWeightMatrix3DMessage(controller_msgs::WeightMatrix3DMessage& wmat_msg,
+                                       IHMCMsgUtils::IHMCMessageParameters msg_params);
+
+    void makeIHMCWholeBodyTrajectoryMessage(dynacore::Vector q,
+                                            controller_msgs::WholeBodyTrajectoryMessage& wholebody_msg,
+                                            IHMCMsgUtils::IHMCMessageParameters msg_params);
+
+    void makeIHMCWholeBodyTrajectoryMessage(dynacore::Vector q,
+                                            dynacore::Vect3 left_hand_pos, dynacore::Quaternion left_hand_quat,
+                                            dynacore::Vect3 right_hand_pos, dynacore::Quaternion right_hand_quat,
+                                            controller_msgs::WholeBodyTrajectoryMessage& wholebody_msg,
+                                            IHMCMsgUtils::IHMCMessageParameters msg_params);
+
+    void makeIHMCHomeLeftArmMessage(controller_msgs::GoHomeMessage& go_home_msg,
+                                    IHMCMsgUtils::IHMCMessageParameters msg_params);
+
+    void makeIHMCHomeRightArmMessage(controller_msgs::GoHomeMessage& go_home_msg,
+                                     IHMCMsgUtils::IHMCMessageParameters msg_params);
+
+    void makeIHMCHomeChestMessage(controller_msgs::GoHomeMessage& go_home_msg,
+                                  IHMCMsgUtils::IHMCMessageParameters msg_params);
+
+    void makeIHMCHomePelvisMessage(controller_msgs::GoHomeMessage& go_home_msg,
+                                   IHMCMsgUtils::IHMCMessageParameters msg_params);
+
+    void makeIHMCValkyrieHandFingerTrajectoryMessage(controller_msgs::ValkyrieHandFingerTrajectoryMessage& finger_msg,
+                                                     int robot_side,
+                                                     bool open,
+                                                     IHMCMsgUtils::IHMCMessageParameters msg_params);
+
+    void makeIHMCValkyrieHandFingerTrajectoryMessage(controller_msgs::ValkyrieHandFingerTrajectoryMessage& finger_msg,
+                                                     int robot_side,
+                                                     std::vector<int> finger_selection,
+                                                     std::vector<double> finger_positions,
+                                                     IHMCMsgUtils::IHMCMessageParameters msg_params);
+
+    void selectRelevantJointsConfiguration(dynacore::Vector q,
+                                           std::vector<int> joint_indices,
+                                           dynacore::Vector& q_joints);
+
+    void getRelevantJointIndicesPelvis(std::vector<int>& joint_indices);
+
+    void getRelevantJointIndicesLeftLeg(std::vector<int>& joint_indices);
+
+    void getRelevantJointIndicesRightLeg(std::vector<int>& joint_indices);
+
+    void getRelevantJointIndicesTorso(std::vector<int>& joint_indices);
+
+    void getRelevantJointIndicesLeftArm(std::vector<int>& joint_indices);
+
+    void getRelevantJointIndicesNeck(std::vector<int>& joint_indices);
+
+    void getRelevantJointIndicesRightArm(std::vector<int>& joint_indices);
+
+    void getChestOrientation(dynacore::Vector q, dynacore::Quaternion& chest_quat);
+
+    void getPelvisPose(dynacore::Vector q_joints,
+                       dynacore::Vect3& pelvis_pos, dynacore::Quaternion& pelvis_quat);
+
+    bool checkControlledLink(std::vector<int> controlled_links, int link_id);
+
+    void getReferenceFrameIds(std::string frame_name,
+                              int& trajectory_reference_frame_id,
+                              int& data_reference_frame_id,
+                              IHMCMsgUtils::IHMCMessageParameters msg_params);
+
+    void applyHandOffset(dynacore::Vect3& left_hand_pos, dynacore::Quaternion& left_hand_quat,
+                         dynacore::Vect3& right_hand_pos, dynacore::Quaternion& right_hand_quat);
+
+} // end namespace IHMCMsgReference
+
+#endif
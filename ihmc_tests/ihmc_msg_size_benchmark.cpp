@@ -0,0 +1,224 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+
+#include <ros/serialization.h>
+#include <ihmc_utils/ihmc_msg_utilities.h>
+
+/*
+ * Serialized-size and bandwidth benchmark for IHMC whole-body messages.
+ * Enumerates every subset of the seven controlled links used by the whole-body message, with jointspace and Cartesian
+ * hand goals, and reports serialized bytes, message build time, serialization time, and the bandwidth needed to
+ * stream each message at 10, 50, and 100 Hz.  Messages use the streaming parameters the IHMC Interface Node uses
+ * for commands from controllers; bandwidth includes the 4-byte length prefix ROS adds to each message on the wire.
+ *
+ * usage: ihmc_msg_size_benchmark [--iterations N] [--csv FILE]
+ */
+
+// LINKS CHECKED BY WHOLE-BODY MESSAGE, WITH SHORT NAMES FOR REPORT
+const int NUM_LINKS = 7;
+const int ALL_LINKS[NUM_LINKS] = {valkyrie_link::pelvis, valkyrie_link::torso,
+                                  valkyrie_link::rightCOP_Frame, valkyrie_link::leftCOP_Frame,
+                                  valkyrie_link::rightPalm, valkyrie_link::leftPalm,
+                                  valkyrie_link::head};
+const char* LINK_NAMES[NUM_LINKS] = {"pelvis", "torso", "rfoot", "lfoot", "rhand", "lhand", "head"};
+
+// STREAM RATES TO REPORT BANDWIDTH FOR (Hz)
+const int NUM_RATES = 3;
+const double RATES[NUM_RATES] = {10.0, 50.0, 100.0};
+
+// BYTES ADDED BY ROS TO EACH MESSAGE ON THE WIRE (length prefix)
+const int ROS_FRAMING_BYTES = 4;
+
+// STRUCT FOR ONE BENCHMARK CASE
+struct SizeResult {
+    int link_mask;
+    bool cartesian_hands;
+    uint32_t num_bytes;
+    double build_micros;
+    double serialize_micros;
+};
+
+std::string getLinkSetName(int link_mask) {
+    if( link_mask == 0 ) {
+        return std::string("(none)");
+    }
+
+    std::string name;
+    for( int i = 0 ; i < NUM_LINKS ; i++ ) {
+        if( link_mask & (1 << i) ) {
+            name += (name.empty() ? "" : "+") + std::string(LINK_NAMES[i]);
+        }
+    }
+
+    return name;
+}
+
+void makeNominalConfiguration(dynacore::Vector& q) {
+    // standing pelvis pose with all joints slightly away from zero
+    q.resize(valkyrie::num_q);
+    q.setZero();
+    q[valkyrie_joint::virtual_Z] = 1.0;
+    q[valkyrie_joint::virtual_Rw] = 1.0;
+    for( int i = 0 ; i < valkyrie::num_act_joint ; i++ ) {
+        q[valkyrie::num_virtual + i] = 0.1;
+    }
+
+    return;
+}
+
+void runCase(const dynacore::Vector& q, int link_mask, bool cartesian_hands, int num_iterations, SizeResult& result) {
+    // streaming parameters, same as IHMC Interface Node with commands from controllers
+    IHMCMsgUtils::IHMCMessageParameters msg_params;
+    msg_params.queueable_params.execution_mode = 2;
+    msg_params.queueable_params.stream_integration_duration = 0.13;
+    msg_params.traj_point_params.time = 0.0;
+    for( int i = 0 ; i < NUM_LINKS ; i++ ) {
+        if( link_mask & (1 << i) ) {
+            msg_params.controlled_links.push_back(ALL_LINKS[i]);
+        }
+    }
+    msg_params.cartesian_hand_goals = cartesian_hands;
+    msg_params.frame_params.cartesian_goal_reference_frame_name = std::string("world");
+
+    // hand goals used for Cartesian hands
+    dynacore::Vect3 left_pos(0.5, 0.3, 1.0);
+    dynacore::Vect3 right_pos(0.5, -0.3, 1.0);
+    dynacore::Quaternion hand_quat;
+    hand_quat.setIdentity();
+
+    // time message building
+    controller_msgs::WholeBodyTrajectoryMessage wholebody_msg;
+    auto t0 = std::chrono::steady_clock::now();
+    for( int i = 0 ; i < num_iterations ; i++ ) {
+        wholebody_msg = controller_msgs::WholeBodyTrajectoryMessage();
+        if( cartesian_hands ) {
+            IHMCMsgUtils::makeIHMCWholeBodyTrajectoryMessage(q, left_pos, hand_quat, right_pos, hand_quat,
+                                                             wholebody_msg, msg_params);
+        }
+        else {
+            IHMCMsgUtils::makeIHMCWholeBodyTrajectoryMessage(q, wholebody_msg, msg_params);
+        }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+
+    // time serialization into a reused buffer, as roscpp does for each published message
+    std::vector<uint8_t> buffer;
+    uint32_t length = 0;
+    for( int i = 0 ; i < num_iterations ; i++ ) {
+        length = ros::serialization::serializationLength(wholebody_msg);
+        buffer.resize(length);
+        ros::serialization::OStream stream(buffer.data(), length);
+        ros::serialization::serialize(stream, wholebody_msg);
+    }
+    auto t2 = std::chrono::steady_clock::now();
+
+    result.link_mask = link_mask;
+    result.cartesian_hands = cartesian_hands;
+    result.num_bytes = length;
+    result.build_micros = std::chrono::duration<double, std::micro>(t1 - t0).count() / num_iterations;
+    result.serialize_micros = std::chrono::duration<double, std::micro>(t2 - t1).count() / num_iterations;
+
+    return;
+}
+
+double getBandwidthKBps(uint32_t num_bytes, double rate) {
+    return (num_bytes + ROS_FRAMING_BYTES) * rate / 1000.0;
+}
+
+int main(int argc, char **argv) {
+    // default benchmark settings
+    int num_iterations = 1000;
+    std::string csv_filename;
+
+    // parse arguments
+    for( int i = 1 ; i + 1 < argc ; i += 2 ) {
+        std::string arg(argv[i]);
+        if( arg == "--iterations" ) { num_iterations = std::max(1, std::stoi(argv[i+1])); }
+        else if( arg == "--csv" ) { csv_filename = std::string(argv[i+1]); }
+        else { std::cout << "[Size Benchmark] Unrecognized argument " << arg << std::endl; return 1; }
+    }
+
+    std::cout << "[Size Benchmark] Measuring whole-body messages for " << (1 << NUM_LINKS)
+              << " controlled-link subsets, jointspace and Cartesian hands, " << num_iterations << " iterations each" << std::endl;
+
+    // run every controlled-link subset in both hand modes
+    dynacore::Vector q;
+    makeNominalConfiguration(q);
+    std::vector<SizeResult> results;
+    for( int hand_mode = 0 ; hand_mode < 2 ; hand_mode++ ) {
+        for( int link_mask = 0 ; link_mask < (1 << NUM_LINKS) ; link_mask++ ) {
+            SizeResult result;
+            runCase(q, link_mask, hand_mode == 1, num_iterations, result);
+            results.push_back(result);
+        }
+    }
+
+    // report each case
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << std::left << std::setw(48) << "links" << std::setw(12) << "hands" << std::right
+              << std::setw(8) << "bytes" << std::setw(11) << "build us" << std::setw(13) << "serialize us";
+    for( int r = 0 ; r < NUM_RATES ; r++ ) {
+        std::ostringstream header;
+        header << "kB/s@" << static_cast<int>(RATES[r]) << "Hz";
+        std::cout << std::setw(13) << header.str();
+    }
+    std::cout << std::endl;
+    for( int i = 0 ; i < results.size() ; i++ ) {
+        const SizeResult& result = results[i];
+        std::cout << std::left << std::setw(48) << getLinkSetName(result.link_mask)
+                  << std::setw(12) << (result.cartesian_hands ? "cartesian" : "jointspace") << std::right
+                  << std::setw(8) << result.num_bytes << std::setw(11) << result.build_micros
+                  << std::setw(13) << result.serialize_micros;
+        for( int r = 0 ; r < NUM_RATES ; r++ ) {
+            std::cout << std::setw(13) << getBandwidthKBps(result.num_bytes, RATES[r]);
+        }
+        std::cout << std::endl;
+    }
+
+    // summarize each hand mode
+    for( int hand_mode = 0 ; hand_mode < 2 ; hand_mode++ ) {
+        uint32_t min_bytes = UINT32_MAX;
+        uint32_t max_bytes = 0;
+        double total_bytes = 0.0;
+        int num_cases = 0;
+        for( int i = 0 ; i < results.size() ; i++ ) {
+            if( results[i].cartesian_hands == (hand_mode == 1) ) {
+                min_bytes = std::min(min_bytes, results[i].num_bytes);
+                max_bytes = std::max(max_bytes, results[i].num_bytes);
+                total_bytes += results[i].num_bytes;
+                num_cases++;
+            }
+        }
+        std::cout << "[Size Benchmark] " << (hand_mode == 1 ? "Cartesian" : "Jointspace") << " hands: "
+                  << min_bytes << " to " << max_bytes << " bytes (mean " << total_bytes / num_cases << "), "
+                  << "up to " << getBandwidthKBps(max_bytes, RATES[NUM_RATES - 1]) << " kB/s at "
+                  << RATES[NUM_RATES - 1] << " Hz" << std::endl;
+    }
+
+    // write CSV, if requested
+    if( !csv_filename.empty() ) {
+        std::ofstream csv_file(csv_filename.c_str());
+        csv_file << "link_mask,links,hands,bytes,build_us,serialize_us";
+        for( int r = 0 ; r < NUM_RATES ; r++ ) {
+            csv_file << ",kBps_" << static_cast<int>(RATES[r]) << "Hz";
+        }
+        csv_file << std::endl;
+        for( int i = 0 ; i < results.size() ; i++ ) {
+            const SizeResult& result = results[i];
+            csv_file << result.link_mask << "," << getLinkSetName(result.link_mask) << ","
+                     << (result.cartesian_hands ? "cartesian" : "jointspace") << "," << result.num_bytes << ","
+                     << result.build_micros << "," << result.serialize_micros;
+            for( int r = 0 ; r < NUM_RATES ; r++ ) {
+                csv_file << "," << getBandwidthKBps(result.num_bytes, RATES[r]);
+            }
+            csv_file << std::endl;
+        }
+        std::cout << "[Size Benchmark] Wrote results to " << csv_filename << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,112 @@
+/**
+ * Shared Utilities for IHMC Message Tests
+ * Emily Sheetz, NSTGRO VTE 2021
+ **/
+
+#ifndef _IHMC_MSG_TEST_UTILITIES_H_
+#define _IHMC_MSG_TEST_UTILITIES_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+#include <ros/serialization.h>
+#include <ihmc_utils/ihmc_msg_utilities.h>
+
+namespace IHMCMsgTestUtils {
+
+    // TIMESTAMPS
+    inline void clearTimestamps(controller_msgs::WholeBodyTrajectoryMessage& msg) {
+        // creation timestamps come from the wall clock, so they can never match between builders
+        msg.left_hand_trajectory_message.se3_trajectory.queueing_properties.timestamp = 0;
+        msg.right_hand_trajectory_message.se3_trajectory.queueing_properties.timestamp = 0;
+        msg.left_arm_trajectory_message.jointspace_trajectory.queueing_properties.timestamp = 0;
+        msg.right_arm_trajectory_message.jointspace_trajectory.queueing_properties.timestamp = 0;
+        msg.chest_trajectory_message.so3_trajectory.queueing_properties.timestamp = 0;
+        msg.spine_trajectory_message.jointspace_trajectory.queueing_properties.timestamp = 0;
+        msg.pelvis_trajectory_message.se3_trajectory.queueing_properties.timestamp = 0;
+        msg.left_foot_trajectory_message.se3_trajectory.queueing_properties.timestamp = 0;
+        msg.right_foot_trajectory_message.se3_trajectory.queueing_properties.timestamp = 0;
+        msg.neck_trajectory_message.jointspace_trajectory.queueing_properties.timestamp = 0;
+        msg.head_trajectory_message.so3_trajectory.queueing_properties.timestamp = 0;
+        return;
+    }
+
+    inline void clearTimestamps(controller_msgs::GoHomeMessage& msg) {
+        // go home messages have no timestamps
+        return;
+    }
+
+    inline void clearTimestamps(controller_msgs::ValkyrieHandFingerTrajectoryMessage& msg) {
+        msg.jointspace_trajectory.queueing_properties.timestamp = 0;
+        return;
+    }
+
+    inline void clearTimestamps(controller_msgs::QueueableMessage& msg) {
+        msg.timestamp = 0;
+        return;
+    }
+
+    inline void clearTimestamps(controller_msgs::SE3TrajectoryMessage& msg) {
+        msg.queueing_properties.timestamp = 0;
+        return;
+    }
+
+    inline void clearTimestamps(controller_msgs::SO3TrajectoryMessage& msg) {
+        msg.queueing_properties.timestamp = 0;
+        return;
+    }
+
+    inline void clearTimestamps(controller_msgs::JointspaceTrajectoryMessage& msg) {
+        msg.queueing_properties.timestamp = 0;
+        return;
+    }
+
+    // JOINTS
+    inline void getActuatedJointNames(std::vector<std::string>& names) {
+        // actuated joints in configuration order, as sent by controllers
+        names.assign(valkyrie::num_act_joint, std::string());
+        for( std::map<std::string, int>::iterator it = val::joint_names_to_indices.begin() ; it != val::joint_names_to_indices.end() ; ++it ) {
+            int jidx = it->second - valkyrie::num_virtual;
+            if( (jidx >= 0) && (jidx < valkyrie::num_act_joint) ) {
+                names[jidx] = it->first;
+            }
+        }
+        return;
+    }
+
+    inline void getTrackedJointIndices(std::vector<int>& joint_indices) {
+        // arm and neck joints tracked by the mock endpoint, in its order
+        std::vector<int> larm_joint_indices;
+        std::vector<int> rarm_joint_indices;
+        std::vector<int> neck_joint_indices;
+        IHMCMsgUtils::getRelevantJointIndicesLeftArm(larm_joint_indices);
+        IHMCMsgUtils::getRelevantJointIndicesRightArm(rarm_joint_indices);
+        IHMCMsgUtils::getRelevantJointIndicesNeck(neck_joint_indices);
+        std::vector<int> part_indices = larm_joint_indices;
+        part_indices.insert(part_indices.end(), rarm_joint_indices.begin(), rarm_joint_indices.end());
+        part_indices.insert(part_indices.end(), neck_joint_indices.begin(), neck_joint_indices.end());
+
+        // special index -1 (wrist joints) is not in valkyrie definition
+        joint_indices.clear();
+        for( int i = 0 ; i < part_indices.size() ; i++ ) {
+            if( part_indices[i] != -1 ) {
+                joint_indices.push_back(part_indices[i]);
+            }
+        }
+        return;
+    }
+
+    // SERIALIZATION
+    template <class M>
+    inline void serializeToBuffer(const M& msg, std::vector<uint8_t>& buffer) {
+        uint32_t length = ros::serialization::serializationLength(msg);
+        buffer.resize(length);
+        ros::serialization::OStream stream(buffer.data(), length);
+        ros::serialization::serialize(stream, msg);
+        return;
+    }
+
+} // end namespace IHMCMsgTestUtils
+
+#endif
@@ -4,8 +4,22 @@
 
 /*
  * Executable for testing IHMC Message Utilities.
- * [TODO brief description of tests]
+ * Checks that reference frame names map to the frame ids IHMC knows: world and pelvis map to their fixed ids,
+ * IHMC frame name ids are hashed, and any other name (e.g., ROS frame names) falls back to the world frame.
  */
+bool testReferenceFrameId(const std::string& frame_name, int expected_id) {
+    IHMCMsgUtils::IHMCMessageParameters msg_params;
+    int trajectory_reference_frame_id;
+    int data_reference_frame_id;
+    IHMCMsgUtils::getReferenceFrameIds(frame_name, trajectory_reference_frame_id, data_reference_frame_id, msg_params);
+
+    bool passed = (trajectory_reference_frame_id == expected_id) && (data_reference_frame_id == expected_id);
+    std::cout << "[Test] Reference frame " << frame_name << ": id " << trajectory_reference_frame_id
+              << (passed ? "" : "  FAILED") << std::endl;
+
+    return passed;
+}
+
 int main(int argc, char **argv) {
     std::cout << "Hello world!" << std::endl;
 
@@ -13,5 +27,22 @@ int main(int argc, char **argv) {
 
     IHMCMsgUtils::testFunction();
 
-    return 0;
+    // frames with fixed ids
+    bool passed = true;
+    passed = testReferenceFrameId("world", IHMCMsgUtils::IHMC_WORLD_FRAME_ID) && passed;
+    passed = testReferenceFrameId("pelvis", IHMCMsgUtils::IHMC_PELVIS_ZUP_FRAME_ID) && passed;
+
+    // IHMC frame name ids are hashed
+    passed = testReferenceFrameId("World", IHMCMsgUtils::IHMC_WORLD_FRAME_ID) && passed;
+    passed = testReferenceFrameId("World:pelvis", IHMCMsgUtils::hashIHMCChildFrameNameId("World", "pelvis")) && passed;
+
+    // ROS frame names and partial name ids are not IHMC frames, so they fall back to world
+    passed = testReferenceFrameId("/world", IHMCMsgUtils::IHMC_WORLD_FRAME_ID) && passed;
+    passed = testReferenceFrameId("torso", IHMCMsgUtils::IHMC_WORLD_FRAME_ID) && passed;
+    passed = testReferenceFrameId("leftPalm", IHMCMsgUtils::IHMC_WORLD_FRAME_ID) && passed;
+    passed = testReferenceFrameId("WorldFrame", IHMCMsgUtils::IHMC_WORLD_FRAME_ID) && passed;
+
+    std::cout << "[Test] " << (passed ? "PASSED" : "FAILED") << std::endl;
+
+    return passed ? 0 : 1;
 }
@@ -0,0 +1,287 @@
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <cmath>
+#include <ctime>
+
+#include <ros/serialization.h>
+#include <ihmc_utils/ihmc_command_streamer.h>
+#include <ihmc_tests/ihmc_msg_test_utilities.h>
+
+/*
+ * Throughput scaling benchmark for the IHMC Interface Node.
+ * Runs the node's core (IHMCCommandStreamer) in-process in real time, with the same cycle timing as the node's main
+ * loop: each cycle a synthetic controller delivers a joint command and pelvis transform (and hand poses, with Cartesian
+ * hand goals) through the node's callbacks, the streamer updates, and every built message is serialized by a sink as
+ * roscpp would on publishing.  Sweeps stream rate from 10 Hz to 1 kHz, the number of controlled links, and jointspace
+ * versus Cartesian hand goals.  For each point, reports the achieved publish rate, thread CPU time per published
+ * message, busy time per cycle (and the highest rate it could sustain), and deadline misses (cycles whose work finished
+ * after the next cycle should have started), then the rate at which each setting saturates.
+ *
+ * usage: ihmc_node_throughput_benchmark [--duration S] [--max-rate HZ] [--csv FILE]
+ */
+
+// EXPERIMENT GRID
+const std::vector<double> RATES{10.0, 20.0, 50.0, 100.0, 200.0, 500.0, 1000.0};
+// nested sets of controlled links; with Cartesian hand goals, palms are sent as hand poses instead of joint commands
+const std::vector<std::vector<int> > LINK_SETS{
+    {valkyrie_link::head},
+    {valkyrie_link::head, valkyrie_link::rightPalm, valkyrie_link::leftPalm},
+    {valkyrie_link::head, valkyrie_link::rightPalm, valkyrie_link::leftPalm, valkyrie_link::pelvis, valkyrie_link::torso},
+    {valkyrie_link::head, valkyrie_link::rightPalm, valkyrie_link::leftPalm, valkyrie_link::pelvis, valkyrie_link::torso,
+     valkyrie_link::rightCOP_Frame, valkyrie_link::leftCOP_Frame}};
+const int MIN_CYCLES = 20;
+
+// SATURATION: achieved rate below this fraction of stream rate, or deadline misses in more than this fraction of cycles;
+// a setting saturates at the lowest rate from which all higher rates are saturated, so single late wakeups are not counted
+const double SATURATION_RATE_FRACTION = 0.9;
+const double SATURATION_MISS_FRACTION = 0.01;
+
+// STRUCT FOR ONE POINT AND ITS RESULT
+struct ThroughputPoint {
+    double rate;
+    int link_set;
+    bool cartesian_hands;
+
+    long num_cycles = 0;
+    long num_messages = 0;
+    long num_bytes = 0;
+    long num_deadline_misses = 0;
+    double publish_rate = 0.0; // messages per second
+    double cpu_micros_per_msg = 0.0;
+    double mean_busy_micros = 0.0; // work per cycle
+    double max_busy_micros = 0.0;
+};
+
+// TIMING
+double getThreadCPUTime() {
+    // CPU time (s) used by this thread
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// SYNTHETIC CONTROLLER
+struct SyntheticController {
+    sensor_msgs::JointState js_msg;
+    geometry_msgs::TransformStamped pelvis_msg;
+    geometry_msgs::TransformStamped left_hand_msg;
+    geometry_msgs::TransformStamped right_hand_msg;
+
+    SyntheticController() {
+        IHMCMsgTestUtils::getActuatedJointNames(js_msg.name);
+        js_msg.position.assign(valkyrie::num_act_joint, 0.0);
+        pelvis_msg.header.frame_id = "world";
+        pelvis_msg.child_frame_id = "pelvis";
+        left_hand_msg.header.frame_id = "world";
+        left_hand_msg.child_frame_id = "leftPalm";
+        right_hand_msg.header.frame_id = "world";
+        right_hand_msg.child_frame_id = "rightPalm";
+    }
+
+    void step(double t) {
+        // slow sinusoids on each joint, pelvis sway, and hands moving in circles
+        for( int i = 0 ; i < js_msg.position.size() ; i++ ) {
+            js_msg.position[i] = 0.3 * std::sin(2.0 * M_PI * 0.5 * t + 0.2 * i);
+        }
+        pelvis_msg.transform.translation.y = 0.03 * std::sin(2.0 * M_PI * 0.25 * t);
+        pelvis_msg.transform.translation.z = 1.0;
+        pelvis_msg.transform.rotation.w = 1.0;
+        left_hand_msg.transform.translation.x = 0.5 + 0.05 * std::cos(2.0 * M_PI * 0.5 * t);
+        left_hand_msg.transform.translation.y = 0.3;
+        left_hand_msg.transform.translation.z = 1.0 + 0.05 * std::sin(2.0 * M_PI * 0.5 * t);
+        left_hand_msg.transform.rotation.w = 1.0;
+        right_hand_msg.transform = left_hand_msg.transform;
+        right_hand_msg.transform.translation.y = -0.3;
+        return;
+    }
+};
+
+// EXPERIMENT
+void runPoint(double duration, ThroughputPoint& point) {
+    // streamer as configured by the IHMC Interface Node with commands from controllers
+    IHMCMsgUtils::IHMCCommandStreamer streamer(true);
+    streamer.setVerbose(false);
+
+    // sink serializes each message into a reused buffer, as roscpp does when publishing
+    std::vector<uint8_t> buffer;
+    streamer.setWholeBodyMessageSink([&](const controller_msgs::WholeBodyTrajectoryMessage& msg) {
+        uint32_t length = ros::serialization::serializationLength(msg);
+        buffer.resize(length);
+        ros::serialization::OStream stream(buffer.data(), length);
+        ros::serialization::serialize(stream, msg);
+        point.num_messages++;
+        point.num_bytes += length;
+    });
+
+    // controller starts streaming; palms are sent as hand poses with Cartesian hand goals
+    std_msgs::String status_msg;
+    status_msg.data = "START-LISTENING";
+    streamer.processStatus(status_msg);
+    std_msgs::Int32MultiArray links_msg;
+    for( int i = 0 ; i < LINK_SETS[point.link_set].size() ; i++ ) {
+        int link = LINK_SETS[point.link_set][i];
+        if( !point.cartesian_hands || ((link != valkyrie_link::rightPalm) && (link != valkyrie_link::leftPalm)) ) {
+            links_msg.data.push_back(link);
+        }
+    }
+    bool send_hand_goals = point.cartesian_hands && (links_msg.data.size() < LINK_SETS[point.link_set].size());
+    streamer.processControlledLinkIds(links_msg);
+    std_msgs::Bool cartesian_msg;
+    cartesian_msg.data = send_hand_goals;
+    streamer.processReceiveCartesianGoals(cartesian_msg);
+
+    // run in real time at stream rate, with the cycle timing of the IHMC Interface Node main loop
+    SyntheticController controller;
+    std::chrono::steady_clock::duration cycle_time = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(1.0 / point.rate));
+    long num_cycles = std::max(static_cast<long>(MIN_CYCLES), static_cast<long>(std::ceil(duration * point.rate)));
+    double total_busy_micros = 0.0;
+    double cpu_start = getThreadCPUTime();
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point next_cycle = start + cycle_time;
+    for( long c = 0 ; c < num_cycles ; c++ ) {
+        std::chrono::steady_clock::time_point cycle_start = std::chrono::steady_clock::now();
+
+        // controller inputs arrive through node callbacks, then messages are built and published
+        controller.step(std::chrono::duration<double>(cycle_start - start).count());
+        streamer.processJointCommand(controller.js_msg);
+        streamer.processPelvisTransform(controller.pelvis_msg);
+        if( send_hand_goals ) {
+            streamer.processHandPoseCommand(controller.left_hand_msg);
+            streamer.processHandPoseCommand(controller.right_hand_msg);
+        }
+        streamer.update();
+
+        // work must finish before next cycle starts
+        std::chrono::steady_clock::time_point cycle_end = std::chrono::steady_clock::now();
+        double busy_micros = std::chrono::duration<double, std::micro>(cycle_end - cycle_start).count();
+        total_busy_micros += busy_micros;
+        point.max_busy_micros = std::max(point.max_busy_micros, busy_micros);
+        if( cycle_end > next_cycle ) {
+            point.num_deadline_misses++;
+        }
+
+        // wait for next cycle; fell behind, restart cycle timing from now
+        std::this_thread::sleep_until(next_cycle);
+        next_cycle += cycle_time;
+        if( next_cycle < std::chrono::steady_clock::now() ) {
+            next_cycle = std::chrono::steady_clock::now() + cycle_time;
+        }
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double cpu_time = getThreadCPUTime() - cpu_start;
+
+    point.num_cycles = num_cycles;
+    point.publish_rate = point.num_messages / elapsed;
+    point.cpu_micros_per_msg = (point.num_messages > 0) ? (cpu_time * 1e6 / point.num_messages) : 0.0;
+    point.mean_busy_micros = total_busy_micros / num_cycles;
+
+    return;
+}
+
+bool isSaturated(const ThroughputPoint& point) {
+    // messages per cycle depends on controlled links and hand goals, so compare cycles completed at stream rate
+    double messages_per_cycle = static_cast<double>(point.num_messages) / point.num_cycles;
+    return (point.num_deadline_misses > SATURATION_MISS_FRACTION * point.num_cycles) ||
+           (point.publish_rate < SATURATION_RATE_FRACTION * point.rate * messages_per_cycle);
+}
+
+int main(int argc, char **argv) {
+    // default benchmark settings
+    double duration = 1.0;
+    double max_rate = 1000.0;
+    std::string csv_filename;
+
+    // parse arguments
+    for( int i = 1 ; i + 1 < argc ; i += 2 ) {
+        std::string arg(argv[i]);
+        if( arg == "--duration" ) { duration = std::max(0.1, std::stod(argv[i+1])); }
+        else if( arg == "--max-rate" ) { max_rate = std::max(RATES.front(), std::stod(argv[i+1])); }
+        else if( arg == "--csv" ) { csv_filename = std::string(argv[i+1]); }
+        else { std::cout << "[Throughput Benchmark] Unrecognized argument " << arg << std::endl; return 1; }
+    }
+
+    // run every point in real time, one at a time
+    std::vector<ThroughputPoint> points;
+    for( int hand_mode = 0 ; hand_mode < 2 ; hand_mode++ ) {
+        for( int s = 0 ; s < LINK_SETS.size() ; s++ ) {
+            for( int r = 0 ; (r < RATES.size()) && (RATES[r] <= max_rate) ; r++ ) {
+                ThroughputPoint point;
+                point.rate = RATES[r];
+                point.link_set = s;
+                point.cartesian_hands = (hand_mode == 1);
+                points.push_back(point);
+            }
+        }
+    }
+    std::cout << "[Throughput Benchmark] Running " << points.size() << " points, at least " << duration
+              << " s each" << std::endl;
+    for( int i = 0 ; i < points.size() ; i++ ) {
+        runPoint(duration, points[i]);
+    }
+
+    // report each point
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << std::left << std::setw(12) << "hands" << std::right << std::setw(7) << "links" << std::setw(9) << "rate Hz"
+              << std::setw(12) << "publish Hz" << std::setw(12) << "cpu us/msg" << std::setw(12) << "busy us"
+              << std::setw(12) << "max busy us" << std::setw(13) << "max rate Hz" << std::setw(9) << "misses" << std::endl;
+    for( int i = 0 ; i < points.size() ; i++ ) {
+        const ThroughputPoint& point = points[i];
+        std::cout << std::left << std::setw(12) << (point.cartesian_hands ? "cartesian" : "jointspace") << std::right
+                  << std::setw(7) << LINK_SETS[point.link_set].size() << std::setw(9) << point.rate
+                  << std::setw(12) << point.publish_rate << std::setw(12) << point.cpu_micros_per_msg
+                  << std::setw(12) << point.mean_busy_micros << std::setw(12) << point.max_busy_micros
+                  << std::setw(13) << 1e6 / point.mean_busy_micros << std::setw(9) << point.num_deadline_misses
+                  << (isSaturated(point) ? "  saturated" : "") << std::endl;
+    }
+
+    // summarize where each setting saturates
+    for( int hand_mode = 0 ; hand_mode < 2 ; hand_mode++ ) {
+        for( int s = 0 ; s < LINK_SETS.size() ; s++ ) {
+            double saturation_rate = 0.0;
+            double max_sustainable_rate = 0.0;
+            for( int i = 0 ; i < points.size() ; i++ ) {
+                const ThroughputPoint& point = points[i];
+                if( (point.cartesian_hands != (hand_mode == 1)) || (point.link_set != s) ) {
+                    continue;
+                }
+                if( !isSaturated(point) ) {
+                    saturation_rate = 0.0;
+                }
+                else if( saturation_rate == 0.0 ) {
+                    saturation_rate = point.rate;
+                }
+                max_sustainable_rate = std::max(max_sustainable_rate, 1e6 / point.mean_busy_micros);
+            }
+            std::cout << "[Throughput Benchmark] " << (hand_mode == 1 ? "Cartesian" : "Jointspace") << " hands, "
+                      << LINK_SETS[s].size() << " links: ";
+            if( saturation_rate > 0.0 ) {
+                std::cout << "saturates at " << saturation_rate << " Hz";
+            }
+            else {
+                std::cout << "no saturation up to " << max_rate << " Hz";
+            }
+            std::cout << " (busy time allows up to " << max_sustainable_rate << " Hz)" << std::endl;
+        }
+    }
+
+    // write every point
+    if( !csv_filename.empty() ) {
+        std::ofstream csv_file(csv_filename.c_str());
+        csv_file << "hands,links,rate,cycles,messages,bytes,publish_rate,cpu_us_per_msg,mean_busy_us,max_busy_us,deadline_misses,saturated" << std::endl;
+        for( int i = 0 ; i < points.size() ; i++ ) {
+            const ThroughputPoint& point = points[i];
+            csv_file << (point.cartesian_hands ? "cartesian" : "jointspace") << "," << LINK_SETS[point.link_set].size() << ","
+                     << point.rate << "," << point.num_cycles << "," << point.num_messages << "," << point.num_bytes << ","
+                     << point.publish_rate << "," << point.cpu_micros_per_msg << "," << point.mean_busy_micros << ","
+                     << point.max_busy_micros << "," << point.num_deadline_misses << "," << (isSaturated(point) ? 1 : 0) << std::endl;
+        }
+        std::cout << "[Throughput Benchmark] Wrote results to " << csv_filename << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,103 @@
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <cmath>
+
+#include <ihmc_utils/ihmc_pose_library.h>
+
+/*
+ * Test for reading pose library files.
+ * Writes pose library files with valid and malformed lines, loads them, and checks which poses are kept:
+ * poses completed before a malformed line are kept with the configuration they were given, and the pose
+ * being read when the malformed line is found is discarded, so it can never be sent half-read.
+ *
+ * usage: ihmc_pose_library_test
+ */
+
+const char* TEST_FILENAME = "/tmp/ihmc_pose_library_test.txt";
+
+// pose that is always complete before the line under test
+const std::string COMPLETE_POSE = "pose ready 2.0\n"
+                                  "rightShoulderPitch -0.2\n"
+                                  "leftShoulderPitch -0.2\n";
+
+bool testLoad(const std::string& description, const std::string& contents,
+              bool expected_loaded, const std::vector<std::string>& expected_poses) {
+    // write pose library file
+    std::ofstream file(TEST_FILENAME);
+    file << contents;
+    file.close();
+
+    IHMCMsgUtils::IHMCPoseLibrary library;
+    bool loaded = library.load(TEST_FILENAME);
+    std::remove(TEST_FILENAME);
+
+    // only expected poses are in library
+    bool passed = (loaded == expected_loaded) && (library.getNumPoses() == expected_poses.size());
+    for( int i = 0 ; i < expected_poses.size() ; i++ ) {
+        passed = passed && (library.getPose(expected_poses[i]) != nullptr);
+    }
+
+    // complete pose keeps the joint positions it was given
+    const IHMCMsgUtils::IHMCPoseLibrary::Pose* ready = library.getPose("ready");
+    if( ready != nullptr ) {
+        int jidx = val::joint_names_to_indices["rightShoulderPitch"];
+        passed = passed && (std::fabs(ready->q[jidx] + 0.2) < 1e-12) && (std::fabs(ready->trajectory_time - 2.0) < 1e-12);
+    }
+
+    std::cout << "[Pose Library Test] " << description << ": loaded " << (loaded ? "true" : "false")
+              << ", " << library.getNumPoses() << " poses" << (passed ? "" : "  FAILED") << std::endl;
+
+    return passed;
+}
+
+int main(int argc, char **argv) {
+    std::cout << "[Pose Library Test] Testing pose library parser" << std::endl;
+
+    bool passed = true;
+
+    // valid files
+    passed = testLoad("valid", "# comment\n" + COMPLETE_POSE +
+                      "pose stow 3.0\n"
+                      "pelvis 0 0 1 0 0 0 1\n"
+                      "links pelvis torso\n"
+                      "torsoYaw 0.1\n",
+                      true, {"ready", "stow"}) && passed;
+    passed = testLoad("empty", "", true, {}) && passed;
+
+    // malformed lines in pose being read; pose is discarded, complete pose before it is kept
+    passed = testLoad("bad joint position", COMPLETE_POSE +
+                      "pose reach 2.0\n"
+                      "rightShoulderPitch 0.5\n"
+                      "rightElbowPitch abc\n"
+                      "leftElbowPitch 0.5\n",
+                      false, {"ready"}) && passed;
+    passed = testLoad("unknown joint", COMPLETE_POSE +
+                      "pose reach 2.0\n"
+                      "rightShoulderPitch 0.5\n"
+                      "rightElbow 0.5\n",
+                      false, {"ready"}) && passed;
+    passed = testLoad("short pelvis", COMPLETE_POSE +
+                      "pose reach 2.0\n"
+                      "pelvis 0 0 1\n",
+                      false, {"ready"}) && passed;
+    passed = testLoad("unknown link", COMPLETE_POSE +
+                      "pose reach 2.0\n"
+                      "links torso rightHand\n",
+                      false, {"ready"}) && passed;
+
+    // malformed pose headers
+    passed = testLoad("negative trajectory time", COMPLETE_POSE +
+                      "pose reach -1.0\n"
+                      "rightShoulderPitch 0.5\n",
+                      false, {"ready"}) && passed;
+    passed = testLoad("missing trajectory time", COMPLETE_POSE +
+                      "pose reach\n",
+                      false, {"ready"}) && passed;
+    passed = testLoad("joint before pose", "rightShoulderPitch 0.5\n" + COMPLETE_POSE,
+                      false, {}) && passed;
+
+    std::cout << "[Pose Library Test] " << (passed ? "PASSED" : "FAILED") << std::endl;
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,398 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <map>
+#include <algorithm>
+#include <chrono>
+#include <dirent.h>
+
+#include <ihmc_utils/ihmc_command_streamer.h>
+#include <ihmc_utils/ihmc_input_log.h>
+#include <ihmc_tests/ihmc_msg_test_utilities.h>
+
+/*
+ * Parallel replay farm for recorded IHMC Interface Node sessions.
+ * Replays every input capture log in a directory through its own IHMCCommandStreamer, one session at a time per worker,
+ * with simulated time: inputs are processed at their recorded times and the streaming loop runs at the node's rate,
+ * so sessions replay as fast as the streamer can process them.  Outputs are digested (serialized bytes, with creation
+ * timestamps cleared) and compared against a baseline of digests from a previous run.
+ *
+ * usage: ihmc_replay_farm --sessions DIR [--threads N] [--rate HZ] [--controllers 0|1]
+ *                         [--baseline FILE] [--write-baseline FILE] [--report FILE]
+ *   --sessions DIR, directory of input capture logs (*.ilog)
+ *   --rate HZ, rate of streaming loop in simulated time (default 10, same as node)
+ *   --controllers 0|1, whether sessions were recorded with commands from controllers (default 1)
+ *   --baseline FILE, compare output digests against a baseline written by --write-baseline
+ *   --report FILE, also write report to file
+ */
+
+// LATENCY HISTOGRAM
+// log-linear buckets (8 per power of two) keep memory fixed for arbitrarily long sessions and merge across workers
+class LatencyHistogram
+{
+public:
+    LatencyHistogram() : counts_(64*8, 0), count_(0), total_(0), max_(0) {}
+
+    void add(int64_t ns) {
+        uint64_t value = (ns > 0) ? ns : 0;
+        counts_[bucket(value)]++;
+        count_++;
+        total_ += value;
+        max_ = std::max(max_, value);
+        return;
+    }
+
+    void merge(const LatencyHistogram& other) {
+        for( int i = 0 ; i < counts_.size() ; i++ ) {
+            counts_[i] += other.counts_[i];
+        }
+        count_ += other.count_;
+        total_ += other.total_;
+        max_ = std::max(max_, other.max_);
+        return;
+    }
+
+    // upper bound of bucket containing requested percentile
+    double percentileMicros(double p) const {
+        uint64_t target = static_cast<uint64_t>(p * count_);
+        uint64_t seen = 0;
+        for( int i = 0 ; i < counts_.size() ; i++ ) {
+            seen += counts_[i];
+            if( seen > target ) {
+                return std::min(bucketUpperBound(i), max_) / 1000.0;
+            }
+        }
+        return max_ / 1000.0;
+    }
+
+    double meanMicros() const { return (count_ > 0) ? (static_cast<double>(total_) / count_) / 1000.0 : 0.0; }
+    double maxMicros() const { return max_ / 1000.0; }
+    uint64_t count() const { return count_; }
+
+private:
+    static int bucket(uint64_t value) {
+        if( value < 8 ) {
+            return value;
+        }
+        int exponent = 63 - __builtin_clzll(value);
+        int sub_bucket = (value >> (exponent - 3)) & 7;
+        return (exponent - 2) * 8 + sub_bucket;
+    }
+
+    static uint64_t bucketUpperBound(int idx) {
+        if( idx < 8 ) {
+            return idx;
+        }
+        int exponent = idx / 8 + 2;
+        uint64_t sub_bucket = idx % 8;
+        return ((8 + sub_bucket + 1) << (exponent - 3)) - 1;
+    }
+
+    std::vector<uint64_t> counts_;
+    uint64_t count_;
+    uint64_t total_;
+    uint64_t max_;
+};
+
+// STRUCT FOR ONE SESSION RESULT
+struct SessionResult {
+    std::string name;
+    bool ok = false;
+    long num_inputs = 0;
+    long num_updates = 0;
+    long num_outputs = 0;
+    double sim_seconds = 0.0;
+    double wall_seconds = 0.0;
+    uint64_t digest = 14695981039346656037ull; // FNV-1a offset basis
+    LatencyHistogram input_latency;
+    LatencyHistogram update_latency;
+};
+
+// DIGEST
+void digestBytes(uint64_t& digest, const uint8_t* data, size_t len) {
+    // FNV-1a; order of outputs matters, so any reordering changes the digest
+    for( size_t i = 0 ; i < len ; i++ ) {
+        digest ^= data[i];
+        digest *= 1099511628211ull;
+    }
+    return;
+}
+
+template <class M>
+void digestMessage(SessionResult& result, uint8_t type_tag, M msg, std::vector<uint8_t>& buffer) {
+    // creation timestamps come from the wall clock, so they never match between runs
+    IHMCMsgTestUtils::clearTimestamps(msg);
+    IHMCMsgTestUtils::serializeToBuffer(msg, buffer);
+    digestBytes(result.digest, &type_tag, 1);
+    digestBytes(result.digest, buffer.data(), buffer.size());
+    result.num_outputs++;
+    return;
+}
+
+// REPLAY
+void replaySession(const std::string& filename, double rate, bool commands_from_controllers, SessionResult& result) {
+    IHMCMsgUtils::IHMCInputLogReader reader;
+    if( !reader.open(filename) ) {
+        return;
+    }
+
+    // isolated streamer for this session; simulated time drives its clock
+    int64_t sim_time = 0;
+    std::vector<uint8_t> buffer;
+    IHMCMsgUtils::IHMCCommandStreamer streamer(commands_from_controllers);
+    streamer.setVerbose(false);
+    streamer.setClock([&sim_time]() { return sim_time; });
+    streamer.setWholeBodyMessageSink([&](const controller_msgs::WholeBodyTrajectoryMessage& msg) { digestMessage(result, 0, msg, buffer); });
+    streamer.setGoHomeMessageSink([&](const controller_msgs::GoHomeMessage& msg) { digestMessage(result, 1, msg, buffer); });
+    streamer.setHandFingerMessageSink([&](const controller_msgs::ValkyrieHandFingerTrajectoryMessage& msg) { digestMessage(result, 2, msg, buffer); });
+
+    auto wall_start = std::chrono::steady_clock::now();
+    int64_t tick_period = static_cast<int64_t>(1e9 / rate);
+    int64_t first_time = 0;
+    int64_t next_tick = 0;
+    bool running = true;
+    IHMCMsgUtils::IHMCInputLogRecord record;
+    while( running && reader.readNext(record) ) {
+        if( result.num_inputs == 0 ) {
+            // streaming loop starts with first input
+            first_time = record.timestamp;
+            next_tick = first_time + tick_period;
+        }
+
+        // run every loop cycle that would have happened before this input arrived
+        while( running && record.timestamp >= next_tick ) {
+            sim_time = next_tick;
+            auto t0 = std::chrono::steady_clock::now();
+            running = streamer.update();
+            result.update_latency.add(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count());
+            result.num_updates++;
+            next_tick += tick_period;
+        }
+        if( !running ) {
+            break;
+        }
+
+        // process input at its recorded time
+        sim_time = record.timestamp;
+        auto t0 = std::chrono::steady_clock::now();
+        streamer.processInputLogRecord(record);
+        result.input_latency.add(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count());
+        result.num_inputs++;
+    }
+
+    // one more loop cycle publishes anything made ready by the last input
+    if( running && result.num_inputs > 0 ) {
+        sim_time = next_tick;
+        auto t0 = std::chrono::steady_clock::now();
+        streamer.update();
+        result.update_latency.add(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count());
+        result.num_updates++;
+    }
+
+    result.sim_seconds = (sim_time - first_time) / 1e9;
+    result.wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+    // truncated or corrupt logs do not count as replayed, even if the inputs before the damage were replayed;
+    // a streamer that stops (single message when not from controllers) leaves the rest of the log unread
+    result.ok = !running || reader.readToCleanEnd();
+
+    return;
+}
+
+// SESSIONS AND BASELINES
+bool listSessions(const std::string& dirname, std::vector<std::string>& sessions) {
+    DIR* dir = opendir(dirname.c_str());
+    if( dir == nullptr ) {
+        std::cout << "[Replay Farm] Could not open session directory " << dirname << std::endl;
+        return false;
+    }
+    struct dirent* entry;
+    while( (entry = readdir(dir)) != nullptr ) {
+        std::string name(entry->d_name);
+        if( name.size() > 5 && name.compare(name.size() - 5, 5, ".ilog") == 0 ) {
+            sessions.push_back(name);
+        }
+    }
+    closedir(dir);
+
+    // sorted so reports and baselines are stable
+    std::sort(sessions.begin(), sessions.end());
+
+    return true;
+}
+
+bool loadBaseline(const std::string& filename, std::map<std::string, std::pair<uint64_t, long>>& baseline) {
+    std::ifstream file(filename.c_str());
+    if( !file.is_open() ) {
+        std::cout << "[Replay Farm] Could not open baseline file " << filename << std::endl;
+        return false;
+    }
+
+    // each line: session name, output digest (hex), number of outputs
+    std::string line;
+    while( std::getline(file, line) ) {
+        std::istringstream ss(line);
+        std::string name;
+        uint64_t digest;
+        long num_outputs;
+        if( ss >> name >> std::hex >> digest >> std::dec >> num_outputs ) {
+            baseline[name] = std::make_pair(digest, num_outputs);
+        }
+    }
+
+    return true;
+}
+
+int main(int argc, char **argv) {
+    // default farm settings
+    std::string sessions_dirname;
+    int num_threads = std::max(1u, std::thread::hardware_concurrency());
+    double rate = 10.0;
+    bool commands_from_controllers = true;
+    std::string baseline_filename;
+    std::string write_baseline_filename;
+    std::string report_filename;
+
+    // parse arguments
+    for( int i = 1 ; i + 1 < argc ; i += 2 ) {
+        std::string arg(argv[i]);
+        if( arg == "--sessions" ) { sessions_dirname = std::string(argv[i+1]); }
+        else if( arg == "--threads" ) { num_threads = std::max(1, std::stoi(argv[i+1])); }
+        else if( arg == "--rate" ) { rate = std::stod(argv[i+1]); }
+        else if( arg == "--controllers" ) { commands_from_controllers = (std::stoi(argv[i+1]) != 0); }
+        else if( arg == "--baseline" ) { baseline_filename = std::string(argv[i+1]); }
+        else if( arg == "--write-baseline" ) { write_baseline_filename = std::string(argv[i+1]); }
+        else if( arg == "--report" ) { report_filename = std::string(argv[i+1]); }
+        else { std::cout << "[Replay Farm] Unrecognized argument " << arg << std::endl; return 1; }
+    }
+    if( sessions_dirname.empty() || rate <= 0.0 ) {
+        std::cout << "[Replay Farm] usage: ihmc_replay_farm --sessions DIR [--threads N] [--rate HZ] [--controllers 0|1] "
+                  << "[--baseline FILE] [--write-baseline FILE] [--report FILE]" << std::endl;
+        return 1;
+    }
+
+    // find sessions and baseline
+    std::vector<std::string> sessions;
+    if( !listSessions(sessions_dirname, sessions) ) {
+        return 1;
+    }
+    std::map<std::string, std::pair<uint64_t, long>> baseline;
+    if( !baseline_filename.empty() && !loadBaseline(baseline_filename, baseline) ) {
+        return 1;
+    }
+    std::cout << "[Replay Farm] Replaying " << sessions.size() << " sessions on " << num_threads << " threads" << std::endl;
+
+    // replay sessions across worker threads; each worker takes the next unclaimed session
+    std::vector<SessionResult> results(sessions.size());
+    std::atomic<int> next_session{0};
+    auto start_time = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for( int t = 0 ; t < num_threads ; t++ ) {
+        workers.push_back(std::thread([&]() {
+            int idx;
+            while( (idx = next_session++) < sessions.size() ) {
+                results[idx].name = sessions[idx];
+                replaySession(sessions_dirname + "/" + sessions[idx], rate, commands_from_controllers, results[idx]);
+            }
+        }));
+    }
+    for( int t = 0 ; t < workers.size() ; t++ ) {
+        workers[t].join();
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+
+    // build report
+    std::ostringstream report;
+    long total_inputs = 0;
+    long total_outputs = 0;
+    double total_sim_seconds = 0.0;
+    int num_failed = 0;
+    int num_matched = 0;
+    int num_mismatched = 0;
+    int num_new = 0;
+    LatencyHistogram input_latency;
+    LatencyHistogram update_latency;
+    report << std::fixed << std::setprecision(3);
+    for( int i = 0 ; i < results.size() ; i++ ) {
+        const SessionResult& result = results[i];
+        report << "[Replay Farm] " << result.name << ": ";
+        if( !result.ok ) {
+            report << "FAILED TO REPLAY" << std::endl;
+            num_failed++;
+            continue;
+        }
+
+        // check output digest against baseline
+        std::string equivalence("-");
+        if( !baseline_filename.empty() ) {
+            std::map<std::string, std::pair<uint64_t, long>>::iterator it = baseline.find(result.name);
+            if( it == baseline.end() ) {
+                equivalence = "NEW";
+                num_new++;
+            }
+            else if( it->second.first == result.digest && it->second.second == result.num_outputs ) {
+                equivalence = "MATCH";
+                num_matched++;
+            }
+            else {
+                equivalence = "MISMATCH";
+                num_mismatched++;
+            }
+        }
+
+        report << result.num_inputs << " inputs, " << result.num_outputs << " outputs, "
+               << result.sim_seconds << " s simulated in " << result.wall_seconds << " s, "
+               << "digest " << std::hex << result.digest << std::dec << ", " << equivalence << std::endl;
+
+        total_inputs += result.num_inputs;
+        total_outputs += result.num_outputs;
+        total_sim_seconds += result.sim_seconds;
+        input_latency.merge(result.input_latency);
+        update_latency.merge(result.update_latency);
+    }
+    report << "[Replay Farm] Sessions: " << sessions.size() << ", failed: " << num_failed
+           << ", inputs: " << total_inputs << ", outputs: " << total_outputs << std::endl;
+    report << "[Replay Farm] " << num_threads << " threads, " << elapsed << " s wall, "
+           << total_sim_seconds << " s simulated (" << (elapsed > 0.0 ? total_sim_seconds / elapsed : 0.0) << "x real time), "
+           << (elapsed > 0.0 ? total_inputs / elapsed : 0.0) << " inputs/s" << std::endl;
+    report << "[Replay Farm] Input latency (us): mean " << input_latency.meanMicros()
+           << ", p50 " << input_latency.percentileMicros(0.50) << ", p99 " << input_latency.percentileMicros(0.99)
+           << ", max " << input_latency.maxMicros() << std::endl;
+    report << "[Replay Farm] Update latency (us): mean " << update_latency.meanMicros()
+           << ", p50 " << update_latency.percentileMicros(0.50) << ", p99 " << update_latency.percentileMicros(0.99)
+           << ", max " << update_latency.maxMicros() << std::endl;
+    if( !baseline_filename.empty() ) {
+        report << "[Replay Farm] Output equivalence: " << num_matched << " match, "
+               << num_mismatched << " mismatch, " << num_new << " not in baseline" << std::endl;
+    }
+
+    std::cout << report.str();
+    if( !report_filename.empty() ) {
+        std::ofstream report_file(report_filename.c_str());
+        report_file << report.str();
+    }
+
+    // write baseline, if requested
+    if( !write_baseline_filename.empty() ) {
+        std::ofstream baseline_file(write_baseline_filename.c_str());
+        for( int i = 0 ; i < results.size() ; i++ ) {
+            if( results[i].ok ) {
+                baseline_file << results[i].name << " " << std::hex << results[i].digest << std::dec
+                              << " " << results[i].num_outputs << std::endl;
+            }
+        }
+        std::cout << "[Replay Farm] Wrote baseline to " << write_baseline_filename << std::endl;
+    }
+
+    if( num_failed > 0 || num_mismatched > 0 ) {
+        std::cout << "[Replay Farm] FAILED" << std::endl;
+        return 1;
+    }
+
+    std::cout << "[Replay Farm] PASSED" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,514 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <thread>
+#include <atomic>
+#include <deque>
+#include <algorithm>
+#include <cmath>
+#include <dirent.h>
+
+#include <ros/serialization.h>
+#include <ihmc_utils/ihmc_command_streamer.h>
+#include <ihmc_utils/ihmc_input_log.h>
+#include <ihmc_utils/ihmc_tracking_monitor.h>
+#include <ihmc_tests/ihmc_mock_endpoint.h>
+
+/*
+ * Offline auto-tuner for streaming parameters.
+ * Replays recorded sessions (input capture logs) through IHMCCommandStreamer, the same core as the IHMC Interface Node,
+ * for every candidate setting of stream rate, stream integration duration, command filter, and stream rate of the
+ * slowly changing body parts (pelvis and torso).  Streamed messages are delivered after a transport delay to a fresh
+ * IHMCMockEndpoint, which tracks them in simulated time.  Each setting is scored by tracking error of the arms, neck,
+ * and pelvis against the recorded (unfiltered) commands, bandwidth of whole-body messages, and end-to-end lag estimated
+ * by IHMCTrackingMonitor.  Settings and sessions are replayed in parallel, and the setting with the lowest tracking error
+ * within the bandwidth and latency budgets is written as a preset that can be loaded into the node's parameters.
+ *
+ * the mock endpoint does not track the chest, so the torso is tuned together with the pelvis
+ *
+ * usage: ihmc_stream_tuner --sessions DIR [--bandwidth-budget KBPS] [--latency-budget S] [--delay S]
+ *                          [--tracking-bandwidth WN] [--threads N] [--preset FILE] [--csv FILE]
+ *   --sessions DIR, directory of input capture logs (*.ilog), or a single log
+ *   --bandwidth-budget KBPS, maximum kB/s of whole-body messages (default 200)
+ *   --latency-budget S, maximum estimated lag (s) from command to robot (default 0.25)
+ *   --delay S, transport delay (s) between sending and receiving each message (default 0)
+ *   --tracking-bandwidth WN, natural frequency (rad/s) of mock endpoint tracking model (default 15)
+ *   --preset FILE, parameter preset to write (default ihmc_stream_preset.yaml)
+ *   --csv FILE, also write every setting and its score
+ */
+
+// SEARCH SPACE
+const std::vector<double> RATES{5.0, 10.0, 20.0, 50.0, 100.0};
+// stream integration durations, as multiples of the interval between messages
+const std::vector<double> INTEGRATION_MULTIPLIERS{1.0, 1.3, 2.0};
+// stream rates of pelvis and torso; 0 streams them in every message
+const std::vector<double> SLOW_PART_RATES{0.0, 2.0, 5.0};
+const std::vector<double> ONE_EURO_MIN_CUTOFFS{0.5, 1.0, 2.0};
+const std::vector<double> ONE_EURO_BETAS{0.1, 0.5};
+const std::vector<double> NATURAL_FREQUENCIES{10.0, 20.0, 40.0};
+
+// SIMULATION
+const double SIM_DT = 0.001;
+const int MEASUREMENT_STEPS = 10; // steps between measurements given to tracking monitor (100 Hz)
+const int ROS_FRAMING_BYTES = 4;
+
+// STRUCT FOR ONE SETTING AND ITS SCORE
+struct TunerSetting {
+    double rate;
+    double stream_integration_duration;
+    double slow_part_rate;
+    IHMCMsgUtils::IHMCCommandFilterParams filter_params;
+
+    // totals over all sessions
+    long num_messages = 0;
+    long num_bytes = 0;
+    double sim_seconds = 0.0;
+    double joint_sq_error = 0.0;
+    long num_joint_samples = 0;
+    double pelvis_sq_error = 0.0;
+    long num_pelvis_samples = 0;
+    double max_lag = 0.0; // worst estimated lag (s) over sessions
+
+    // score
+    double bandwidth = 0.0; // kB/s
+    double joint_rms_error = 0.0;
+    double pelvis_rms_error = 0.0;
+    bool within_budget = false;
+};
+
+// SESSIONS
+bool loadSessions(const std::string& path, std::vector<std::string>& names,
+                  std::vector<std::vector<IHMCMsgUtils::IHMCInputLogRecord>>& sessions) {
+    // single log or directory of logs
+    std::vector<std::string> filenames;
+    DIR* dir = opendir(path.c_str());
+    if( dir == nullptr ) {
+        filenames.push_back(path);
+    }
+    else {
+        struct dirent* entry;
+        while( (entry = readdir(dir)) != nullptr ) {
+            std::string name(entry->d_name);
+            if( name.size() > 5 && name.compare(name.size() - 5, 5, ".ilog") == 0 ) {
+                filenames.push_back(path + "/" + name);
+            }
+        }
+        closedir(dir);
+        std::sort(filenames.begin(), filenames.end());
+    }
+
+    // sessions are read once and shared read-only by every worker
+    for( int i = 0 ; i < filenames.size() ; i++ ) {
+        IHMCMsgUtils::IHMCInputLogReader reader;
+        if( !reader.open(filenames[i]) ) {
+            std::cout << "[Stream Tuner] Could not open session " << filenames[i] << std::endl;
+            return false;
+        }
+        std::vector<IHMCMsgUtils::IHMCInputLogRecord> records;
+        IHMCMsgUtils::IHMCInputLogRecord record;
+        while( reader.readNext(record) ) {
+            records.push_back(record);
+        }
+        if( records.empty() ) {
+            std::cout << "[Stream Tuner] Skipping empty session " << filenames[i] << std::endl;
+            continue;
+        }
+        names.push_back(filenames[i]);
+        sessions.push_back(records);
+    }
+
+    return !sessions.empty();
+}
+
+// REPLAY
+void applyInputToReference(const IHMCMsgUtils::IHMCInputLogRecord& record, dynacore::Vector& q_ref, bool& has_reference) {
+    // reference is assembled the same way as the IHMC Interface Node, before any filtering
+    if( record.type == IHMCMsgUtils::INPUT_LOG_PELVIS_TRANSFORM ) {
+        q_ref[valkyrie_joint::virtual_X] = record.transform.transform.translation.x;
+        q_ref[valkyrie_joint::virtual_Y] = record.transform.transform.translation.y;
+        q_ref[valkyrie_joint::virtual_Z] = record.transform.transform.translation.z;
+        q_ref[valkyrie_joint::virtual_Rx] = record.transform.transform.rotation.x;
+        q_ref[valkyrie_joint::virtual_Ry] = record.transform.transform.rotation.y;
+        q_ref[valkyrie_joint::virtual_Rz] = record.transform.transform.rotation.z;
+        q_ref[valkyrie_joint::virtual_Rw] = record.transform.transform.rotation.w;
+        has_reference = true;
+    }
+    else if( record.type == IHMCMsgUtils::INPUT_LOG_JOINT_COMMAND ) {
+        for( int i = 0 ; i < record.joint_command.position.size() && i < record.joint_command.name.size() ; i++ ) {
+            std::map<std::string, int>::iterator it = val::joint_names_to_indices.find(record.joint_command.name[i]);
+            if( it != val::joint_names_to_indices.end() ) {
+                q_ref[it->second] = record.joint_command.position[i];
+            }
+        }
+        has_reference = true;
+    }
+
+    return;
+}
+
+void holdJoints(const std::vector<int>& joint_indices, dynacore::Vector& q) {
+    // special index -1 (wrist joints) is not in valkyrie definition
+    for( int i = 0 ; i < joint_indices.size() ; i++ ) {
+        if( joint_indices[i] != -1 ) {
+            q[joint_indices[i]] = 0.0;
+        }
+    }
+    return;
+}
+
+void replaySession(const std::vector<IHMCMsgUtils::IHMCInputLogRecord>& records, double delay,
+                   IHMCMockTrackingParams tracking_params, TunerSetting& result) {
+    // isolated streamer and endpoint for this run; simulated time drives the streamer's clock
+    int64_t sim_time = records.front().timestamp;
+    IHMCMsgUtils::IHMCCommandStreamer streamer(true);
+    streamer.setVerbose(false);
+    streamer.setClock([&sim_time]() { return sim_time; });
+    streamer.setStreamIntegrationDuration(result.stream_integration_duration);
+    streamer.setCommandFilterParams(result.filter_params);
+    if( result.slow_part_rate > 0.0 ) {
+        streamer.setBodyPartStreamRate(valkyrie_link::pelvis, result.slow_part_rate);
+        streamer.setBodyPartStreamRate(valkyrie_link::torso, result.slow_part_rate);
+    }
+
+    // streamed messages are delivered after transport delay
+    std::deque<std::pair<int64_t, controller_msgs::WholeBodyTrajectoryMessage>> in_flight;
+    int64_t delay_ns = static_cast<int64_t>(delay * 1e9);
+    long num_messages = 0;
+    long num_bytes = 0;
+    streamer.setWholeBodyMessageSink([&](const controller_msgs::WholeBodyTrajectoryMessage& msg) {
+        num_bytes += ros::serialization::serializationLength(msg) + ROS_FRAMING_BYTES;
+        num_messages++;
+        in_flight.push_back(std::make_pair(sim_time + delay_ns, msg));
+    });
+
+    IHMCMockEndpoint endpoint(tracking_params);
+    std::vector<int> joint_indices;
+    for( int part = IHMCMockEndpoint::LEFT_ARM ; part <= IHMCMockEndpoint::NECK ; part++ ) {
+        const std::vector<int>& part_indices = endpoint.getJointIndices(part);
+        for( int i = 0 ; i < part_indices.size() ; i++ ) {
+            // special index -1 (wrist joints) is not in valkyrie definition
+            if( part_indices[i] != -1 ) {
+                joint_indices.push_back(part_indices[i]);
+            }
+        }
+    }
+
+    // lag from recorded command to tracked configuration; commands kept for up to a second at controller rates
+    // torso is not tracked by mock endpoint, so it is held fixed in what the monitor compares
+    IHMCMsgUtils::IHMCTrackingMonitor monitor(100, 100);
+    std::vector<int> torso_indices;
+    IHMCMsgUtils::getRelevantJointIndicesTorso(torso_indices);
+    dynacore::Vector q_monitor;
+
+    dynacore::Vector q_ref;
+    q_ref.resize(valkyrie::num_q);
+    q_ref.setZero();
+    q_ref[valkyrie_joint::virtual_Rw] = 1.0;
+    bool has_reference = false;
+    bool endpoint_started = false;
+
+    int64_t start_time = records.front().timestamp;
+    int64_t end_time = records.back().timestamp + static_cast<int64_t>(1e9); // let tracking settle after last input
+    int64_t dt = static_cast<int64_t>(SIM_DT * 1e9);
+    int64_t tick_period = static_cast<int64_t>(1e9 / result.rate);
+    int64_t next_tick = start_time + tick_period;
+    int next_record = 0;
+    long step = 0;
+    for( sim_time = start_time ; sim_time <= end_time ; sim_time += dt, step++ ) {
+        // process inputs received by now; pelvis transform and joint command received together are one command
+        bool reference_changed = false;
+        while( next_record < records.size() && records[next_record].timestamp <= sim_time ) {
+            reference_changed = reference_changed ||
+                                (records[next_record].type == IHMCMsgUtils::INPUT_LOG_PELVIS_TRANSFORM) ||
+                                (records[next_record].type == IHMCMsgUtils::INPUT_LOG_JOINT_COMMAND);
+            applyInputToReference(records[next_record], q_ref, has_reference);
+            streamer.processInputLogRecord(records[next_record]);
+            next_record++;
+        }
+        if( reference_changed ) {
+            q_monitor = q_ref;
+            holdJoints(torso_indices, q_monitor);
+            monitor.addCommand(sim_time, q_monitor);
+        }
+
+        // streaming loop at candidate rate
+        if( sim_time >= next_tick ) {
+            streamer.update();
+            next_tick += tick_period;
+        }
+
+        // robot starts at first commanded configuration
+        if( !has_reference ) {
+            continue;
+        }
+        if( !endpoint_started ) {
+            endpoint.reset(q_ref);
+            endpoint_started = true;
+        }
+
+        // deliver messages that have arrived
+        while( !in_flight.empty() && in_flight.front().first <= sim_time ) {
+            endpoint.receiveWholeBodyMessage(in_flight.front().second, sim_time / 1e9);
+            in_flight.pop_front();
+        }
+
+        // step endpoint and measure tracking error against recorded commands
+        endpoint.update(sim_time / 1e9, SIM_DT);
+        const dynacore::Vector& q_actual = endpoint.getActualConfiguration();
+        for( int i = 0 ; i < joint_indices.size() ; i++ ) {
+            double err = q_actual[joint_indices[i]] - q_ref[joint_indices[i]];
+            result.joint_sq_error += err * err;
+        }
+        result.num_joint_samples += joint_indices.size();
+        for( int i = valkyrie_joint::virtual_X ; i <= valkyrie_joint::virtual_Z ; i++ ) {
+            double err = q_actual[i] - q_ref[i];
+            result.pelvis_sq_error += err * err;
+        }
+        result.num_pelvis_samples += 3;
+        // after last input, measurements only approach the last command and say nothing about lag
+        if( (step % MEASUREMENT_STEPS == 0) && (next_record < records.size()) ) {
+            q_monitor = q_actual;
+            holdJoints(torso_indices, q_monitor);
+            monitor.addMeasurement(sim_time, q_monitor);
+        }
+    }
+
+    result.num_messages += num_messages;
+    result.num_bytes += num_bytes;
+    result.sim_seconds += (end_time - start_time) / 1e9;
+    result.max_lag = std::max(result.max_lag, monitor.getEstimatedLag());
+
+    return;
+}
+
+// SEARCH
+void makeFilterCandidates(std::vector<IHMCMsgUtils::IHMCCommandFilterParams>& filters) {
+    IHMCMsgUtils::IHMCCommandFilterParams no_filter;
+    filters.push_back(no_filter);
+    for( int c = 0 ; c < ONE_EURO_MIN_CUTOFFS.size() ; c++ ) {
+        for( int b = 0 ; b < ONE_EURO_BETAS.size() ; b++ ) {
+            IHMCMsgUtils::IHMCCommandFilterParams one_euro;
+            one_euro.type = IHMCMsgUtils::COMMAND_FILTER_ONE_EURO;
+            one_euro.min_cutoff = ONE_EURO_MIN_CUTOFFS[c];
+            one_euro.beta = ONE_EURO_BETAS[b];
+            filters.push_back(one_euro);
+        }
+    }
+    for( int w = 0 ; w < NATURAL_FREQUENCIES.size() ; w++ ) {
+        IHMCMsgUtils::IHMCCommandFilterParams critically_damped;
+        critically_damped.type = IHMCMsgUtils::COMMAND_FILTER_CRITICALLY_DAMPED;
+        critically_damped.natural_frequency = NATURAL_FREQUENCIES[w];
+        filters.push_back(critically_damped);
+    }
+
+    return;
+}
+
+std::string getFilterName(const IHMCMsgUtils::IHMCCommandFilterParams& filter_params) {
+    if( filter_params.type == IHMCMsgUtils::COMMAND_FILTER_ONE_EURO ) {
+        return std::string("one_euro");
+    }
+    else if( filter_params.type == IHMCMsgUtils::COMMAND_FILTER_CRITICALLY_DAMPED ) {
+        return std::string("critically_damped");
+    }
+    return std::string("none");
+}
+
+std::string getFilterDescription(const IHMCMsgUtils::IHMCCommandFilterParams& filter_params) {
+    std::ostringstream ss;
+    ss << getFilterName(filter_params);
+    if( filter_params.type == IHMCMsgUtils::COMMAND_FILTER_ONE_EURO ) {
+        ss << "(" << filter_params.min_cutoff << "," << filter_params.beta << ")";
+    }
+    else if( filter_params.type == IHMCMsgUtils::COMMAND_FILTER_CRITICALLY_DAMPED ) {
+        ss << "(" << filter_params.natural_frequency << ")";
+    }
+    return ss.str();
+}
+
+bool isBetterSetting(const TunerSetting& a, const TunerSetting& b) {
+    // lower tracking error of arms, neck, and pelvis; settings that track equally well are ranked by bandwidth
+    double error_a = a.joint_rms_error + a.pelvis_rms_error;
+    double error_b = b.joint_rms_error + b.pelvis_rms_error;
+    if( std::fabs(error_a - error_b) > 1e-6 ) {
+        return error_a < error_b;
+    }
+    return a.bandwidth < b.bandwidth;
+}
+
+bool writePreset(const std::string& filename, const TunerSetting& best, int num_sessions,
+                 double bandwidth_budget, double latency_budget) {
+    std::ofstream file(filename.c_str());
+    if( !file.is_open() ) {
+        std::cout << "[Stream Tuner] Could not write preset " << filename << std::endl;
+        return false;
+    }
+
+    // rosparam file for the IHMC Interface Node
+    file << std::fixed << std::setprecision(4);
+    file << "# streaming preset from ihmc_stream_tuner over " << num_sessions << " sessions" << std::endl;
+    file << "# budget: " << bandwidth_budget << " kB/s, " << latency_budget << " s lag; "
+         << "scored: " << best.bandwidth << " kB/s, " << best.max_lag << " s lag, "
+         << best.joint_rms_error << " rad joint rms, " << best.pelvis_rms_error << " m pelvis rms" << std::endl;
+    file << "stream_rate: " << best.rate << std::endl;
+    file << "stream_integration_duration: " << best.stream_integration_duration << std::endl;
+    file << "command_filter: " << getFilterName(best.filter_params) << std::endl;
+    file << "filter_min_cutoff: " << best.filter_params.min_cutoff << std::endl;
+    file << "filter_beta: " << best.filter_params.beta << std::endl;
+    file << "filter_natural_frequency: " << best.filter_params.natural_frequency << std::endl;
+    if( best.slow_part_rate > 0.0 ) {
+        file << "body_part_stream_rates: {pelvis: " << best.slow_part_rate << ", torso: " << best.slow_part_rate << "}" << std::endl;
+    }
+    else {
+        file << "body_part_stream_rates: {}" << std::endl;
+    }
+
+    return true;
+}
+
+int main(int argc, char **argv) {
+    // default tuner settings
+    std::string sessions_path;
+    double bandwidth_budget = 200.0;
+    double latency_budget = 0.25;
+    double delay = 0.0;
+    IHMCMockTrackingParams tracking_params;
+    int num_threads = std::max(1u, std::thread::hardware_concurrency());
+    std::string preset_filename("ihmc_stream_preset.yaml");
+    std::string csv_filename;
+
+    // parse arguments
+    for( int i = 1 ; i + 1 < argc ; i += 2 ) {
+        std::string arg(argv[i]);
+        if( arg == "--sessions" ) { sessions_path = std::string(argv[i+1]); }
+        else if( arg == "--bandwidth-budget" ) { bandwidth_budget = std::stod(argv[i+1]); }
+        else if( arg == "--latency-budget" ) { latency_budget = std::stod(argv[i+1]); }
+        else if( arg == "--delay" ) { delay = std::max(0.0, std::stod(argv[i+1])); }
+        else if( arg == "--tracking-bandwidth" ) { tracking_params.natural_frequency = std::stod(argv[i+1]); }
+        else if( arg == "--threads" ) { num_threads = std::max(1, std::stoi(argv[i+1])); }
+        else if( arg == "--preset" ) { preset_filename = std::string(argv[i+1]); }
+        else if( arg == "--csv" ) { csv_filename = std::string(argv[i+1]); }
+        else { std::cout << "[Stream Tuner] Unrecognized argument " << arg << std::endl; return 1; }
+    }
+    if( sessions_path.empty() ) {
+        std::cout << "[Stream Tuner] usage: ihmc_stream_tuner --sessions DIR [--bandwidth-budget KBPS] [--latency-budget S] "
+                  << "[--delay S] [--tracking-bandwidth WN] [--threads N] [--preset FILE] [--csv FILE]" << std::endl;
+        return 1;
+    }
+
+    // load sessions
+    std::vector<std::string> session_names;
+    std::vector<std::vector<IHMCMsgUtils::IHMCInputLogRecord>> sessions;
+    if( !loadSessions(sessions_path, session_names, sessions) ) {
+        std::cout << "[Stream Tuner] No sessions to replay from " << sessions_path << std::endl;
+        return 1;
+    }
+
+    // build search grid; pelvis and torso rates only matter when slower than stream rate
+    std::vector<IHMCMsgUtils::IHMCCommandFilterParams> filters;
+    makeFilterCandidates(filters);
+    std::vector<TunerSetting> settings;
+    for( int r = 0 ; r < RATES.size() ; r++ ) {
+        for( int d = 0 ; d < INTEGRATION_MULTIPLIERS.size() ; d++ ) {
+            for( int s = 0 ; s < SLOW_PART_RATES.size() ; s++ ) {
+                if( SLOW_PART_RATES[s] >= RATES[r] ) {
+                    continue;
+                }
+                for( int f = 0 ; f < filters.size() ; f++ ) {
+                    TunerSetting setting;
+                    setting.rate = RATES[r];
+                    setting.stream_integration_duration = INTEGRATION_MULTIPLIERS[d] / RATES[r];
+                    setting.slow_part_rate = SLOW_PART_RATES[s];
+                    setting.filter_params = filters[f];
+                    settings.push_back(setting);
+                }
+            }
+        }
+    }
+
+    std::cout << "[Stream Tuner] Replaying " << sessions.size() << " sessions with " << settings.size()
+              << " settings on " << num_threads << " threads" << std::endl;
+
+    // replay settings across worker threads; each worker takes the next unclaimed setting and replays every session with it
+    std::atomic<int> next_setting{0};
+    std::vector<std::thread> workers;
+    for( int t = 0 ; t < num_threads ; t++ ) {
+        workers.push_back(std::thread([&]() {
+            int idx;
+            while( (idx = next_setting++) < settings.size() ) {
+                for( int s = 0 ; s < sessions.size() ; s++ ) {
+                    replaySession(sessions[s], delay, tracking_params, settings[idx]);
+                }
+            }
+        }));
+    }
+    for( int t = 0 ; t < workers.size() ; t++ ) {
+        workers[t].join();
+    }
+
+    // score settings; lowest tracking error within budget wins
+    int best = -1;
+    for( int i = 0 ; i < settings.size() ; i++ ) {
+        TunerSetting& setting = settings[i];
+        setting.bandwidth = (setting.sim_seconds > 0.0) ? setting.num_bytes / setting.sim_seconds / 1000.0 : 0.0;
+        setting.joint_rms_error = (setting.num_joint_samples > 0) ? std::sqrt(setting.joint_sq_error / setting.num_joint_samples) : 0.0;
+        setting.pelvis_rms_error = (setting.num_pelvis_samples > 0) ? std::sqrt(setting.pelvis_sq_error / setting.num_pelvis_samples) : 0.0;
+        // lag is negative if it could not be estimated (e.g., no motion), which does not count against the budget
+        setting.within_budget = (setting.bandwidth <= bandwidth_budget) && (setting.max_lag <= latency_budget);
+        if( setting.within_budget && (best < 0 || isBetterSetting(setting, settings[best])) ) {
+            best = i;
+        }
+    }
+
+    // report settings within budget, best first
+    std::vector<int> order;
+    for( int i = 0 ; i < settings.size() ; i++ ) {
+        if( settings[i].within_budget ) {
+            order.push_back(i);
+        }
+    }
+    std::sort(order.begin(), order.end(), [&](int a, int b) { return isBetterSetting(settings[a], settings[b]); });
+    std::cout << std::fixed;
+    std::cout << std::right << std::setw(8) << "rate" << std::setw(12) << "integ (s)" << std::setw(10) << "slow (Hz)"
+              << "  " << std::left << std::setw(24) << "filter" << std::right << std::setw(10) << "kB/s"
+              << std::setw(10) << "lag (s)" << std::setw(16) << "joint rms (rad)" << std::setw(16) << "pelvis rms (m)" << std::endl;
+    for( int k = 0 ; k < order.size() && k < 10 ; k++ ) {
+        const TunerSetting& setting = settings[order[k]];
+        std::cout << std::right << std::setprecision(0) << std::setw(8) << setting.rate
+                  << std::setprecision(3) << std::setw(12) << setting.stream_integration_duration
+                  << std::setprecision(1) << std::setw(10) << setting.slow_part_rate
+                  << "  " << std::left << std::setw(24) << getFilterDescription(setting.filter_params) << std::right
+                  << std::setw(10) << setting.bandwidth
+                  << std::setprecision(3) << std::setw(10) << setting.max_lag
+                  << std::setprecision(4) << std::setw(16) << setting.joint_rms_error
+                  << std::setw(16) << setting.pelvis_rms_error << std::endl;
+    }
+    std::cout << std::setprecision(3) << "[Stream Tuner] " << order.size() << " of " << settings.size() << " settings within "
+              << bandwidth_budget << " kB/s and " << latency_budget << " s lag" << std::endl;
+
+    // write CSV, if requested
+    if( !csv_filename.empty() ) {
+        std::ofstream csv_file(csv_filename.c_str());
+        csv_file << "rate,stream_integration_duration,slow_part_rate,filter,messages,bandwidth_kBps,max_lag,joint_rms_error,pelvis_rms_error,within_budget" << std::endl;
+        for( int i = 0 ; i < settings.size() ; i++ ) {
+            const TunerSetting& setting = settings[i];
+            csv_file << setting.rate << "," << setting.stream_integration_duration << "," << setting.slow_part_rate << ","
+                     << getFilterDescription(setting.filter_params) << "," << setting.num_messages << "," << setting.bandwidth << ","
+                     << setting.max_lag << "," << setting.joint_rms_error << "," << setting.pelvis_rms_error << ","
+                     << (setting.within_budget ? 1 : 0) << std::endl;
+        }
+        std::cout << "[Stream Tuner] Wrote results to " << csv_filename << std::endl;
+    }
+
+    if( best < 0 ) {
+        std::cout << "[Stream Tuner] No setting meets the budget, not writing preset" << std::endl;
+        return 1;
+    }
+    if( !writePreset(preset_filename, settings[best], sessions.size(), bandwidth_budget, latency_budget) ) {
+        return 1;
+    }
+    std::cout << "[Stream Tuner] Wrote preset to " << preset_filename << std::endl;
+
+    return 0;
+}
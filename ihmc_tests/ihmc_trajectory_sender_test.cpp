@@ -0,0 +1,228 @@
+#include <iostream>
+#include <iomanip>
+#include <deque>
+#include <algorithm>
+#include <cmath>
+
+#include <ihmc_utils/ihmc_trajectory_sender.h>
+#include <ihmc_utils/ihmc_tracking_monitor.h>
+#include <ihmc_tests/ihmc_mock_endpoint.h>
+#include <ihmc_tests/ihmc_msg_test_utilities.h>
+
+/*
+ * Test for chunked trajectory sending.
+ * Sends a long trajectory of the arms, neck, and pelvis through IHMCTrajectorySender to a mock IHMC endpoint in
+ * simulated time, with the same transport delay on segments and on measured configurations fed back to the sender,
+ * tracking execution by elapsed time and by measured configurations.  Checks that no queued segment is rejected, that the
+ * endpoint queue never holds more segments than the segments sent ahead plus those released early to cover the
+ * expected latency, that every segment arrives before the previous one finishes (so the endpoint queue never runs dry),
+ * and that the final waypoint is reached.  The expected latency defaults to the round trip (twice the delay), plus the lag
+ * of the endpoint's tracking behind a ramp and half a waypoint interval, since feedback reports the waypoint closest to
+ * where the robot is rather than where it is commanded to be.  Also checks that a trajectory returning to its start is
+ * not matched to the return while the robot is still at the start.
+ *
+ * usage: ihmc_trajectory_sender_test [--waypoints N] [--points-per-segment N] [--ahead N] [--delay S] [--latency S]
+ */
+
+// TRAJECTORY
+const double WAYPOINT_INTERVAL = 0.1;
+const double SETTLE_TIME = 2.0;
+const double SIM_DT = 0.001;
+const double FEEDBACK_RATE = 100.0;
+
+void makeTrajectory(int num_waypoints, const std::vector<int>& joint_indices,
+                    std::vector<dynacore::Vector>& waypoints, std::vector<double>& times) {
+    // slow sinusoids on each joint and a pelvis sway, starting from rest at zero
+    for( int k = 0 ; k < num_waypoints ; k++ ) {
+        double t = (k + 1) * WAYPOINT_INTERVAL;
+        dynacore::Vector q;
+        q.resize(valkyrie::num_q);
+        q.setZero();
+        q[valkyrie_joint::virtual_Y] = 0.03 * std::sin(2.0 * M_PI * 0.1 * t);
+        q[valkyrie_joint::virtual_Z] = 1.0;
+        q[valkyrie_joint::virtual_Rw] = 1.0;
+        for( int i = 0 ; i < joint_indices.size() ; i++ ) {
+            q[joint_indices[i]] = 0.4 * std::sin(2.0 * M_PI * 0.1 * t + 0.7 * i) - 0.4 * std::sin(0.7 * i);
+        }
+        waypoints.push_back(q);
+        times.push_back(t);
+    }
+
+    return;
+}
+
+bool runTest(int progress_source, const char* name, int num_waypoints, IHMCMsgUtils::IHMCTrajectorySenderParams params, double delay) {
+    params.progress_source = progress_source;
+    IHMCMockEndpoint endpoint;
+    std::vector<int> joint_indices;
+    IHMCMsgTestUtils::getTrackedJointIndices(joint_indices);
+
+    std::vector<dynacore::Vector> waypoints;
+    std::vector<double> times;
+    makeTrajectory(num_waypoints, joint_indices, waypoints, times);
+    dynacore::Vector q_start = waypoints[0];
+    q_start.setZero();
+    q_start[valkyrie_joint::virtual_Z] = 1.0;
+    q_start[valkyrie_joint::virtual_Rw] = 1.0;
+    endpoint.reset(q_start);
+
+    // sender runs on simulated clock; messages are delivered after transport delay
+    double t = 0.0;
+    std::deque<std::pair<double, controller_msgs::WholeBodyTrajectoryMessage>> in_transport;
+    IHMCMsgUtils::IHMCTrajectorySender sender(params);
+    sender.setClock([&t]() { return static_cast<int64_t>(std::llround(t * 1e9)); });
+    sender.setWholeBodyMessageSink([&](const controller_msgs::WholeBodyTrajectoryMessage& msg) {
+        in_transport.push_back(std::make_pair(t + delay, msg));
+    });
+
+    IHMCMsgUtils::IHMCMessageParameters msg_params;
+    msg_params.controlled_links = {valkyrie_link::pelvis, valkyrie_link::rightPalm, valkyrie_link::leftPalm, valkyrie_link::head};
+    msg_params.queueable_params.message_id = 10;
+    if( !sender.sendTrajectory(waypoints, times, msg_params) ) {
+        std::cout << std::left << std::setw(10) << name << "  trajectory not sent  FAILED" << std::endl;
+        return false;
+    }
+
+    // endpoint queue holds segments sent ahead, plus segments released early to cover the expected latency and
+    // (for elapsed time, which starts when the first segment is sent rather than when it arrives) the transport delay
+    double segment_duration = params.points_per_segment * WAYPOINT_INTERVAL;
+    int max_queue_depth = params.segments_ahead +
+                          static_cast<int>(std::ceil((params.expected_latency + delay) / segment_duration - 1e-9));
+
+    // receive times of segments at endpoint, and measured configurations in transport back to sender
+    std::vector<double> receive_times;
+    std::deque<std::pair<double, controller_msgs::RobotConfigurationData>> feedback_in_transport;
+    int queue_depth = 0;
+    double next_feedback = 0.0;
+    double end_time = delay + times.back() + SETTLE_TIME;
+    for( t = SIM_DT ; t <= end_time ; t += SIM_DT ) {
+        while( !in_transport.empty() && in_transport.front().first <= t ) {
+            endpoint.receiveWholeBodyMessage(in_transport.front().second, t);
+            receive_times.push_back(t);
+            in_transport.pop_front();
+        }
+        endpoint.update(t, SIM_DT);
+
+        // largest number of segments executing or queued on endpoint, for any tracked body part
+        for( int part = IHMCMockEndpoint::LEFT_ARM ; part <= IHMCMockEndpoint::NECK ; part++ ) {
+            queue_depth = std::max(queue_depth, endpoint.getNumPendingSegments(part, t));
+        }
+
+        // robot configuration data at feedback rate, delivered after transport delay
+        if( t >= next_feedback ) {
+            controller_msgs::RobotConfigurationData config_msg;
+            IHMCMsgUtils::makeRobotConfigurationData(endpoint.getActualConfiguration(), config_msg);
+            feedback_in_transport.push_back(std::make_pair(t + delay, config_msg));
+            next_feedback += 1.0 / FEEDBACK_RATE;
+        }
+        while( !feedback_in_transport.empty() && feedback_in_transport.front().first <= t ) {
+            sender.processRobotConfigurationData(feedback_in_transport.front().second);
+            feedback_in_transport.pop_front();
+        }
+
+        sender.update();
+    }
+
+    // each segment must arrive before the previous segment finishes executing on endpoint
+    int num_late = 0;
+    double min_margin = 1e9;
+    for( int i = 1 ; i < receive_times.size() ; i++ ) {
+        int prev_last_waypoint = std::min(num_waypoints, i * params.points_per_segment) - 1;
+        double margin = (receive_times[0] + times[prev_last_waypoint]) - receive_times[i];
+        min_margin = std::min(min_margin, margin);
+        if( margin < 0.0 ) {
+            num_late++;
+        }
+    }
+
+    // final waypoint reached
+    double final_error = 0.0;
+    for( int i = 0 ; i < joint_indices.size() ; i++ ) {
+        final_error = std::max(final_error, std::fabs(endpoint.getActualConfiguration()[joint_indices[i]] - waypoints.back()[joint_indices[i]]));
+    }
+
+    bool passed = (endpoint.getNumRejectedMessages() == 0) && (queue_depth <= max_queue_depth) &&
+                  (num_late == 0) && (receive_times.size() == sender.getNumSegments()) && !sender.isActive() &&
+                  (final_error < 1e-3);
+    std::cout << std::left << std::setw(10) << name << std::right << std::fixed << std::setprecision(3)
+              << "  segments " << receive_times.size() << "/" << sender.getNumSegments()
+              << ", max queue depth " << queue_depth << "/" << max_queue_depth << ", rejected " << endpoint.getNumRejectedMessages()
+              << ", late " << num_late << ", min margin " << min_margin << " s, final error "
+              << std::scientific << std::setprecision(1) << final_error << " rad" << (passed ? "" : "  FAILED") << std::endl;
+
+    return passed;
+}
+
+bool runMatchWindowTest(IHMCMsgUtils::IHMCTrajectorySenderParams params) {
+    // trajectory out and back, all sent at once, so the return to the start is among the waypoints sent
+    params.progress_source = IHMCMsgUtils::TRAJECTORY_PROGRESS_FEEDBACK;
+    params.points_per_segment = 20;
+    params.segments_ahead = 1;
+    std::vector<int> joint_indices;
+    IHMCMsgTestUtils::getTrackedJointIndices(joint_indices);
+    std::vector<dynacore::Vector> waypoints;
+    std::vector<double> times;
+    for( int k = 0 ; k < params.points_per_segment ; k++ ) {
+        double t = (k + 1) * WAYPOINT_INTERVAL;
+        dynacore::Vector q = dynacore::Vector::Zero(valkyrie::num_q);
+        q[valkyrie_joint::virtual_Z] = 1.0;
+        q[valkyrie_joint::virtual_Rw] = 1.0;
+        for( int i = 0 ; i < joint_indices.size() ; i++ ) {
+            q[joint_indices[i]] = 0.4 * std::sin(M_PI * t / (params.points_per_segment * WAYPOINT_INTERVAL));
+        }
+        waypoints.push_back(q);
+        times.push_back(t);
+    }
+
+    IHMCMsgUtils::IHMCTrajectorySender sender(params);
+    sender.setClock([]() { return static_cast<int64_t>(0); });
+    IHMCMsgUtils::IHMCMessageParameters msg_params;
+    msg_params.controlled_links = {valkyrie_link::rightPalm, valkyrie_link::leftPalm, valkyrie_link::head};
+    sender.sendTrajectory(waypoints, times, msg_params);
+
+    // robot still at start, which is closest to the last waypoint of the return
+    dynacore::Vector q_start = dynacore::Vector::Zero(valkyrie::num_q);
+    q_start[valkyrie_joint::virtual_Z] = 1.0;
+    q_start[valkyrie_joint::virtual_Rw] = 1.0;
+    sender.addMeasuredConfiguration(q_start);
+
+    bool passed = (sender.getProgressTime() <= params.feedback_match_window + WAYPOINT_INTERVAL);
+    std::cout << std::left << std::setw(10) << "window" << std::right << std::fixed << std::setprecision(3)
+              << "  progress at start " << sender.getProgressTime() << " s of " << times.back() << " s"
+              << (passed ? "" : "  FAILED") << std::endl;
+
+    return passed;
+}
+
+int main(int argc, char **argv) {
+    // default test settings
+    int num_waypoints = 200;
+    double delay = 0.2;
+    double latency = -1.0;
+    IHMCMsgUtils::IHMCTrajectorySenderParams params;
+
+    // parse arguments
+    for( int i = 1 ; i + 1 < argc ; i += 2 ) {
+        std::string arg(argv[i]);
+        if( arg == "--waypoints" ) { num_waypoints = std::max(1, std::stoi(argv[i+1])); }
+        else if( arg == "--points-per-segment" ) { params.points_per_segment = std::max(1, std::stoi(argv[i+1])); }
+        else if( arg == "--ahead" ) { params.segments_ahead = std::max(1, std::stoi(argv[i+1])); }
+        else if( arg == "--delay" ) { delay = std::max(0.0, std::stod(argv[i+1])); }
+        else if( arg == "--latency" ) { latency = std::max(0.0, std::stod(argv[i+1])); }
+        else { std::cout << "[Trajectory Sender Test] Unrecognized argument " << arg << std::endl; return 1; }
+    }
+
+    // segments and measured configurations are both delayed, the robot lags behind its commands,
+    // and measured configurations are matched to the closest waypoint
+    double tracking_lag = 2.0 / IHMCMockTrackingParams().natural_frequency;
+    params.expected_latency = (latency >= 0.0) ? latency : (2.0 * delay + tracking_lag + 0.5 * WAYPOINT_INTERVAL);
+
+    bool passed = true;
+    passed = runTest(IHMCMsgUtils::TRAJECTORY_PROGRESS_ELAPSED_TIME, "elapsed", num_waypoints, params, delay) && passed;
+    passed = runTest(IHMCMsgUtils::TRAJECTORY_PROGRESS_FEEDBACK, "feedback", num_waypoints, params, delay) && passed;
+    passed = runMatchWindowTest(params) && passed;
+
+    std::cout << "[Trajectory Sender Test] " << (passed ? "PASSED" : "FAILED") << std::endl;
+
+    return passed ? 0 : 1;
+}
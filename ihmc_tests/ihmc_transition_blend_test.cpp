@@ -0,0 +1,182 @@
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+
+#include <ihmc_utils/ihmc_command_streamer.h>
+#include <ihmc_tests/ihmc_mock_endpoint.h>
+#include <ihmc_tests/ihmc_msg_test_utilities.h>
+
+/*
+ * Test for blending streamed commands in from poses.
+ * Sends a pose through IHMCCommandStreamer to a mock IHMC endpoint in simulated time, then starts streaming a different
+ * configuration while the pose trajectory is still moving.  Measures the largest jump of the endpoint's desired
+ * configuration between simulation steps, without blending and with blending, and checks that blending removes the jump
+ * at the start of streaming and that the streamed configuration is still reached.  Measured configurations are fed back
+ * so the pose trajectory starts where the robot is.  Streams at the interface node's default rate of 10 Hz, where blended
+ * setpoints are a tenth of a second apart, so the blend is only smooth if each setpoint carries the velocity of the blend.
+ * The pelvis is streamed at a lower rate; a second pair of runs sends the pose while the controller keeps streaming,
+ * so the pelvis is first sent after the pose at a later cycle than the arms and neck, and must blend in from there.
+ *
+ * usage: ihmc_transition_blend_test [--blend S] [--stream-start S] [--stream-rate HZ] [--pelvis-rate HZ] [--pose-time S]
+ */
+
+// SIMULATION
+const double SIM_DT = 0.001;
+const double SETTLE_TIME = 1.0;
+const double FEEDBACK_RATE = 100.0;
+
+double runTest(const char* name, double blend_duration, double stream_start, double stream_rate, double pelvis_rate,
+               double pose_time, bool mid_stream, double& final_error) {
+    IHMCMockEndpoint endpoint;
+    std::vector<int> joint_indices;
+    IHMCMsgTestUtils::getTrackedJointIndices(joint_indices);
+    joint_indices.push_back(valkyrie_joint::virtual_Z);
+
+    // robot starts at rest at zero; pose and streamed configuration move arms, neck, and pelvis to different targets
+    dynacore::Vector q_start;
+    q_start.resize(valkyrie::num_q);
+    q_start.setZero();
+    q_start[valkyrie_joint::virtual_Z] = 1.0;
+    q_start[valkyrie_joint::virtual_Rw] = 1.0;
+    endpoint.reset(q_start);
+    dynacore::Vector q_pose = q_start;
+    dynacore::Vector q_stream = q_start;
+    for( int i = 0 ; i < joint_indices.size() ; i++ ) {
+        q_pose[joint_indices[i]] = 0.6 * std::sin(0.9 * i + 0.5);
+        q_stream[joint_indices[i]] = 0.3 * std::cos(1.3 * i);
+    }
+    q_pose[valkyrie_joint::virtual_Z] = 0.7;
+    q_stream[valkyrie_joint::virtual_Z] = 1.0;
+
+    // streamer runs on simulated clock; messages are delivered right away
+    double t = 0.0;
+    IHMCMsgUtils::IHMCCommandStreamer streamer(true);
+    streamer.setVerbose(false);
+    streamer.setClock([&t]() { return static_cast<int64_t>(std::llround(t * 1e9)); });
+    streamer.setWholeBodyMessageSink([&](const controller_msgs::WholeBodyTrajectoryMessage& msg) {
+        endpoint.receiveWholeBodyMessage(msg, t);
+    });
+    streamer.setGoHomeMessageSink([](const controller_msgs::GoHomeMessage& msg) {});
+    streamer.setStopAllTrajectoryMessageSink([](const controller_msgs::StopAllTrajectoryMessage& msg) {});
+    streamer.setStreamIntegrationDuration(1.3 / stream_rate);
+    streamer.setTransitionBlendDuration(blend_duration);
+    streamer.setBodyPartStreamRate(valkyrie_link::pelvis, pelvis_rate);
+
+    IHMCMsgUtils::IHMCMessageParameters pose_params;
+    pose_params.controlled_links = {valkyrie_link::rightPalm, valkyrie_link::leftPalm, valkyrie_link::head, valkyrie_link::pelvis};
+    pose_params.traj_point_params.time = pose_time;
+    streamer.getPoseLibrary().addPose("reach", q_pose, pose_params);
+
+    // controller inputs for streamed configuration
+    geometry_msgs::TransformStamped tf_msg;
+    tf_msg.transform.translation.z = q_stream[valkyrie_joint::virtual_Z];
+    tf_msg.transform.rotation.w = q_stream[valkyrie_joint::virtual_Rw];
+    sensor_msgs::JointState js_msg;
+    IHMCMsgTestUtils::getActuatedJointNames(js_msg.name);
+    js_msg.position.resize(valkyrie::num_act_joint);
+    for( int i = 0 ; i < valkyrie::num_act_joint ; i++ ) {
+        js_msg.position[i] = q_stream[i + valkyrie::num_virtual];
+    }
+
+    // measured configuration before pose, then pose, then controller starts streaming while pose trajectory is still moving;
+    // mid-stream, controller streams from the start and pose is sent between two streaming cycles
+    controller_msgs::RobotConfigurationData config_msg;
+    IHMCMsgUtils::makeRobotConfigurationData(endpoint.getActualConfiguration(), config_msg);
+    streamer.processRobotConfigurationData(config_msg);
+    bool posed = false;
+    if( !mid_stream ) {
+        streamer.setStatus("POSE:reach");
+        posed = true;
+    }
+    bool streaming = false;
+    double next_stream = mid_stream ? 0.0 : stream_start;
+    double pose_time_in_stream = stream_start + 0.5 / stream_rate;
+    double next_feedback = 1.0 / FEEDBACK_RATE;
+    double max_jump = 0.0;
+    dynacore::Vector q_prev = endpoint.getDesiredConfiguration();
+    for( t = SIM_DT ; t <= stream_start + blend_duration + SETTLE_TIME ; t += SIM_DT ) {
+        if( !posed && (t >= pose_time_in_stream) ) {
+            streamer.setStatus("POSE:reach");
+            posed = true;
+            // jumps are measured from the pose on
+            max_jump = 0.0;
+        }
+        if( t >= next_stream ) {
+            if( !streaming ) {
+                streamer.setStatus("START-LISTENING");
+                streamer.setControlledLinks(pose_params.controlled_links);
+                streaming = true;
+            }
+            streamer.processPelvisTransform(tf_msg);
+            streamer.processJointCommand(js_msg);
+            streamer.update();
+            next_stream += 1.0 / stream_rate;
+        }
+        endpoint.update(t, SIM_DT);
+
+        // robot configuration data at feedback rate
+        if( t >= next_feedback ) {
+            IHMCMsgUtils::makeRobotConfigurationData(endpoint.getActualConfiguration(), config_msg);
+            streamer.processRobotConfigurationData(config_msg);
+            next_feedback += 1.0 / FEEDBACK_RATE;
+        }
+
+        // largest change of desired configuration in one step
+        const dynacore::Vector& q_desired = endpoint.getDesiredConfiguration();
+        for( int i = 0 ; i < joint_indices.size() ; i++ ) {
+            max_jump = std::max(max_jump, std::fabs(q_desired[joint_indices[i]] - q_prev[joint_indices[i]]));
+        }
+        q_prev = q_desired;
+    }
+
+    // streamed configuration reached
+    final_error = 0.0;
+    for( int i = 0 ; i < joint_indices.size() ; i++ ) {
+        final_error = std::max(final_error, std::fabs(endpoint.getDesiredConfiguration()[joint_indices[i]] - q_stream[joint_indices[i]]));
+    }
+
+    std::cout << std::left << std::setw(20) << name << std::right << std::fixed << std::setprecision(3)
+              << "  blend " << blend_duration << " s, max desired jump " << max_jump << " rad, final error "
+              << std::scientific << std::setprecision(1) << final_error << " rad" << std::endl;
+
+    return max_jump;
+}
+
+int main(int argc, char **argv) {
+    // default test settings
+    double blend_duration = 0.5;
+    double stream_start = 0.6;
+    double stream_rate = 10.0;
+    double pelvis_rate = 5.0;
+    double pose_time = 2.0;
+
+    // parse arguments
+    for( int i = 1 ; i + 1 < argc ; i += 2 ) {
+        std::string arg(argv[i]);
+        if( arg == "--blend" ) { blend_duration = std::max(0.0, std::stod(argv[i+1])); }
+        else if( arg == "--stream-start" ) { stream_start = std::max(0.0, std::stod(argv[i+1])); }
+        else if( arg == "--stream-rate" ) { stream_rate = std::max(1.0, std::stod(argv[i+1])); }
+        else if( arg == "--pelvis-rate" ) { pelvis_rate = std::max(1.0, std::stod(argv[i+1])); }
+        else if( arg == "--pose-time" ) { pose_time = std::max(0.0, std::stod(argv[i+1])); }
+        else { std::cout << "[Transition Blend Test] Unrecognized argument " << arg << std::endl; return 1; }
+    }
+
+    bool passed = true;
+    for( int mid_stream = 0 ; mid_stream < 2 ; mid_stream++ ) {
+        double unblended_error;
+        double blended_error;
+        double unblended_jump = runTest(mid_stream ? "unblended mid-stream" : "unblended", 0.0, stream_start, stream_rate,
+                                        pelvis_rate, pose_time, mid_stream, unblended_error);
+        double blended_jump = runTest(mid_stream ? "blended mid-stream" : "blended", blend_duration, stream_start, stream_rate,
+                                      pelvis_rate, pose_time, mid_stream, blended_error);
+
+        // blend spreads jump at start of streaming over blend duration; stream still reached;
+        // mid-stream, the pose only runs until each body part is next streamed, so the jump without blending is smaller
+        double max_ratio = mid_stream ? 0.5 : 0.25;
+        passed = passed && (blended_jump < max_ratio * unblended_jump) && (blended_error < 1e-6) && (unblended_error < 1e-6);
+    }
+    std::cout << "[Transition Blend Test] " << (passed ? "PASSED" : "FAILED") << std::endl;
+
+    return passed ? 0 : 1;
+}
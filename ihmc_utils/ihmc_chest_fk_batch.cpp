@@ -0,0 +1,265 @@
+/**
+ * Batched Chest Orientation Forward Kinematics
+ * Emily Sheetz, NSTGRO VTE 2021
+ **/
+
+#include <ihmc_utils/ihmc_chest_fk_batch.h>
+
+#include <cmath>
+
+// AVX2 kernel is compiled with a target attribute and chosen at runtime, so no compiler flags are needed;
+// define IHMC_DISABLE_SIMD to always use the scalar kernel
+#if !defined(IHMC_DISABLE_SIMD) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define IHMC_CHEST_FK_AVX2
+#include <immintrin.h>
+#endif
+
+namespace IHMCMsgUtils {
+
+    // BATCH LAYOUT
+    void IHMCChestFKBatch::resize(int n) {
+        pelvis_qx.resize(n);
+        pelvis_qy.resize(n);
+        pelvis_qz.resize(n);
+        pelvis_qw.resize(n);
+        torso_yaw.resize(n);
+        torso_pitch.resize(n);
+        torso_roll.resize(n);
+        chest_qx.resize(n);
+        chest_qy.resize(n);
+        chest_qz.resize(n);
+        chest_qw.resize(n);
+
+        return;
+    }
+
+    void IHMCChestFKBatch::setConfiguration(int i, const dynacore::Vector& q) {
+        pelvis_qx[i] = q[valkyrie_joint::virtual_Rx];
+        pelvis_qy[i] = q[valkyrie_joint::virtual_Ry];
+        pelvis_qz[i] = q[valkyrie_joint::virtual_Rz];
+        pelvis_qw[i] = q[valkyrie_joint::virtual_Rw];
+        torso_yaw[i] = q[valkyrie_joint::torsoYaw];
+        torso_pitch[i] = q[valkyrie_joint::torsoPitch];
+        torso_roll[i] = q[valkyrie_joint::torsoRoll];
+
+        return;
+    }
+
+    void IHMCChestFKBatch::getChestOrientation(int i, dynacore::Quaternion& chest_quat) const {
+        chest_quat.x() = chest_qx[i];
+        chest_quat.y() = chest_qy[i];
+        chest_quat.z() = chest_qz[i];
+        chest_quat.w() = chest_qw[i];
+
+        return;
+    }
+
+    int IHMCChestFKBatch::size() const {
+        return pelvis_qw.size();
+    }
+
+    // SCALAR KERNEL
+    namespace {
+        void computeChestOrientationsScalar(IHMCChestFKBatch& batch, int begin, int end) {
+            for( int i = begin ; i < end ; i++ ) {
+                // half-angle sines and cosines of torso joints
+                double cy = std::cos(0.5 * batch.torso_yaw[i]);
+                double sy = std::sin(0.5 * batch.torso_yaw[i]);
+                double cp = std::cos(0.5 * batch.torso_pitch[i]);
+                double sp = std::sin(0.5 * batch.torso_pitch[i]);
+                double cr = std::cos(0.5 * batch.torso_roll[i]);
+                double sr = std::sin(0.5 * batch.torso_roll[i]);
+
+                // Rz(yaw) * Ry(pitch)
+                double w1 = cy * cp;
+                double x1 = -sy * sp;
+                double y1 = cy * sp;
+                double z1 = sy * cp;
+
+                // torso rotation, Rz(yaw) * Ry(pitch) * Rx(roll)
+                double tw = w1 * cr - x1 * sr;
+                double tx = w1 * sr + x1 * cr;
+                double ty = y1 * cr + z1 * sr;
+                double tz = z1 * cr - y1 * sr;
+
+                // chest orientation, pelvis * torso
+                double pw = batch.pelvis_qw[i];
+                double px = batch.pelvis_qx[i];
+                double py = batch.pelvis_qy[i];
+                double pz = batch.pelvis_qz[i];
+                batch.chest_qw[i] = pw * tw - px * tx - py * ty - pz * tz;
+                batch.chest_qx[i] = pw * tx + px * tw + py * tz - pz * ty;
+                batch.chest_qy[i] = pw * ty - px * tz + py * tw + pz * tx;
+                batch.chest_qz[i] = pw * tz + px * ty - py * tx + pz * tw;
+            }
+
+            return;
+        }
+
+#ifdef IHMC_CHEST_FK_AVX2
+        // sine and cosine of 4 doubles; Cephes range reduction to [-pi/4, pi/4] and minimax polynomials
+        __attribute__((target("avx2,fma")))
+        inline void sincos4(__m256d x, __m256d& s, __m256d& c) {
+            const __m256d sign_mask = _mm256_set1_pd(-0.0);
+            const __m256d one = _mm256_set1_pd(1.0);
+            const __m256d two = _mm256_set1_pd(2.0);
+            const __m256d four = _mm256_set1_pd(4.0);
+            const __m256d eight = _mm256_set1_pd(8.0);
+
+            // work with |x| and restore sign of sine at end
+            __m256d x_sign = _mm256_and_pd(x, sign_mask);
+            __m256d ax = _mm256_andnot_pd(sign_mask, x);
+
+            // octant j (made even) such that ax = j * pi/4 + z
+            __m256d j = _mm256_floor_pd(_mm256_mul_pd(ax, _mm256_set1_pd(1.27323954473516268615))); // 4/pi
+            __m256d j_odd = _mm256_sub_pd(j, _mm256_mul_pd(two, _mm256_floor_pd(_mm256_mul_pd(j, _mm256_set1_pd(0.5)))));
+            j = _mm256_add_pd(j, j_odd);
+            __m256d z = _mm256_fnmadd_pd(j, _mm256_set1_pd(7.85398125648498535156E-1), ax);
+            z = _mm256_fnmadd_pd(j, _mm256_set1_pd(3.77489470793079817668E-8), z);
+            z = _mm256_fnmadd_pd(j, _mm256_set1_pd(2.69515142907905952645E-15), z);
+            __m256d j8 = _mm256_sub_pd(j, _mm256_mul_pd(eight, _mm256_floor_pd(_mm256_mul_pd(j, _mm256_set1_pd(0.125)))));
+
+            // sine and cosine polynomials on reduced argument
+            __m256d zz = _mm256_mul_pd(z, z);
+            __m256d ps = _mm256_set1_pd(1.58962301576546568060E-10);
+            ps = _mm256_fmadd_pd(ps, zz, _mm256_set1_pd(-2.50507477628578072866E-8));
+            ps = _mm256_fmadd_pd(ps, zz, _mm256_set1_pd(2.75573136213857245213E-6));
+            ps = _mm256_fmadd_pd(ps, zz, _mm256_set1_pd(-1.98412698295895385996E-4));
+            ps = _mm256_fmadd_pd(ps, zz, _mm256_set1_pd(8.33333333332211858878E-3));
+            ps = _mm256_fmadd_pd(ps, zz, _mm256_set1_pd(-1.66666666666666307295E-1));
+            __m256d sin_z = _mm256_fmadd_pd(_mm256_mul_pd(z, zz), ps, z);
+            __m256d pc = _mm256_set1_pd(-1.13585365213876817300E-11);
+            pc = _mm256_fmadd_pd(pc, zz, _mm256_set1_pd(2.08757008419747316778E-9));
+            pc = _mm256_fmadd_pd(pc, zz, _mm256_set1_pd(-2.75573141792967388112E-7));
+            pc = _mm256_fmadd_pd(pc, zz, _mm256_set1_pd(2.48015872888517045348E-5));
+            pc = _mm256_fmadd_pd(pc, zz, _mm256_set1_pd(-1.38888888888730564116E-3));
+            pc = _mm256_fmadd_pd(pc, zz, _mm256_set1_pd(4.16666666666665929218E-2));
+            __m256d cos_z = _mm256_fmadd_pd(_mm256_mul_pd(zz, zz), pc, _mm256_fnmadd_pd(_mm256_set1_pd(0.5), zz, one));
+
+            // octants 2 and 6 swap sine and cosine; octants 4 and 6 negate sine, octants 2 and 4 negate cosine
+            __m256d swap = _mm256_or_pd(_mm256_cmp_pd(j8, two, _CMP_EQ_OQ), _mm256_cmp_pd(j8, _mm256_set1_pd(6.0), _CMP_EQ_OQ));
+            __m256d sin_neg = _mm256_and_pd(_mm256_cmp_pd(j8, four, _CMP_GE_OQ), sign_mask);
+            __m256d cos_neg = _mm256_and_pd(_mm256_or_pd(_mm256_cmp_pd(j8, two, _CMP_EQ_OQ), _mm256_cmp_pd(j8, four, _CMP_EQ_OQ)), sign_mask);
+            s = _mm256_xor_pd(_mm256_blendv_pd(sin_z, cos_z, swap), _mm256_xor_pd(sin_neg, x_sign));
+            c = _mm256_xor_pd(_mm256_blendv_pd(cos_z, sin_z, swap), cos_neg);
+
+            return;
+        }
+
+        __attribute__((target("avx2,fma")))
+        int computeChestOrientationsAVX2(IHMCChestFKBatch& batch) {
+            const __m256d half = _mm256_set1_pd(0.5);
+            int n = batch.size();
+            int i = 0;
+            for( ; i + 4 <= n ; i += 4 ) {
+                // half-angle sines and cosines of torso joints
+                __m256d cy, sy, cp, sp, cr, sr;
+                sincos4(_mm256_mul_pd(half, _mm256_loadu_pd(&batch.torso_yaw[i])), sy, cy);
+                sincos4(_mm256_mul_pd(half, _mm256_loadu_pd(&batch.torso_pitch[i])), sp, cp);
+                sincos4(_mm256_mul_pd(half, _mm256_loadu_pd(&batch.torso_roll[i])), sr, cr);
+
+                // Rz(yaw) * Ry(pitch)
+                __m256d w1 = _mm256_mul_pd(cy, cp);
+                __m256d x1 = _mm256_xor_pd(_mm256_mul_pd(sy, sp), _mm256_set1_pd(-0.0));
+                __m256d y1 = _mm256_mul_pd(cy, sp);
+                __m256d z1 = _mm256_mul_pd(sy, cp);
+
+                // torso rotation, Rz(yaw) * Ry(pitch) * Rx(roll)
+                __m256d tw = _mm256_fmsub_pd(w1, cr, _mm256_mul_pd(x1, sr));
+                __m256d tx = _mm256_fmadd_pd(w1, sr, _mm256_mul_pd(x1, cr));
+                __m256d ty = _mm256_fmadd_pd(y1, cr, _mm256_mul_pd(z1, sr));
+                __m256d tz = _mm256_fmsub_pd(z1, cr, _mm256_mul_pd(y1, sr));
+
+                // chest orientation, pelvis * torso
+                __m256d pw = _mm256_loadu_pd(&batch.pelvis_qw[i]);
+                __m256d px = _mm256_loadu_pd(&batch.pelvis_qx[i]);
+                __m256d py = _mm256_loadu_pd(&batch.pelvis_qy[i]);
+                __m256d pz = _mm256_loadu_pd(&batch.pelvis_qz[i]);
+                __m256d qw = _mm256_mul_pd(pw, tw);
+                qw = _mm256_fnmadd_pd(px, tx, qw);
+                qw = _mm256_fnmadd_pd(py, ty, qw);
+                qw = _mm256_fnmadd_pd(pz, tz, qw);
+                __m256d qx = _mm256_mul_pd(pw, tx);
+                qx = _mm256_fmadd_pd(px, tw, qx);
+                qx = _mm256_fmadd_pd(py, tz, qx);
+                qx = _mm256_fnmadd_pd(pz, ty, qx);
+                __m256d qy = _mm256_mul_pd(pw, ty);
+                qy = _mm256_fnmadd_pd(px, tz, qy);
+                qy = _mm256_fmadd_pd(py, tw, qy);
+                qy = _mm256_fmadd_pd(pz, tx, qy);
+                __m256d qz = _mm256_mul_pd(pw, tz);
+                qz = _mm256_fmadd_pd(px, ty, qz);
+                qz = _mm256_fnmadd_pd(py, tx, qz);
+                qz = _mm256_fmadd_pd(pz, tw, qz);
+                _mm256_storeu_pd(&batch.chest_qw[i], qw);
+                _mm256_storeu_pd(&batch.chest_qx[i], qx);
+                _mm256_storeu_pd(&batch.chest_qy[i], qy);
+                _mm256_storeu_pd(&batch.chest_qz[i], qz);
+            }
+
+            // number of configurations computed; remainder is left for scalar kernel
+            return i;
+        }
+#endif
+    } // end anonymous namespace
+
+    // BATCH KERNELS
+    void computeChestOrientationsBatch(IHMCChestFKBatch& batch) {
+        if( isChestFKBatchAVX2Available() ) {
+            computeChestOrientationsBatchAVX2(batch);
+        }
+        else {
+            computeChestOrientationsBatchScalar(batch);
+        }
+
+        return;
+    }
+
+    void computeChestOrientationsBatchScalar(IHMCChestFKBatch& batch) {
+        computeChestOrientationsScalar(batch, 0, batch.size());
+
+        return;
+    }
+
+    void computeChestOrientationsBatchAVX2(IHMCChestFKBatch& batch) {
+        int num_computed = 0;
+#ifdef IHMC_CHEST_FK_AVX2
+        if( isChestFKBatchAVX2Available() ) {
+            num_computed = computeChestOrientationsAVX2(batch);
+        }
+#endif
+        // remainder (or whole batch, if AVX2 not available)
+        computeChestOrientationsScalar(batch, num_computed, batch.size());
+
+        return;
+    }
+
+    bool isChestFKBatchAVX2Available() {
+#ifdef IHMC_CHEST_FK_AVX2
+        static const bool available = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+        return available;
+#else
+        return false;
+#endif
+    }
+
+    void getChestOrientations(const std::vector<dynacore::Vector>& q_batch, std::vector<dynacore::Quaternion>& chest_quats) {
+        // pack configurations into structure-of-arrays layout
+        IHMCChestFKBatch batch;
+        batch.resize(q_batch.size());
+        for( int i = 0 ; i < q_batch.size() ; i++ ) {
+            batch.setConfiguration(i, q_batch[i]);
+        }
+
+        computeChestOrientationsBatch(batch);
+
+        // unpack chest orientations
+        chest_quats.resize(q_batch.size());
+        for( int i = 0 ; i < q_batch.size() ; i++ ) {
+            batch.getChestOrientation(i, chest_quats[i]);
+        }
+
+        return;
+    }
+
+} // end namespace IHMCMsgUtils
@@ -0,0 +1,100 @@
+/**
+ * Batched Chest Orientation Forward Kinematics
+ * Emily Sheetz, NSTGRO VTE 2021
+ **/
+
+#ifndef _IHMC_CHEST_FK_BATCH_H_
+#define _IHMC_CHEST_FK_BATCH_H_
+
+#include <vector>
+#include <Valkyrie/Valkyrie_Definition.h>
+#include <Utils/wrap_eigen.hpp>
+
+namespace IHMCMsgUtils {
+
+    /*
+     * the chest (torso link) orientation depends only on the pelvis orientation and the three torso joints;
+     * the torso joint axes are z (torsoYaw), y (torsoPitch), and x (torsoRoll) with no rotation between joint frames, so
+     *     chest_quat = pelvis_quat * Rz(torsoYaw) * Ry(torsoPitch) * Rx(torsoRoll)
+     * which is the same orientation Valkyrie_Model computes for valkyrie_link::torso, without building the model;
+     * batches are given as structure-of-arrays so the kernel can process several configurations per instruction
+     * (4 doubles per instruction with AVX2, chosen at runtime when the CPU supports it; scalar otherwise)
+     */
+
+    // STRUCT FOR A BATCH OF CONFIGURATIONS IN STRUCTURE-OF-ARRAYS LAYOUT
+    struct IHMCChestFKBatch {
+        // inputs: pelvis quaternion and torso joint angles (rad) of each configuration
+        std::vector<double> pelvis_qx;
+        std::vector<double> pelvis_qy;
+        std::vector<double> pelvis_qz;
+        std::vector<double> pelvis_qw;
+        std::vector<double> torso_yaw;
+        std::vector<double> torso_pitch;
+        std::vector<double> torso_roll;
+
+        // outputs: chest quaternion of each configuration
+        std::vector<double> chest_qx;
+        std::vector<double> chest_qy;
+        std::vector<double> chest_qz;
+        std::vector<double> chest_qw;
+
+        /*
+         * resizes all inputs and outputs
+         * @param n, the number of configurations in the batch
+         * @return none
+         */
+        void resize(int n);
+
+        /*
+         * sets the inputs of one configuration from a configuration vector
+         * @param i, the index of the configuration in the batch
+         * @param q, the configuration vector (valkyrie::num_q values)
+         * @return none
+         */
+        void setConfiguration(int i, const dynacore::Vector& q);
+
+        /*
+         * gets the output chest orientation of one configuration
+         * @param i, the index of the configuration in the batch
+         * @param chest_quat, the quaternion of the chest that will be updated
+         * @return none
+         */
+        void getChestOrientation(int i, dynacore::Quaternion& chest_quat) const;
+
+        int size() const;
+    };
+
+    /*
+     * computes chest orientations for all configurations in the batch
+     * @param batch, the batch with inputs set
+     * @return none
+     * @post batch outputs updated; uses the AVX2 kernel if available, otherwise the scalar kernel
+     */
+    void computeChestOrientationsBatch(IHMCChestFKBatch& batch);
+
+    /*
+     * computes chest orientations for all configurations in the batch with a specific kernel
+     * @param batch, the batch with inputs set
+     * @return none
+     * @post batch outputs updated
+     */
+    void computeChestOrientationsBatchScalar(IHMCChestFKBatch& batch);
+    void computeChestOrientationsBatchAVX2(IHMCChestFKBatch& batch);
+
+    /*
+     * checks whether the AVX2 kernel was compiled in and is supported by this CPU
+     * @return boolean indicating if computeChestOrientationsBatchAVX2 can be used
+     */
+    bool isChestFKBatchAVX2Available();
+
+    /*
+     * computes chest orientations for many configurations
+     * @param q_batch, the configuration vectors
+     * @param chest_quats, the chest quaternions that will be updated (one per configuration)
+     * @return none
+     */
+    void getChestOrientations(const std::vector<dynacore::Vector>& q_batch, std::vector<dynacore::Quaternion>& chest_quats);
+
+} // end namespace IHMCMsgUtils
+
+#endif
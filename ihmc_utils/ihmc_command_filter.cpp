@@ -0,0 +1,194 @@
+/**
+ * IHMC Command Filter
+ * Emily Sheetz, NSTGRO VTE 2021
+ **/
+
+#include <ihmc_utils/ihmc_command_filter.h>
+
+#include <cmath>
+
+namespace IHMCMsgUtils {
+
+    // HELPER FUNCTIONS
+    namespace {
+        // smoothing factor of first-order low-pass filter with given cutoff (Hz) for given time step (s)
+        double getLowPassAlpha(double dt, double cutoff) {
+            return 1.0 / (1.0 + 1.0 / (2.0 * M_PI * cutoff * dt));
+        }
+
+        // rotation vector (axis times angle) of a unit quaternion with non-negative w
+        Eigen::Vector3d getRotationVector(const dynacore::Quaternion& quat) {
+            double sin_half_angle = quat.vec().norm();
+            if( sin_half_angle < 1e-12 ) {
+                return 2.0 * quat.vec();
+            }
+            double angle = 2.0 * std::atan2(sin_half_angle, quat.w());
+            return (angle / sin_half_angle) * quat.vec();
+        }
+
+        // unit quaternion from rotation vector
+        dynacore::Quaternion getQuaternionFromRotationVector(const Eigen::Vector3d& rot) {
+            double angle = rot.norm();
+            if( angle < 1e-12 ) {
+                return dynacore::Quaternion(1.0, 0.5 * rot.x(), 0.5 * rot.y(), 0.5 * rot.z()).normalized();
+            }
+            return dynacore::Quaternion(Eigen::AngleAxisd(angle, rot / angle));
+        }
+    } // end anonymous namespace
+
+    bool getCommandFilterType(const std::string& name, int& type) {
+        if( name == "none" ) {
+            type = COMMAND_FILTER_NONE;
+        }
+        else if( name == "one_euro" ) {
+            type = COMMAND_FILTER_ONE_EURO;
+        }
+        else if( name == "critically_damped" ) {
+            type = COMMAND_FILTER_CRITICALLY_DAMPED;
+        }
+        else {
+            return false;
+        }
+
+        return true;
+    }
+
+    // VECTOR FILTER
+    IHMCVectorFilter::IHMCVectorFilter(IHMCCommandFilterParams params) {
+        setParams(params);
+    }
+
+    IHMCVectorFilter::~IHMCVectorFilter() {
+    }
+
+    void IHMCVectorFilter::setParams(IHMCCommandFilterParams params) {
+        params_ = params;
+        reset();
+        return;
+    }
+
+    void IHMCVectorFilter::reset() {
+        initialized_ = false;
+        return;
+    }
+
+    void IHMCVectorFilter::filter(double time, const Eigen::VectorXd& x, Eigen::VectorXd& x_filtered) {
+        // no filtering
+        if( params_.type == COMMAND_FILTER_NONE ) {
+            x_filtered = x;
+            return;
+        }
+
+        // start from input if there is no state, or state is stale
+        double dt = time - last_time_;
+        if( !initialized_ || (x_hat_.size() != x.size()) || (dt < 0.0) || (dt > params_.reset_interval) ) {
+            x_hat_ = x.array();
+            dx_hat_ = Eigen::ArrayXd::Zero(x.size());
+            last_time_ = time;
+            initialized_ = true;
+            x_filtered = x;
+            return;
+        }
+
+        // inputs with same time do not advance filter
+        if( dt > 0.0 ) {
+            if( params_.type == COMMAND_FILTER_ONE_EURO ) {
+                // low-pass filtered speed sets cutoff of each value
+                Eigen::ArrayXd dx = (x.array() - x_hat_) / dt;
+                double alpha_d = getLowPassAlpha(dt, params_.derivative_cutoff);
+                dx_hat_ = alpha_d * dx + (1.0 - alpha_d) * dx_hat_;
+                Eigen::ArrayXd cutoff = params_.min_cutoff + params_.beta * dx_hat_.abs();
+                Eigen::ArrayXd alpha = 1.0 / (1.0 + 1.0 / (2.0 * M_PI * dt * cutoff));
+                x_hat_ = alpha * x.array() + (1.0 - alpha) * x_hat_;
+            }
+            else if( params_.type == COMMAND_FILTER_CRITICALLY_DAMPED ) {
+                // exact solution toward input held over time step, stable for any time step
+                double wn = params_.natural_frequency;
+                double decay = std::exp(-wn * dt);
+                Eigen::ArrayXd e0 = x_hat_ - x.array();
+                Eigen::ArrayXd c = dx_hat_ + wn * e0;
+                x_hat_ = x.array() + (e0 + c * dt) * decay;
+                dx_hat_ = (dx_hat_ - wn * dt * c) * decay;
+            }
+            last_time_ = time;
+        }
+
+        x_filtered = x_hat_.matrix();
+
+        return;
+    }
+
+    // QUATERNION FILTER
+    IHMCQuaternionFilter::IHMCQuaternionFilter(IHMCCommandFilterParams params) {
+        setParams(params);
+    }
+
+    IHMCQuaternionFilter::~IHMCQuaternionFilter() {
+    }
+
+    void IHMCQuaternionFilter::setParams(IHMCCommandFilterParams params) {
+        params_ = params;
+        reset();
+        return;
+    }
+
+    void IHMCQuaternionFilter::reset() {
+        initialized_ = false;
+        return;
+    }
+
+    void IHMCQuaternionFilter::filter(double time, const dynacore::Quaternion& quat, dynacore::Quaternion& quat_filtered) {
+        // no filtering
+        if( params_.type == COMMAND_FILTER_NONE ) {
+            quat_filtered = quat;
+            return;
+        }
+
+        // start from input if there is no state, or state is stale
+        dynacore::Quaternion quat_in = quat.normalized();
+        double dt = time - last_time_;
+        if( !initialized_ || (dt < 0.0) || (dt > params_.reset_interval) ) {
+            quat_hat_ = quat_in;
+            omega_hat_.setZero();
+            last_time_ = time;
+            initialized_ = true;
+            quat_filtered = quat_hat_;
+            return;
+        }
+
+        // q and -q are the same orientation; use the one closest to filtered orientation
+        if( quat_hat_.dot(quat_in) < 0.0 ) {
+            quat_in.coeffs() *= -1.0;
+        }
+
+        // inputs with same time do not advance filter
+        if( dt > 0.0 ) {
+            // rotation from filtered orientation to input, in body frame
+            Eigen::Vector3d rot_error = getRotationVector(quat_hat_.conjugate() * quat_in);
+
+            if( params_.type == COMMAND_FILTER_ONE_EURO ) {
+                // low-pass filtered angular speed sets cutoff
+                double alpha_d = getLowPassAlpha(dt, params_.derivative_cutoff);
+                omega_hat_ = alpha_d * (rot_error / dt) + (1.0 - alpha_d) * omega_hat_;
+                double alpha = getLowPassAlpha(dt, params_.min_cutoff + params_.beta * omega_hat_.norm());
+                quat_hat_ = quat_hat_ * getQuaternionFromRotationVector(alpha * rot_error);
+            }
+            else if( params_.type == COMMAND_FILTER_CRITICALLY_DAMPED ) {
+                // exact solution toward input held over time step, with error as rotation from input to filtered orientation
+                double wn = params_.natural_frequency;
+                double decay = std::exp(-wn * dt);
+                Eigen::Vector3d e0 = -rot_error;
+                Eigen::Vector3d c = omega_hat_ + wn * e0;
+                quat_hat_ = quat_in * getQuaternionFromRotationVector((e0 + c * dt) * decay);
+                omega_hat_ = (omega_hat_ - wn * dt * c) * decay;
+            }
+            quat_hat_.normalize();
+            last_time_ = time;
+        }
+
+        quat_filtered = quat_hat_;
+
+        return;
+    }
+
+} // end namespace IHMCMsgUtils
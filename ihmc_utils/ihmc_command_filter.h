@@ -0,0 +1,124 @@
+/**
+ * IHMC Command Filter
+ * Emily Sheetz, NSTGRO VTE 2021
+ **/
+
+#ifndef _IHMC_COMMAND_FILTER_H_
+#define _IHMC_COMMAND_FILTER_H_
+
+#include <string>
+#include <Utils/wrap_eigen.hpp>
+
+namespace IHMCMsgUtils {
+
+    /*
+     * smoothing filters applied to incoming commands before they are built into messages, so noisy controller outputs
+     * do not need a long stream integration duration to look smooth;
+     * all joints are filtered at once in Eigen array form, and the pelvis orientation is filtered on the rotation group
+     * (errors are rotation vectors, so the filtered orientation stays a unit quaternion and never flips sign)
+     *
+     * one-euro: a low-pass filter whose cutoff rises with speed (min_cutoff + beta * |speed|), little lag when moving
+     * critically damped: a second-order filter with natural frequency natural_frequency, stepped exactly for each input
+     */
+
+    // TYPES OF FILTER
+    enum IHMCCommandFilterType {
+        COMMAND_FILTER_NONE = 0,
+        COMMAND_FILTER_ONE_EURO,
+        COMMAND_FILTER_CRITICALLY_DAMPED
+    };
+
+    // STRUCT FOR FILTER PARAMETERS
+    struct IHMCCommandFilterParams {
+        // type of filter
+        int type;
+
+        // one-euro: minimum cutoff frequency (Hz), increase of cutoff with speed, and cutoff for speed estimate (Hz)
+        double min_cutoff;
+        double beta;
+        double derivative_cutoff;
+
+        // critically damped: natural frequency (rad/s); lag behind a ramp is 2 / natural_frequency seconds
+        double natural_frequency;
+
+        // gap (s) between inputs after which filter restarts from the next input, rather than sweeping from stale state
+        double reset_interval;
+
+        // DEFAULT CONSTRUCTOR; sets all parameters to default values
+        IHMCCommandFilterParams() {
+            type = COMMAND_FILTER_NONE;
+            min_cutoff = 1.0;
+            beta = 0.5;
+            derivative_cutoff = 1.0;
+            natural_frequency = 50.0;
+            reset_interval = 1.0;
+        }
+    };
+
+    /*
+     * gets filter type from its name
+     * @param name, the name of the filter ("none", "one_euro", or "critically_damped")
+     * @param type, the filter type that will be updated
+     * @return bool indicating if name was recognized
+     */
+    bool getCommandFilterType(const std::string& name, int& type);
+
+    // FILTER FOR A VECTOR OF INDEPENDENT VALUES (e.g., joint positions, pelvis position)
+    class IHMCVectorFilter
+    {
+    public:
+        // CONSTRUCTORS/DESTRUCTORS
+        IHMCVectorFilter(IHMCCommandFilterParams params = IHMCCommandFilterParams());
+        ~IHMCVectorFilter();
+
+        void setParams(IHMCCommandFilterParams params);
+        void reset();
+
+        /*
+         * filters the next input
+         * @param time, the time (s) of the input
+         * @param x, the input values
+         * @param x_filtered, the filtered values that will be updated (may be the same vector as x)
+         * @return none
+         */
+        void filter(double time, const Eigen::VectorXd& x, Eigen::VectorXd& x_filtered);
+
+    private:
+        IHMCCommandFilterParams params_; // filter parameters
+        bool initialized_; // flag indicating whether filter has a state
+        double last_time_; // time (s) of last input
+        Eigen::ArrayXd x_hat_; // filtered values
+        Eigen::ArrayXd dx_hat_; // filtered rates of change
+    };
+
+    // FILTER FOR AN ORIENTATION
+    class IHMCQuaternionFilter
+    {
+    public:
+        // CONSTRUCTORS/DESTRUCTORS
+        IHMCQuaternionFilter(IHMCCommandFilterParams params = IHMCCommandFilterParams());
+        ~IHMCQuaternionFilter();
+
+        void setParams(IHMCCommandFilterParams params);
+        void reset();
+
+        /*
+         * filters the next input
+         * @param time, the time (s) of the input
+         * @param quat, the input orientation
+         * @param quat_filtered, the filtered orientation that will be updated (may be the same quaternion as quat)
+         * @return none
+         */
+        void filter(double time, const dynacore::Quaternion& quat, dynacore::Quaternion& quat_filtered);
+
+    private:
+        IHMCCommandFilterParams params_; // filter parameters
+        bool initialized_; // flag indicating whether filter has a state
+        double last_time_; // time (s) of last input
+        dynacore::Quaternion quat_hat_; // filtered orientation
+        Eigen::Vector3d omega_hat_; // filtered angular velocity (rad/s, body frame)
+    };
+
+} // end namespace IHMCMsgUtils
+
+#endif
@@ -0,0 +1,41 @@
+/**
+ * IHMC Command Publisher
+ * Emily Sheetz, NSTGRO VTE 2021
+ **/
+
+#include <ihmc_utils/ihmc_command_publisher.h>
+
+namespace IHMCMsgUtils {
+
+    // CONSTRUCTORS/DESTRUCTORS
+    IHMCCommandPublisher::IHMCCommandPublisher() {
+    }
+
+    IHMCCommandPublisher::~IHMCCommandPublisher() {
+    }
+
+    // CONNECTIONS
+    bool IHMCCommandPublisher::connect(ros::NodeHandle& nh, IHMCCommandStreamer& streamer,
+                                       const std::vector<std::string>& wholebody_output_topics) {
+        // publishers for sending messages to IHMC
+        // whole-body messages may go to several output targets (e.g., SCS, logger, visualization)
+        bool advertised = wholebody_pub_.advertise(nh, wholebody_output_topics, 1);
+        go_home_pub_ = nh.advertise<controller_msgs::GoHomeMessage>("/ihmc/valkyrie/humanoid_control/input/go_home", 20);
+        finger_pub_ = nh.advertise<controller_msgs::ValkyrieHandFingerTrajectoryMessage>("/ihmc/valkyrie/humanoid_control/input/valkyrie_hand_finger_trajectory", 10);
+        stop_pub_ = nh.advertise<controller_msgs::StopAllTrajectoryMessage>("/ihmc/valkyrie/humanoid_control/input/stop_all_trajectory", 1);
+
+        // messages built by streamer go out on publishers
+        streamer.setWholeBodyMessageSink([this](const controller_msgs::WholeBodyTrajectoryMessage& msg) { wholebody_pub_.publish(msg); });
+        streamer.setGoHomeMessageSink([this](const controller_msgs::GoHomeMessage& msg) { go_home_pub_.publish(msg); });
+        streamer.setHandFingerMessageSink([this](const controller_msgs::ValkyrieHandFingerTrajectoryMessage& msg) { finger_pub_.publish(msg); });
+        streamer.setStopAllTrajectoryMessageSink([this](const controller_msgs::StopAllTrajectoryMessage& msg) { stop_pub_.publish(msg); });
+
+        return advertised;
+    }
+
+    // HELPER FUNCTIONS
+    std::vector<std::string> IHMCCommandPublisher::getDefaultWholeBodyOutputTopics() {
+        return std::vector<std::string>{"/ihmc/valkyrie/humanoid_control/input/whole_body_trajectory"};
+    }
+
+} // end namespace IHMCMsgUtils
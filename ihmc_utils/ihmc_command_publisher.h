@@ -0,0 +1,54 @@
+/**
+ * IHMC Command Publisher
+ * Emily Sheetz, NSTGRO VTE 2021
+ **/
+
+#ifndef _IHMC_COMMAND_PUBLISHER_H_
+#define _IHMC_COMMAND_PUBLISHER_H_
+
+#include <string>
+#include <vector>
+#include <ros/ros.h>
+#include <ihmc_utils/ihmc_command_streamer.h>
+#include <ihmc_utils/ihmc_fanout_publisher.h>
+
+namespace IHMCMsgUtils {
+
+    /*
+     * ROS binding for an IHMCCommandStreamer: advertises the IHMC input topics and publishes every message the
+     * streamer builds on them;
+     * used by the IHMC Interface Node, and by controllers that embed the streamer to send commands straight to IHMC,
+     * saving the serialization and extra hop through the node; must outlive any use of the streamer's sinks
+     */
+    class IHMCCommandPublisher
+    {
+    public:
+        // CONSTRUCTORS/DESTRUCTORS
+        IHMCCommandPublisher();
+        ~IHMCCommandPublisher();
+
+        // CONNECTIONS
+        /*
+         * advertises publishers for IHMC messages and sets the streamer's output sinks to publish on them
+         * @param nh, the node handle used to advertise
+         * @param streamer, the streamer whose messages will be published
+         * @param wholebody_output_topics, the topics whole-body messages are published to (e.g., IHMC, logger, visualization);
+         *        each message is serialized once for all topics
+         * @return bool indicating if at least one whole-body output topic was advertised
+         */
+        bool connect(ros::NodeHandle& nh, IHMCCommandStreamer& streamer,
+                     const std::vector<std::string>& wholebody_output_topics = getDefaultWholeBodyOutputTopics());
+
+        // HELPER FUNCTIONS
+        static std::vector<std::string> getDefaultWholeBodyOutputTopics();
+
+    private:
+        IHMCFanOutPublisher<controller_msgs::WholeBodyTrajectoryMessage> wholebody_pub_; // publisher for wholebody messages, serialized once for all output topics
+        ros::Publisher go_home_pub_; // publisher for go home messages
+        ros::Publisher finger_pub_; // publisher for finger messages
+        ros::Publisher stop_pub_; // publisher for stop messages
+    };
+
+} // end namespace IHMCMsgUtils
+
+#endif
@@ -0,0 +1,1794 @@
+/**
+ * IHMC Command Streamer
+ * Emily Sheetz, NSTGRO VTE 2021
+ **/
+
+#include <ihmc_utils/ihmc_command_streamer.h>
+
+namespace IHMCMsgUtils {
+
+    // HELPER FUNCTIONS
+    namespace {
+        // sets stream integration duration of every queueable message in a body part message
+        class StreamIntegrationDurationSetter
+        {
+        public:
+            StreamIntegrationDurationSetter(double stream_integration_duration) : stream_integration_duration_(stream_integration_duration) {}
+
+            template <class T, class F>
+            void operator()(const IHMCFieldPath& path, T& value, F field) {
+                return;
+            }
+
+            template <class T>
+            void operator()(const IHMCFieldPath& path, T& value, IHMCStreamIntegrationDurationField field) {
+                value = static_cast<T>(stream_integration_duration_);
+                return;
+            }
+
+        private:
+            double stream_integration_duration_; // stream integration duration (s)
+        };
+    } // end anonymous namespace
+
+    // CONSTRUCTORS/DESTRUCTORS
+    IHMCCommandStreamer::IHMCCommandStreamer(bool commands_from_controllers) {
+        commands_from_controllers_ = commands_from_controllers;
+
+        // default clock is system clock, same as message timestamps
+        clock_ = []() {
+            return static_cast<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count());
+        };
+        verbose_ = true;
+        monitor_tracking_ = false;
+        stream_integration_duration_ = 0.13;
+        last_schedule_time_ = 0;
+        stream_period_ = 0;
+        schedule_reset_ = true;
+        finger_stream_min_interval_ = 0.02;
+        finger_stream_integration_duration_ = 0.05;
+
+        // stop message has no content besides sequence id, so it is built once and ready to publish
+        IHMCMsgUtils::IHMCMessageParameters stop_params;
+        IHMCMsgUtils::makeIHMCStopAllTrajectoryMessage(stop_msg_, stop_params);
+        stop_on_stop_listening_ = true;
+        streaming_ = false;
+        num_stops_ = 0;
+        last_stop_latency_ = 0.0;
+        max_stop_latency_ = 0.0;
+
+        // initialize flags for receiving and publishing messages
+        if( commands_from_controllers_ ) {
+            receive_pelvis_transform_ = false;
+            receive_joint_command_ = false;
+            receive_link_ids_ = false;
+            received_link_ids_ = false;
+        }
+        else {
+            receive_pelvis_transform_ = true;
+            receive_joint_command_ = true;
+            receive_link_ids_ = false;
+            received_link_ids_ = true;
+            // will not wait for link ids, assume all links controlled
+            controlled_links_.clear();
+            controlled_links_.push_back(valkyrie_link::pelvis);
+            controlled_links_.push_back(valkyrie_link::torso);
+            controlled_links_.push_back(valkyrie_link::rightCOP_Frame);
+            controlled_links_.push_back(valkyrie_link::leftCOP_Frame);
+            controlled_links_.push_back(valkyrie_link::rightPalm);
+            controlled_links_.push_back(valkyrie_link::leftPalm);
+            controlled_links_.push_back(valkyrie_link::head);
+        }
+        cartesian_hand_goals_ = false;
+        received_pelvis_transform_ = false;
+        received_joint_command_ = false;
+        received_left_hand_goal_ = false;
+        received_right_hand_goal_ = false;
+        received_bimanual_hand_goal_ = false;
+        publish_commands_ = false;
+        stop_node_ = false;
+
+        home_left_arm_ = false;
+        home_right_arm_ = false;
+        home_chest_ = false;
+        home_pelvis_ = false;
+        publish_go_home_command_ = false;
+
+        open_left_hand_ = false;
+        close_left_hand_ = false;
+        open_right_hand_ = false;
+        close_right_hand_ = false;
+        received_finger_position_[0] = false;
+        received_finger_position_[1] = false;
+        finger_publish_time_[0] = 0;
+        finger_publish_time_[1] = 0;
+        publish_finger_command_ = false;
+        publish_hand_command_ = false;
+
+        // set initial empty status
+        status_ = std::string("");
+    }
+
+    IHMCCommandStreamer::~IHMCCommandStreamer() {
+        // write seek index and close input capture log
+        input_log_.close();
+    }
+
+    // OUTPUTS
+    void IHMCCommandStreamer::setWholeBodyMessageSink(WholeBodyMessageSink sink) {
+        wholebody_sink_ = sink;
+        return;
+    }
+
+    void IHMCCommandStreamer::setGoHomeMessageSink(GoHomeMessageSink sink) {
+        go_home_sink_ = sink;
+        return;
+    }
+
+    void IHMCCommandStreamer::setHandFingerMessageSink(HandFingerMessageSink sink) {
+        finger_sink_ = sink;
+        return;
+    }
+
+    void IHMCCommandStreamer::setStopAllTrajectoryMessageSink(StopAllTrajectoryMessageSink sink) {
+        stop_sink_ = sink;
+        return;
+    }
+
+    void IHMCCommandStreamer::setClock(Clock clock) {
+        clock_ = clock;
+        return;
+    }
+
+    void IHMCCommandStreamer::setVerbose(bool verbose) {
+        verbose_ = verbose;
+        return;
+    }
+
+    // INPUT CAPTURE
+    bool IHMCCommandStreamer::openInputLog(std::string filename, int keyframe_interval) {
+        return input_log_.open(filename, keyframe_interval);
+    }
+
+    void IHMCCommandStreamer::closeInputLog() {
+        input_log_.close();
+        return;
+    }
+
+    // COMMAND FILTERING
+    void IHMCCommandStreamer::setCommandFilterParams(IHMCCommandFilterParams filter_params) {
+        joint_filter_.setParams(filter_params);
+        pelvis_position_filter_.setParams(filter_params);
+        pelvis_orientation_filter_.setParams(filter_params);
+        return;
+    }
+
+    void IHMCCommandStreamer::setStreamIntegrationDuration(double stream_integration_duration) {
+        stream_integration_duration_ = stream_integration_duration;
+        return;
+    }
+
+    void IHMCCommandStreamer::setBodyPartStreamRate(int link_id, double rate, double stream_integration_duration) {
+        if( rate <= 0.0 ) {
+            // stream link in every message
+            body_part_streams_.erase(link_id);
+            return;
+        }
+
+        BodyPartStream& stream = body_part_streams_[link_id];
+        stream.period = static_cast<int64_t>(1e9 / rate);
+        // integration duration should be equal to or slightly longer than interval between messages including link
+        stream.stream_integration_duration = (stream_integration_duration > 0.0) ? stream_integration_duration : (1.3 / rate);
+        stream.next_publish_time = 0;
+
+        return;
+    }
+
+    void IHMCCommandStreamer::clearBodyPartStreamRates() {
+        body_part_streams_.clear();
+        return;
+    }
+
+    void IHMCCommandStreamer::setFingerStreamParameters(double min_interval, double stream_integration_duration) {
+        finger_stream_min_interval_ = min_interval;
+        finger_stream_integration_duration_ = stream_integration_duration;
+        return;
+    }
+
+    void IHMCCommandStreamer::setTransitionBlendDuration(double blend_duration) {
+        transition_blender_.setBlendDuration(blend_duration);
+        return;
+    }
+
+    // STOPPING
+    void IHMCCommandStreamer::setStopOnStopListening(bool stop_on_stop_listening) {
+        stop_on_stop_listening_ = stop_on_stop_listening;
+        return;
+    }
+
+    double IHMCCommandStreamer::getLastStopLatency() {
+        return last_stop_latency_;
+    }
+
+    double IHMCCommandStreamer::getMaxStopLatency() {
+        return max_stop_latency_;
+    }
+
+    int IHMCCommandStreamer::getNumStops() {
+        return num_stops_;
+    }
+
+    // TRACKING MONITOR
+    void IHMCCommandStreamer::setTrackingMonitorEnabled(bool enabled) {
+        monitor_tracking_ = enabled;
+        tracking_monitor_.reset();
+        return;
+    }
+
+    IHMCTrackingMonitor& IHMCCommandStreamer::getTrackingMonitor() {
+        return tracking_monitor_;
+    }
+
+    // POSE LIBRARY
+    bool IHMCCommandStreamer::loadPoseLibrary(std::string filename) {
+        bool loaded = pose_library_.load(filename);
+        if( verbose_ ) {
+            ROS_INFO("[IHMC Command Streamer] Loaded %d poses from %s", pose_library_.getNumPoses(), filename.c_str());
+        }
+        return loaded;
+    }
+
+    IHMCPoseLibrary& IHMCCommandStreamer::getPoseLibrary() {
+        return pose_library_;
+    }
+
+    // INPUTS
+    void IHMCCommandStreamer::processPelvisTransform(const geometry_msgs::TransformStamped& tf_msg) {
+        // capture input for replay
+        if( input_log_.isOpen() ) {
+            input_log_.logPelvisTransform(clock_(), tf_msg);
+        }
+
+        if( receive_pelvis_transform_ ) {
+            // set pelvis pose from message
+            Eigen::VectorXd pelvis_pos(3);
+            pelvis_pos << tf_msg.transform.translation.x, tf_msg.transform.translation.y, tf_msg.transform.translation.z;
+            dynacore::Quaternion pelvis_quat(tf_msg.transform.rotation.w, tf_msg.transform.rotation.x,
+                                             tf_msg.transform.rotation.y, tf_msg.transform.rotation.z);
+            applyPelvisPose(pelvis_pos, pelvis_quat);
+        }
+
+        // update flag to publish commands
+        updatePublishCommandsFlag();
+
+        // update flag to stop node
+        updateStopNodeFlag();
+
+        return;
+    }
+
+    void IHMCCommandStreamer::processPartialPelvisTransform(const IHMCPartialTransformStamped& tf_msg) {
+        // capture input for replay, in the same form as full transforms
+        if( input_log_.isOpen() ) {
+            geometry_msgs::TransformStamped full_tf_msg;
+            full_tf_msg.transform = tf_msg.transform;
+            input_log_.logPelvisTransform(clock_(), full_tf_msg);
+        }
+
+        if( receive_pelvis_transform_ ) {
+            // set pelvis pose from message
+            Eigen::VectorXd pelvis_pos(3);
+            pelvis_pos << tf_msg.transform.translation.x, tf_msg.transform.translation.y, tf_msg.transform.translation.z;
+            dynacore::Quaternion pelvis_quat(tf_msg.transform.rotation.w, tf_msg.transform.rotation.x,
+                                             tf_msg.transform.rotation.y, tf_msg.transform.rotation.z);
+            applyPelvisPose(pelvis_pos, pelvis_quat);
+        }
+
+        // update flag to publish commands
+        updatePublishCommandsFlag();
+
+        // update flag to stop node
+        updateStopNodeFlag();
+
+        return;
+    }
+
+    void IHMCCommandStreamer::processControlledLinkIds(const std_msgs::Int32MultiArray& arr_msg) {
+        // capture input for replay
+        if( input_log_.isOpen() ) {
+            input_log_.logControlledLinkIds(clock_(), arr_msg);
+        }
+
+        if( receive_link_ids_ ) {
+            // clear vector of controlled links
+            controlled_links_.clear();
+
+            // set controlled links
+            for( int i = 0 ; i < arr_msg.data.size() ; i++ ) {
+                controlled_links_.push_back(arr_msg.data[i]);
+            }
+
+            // set flag indicating link ids have been received
+            received_link_ids_ = true;
+
+            // set flag to no longer receive link ids
+            if( !commands_from_controllers_ ) {
+                receive_link_ids_ = false;
+            }
+        }
+
+        // update flag to publish commands
+        updatePublishCommandsFlag();
+
+        // update flag to stop node
+        updateStopNodeFlag();
+
+        return;
+    }
+
+    void IHMCCommandStreamer::processJointCommand(const sensor_msgs::JointState& js_msg) {
+        // capture input for replay
+        if( input_log_.isOpen() ) {
+            input_log_.logJointCommand(clock_(), js_msg);
+        }
+
+        if( receive_joint_command_ ) {
+            // resize vector for joint positions
+            q_joint_.resize(valkyrie::num_act_joint);
+            q_joint_.setZero();
+
+            // set positions for each joint
+            for( int i = 0 ; i < js_msg.position.size(); i++ ) {
+                // joint state message may contain joints we don't care about, especially when coming from IHMC
+                // messages coming from ControllerManager will not have this problem, but it's good to be safe
+                // check if joint is one of Valkyrie's action joints
+                std::map<std::string, int>::iterator it;
+                it = val::joint_names_to_indices.find(js_msg.name[i]);
+                if( it != val::joint_names_to_indices.end() ) {
+                    // joint state message may publish joints in an order not expected by configuration vector
+                    // set index for joint based on joint name; add offset to ignoring virtual joints
+                    int jidx = val::joint_names_to_indices[js_msg.name[i]] - valkyrie::num_virtual;
+                    q_joint_[jidx] = js_msg.position[i];
+                }
+                // if joint name is not one of Valkyrie's action joints, ignore it
+            }
+
+            // smooth joint positions and set flags
+            applyJointCommand();
+        }
+
+        // update flag to publish commands
+        updatePublishCommandsFlag();
+
+        // update flag to stop node
+        updateStopNodeFlag();
+
+        return;
+    }
+
+    void IHMCCommandStreamer::processStatus(const std_msgs::String& status_msg) {
+        // status received now
+        processStatus(status_msg, std::chrono::steady_clock::now());
+        return;
+    }
+
+    void IHMCCommandStreamer::processStatus(const std_msgs::String& status_msg, std::chrono::steady_clock::time_point receipt_time) {
+        // stopping is the most urgent status; publish prebuilt stop message before doing anything else
+        if( status_msg.data == std::string("STOP-LISTENING") ) {
+            publishStopMessage(receipt_time);
+        }
+
+        // capture input for replay
+        if( input_log_.isOpen() ) {
+            input_log_.logStatus(clock_(), status_msg);
+        }
+
+        if( status_msg.data == std::string("STOP-LISTENING") ) {
+            // set status
+            status_ = status_msg.data;
+
+            // controllers have converged, do not receive any more messages
+            receive_pelvis_transform_ = false;
+            received_pelvis_transform_ = false;
+            receive_link_ids_ = false;
+            received_link_ids_ = false;
+            receive_joint_command_ = false;
+            received_joint_command_ = false;
+
+            // update flag to publish commands
+            updatePublishCommandsFlag();
+
+            // update flag to stop node
+            updateStopNodeFlag();
+
+            if( verbose_ ) {
+                ROS_INFO("[IHMC Command Streamer] Controllers stopped, no longer publishing whole-body messages");
+            }
+            if( verbose_ ) {
+                ROS_INFO("[IHMC Command Streamer] Waiting for status change to receive more joint commands...");
+            }
+            // stream of messages can be ended with message with velocity of 0
+            // messages are sent with velocity 0 outside of transition blends, so ending on any message is fine;
+            // a message sent during a blend is only integrated for its stream integration duration;
+            // stop message (if enabled) already published, so robot holds where it is instead of finishing last command
+        }
+        else if( status_msg.data == std::string("START-LISTENING") ) {
+            // set status
+            status_ = status_msg.data;
+
+            // controllers are started, prepare to receive messages
+            // new stream sends every body part right away and measures its own stream period
+            schedule_reset_ = true;
+            receive_pelvis_transform_ = true;
+            received_pelvis_transform_ = false;
+            receive_link_ids_ = true;
+            received_link_ids_ = false;
+            receive_joint_command_ = true;
+            received_joint_command_ = false;
+
+            // update flag to publish commands
+            updatePublishCommandsFlag();
+
+            // update flag to stop node
+            updateStopNodeFlag();
+
+            if( verbose_ ) {
+                ROS_INFO("[IHMC Command Streamer] Controllers started, waiting for joint commands...");
+            }
+        }
+        else if( status_msg.data == std::string("HOME-LEFTARM") ) {
+            // set status
+            status_ = status_msg.data;
+
+            // set flag
+            home_left_arm_ = true;
+
+            // update flag to publish go home message
+            updatePublishGoHomeCommandFlag();
+
+            if( verbose_ ) {
+                ROS_INFO("[IHMC Command Streamer] Homing left arm...");
+            }
+        }
+        else if( status_msg.data == std::string("HOME-RIGHTARM") ) {
+            // set status
+            status_ = status_msg.data;
+
+            // set flag
+            home_right_arm_ = true;
+
+            // update flag to publish go home message
+            updatePublishGoHomeCommandFlag();
+
+            if( verbose_ ) {
+                ROS_INFO("[IHMC Command Streamer] Homing right arm...");
+            }
+        }
+        else if( status_msg.data == std::string("HOME-CHEST") ) {
+            // set status
+            status_ = status_msg.data;
+
+            // set flag
+            home_chest_ = true;
+
+            // update flag to publish go home message
+            updatePublishGoHomeCommandFlag();
+
+            if( verbose_ ) {
+                ROS_INFO("[IHMC Command Streamer] Homing chest...");
+            }
+        }
+        else if( status_msg.data == std::string("HOME-PELVIS") ) {
+            // set status
+            status_ = status_msg.data;
+
+            // set flag
+            home_pelvis_ = true;
+
+            // update flag to publish go home message
+            updatePublishGoHomeCommandFlag();
+
+            if( verbose_ ) {
+                ROS_INFO("[IHMC Command Streamer] Homing pelvis...");
+            }
+        }
+        else if( status_msg.data == std::string("OPEN-LEFT-HAND") ) {
+            // set status
+            status_ = status_msg.data;
+
+            // set flag
+            open_left_hand_ = true;
+
+            // update flag to publish finger message
+            updatePublishFingerCommandFlag();
+
+            if( verbose_ ) {
+                ROS_INFO("[IHMC Command Streamer] Opening left hand...");
+            }
+        }
+        else if( status_msg.data == std::string("CLOSE-LEFT-HAND") ) {
+            // set status
+            status_ = status_msg.data;
+
+            // set flag
+            close_left_hand_ = true;
+
+            // update flag to publish finger message
+            updatePublishFingerCommandFlag();
+
+            if( verbose_ ) {
+                ROS_INFO("[IHMC Command Streamer] Closing left hand...");
+            }
+        }
+        else if( status_msg.data == std::string("OPEN-RIGHT-HAND") ) {
+            // set status
+            status_ = status_msg.data;
+
+            // set flag
+            open_right_hand_ = true;
+
+            // update flag to publish finger message
+            updatePublishFingerCommandFlag();
+
+            if( verbose_ ) {
+                ROS_INFO("[IHMC Command Streamer] Opening right hand...");
+            }
+        }
+        else if( status_msg.data == std::string("CLOSE-RIGHT-HAND") ) {
+            // set status
+            status_ = status_msg.data;
+
+            // set flag
+            close_right_hand_ = true;
+
+            // update flag to publish finger message
+            updatePublishFingerCommandFlag();
+
+            if( verbose_ ) {
+                ROS_INFO("[IHMC Command Streamer] Closing right hand...");
+            }
+        }
+        else if( status_msg.data.compare(0, 5, "POSE:") == 0 ) {
+            // set status
+            status_ = status_msg.data;
+
+            // pose message is prebuilt, so publish right away instead of waiting for next update
+            std::string pose_name = status_msg.data.substr(5);
+            if( publishPoseMessage(pose_name) ) {
+                if( verbose_ ) {
+                    ROS_INFO("[IHMC Command Streamer] Moving to pose %s...", pose_name.c_str());
+                }
+            }
+            else {
+                ROS_WARN("[IHMC Command Streamer] Unknown pose %s, ignoring status message", pose_name.c_str());
+            }
+        }
+        else {
+            ROS_WARN("[IHMC Command Streamer] Unrecognized status %s, ignoring status message", status_msg.data.c_str());
+        }
+        return;
+    }
+
+    void IHMCCommandStreamer::processHandPoseCommand(const geometry_msgs::TransformStamped& tf_msg) {
+        // capture input for replay
+        if( input_log_.isOpen() ) {
+            input_log_.logHandPoseCommand(clock_(), tf_msg);
+        }
+
+        if( cartesian_hand_goals_ ) {
+            // check for left hand goal
+            if( tf_msg.child_frame_id.find(std::string("left")) != std::string::npos ) {
+                // store left target
+                left_hand_target_ = tf_msg;
+                // set flag indicating hand goal has been received
+                received_left_hand_goal_ = true;
+            }
+            // check for right hand goal
+            else if( tf_msg.child_frame_id.find(std::string("right")) != std::string::npos ) {
+                // store right target
+                right_hand_target_ = tf_msg;
+                // set flag indicating hand goal has been received
+                received_right_hand_goal_ = true;
+            }
+            else {
+                ROS_WARN("[IHMC Command Streamer] Unrecognized child frame id %s, ignoring hand pose command message", tf_msg.child_frame_id.c_str());
+                return;
+            }
+        }
+
+        // update flag to publish hand commands
+        updatePublishHandCommandFlag();
+
+        return;
+    }
+
+    void IHMCCommandStreamer::processBimanualHandPoseCommand(const IHMCMsgInterface::BimanualHandGoal& goal_msg) {
+        // capture input for replay
+        if( input_log_.isOpen() ) {
+            input_log_.logBimanualHandPoseCommand(clock_(), goal_msg);
+        }
+
+        if( cartesian_hand_goals_ ) {
+            // check that goal pair contains at least one hand goal
+            if( !goal_msg.left_hand_goal_valid && !goal_msg.right_hand_goal_valid ) {
+                ROS_WARN("[IHMC Command Streamer] Received goal pair for cycle %u with no valid hand goals, ignoring bimanual hand pose command message", goal_msg.cycle_id);
+                return;
+            }
+
+            // store goal pair; both hands share one frame, so no need to classify or match targets
+            bimanual_hand_target_ = goal_msg;
+            // set flag indicating goal pair has been received
+            received_bimanual_hand_goal_ = true;
+        }
+
+        // update flag to publish hand commands
+        updatePublishHandCommandFlag();
+
+        return;
+    }
+
+    void IHMCCommandStreamer::processReceiveCartesianGoals(const std_msgs::Bool& bool_msg) {
+        // capture input for replay
+        if( input_log_.isOpen() ) {
+            input_log_.logReceiveCartesianGoals(clock_(), bool_msg);
+        }
+
+        // update Cartesian goals flag based on message
+        cartesian_hand_goals_ = bool_msg.data;
+
+        // status of Cartesian goals has changed; reset targets
+        geometry_msgs::TransformStamped empty_tf_msg;
+        left_hand_target_ = empty_tf_msg;
+        right_hand_target_ = empty_tf_msg;
+        IHMCMsgInterface::BimanualHandGoal empty_goal_msg;
+        bimanual_hand_target_ = empty_goal_msg;
+
+        // update flags
+        if( cartesian_hand_goals_ ) {
+            // prepare to receive Cartesian hand goals
+            received_left_hand_goal_ = false;
+            received_right_hand_goal_ = false;
+            received_bimanual_hand_goal_ = false;
+
+            // update flag to publish hand commands
+            updatePublishHandCommandFlag();
+
+            if( verbose_ ) {
+                ROS_INFO("[IHMC Command Streamer] Accepting Cartesian hand goals");
+            }
+        }
+        else {
+            // not receiving Cartesian hand goals
+            received_left_hand_goal_ = false;
+            received_right_hand_goal_ = false;
+            received_bimanual_hand_goal_ = false;
+
+            // update flag to publish hand commands
+            updatePublishHandCommandFlag();
+
+            // update flag to stop node
+            updateStopNodeFlag();
+
+            if( verbose_ ) {
+                ROS_INFO("[IHMC Command Streamer] Not accepting Cartesian hand goals");
+            }
+        }
+
+        return;
+    }
+
+    void IHMCCommandStreamer::processRobotConfigurationData(const controller_msgs::RobotConfigurationData& config_msg) {
+        // measured configuration is only compared against commands when monitoring, and only starts blends when blending
+        if( !monitor_tracking_ && (transition_blender_.getBlendDuration() <= 0.0) ) {
+            return;
+        }
+
+        // read measured configuration
+        dynacore::Vector q_measured;
+        if( !getConfigurationFromRobotConfigurationData(config_msg, q_measured) ) {
+            ROS_WARN_ONCE("[IHMC Command Streamer] Unexpected number of joint angles (%d) in robot configuration data",
+                          (int) config_msg.joint_angles.size());
+            return;
+        }
+
+        // compare against latest commanded configuration; ignored until first command is published
+        if( monitor_tracking_ ) {
+            tracking_monitor_.addMeasurement(clock_(), q_measured);
+        }
+
+        // start of next pose or go home trajectory for joints not commanded yet
+        transition_blender_.setMeasuredConfiguration(q_measured);
+
+        return;
+    }
+
+    void IHMCCommandStreamer::processFingerPositionCommand(const IHMCMsgInterface::FingerPositionCommand& finger_msg) {
+        // capture input for replay
+        if( input_log_.isOpen() ) {
+            input_log_.logFingerPositionCommand(clock_(), finger_msg);
+        }
+
+        // check that command is for one hand and gives a position for each motor
+        if( (finger_msg.robot_side != controller_msgs::ValkyrieHandFingerTrajectoryMessage::ROBOT_SIDE_LEFT) &&
+            (finger_msg.robot_side != controller_msgs::ValkyrieHandFingerTrajectoryMessage::ROBOT_SIDE_RIGHT) ) {
+            ROS_WARN("[IHMC Command Streamer] Unrecognized robot side %d, ignoring finger position command message", (int) finger_msg.robot_side);
+            return;
+        }
+        if( finger_msg.valkyrie_finger_motor_names.empty() ||
+            (finger_msg.valkyrie_finger_motor_names.size() != finger_msg.motor_positions.size()) ) {
+            ROS_WARN("[IHMC Command Streamer] Received %d finger motors and %d positions, ignoring finger position command message",
+                     (int) finger_msg.valkyrie_finger_motor_names.size(), (int) finger_msg.motor_positions.size());
+            return;
+        }
+
+        // keep latest command for each hand; newer commands replace any command not yet published
+        int side = finger_msg.robot_side;
+        finger_position_target_[side] = finger_msg;
+        received_finger_position_[side] = true;
+
+        // publish right away unless hand was published within minimum interval; otherwise sent by a later command or update
+        if( (clock_() - finger_publish_time_[side]) >= static_cast<int64_t>(finger_stream_min_interval_ * 1e9) ) {
+            publishFingerPositionMessage(side);
+        }
+
+        // update flag to publish finger message
+        updatePublishFingerCommandFlag();
+
+        return;
+    }
+
+    void IHMCCommandStreamer::processInputLogRecord(const IHMCInputLogRecord& record) {
+        // hand recorded input to the same function that handled it live
+        switch( record.type ) {
+            case INPUT_LOG_JOINT_COMMAND:
+                processJointCommand(record.joint_command);
+                break;
+            case INPUT_LOG_PELVIS_TRANSFORM:
+                processPelvisTransform(record.transform);
+                break;
+            case INPUT_LOG_CONTROLLED_LINK_IDS:
+                processControlledLinkIds(record.controlled_link_ids);
+                break;
+            case INPUT_LOG_STATUS:
+                processStatus(record.status);
+                break;
+            case INPUT_LOG_HAND_POSE_COMMAND:
+                processHandPoseCommand(record.transform);
+                break;
+            case INPUT_LOG_BIMANUAL_HAND_POSE_COMMAND:
+                processBimanualHandPoseCommand(record.bimanual_hand_goal);
+                break;
+            case INPUT_LOG_RECEIVE_CARTESIAN_GOALS:
+                processReceiveCartesianGoals(record.receive_cartesian_goals);
+                break;
+            case INPUT_LOG_FINGER_POSITION_COMMAND:
+                processFingerPositionCommand(record.finger_position_command);
+                break;
+            default:
+                break;
+        }
+
+        return;
+    }
+
+    void IHMCCommandStreamer::processPartialJointCommand(const IHMCPartialJointState& js_msg) {
+        // capture input for replay, as a joint command of the actuated joints in configuration order
+        if( input_log_.isOpen() ) {
+            dynacore::Vector q = dynacore::Vector::Zero(valkyrie::num_q);
+            q.segment(valkyrie::num_virtual, valkyrie::num_act_joint) = js_msg.q_joint;
+            geometry_msgs::TransformStamped full_tf_msg;
+            sensor_msgs::JointState full_js_msg;
+            makeInputMessagesFromConfiguration(q, full_tf_msg, full_js_msg);
+            input_log_.logJointCommand(clock_(), full_js_msg);
+        }
+
+        if( receive_joint_command_ ) {
+            // joint names were matched during deserialization, so no name lookups are needed
+            q_joint_ = js_msg.q_joint;
+            applyJointCommand();
+        }
+
+        // update flag to publish commands
+        updatePublishCommandsFlag();
+
+        // update flag to stop node
+        updateStopNodeFlag();
+
+        return;
+    }
+
+    // CONTROLLER API
+    void IHMCCommandStreamer::setCommandedConfiguration(const dynacore::Vector& q) {
+        // capture input for replay, in the same form as inputs received on topics
+        if( input_log_.isOpen() ) {
+            geometry_msgs::TransformStamped tf_msg;
+            sensor_msgs::JointState js_msg;
+            makeInputMessagesFromConfiguration(q, tf_msg, js_msg);
+            input_log_.logPelvisTransform(clock_(), tf_msg);
+            input_log_.logJointCommand(clock_(), js_msg);
+        }
+
+        if( receive_pelvis_transform_ ) {
+            // set pelvis pose from virtual joints
+            Eigen::VectorXd pelvis_pos(3);
+            pelvis_pos << q[valkyrie_joint::virtual_X], q[valkyrie_joint::virtual_Y], q[valkyrie_joint::virtual_Z];
+            dynacore::Quaternion pelvis_quat(q[valkyrie_joint::virtual_Rw], q[valkyrie_joint::virtual_Rx],
+                                             q[valkyrie_joint::virtual_Ry], q[valkyrie_joint::virtual_Rz]);
+            applyPelvisPose(pelvis_pos, pelvis_quat);
+        }
+
+        if( receive_joint_command_ ) {
+            // configuration vector is already in joint order, so no name lookups are needed
+            q_joint_ = q.segment(valkyrie::num_virtual, valkyrie::num_act_joint);
+            applyJointCommand();
+        }
+
+        // update flag to publish commands
+        updatePublishCommandsFlag();
+
+        // update flag to stop node
+        updateStopNodeFlag();
+
+        return;
+    }
+
+    void IHMCCommandStreamer::setControlledLinks(const std::vector<int>& controlled_links) {
+        std_msgs::Int32MultiArray arr_msg;
+        arr_msg.data.assign(controlled_links.begin(), controlled_links.end());
+        processControlledLinkIds(arr_msg);
+        return;
+    }
+
+    void IHMCCommandStreamer::setStatus(const std::string& status) {
+        std_msgs::String status_msg;
+        status_msg.data = status;
+        processStatus(status_msg);
+        return;
+    }
+
+    // UPDATE
+    bool IHMCCommandStreamer::update() {
+        // check if commands coming from controllers
+        if( commands_from_controllers_ ) {
+            // consistently publish messages until controllers converge
+            if( publish_commands_ ) {
+                // ready to publish commands
+                if( verbose_ ) {
+                    ROS_INFO("[IHMC Command Streamer] Preparing and streaming whole-body message...");
+                }
+                publishWholeBodyMessage();
+            }
+
+            // check if any body parts need to be homed
+            if( publish_go_home_command_ ) {
+                // ready to publish homing message
+                if( verbose_ ) {
+                    ROS_INFO("[IHMC Command Streamer] Publishing go home message...");
+                }
+                publishGoHomeMessage();
+            }
+
+            // check if any hands need to be opened/closed
+            if( publish_finger_command_ ) {
+                // ready to publish finger message
+                if( verbose_ ) {
+                    ROS_INFO("[IHMC Command Streamer] Publishing hand finger trajectory message...");
+                }
+                publishHandFingerMessage();
+            }
+
+            // check if any hands need to be moved to target
+            if( publish_hand_command_ ) {
+                // ready to publish hand message
+                if( verbose_ ) {
+                    ROS_INFO("[IHMC Command Streamer] Publishing hand trajectory message...");
+                }
+                publishWholeBodyMessageCartesianHandGoals();
+            }
+        }
+        else {
+            // otherwise, publish single whole-body message and stop
+            if( publish_commands_ && stop_node_ ) {
+                if( verbose_ ) {
+                    ROS_INFO("[IHMC Command Streamer] Preparing and executing whole-body message...");
+                }
+                publishWholeBodyMessage();
+                return false; // only publish one message, then stop
+            }
+        }
+
+        return true;
+    }
+
+    // PUBLISH MESSAGE
+    void IHMCCommandStreamer::publishWholeBodyMessage() {
+        // prepare configuration vector based on received pelvis transform and joint command
+        prepareConfigurationVector();
+
+        // initialize struct of default IHMC message parameters
+        IHMCMsgUtils::IHMCMessageParameters msg_params;
+        // set controlled links
+        msg_params.controlled_links = controlled_links_;
+        // velocity of streamed configuration; only nonzero while blending in from a discrete command
+        dynacore::Vector qdot = dynacore::Vector::Zero(valkyrie::num_q);
+
+        // if commands are coming from controllers, default message parameters will need to be changed
+        if( commands_from_controllers_ ) {
+            // set execution mode to streaming (0 override; 1 queue; 2 stream)
+            msg_params.queueable_params.execution_mode = 2;
+            // set stream integration duration (equal or slightly longer than interval between two consecutive messages, which should be coming in at 10 Hz or 0.1 secs)
+            msg_params.queueable_params.stream_integration_duration = stream_integration_duration_;
+            // set time to achieve trajectory point messages (1.0 for queueing, 0.0 for streaming)
+            msg_params.traj_point_params.time = 0.0;
+
+            // only include body parts that are due, each on its own cadence
+            if( !body_part_streams_.empty() ) {
+                scheduleBodyParts(msg_params.controlled_links);
+                if( msg_params.controlled_links.empty() && !controlled_links_.empty() ) {
+                    // no controlled body part is due this cycle
+                    return;
+                }
+            }
+        }
+
+        // joints of body parts included in message
+        std::vector<int> joint_indices;
+        IHMCMsgUtils::getRelevantJointIndicesControlledLinks(msg_params.controlled_links, joint_indices);
+
+        // start streaming from wherever the last pose or go home message is, instead of jumping to the stream
+        if( commands_from_controllers_ ) {
+            transition_blender_.blendStreamedCommand(clock_(), q_, qdot, joint_indices);
+        }
+
+        // create whole-body message
+        controller_msgs::WholeBodyTrajectoryMessage wholebody_msg;
+        IHMCMsgUtils::makeIHMCWholeBodyTrajectoryMessage(q_, wholebody_msg, msg_params);
+        if( commands_from_controllers_ && !body_part_streams_.empty() ) {
+            applyBodyPartStreamIntegrationDurations(msg_params.controlled_links, wholebody_msg);
+        }
+        if( commands_from_controllers_ && !qdot.isZero() ) {
+            applyStreamedVelocities(msg_params.controlled_links, qdot, wholebody_msg);
+        }
+
+        // publish message
+        if( wholebody_sink_ ) {
+            wholebody_sink_(wholebody_msg);
+        }
+
+        // streamed messages will be followed by stop message when controllers stop
+        if( commands_from_controllers_ ) {
+            streaming_ = true;
+        }
+
+        // record commanded joints for comparing against measured configurations
+        if( monitor_tracking_ ) {
+            tracking_monitor_.addCommand(clock_(), q_, joint_indices);
+        }
+
+        return;
+    }
+
+    void IHMCCommandStreamer::publishWholeBodyMessageCartesianHandGoals() {
+        // initialize left and right hand goals, frame id, and controlled links
+        dynacore::Vect3 left_pos;
+        dynacore::Quaternion left_quat;
+        dynacore::Vect3 right_pos;
+        dynacore::Quaternion right_quat;
+        std::string cartesian_frame_id;
+        std::vector<int> controlled_links;
+
+        // prepare left and right goals; goal pairs take precedence over individually received goals
+        bool proceed;
+        if( received_bimanual_hand_goal_ ) {
+            proceed = prepareBimanualHandGoals(left_pos, left_quat, right_pos, right_quat, cartesian_frame_id, controlled_links);
+        }
+        else {
+            proceed = prepareCartesianHandGoals(left_pos, left_quat, right_pos, right_quat, cartesian_frame_id, controlled_links);
+        }
+
+        if( !proceed ) {
+            ROS_WARN("[IHMC Command Streamer] Not publishing whole-body message");
+            return;
+        }
+
+        // initialize struct of default IHMC message parameters
+        IHMCMsgUtils::IHMCMessageParameters msg_params;
+        // set controlled links
+        msg_params.controlled_links = controlled_links;
+        // tag message with cycle id of goal pair
+        if( received_bimanual_hand_goal_ ) {
+            msg_params.sequence_id = bimanual_hand_target_.cycle_id;
+        }
+
+        // update message parameters for Cartesian goals
+        msg_params.cartesian_hand_goals = cartesian_hand_goals_;
+        msg_params.frame_params.cartesian_goal_reference_frame_name = cartesian_frame_id;
+
+        // create whole-body message
+        controller_msgs::WholeBodyTrajectoryMessage wholebody_msg;
+        IHMCMsgUtils::makeIHMCWholeBodyTrajectoryMessage(q_, left_pos, left_quat, right_pos, right_quat,
+                                                         wholebody_msg, msg_params);
+        // configuration vector q_ will not be used
+        // hand goals are sent in their given frame, so no transform lookup is needed
+
+        // arm configurations reached by hand goals are not known, so streamed arm commands cannot be blended in from them
+        std::vector<int> joint_indices;
+        IHMCMsgUtils::getRelevantJointIndicesControlledLinks(controlled_links, joint_indices);
+        transition_blender_.forgetJoints(joint_indices);
+
+        // publish message
+        if( wholebody_sink_ ) {
+            wholebody_sink_(wholebody_msg);
+        }
+
+        // reset flags since received targets have been processed
+        received_left_hand_goal_ = false;
+        received_right_hand_goal_ = false;
+        received_bimanual_hand_goal_ = false;
+
+        // update flag to publish hand message
+        updatePublishHandCommandFlag();
+
+        return;
+    }
+
+    bool IHMCCommandStreamer::publishPoseMessage(const std::string& pose_name) {
+        // get prebuilt whole-body message
+        controller_msgs::WholeBodyTrajectoryMessage wholebody_msg;
+        if( !pose_library_.getPoseMessage(pose_name, wholebody_msg) ) {
+            return false;
+        }
+
+        // publish message
+        if( wholebody_sink_ ) {
+            wholebody_sink_(wholebody_msg);
+        }
+
+        // record commanded joints for comparing against measured configurations
+        const IHMCPoseLibrary::Pose* pose = pose_library_.getPose(pose_name);
+        std::vector<int> joint_indices;
+        IHMCMsgUtils::getRelevantJointIndicesControlledLinks(pose->controlled_links, joint_indices);
+        if( monitor_tracking_ ) {
+            tracking_monitor_.addCommand(clock_(), pose->q, joint_indices);
+        }
+
+        // record pose target for blending streamed commands in from pose
+        transition_blender_.addDiscreteCommand(clock_(), pose->q, joint_indices, pose->trajectory_time);
+
+        return true;
+    }
+
+    void IHMCCommandStreamer::publishGoHomeMessage() {
+        // initialize struct of default IHMC message parameters
+        IHMCMsgUtils::IHMCMessageParameters msg_params;
+
+        // home left arm
+        if( home_left_arm_ ) {
+            // create go home message
+            controller_msgs::GoHomeMessage go_home_msg;
+            IHMCMsgUtils::makeIHMCHomeLeftArmMessage(go_home_msg, msg_params);
+
+            // publish message
+            if( go_home_sink_ ) {
+                go_home_sink_(go_home_msg);
+            }
+
+            // record home target for blending streamed commands in from go home message
+            recordGoHomeCommand(valkyrie_link::leftPalm, msg_params.go_home_params.trajectory_time);
+
+            // reset flag
+            home_left_arm_ = false;
+        }
+
+        // home right arm
+        if( home_right_arm_ ) {
+            // create go home message
+            controller_msgs::GoHomeMessage go_home_msg;
+            IHMCMsgUtils::makeIHMCHomeRightArmMessage(go_home_msg, msg_params);
+
+            // publish message
+            if( go_home_sink_ ) {
+                go_home_sink_(go_home_msg);
+            }
+
+            // record home target for blending streamed commands in from go home message
+            recordGoHomeCommand(valkyrie_link::rightPalm, msg_params.go_home_params.trajectory_time);
+
+            // reset flag
+            home_right_arm_ = false;
+        }
+
+        // home chest
+        if( home_chest_ ) {
+            // create go home message
+            controller_msgs::GoHomeMessage go_home_msg;
+            IHMCMsgUtils::makeIHMCHomeChestMessage(go_home_msg, msg_params);
+
+            // publish message
+            if( go_home_sink_ ) {
+                go_home_sink_(go_home_msg);
+            }
+
+            // record home target for blending streamed commands in from go home message
+            recordGoHomeCommand(valkyrie_link::torso, msg_params.go_home_params.trajectory_time);
+
+            // reset flag
+            home_chest_ = false;
+        }
+
+        // home pelvis
+        if( home_pelvis_ ) {
+            // create go home message
+            controller_msgs::GoHomeMessage go_home_msg;
+            IHMCMsgUtils::makeIHMCHomePelvisMessage(go_home_msg, msg_params);
+
+            // publish message
+            if( go_home_sink_ ) {
+                go_home_sink_(go_home_msg);
+            }
+
+            // record home target for blending streamed commands in from go home message
+            recordGoHomeCommand(valkyrie_link::pelvis, msg_params.go_home_params.trajectory_time);
+
+            // reset flag
+            home_pelvis_ = false;
+        }
+
+        // update flag to publish go home message
+        updatePublishGoHomeCommandFlag();
+
+        return;
+    }
+
+    void IHMCCommandStreamer::publishHandFingerMessage() {
+        // open left hand
+        if( open_left_hand_ ) {
+            // publish message
+            publishFingerOpenLeftMessage();
+
+            // reset flag
+            open_left_hand_ = false;
+        }
+
+        // close left hand
+        if( close_left_hand_ ) {
+            // publish message
+            publishFingerCloseLeftMessage();
+
+            // reset flag
+            close_left_hand_ = false;
+        }
+
+        // open right hand
+        if( open_right_hand_ ) {
+            // publish message
+            publishFingerOpenRightMessage();
+
+            // reset flag
+            open_right_hand_ = false;
+        }
+
+        // close right hand
+        if( close_right_hand_ ) {
+            // publish message
+            publishFingerCloseRightMessage();
+
+            // reset flag
+            close_right_hand_ = false;
+        }
+
+        // stream latest finger positions held back by minimum interval, once interval has passed; otherwise kept for a later update
+        for( int side = 0 ; side < 2 ; side++ ) {
+            if( received_finger_position_[side] &&
+                ((clock_() - finger_publish_time_[side]) >= static_cast<int64_t>(finger_stream_min_interval_ * 1e9)) ) {
+                publishFingerPositionMessage(side);
+            }
+        }
+
+        // update flag to publish hand message
+        updatePublishFingerCommandFlag();
+
+        return;
+    }
+
+    void IHMCCommandStreamer::publishFingerOpenLeftMessage() {
+        // initialize struct of default IHMC message parameters
+        IHMCMsgUtils::IHMCMessageParameters msg_params;
+        // modify default parameters for finger messages
+        msg_params.setParametersForFingerMessages();
+        // set time for trajectory
+        msg_params.traj_point_params.time = msg_params.finger_traj_params.open_hand_time;
+
+        // create finger message
+        controller_msgs::ValkyrieHandFingerTrajectoryMessage finger_msg;
+        IHMCMsgUtils::makeIHMCValkyrieHandFingerTrajectoryMessage(finger_msg, finger_msg.ROBOT_SIDE_LEFT, true, msg_params);
+
+        // publish message
+        if( finger_sink_ ) {
+            finger_sink_(finger_msg);
+        }
+
+        return;
+    }
+
+    void IHMCCommandStreamer::publishFingerCloseLeftMessage() {
+        // initialize struct of default IHMC message parameters
+        IHMCMsgUtils::IHMCMessageParameters msg_params;
+        // modify default parameters for finger messages
+        msg_params.setParametersForFingerMessages();
+        // set time for trajectory
+        msg_params.traj_point_params.time = msg_params.finger_traj_params.close_hand_time;
+
+        // create finger message
+        controller_msgs::ValkyrieHandFingerTrajectoryMessage finger_msg;
+        IHMCMsgUtils::makeIHMCValkyrieHandFingerTrajectoryMessage(finger_msg, finger_msg.ROBOT_SIDE_LEFT, false, msg_params);
+
+        // publish message
+        if( finger_sink_ ) {
+            finger_sink_(finger_msg);
+        }
+
+        return;
+    }
+
+    void IHMCCommandStreamer::publishFingerOpenRightMessage() {
+        // initialize struct of default IHMC message parameters
+        IHMCMsgUtils::IHMCMessageParameters msg_params;
+        // modify default parameters for finger messages
+        msg_params.setParametersForFingerMessages();
+        // set time for trajectory
+        msg_params.traj_point_params.time = msg_params.finger_traj_params.open_hand_time;
+
+        // create finger message
+        controller_msgs::ValkyrieHandFingerTrajectoryMessage finger_msg;
+        IHMCMsgUtils::makeIHMCValkyrieHandFingerTrajectoryMessage(finger_msg, finger_msg.ROBOT_SIDE_RIGHT, true, msg_params);
+
+        // publish message
+        if( finger_sink_ ) {
+            finger_sink_(finger_msg);
+        }
+
+        return;
+    }
+
+    void IHMCCommandStreamer::publishFingerCloseRightMessage() {
+        // initialize struct of default IHMC message parameters
+        IHMCMsgUtils::IHMCMessageParameters msg_params;
+        // modify default parameters for finger messages
+        msg_params.setParametersForFingerMessages();
+        // set time for trajectory
+        msg_params.traj_point_params.time = msg_params.finger_traj_params.close_hand_time;
+
+        // create finger message
+        controller_msgs::ValkyrieHandFingerTrajectoryMessage finger_msg;
+        IHMCMsgUtils::makeIHMCValkyrieHandFingerTrajectoryMessage(finger_msg, finger_msg.ROBOT_SIDE_RIGHT, false, msg_params);
+
+        // publish message
+        if( finger_sink_ ) {
+            finger_sink_(finger_msg);
+        }
+
+        return;
+    }
+
+    void IHMCCommandStreamer::publishFingerPositionMessage(int robot_side) {
+        // initialize struct of default IHMC message parameters
+        IHMCMsgUtils::IHMCMessageParameters msg_params;
+        // modify default parameters for finger messages
+        msg_params.setParametersForFingerMessages();
+        // set execution mode to streaming, with short integration duration so hand follows commands closely
+        msg_params.queueable_params.execution_mode = 2;
+        msg_params.queueable_params.stream_integration_duration = finger_stream_integration_duration_;
+        // set time to achieve trajectory point messages (0.0 for streaming)
+        msg_params.traj_point_params.time = 0.0;
+
+        // create finger message from commanded motors
+        const IHMCMsgInterface::FingerPositionCommand& finger_cmd = finger_position_target_[robot_side];
+        std::vector<int> finger_selection(finger_cmd.valkyrie_finger_motor_names.begin(), finger_cmd.valkyrie_finger_motor_names.end());
+        controller_msgs::ValkyrieHandFingerTrajectoryMessage finger_msg;
+        IHMCMsgUtils::makeIHMCValkyrieHandFingerTrajectoryMessage(finger_msg, robot_side, finger_selection,
+                                                                  finger_cmd.motor_positions, msg_params);
+
+        // publish message
+        if( finger_sink_ ) {
+            finger_sink_(finger_msg);
+        }
+
+        // reset flag, and start minimum interval for hand
+        received_finger_position_[robot_side] = false;
+        finger_publish_time_[robot_side] = clock_();
+
+        return;
+    }
+
+    void IHMCCommandStreamer::publishStopMessage(std::chrono::steady_clock::time_point receipt_time) {
+        // only stop robot if it is following streamed messages
+        if( !stop_on_stop_listening_ || !streaming_ ) {
+            return;
+        }
+
+        // publish prebuilt message
+        if( stop_sink_ ) {
+            stop_sink_(stop_msg_);
+        }
+
+        // measure time from receiving status to publishing
+        last_stop_latency_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - receipt_time).count();
+        max_stop_latency_ = std::max(max_stop_latency_, last_stop_latency_);
+        num_stops_++;
+        streaming_ = false;
+
+        if( verbose_ ) {
+            ROS_INFO("[IHMC Command Streamer] Published stop message %.3f ms after receiving status", last_stop_latency_ * 1e3);
+        }
+
+        return;
+    }
+
+    // HELPER FUNCTIONS
+    std::string IHMCCommandStreamer::getStatus() {
+        return status_;
+    }
+
+    bool IHMCCommandStreamer::getCommandsFromControllersFlag() {
+        return commands_from_controllers_;
+    }
+
+    bool IHMCCommandStreamer::getPublishCommandsFlag() {
+        return publish_commands_;
+    }
+
+    void IHMCCommandStreamer::updatePublishCommandsFlag() {
+        // if pelvis and joint command both received, then commands can be published
+        publish_commands_ = received_pelvis_transform_ && received_link_ids_ && received_joint_command_;
+
+        return;
+    }
+
+    bool IHMCCommandStreamer::getStopNodeFlag() {
+        return stop_node_;
+    }
+
+    void IHMCCommandStreamer::updateStopNodeFlag() {
+        // if both pelvis and joint commands no longer being received, then prepare to stop node
+        stop_node_ = !receive_pelvis_transform_ && !receive_joint_command_;
+
+        return;
+    }
+
+    bool IHMCCommandStreamer::getPublishGoHomeCommandFlag() {
+        return publish_go_home_command_;
+    }
+
+    void IHMCCommandStreamer::updatePublishGoHomeCommandFlag() {
+        // if any body parts need to be homed, then go home message(s) need to be published
+        publish_go_home_command_ = home_left_arm_ || home_right_arm_ || home_chest_ || home_pelvis_;
+
+        return;
+    }
+
+    bool IHMCCommandStreamer::getPublishFingerCommandFlag() {
+        return publish_finger_command_;
+    }
+
+    void IHMCCommandStreamer::updatePublishFingerCommandFlag() {
+        // if any hand needs to be opened/closed or has streamed positions waiting, then finger message needs to be published
+        publish_finger_command_ = open_left_hand_ || close_left_hand_ || open_right_hand_ || close_right_hand_ ||
+                                  received_finger_position_[0] || received_finger_position_[1];
+
+        return;
+    }
+
+    bool IHMCCommandStreamer::getPublishHandCommandFlag() {
+        return publish_hand_command_;
+    }
+
+    void IHMCCommandStreamer::updatePublishHandCommandFlag() {
+        // if Cartesian goals are being accepted and either left, right, or bimanual goal received, then hand message needs to be published
+        publish_hand_command_ = cartesian_hand_goals_ && (received_left_hand_goal_ || received_right_hand_goal_ || received_bimanual_hand_goal_);
+
+        return;
+    }
+
+    void IHMCCommandStreamer::prepareEmptyPose(dynacore::Vect3& pos, dynacore::Quaternion& quat) {
+        // set position to zero
+        pos.setZero();
+        // set quaternion to identity
+        quat.setIdentity();
+
+        return;
+    }
+
+    void IHMCCommandStreamer::preparePoseFromTransform(dynacore::Vect3& pos, dynacore::Quaternion& quat,
+                                                     geometry_msgs::TransformStamped tf_msg) {
+        // set position from transform
+        pos << tf_msg.transform.translation.x, tf_msg.transform.translation.y, tf_msg.transform.translation.z;
+        // set quaternion from transform
+        quat.x() = tf_msg.transform.rotation.x;
+        quat.y() = tf_msg.transform.rotation.y;
+        quat.z() = tf_msg.transform.rotation.z;
+        quat.w() = tf_msg.transform.rotation.w;
+
+        return;
+    }
+
+    void IHMCCommandStreamer::preparePoseFromPoseMessage(dynacore::Vect3& pos, dynacore::Quaternion& quat,
+                                                       geometry_msgs::Pose pose_msg) {
+        // set position from pose
+        pos << pose_msg.position.x, pose_msg.position.y, pose_msg.position.z;
+        // set quaternion from pose
+        quat.x() = pose_msg.orientation.x;
+        quat.y() = pose_msg.orientation.y;
+        quat.z() = pose_msg.orientation.z;
+        quat.w() = pose_msg.orientation.w;
+
+        return;
+    }
+
+    bool IHMCCommandStreamer::prepareCartesianHandGoals(dynacore::Vect3& left_pos, dynacore::Quaternion& left_quat,
+                                                      dynacore::Vect3& right_pos, dynacore::Quaternion& right_quat,
+                                                      std::string& frame_id, std::vector<int>& controlled_links) {
+        // clear controlled links vector
+        controlled_links.clear();
+
+        // check if left target received
+        if( !received_left_hand_goal_ ) {
+            // no target received
+            prepareEmptyPose(left_pos, left_quat);
+        }
+        else {
+            // set target from transform
+            preparePoseFromTransform(left_pos, left_quat, left_hand_target_);
+        }
+
+        // check if right target received
+        if( !received_right_hand_goal_ ) {
+            // no target received
+            prepareEmptyPose(right_pos, right_quat);
+        }
+        else {
+            // set target from transform
+            preparePoseFromTransform(right_pos, right_quat, right_hand_target_);
+        }
+
+        // set frame id
+        if( !received_left_hand_goal_ && !received_right_hand_goal_ ) {
+            // neither pose set
+            frame_id = std::string("");
+            return false;
+        }
+        else if( received_left_hand_goal_ && !received_right_hand_goal_ ) {
+            // left pose set, right pose not
+            frame_id = std::string(left_hand_target_.header.frame_id);
+            controlled_links.push_back(valkyrie_link::leftPalm);
+            return true;
+        }
+        else if( !received_left_hand_goal_ && received_right_hand_goal_ ) {
+            // right pose set, left pose not
+            frame_id = std::string(right_hand_target_.header.frame_id);
+            controlled_links.push_back(valkyrie_link::rightPalm);
+            return true;
+        }
+        else { // received_left_hand_goal_ && received_right_hand_goal_
+            // make sure frames are the same
+            if( left_hand_target_.header.frame_id.compare(right_hand_target_.header.frame_id) == 0 ) {
+                // frames are the same
+                frame_id = std::string(left_hand_target_.header.frame_id);
+                controlled_links.push_back(valkyrie_link::leftPalm);
+                controlled_links.push_back(valkyrie_link::rightPalm);
+                return true;
+            }
+            else {
+                // frames are not the same; cannot confidently set frame
+                ROS_WARN("[IHMC Command Streamer] Received left hand target in frame %s and right hand target in frame %s; cannot send Cartesian hand targets due to ambiguity",
+                          left_hand_target_.header.frame_id.c_str(), right_hand_target_.header.frame_id.c_str());
+                frame_id = std::string("");
+                return false;
+            }
+        }
+    }
+
+    bool IHMCCommandStreamer::prepareBimanualHandGoals(dynacore::Vect3& left_pos, dynacore::Quaternion& left_quat,
+                                                     dynacore::Vect3& right_pos, dynacore::Quaternion& right_quat,
+                                                     std::string& frame_id, std::vector<int>& controlled_links) {
+        // clear controlled links vector
+        controlled_links.clear();
+
+        // check if left target valid
+        if( !bimanual_hand_target_.left_hand_goal_valid ) {
+            // no target given
+            prepareEmptyPose(left_pos, left_quat);
+        }
+        else {
+            // set target from pose
+            preparePoseFromPoseMessage(left_pos, left_quat, bimanual_hand_target_.left_hand_pose);
+            controlled_links.push_back(valkyrie_link::leftPalm);
+        }
+
+        // check if right target valid
+        if( !bimanual_hand_target_.right_hand_goal_valid ) {
+            // no target given
+            prepareEmptyPose(right_pos, right_quat);
+        }
+        else {
+            // set target from pose
+            preparePoseFromPoseMessage(right_pos, right_quat, bimanual_hand_target_.right_hand_pose);
+            controlled_links.push_back(valkyrie_link::rightPalm);
+        }
+
+        // both targets share the frame given in the header
+        frame_id = bimanual_hand_target_.header.frame_id;
+
+        return !controlled_links.empty();
+    }
+
+    void IHMCCommandStreamer::scheduleBodyParts(std::vector<int>& due_links) {
+        int64_t now = clock_();
+
+        // start of a new stream sends every body part right away;
+        // streams start with START-LISTENING, whether or not a stop message ended the previous stream
+        if( schedule_reset_ ) {
+            for( std::map<int, BodyPartStream>::iterator it = body_part_streams_.begin() ; it != body_part_streams_.end() ; ++it ) {
+                it->second.next_publish_time = 0;
+            }
+            stream_period_ = 0;
+            schedule_reset_ = false;
+        }
+        else {
+            // stream period is averaged over schedules, so loop jitter evens out;
+            // a pause in the stream (e.g., controllers stop sending) is clamped so it cannot swamp the average
+            int64_t interval = std::max<int64_t>(0, now - last_schedule_time_);
+            int64_t max_interval = 2 * stream_period_;
+            if( stream_period_ == 0 ) {
+                // first interval of stream is at most the shortest body part period
+                for( std::map<int, BodyPartStream>::iterator it = body_part_streams_.begin() ; it != body_part_streams_.end() ; ++it ) {
+                    max_interval = (max_interval == 0) ? it->second.period : std::min(max_interval, it->second.period);
+                }
+            }
+            interval = std::min(interval, max_interval);
+            stream_period_ = (stream_period_ == 0) ? interval : ((7 * stream_period_ + interval) / 8);
+        }
+        last_schedule_time_ = now;
+
+        // body parts due within half a stream period count as due now, so a cycle that runs slightly early because of
+        // loop jitter does not push a body part back a whole cycle
+        int64_t half_stream_period = stream_period_ / 2;
+
+        std::vector<int> links;
+        links.swap(due_links);
+        for( int i = 0 ; i < links.size() ; i++ ) {
+            std::map<int, BodyPartStream>::iterator it = body_part_streams_.find(links[i]);
+            if( it == body_part_streams_.end() ) {
+                // no rate given, stream in every message
+                due_links.push_back(links[i]);
+            }
+            else if( now + half_stream_period >= it->second.next_publish_time ) {
+                due_links.push_back(links[i]);
+                // keep cadence, unless cycles were missed
+                it->second.next_publish_time += it->second.period;
+                if( it->second.next_publish_time <= now ) {
+                    it->second.next_publish_time = now + it->second.period;
+                }
+            }
+        }
+
+        return;
+    }
+
+    void IHMCCommandStreamer::applyBodyPartStreamIntegrationDurations(const std::vector<int>& links,
+                                                                      controller_msgs::WholeBodyTrajectoryMessage& wholebody_msg) {
+        for( int i = 0 ; i < links.size() ; i++ ) {
+            std::map<int, BodyPartStream>::iterator it = body_part_streams_.find(links[i]);
+            if( it == body_part_streams_.end() ) {
+                continue;
+            }
+
+            // only body parts that are built from streamed configurations; feet are never sent
+            StreamIntegrationDurationSetter setter(it->second.stream_integration_duration);
+            switch( links[i] ) {
+                case valkyrie_link::pelvis:
+                    visitFields(setter, wholebody_msg.pelvis_trajectory_message);
+                    break;
+                case valkyrie_link::torso:
+                    visitFields(setter, wholebody_msg.chest_trajectory_message);
+                    break;
+                case valkyrie_link::leftPalm:
+                    visitFields(setter, wholebody_msg.left_arm_trajectory_message);
+                    break;
+                case valkyrie_link::rightPalm:
+                    visitFields(setter, wholebody_msg.right_arm_trajectory_message);
+                    break;
+                case valkyrie_link::head:
+                    visitFields(setter, wholebody_msg.neck_trajectory_message);
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        return;
+    }
+
+    void IHMCCommandStreamer::applyStreamedVelocities(const std::vector<int>& links, const dynacore::Vector& qdot,
+                                                      controller_msgs::WholeBodyTrajectoryMessage& wholebody_msg) {
+        // jointspace body parts; joints are in the same order as their relevant joint indices
+        std::vector<int> joint_indices;
+        controller_msgs::JointspaceTrajectoryMessage* js_msg;
+        for( int i = 0 ; i < links.size() ; i++ ) {
+            switch( links[i] ) {
+                case valkyrie_link::leftPalm:
+                    IHMCMsgUtils::getRelevantJointIndicesLeftArm(joint_indices);
+                    js_msg = &wholebody_msg.left_arm_trajectory_message.jointspace_trajectory;
+                    break;
+                case valkyrie_link::rightPalm:
+                    IHMCMsgUtils::getRelevantJointIndicesRightArm(joint_indices);
+                    js_msg = &wholebody_msg.right_arm_trajectory_message.jointspace_trajectory;
+                    break;
+                case valkyrie_link::head:
+                    IHMCMsgUtils::getRelevantJointIndicesNeck(joint_indices);
+                    js_msg = &wholebody_msg.neck_trajectory_message.jointspace_trajectory;
+                    break;
+                default:
+                    // chest orientation comes from the torso joints through the robot's kinematics, so it is sent without velocity
+                    continue;
+            }
+            for( int j = 0 ; (j < joint_indices.size()) && (j < js_msg->joint_trajectory_messages.size()) ; j++ ) {
+                // special index -1 (wrist joints) is not in valkyrie definition
+                if( joint_indices[j] == -1 ) {
+                    continue;
+                }
+                std::vector<controller_msgs::TrajectoryPoint1DMessage>& points = js_msg->joint_trajectory_messages[j].trajectory_points;
+                for( int k = 0 ; k < points.size() ; k++ ) {
+                    points[k].velocity = qdot[joint_indices[j]];
+                }
+            }
+        }
+
+        // pelvis; angular velocity (world frame) from rate of orientation quaternion, w = 2 * qdot * conj(q)
+        if( IHMCMsgUtils::checkControlledLink(links, valkyrie_link::pelvis) ) {
+            dynacore::Quaternion quat(q_[valkyrie_joint::virtual_Rw], q_[valkyrie_joint::virtual_Rx],
+                                      q_[valkyrie_joint::virtual_Ry], q_[valkyrie_joint::virtual_Rz]);
+            dynacore::Quaternion quat_rate(qdot[valkyrie_joint::virtual_Rw], qdot[valkyrie_joint::virtual_Rx],
+                                           qdot[valkyrie_joint::virtual_Ry], qdot[valkyrie_joint::virtual_Rz]);
+            Eigen::Vector3d omega = 2.0 * (quat_rate * quat.conjugate()).vec();
+            std::vector<controller_msgs::SE3TrajectoryPointMessage>& points =
+                wholebody_msg.pelvis_trajectory_message.se3_trajectory.taskspace_trajectory_points;
+            for( int k = 0 ; k < points.size() ; k++ ) {
+                points[k].linear_velocity.x = qdot[valkyrie_joint::virtual_X];
+                points[k].linear_velocity.y = qdot[valkyrie_joint::virtual_Y];
+                points[k].linear_velocity.z = qdot[valkyrie_joint::virtual_Z];
+                points[k].angular_velocity.x = omega[0];
+                points[k].angular_velocity.y = omega[1];
+                points[k].angular_velocity.z = omega[2];
+            }
+        }
+
+        return;
+    }
+
+    void IHMCCommandStreamer::applyPelvisPose(Eigen::VectorXd pelvis_pos, dynacore::Quaternion pelvis_quat) {
+        // smooth pelvis pose
+        double time = clock_() / 1e9;
+        pelvis_position_filter_.filter(time, pelvis_pos, pelvis_pos);
+        pelvis_orientation_filter_.filter(time, pelvis_quat, pelvis_quat);
+
+        // set pelvis translation
+        tf_pelvis_wrt_world_.setOrigin(tf::Vector3(pelvis_pos[0], pelvis_pos[1], pelvis_pos[2]));
+        // set pelvis orientation
+        tf::Quaternion quat_pelvis_wrt_world(pelvis_quat.x(), pelvis_quat.y(), pelvis_quat.z(), pelvis_quat.w());
+        tf_pelvis_wrt_world_.setRotation(quat_pelvis_wrt_world);
+
+        // set flag indicating pelvis transform has been received
+        received_pelvis_transform_ = true;
+
+        // set flag to no longer receive transform messages
+        if( !commands_from_controllers_ ) {
+            receive_pelvis_transform_ = false;
+        }
+
+        return;
+    }
+
+    void IHMCCommandStreamer::applyJointCommand() {
+        // smooth joint positions, all joints at once
+        joint_filter_.filter(clock_() / 1e9, q_joint_, q_joint_);
+
+        // set flag indicating joint command has been received
+        received_joint_command_ = true;
+
+        // set flag to no longer receive joint command messages
+        if( !commands_from_controllers_ ) {
+            receive_joint_command_ = false;
+        }
+
+        return;
+    }
+
+    void IHMCCommandStreamer::recordGoHomeCommand(int link_id, double trajectory_time) {
+        // joints moved by homed body part
+        std::vector<int> joint_indices;
+        IHMCMsgUtils::getRelevantJointIndicesControlledLinks(std::vector<int>{link_id}, joint_indices);
+
+        // home configuration is only known if pose library has a pose named home
+        const IHMCPoseLibrary::Pose* home_pose = pose_library_.getPose("home");
+        if( home_pose != nullptr ) {
+            transition_blender_.addDiscreteCommand(clock_(), home_pose->q, joint_indices, trajectory_time);
+        }
+        else {
+            transition_blender_.forgetJoints(joint_indices);
+        }
+
+        return;
+    }
+
+    void IHMCCommandStreamer::makeInputMessagesFromConfiguration(const dynacore::Vector& q,
+                                                                 geometry_msgs::TransformStamped& tf_msg,
+                                                                 sensor_msgs::JointState& js_msg) {
+        // pelvis transform from virtual joints
+        tf_msg.transform.translation.x = q[valkyrie_joint::virtual_X];
+        tf_msg.transform.translation.y = q[valkyrie_joint::virtual_Y];
+        tf_msg.transform.translation.z = q[valkyrie_joint::virtual_Z];
+        tf_msg.transform.rotation.x = q[valkyrie_joint::virtual_Rx];
+        tf_msg.transform.rotation.y = q[valkyrie_joint::virtual_Ry];
+        tf_msg.transform.rotation.z = q[valkyrie_joint::virtual_Rz];
+        tf_msg.transform.rotation.w = q[valkyrie_joint::virtual_Rw];
+
+        // joint names in configuration order, looked up once; static initialization is thread-safe
+        static const std::vector<std::string> joint_names = []() {
+            std::vector<std::string> names(valkyrie::num_act_joint);
+            for( std::map<std::string, int>::iterator it = val::joint_names_to_indices.begin() ; it != val::joint_names_to_indices.end() ; ++it ) {
+                int jidx = it->second - valkyrie::num_virtual;
+                if( (jidx >= 0) && (jidx < valkyrie::num_act_joint) ) {
+                    names[jidx] = it->first;
+                }
+            }
+            return names;
+        }();
+
+        // joint command from actuated joints
+        js_msg.name = joint_names;
+        js_msg.position.resize(valkyrie::num_act_joint);
+        for( int i = 0 ; i < valkyrie::num_act_joint ; i++ ) {
+            js_msg.position[i] = q[i + valkyrie::num_virtual];
+        }
+
+        return;
+    }
+
+    void IHMCCommandStreamer::prepareConfigurationVector() {
+        // pelvis transform and joint command received, so prepare configuration vector
+        // resize configuration vector
+        q_.resize(valkyrie::num_q);
+        q_.setZero();
+
+        // get pelvis transform
+        tf::Vector3 pelvis_origin = tf_pelvis_wrt_world_.getOrigin();
+        tf::Quaternion pelvis_tfrotation = tf_pelvis_wrt_world_.getRotation();
+
+        // set pelvis position
+        q_[valkyrie_joint::virtual_X] = pelvis_origin.getX();
+        q_[valkyrie_joint::virtual_Y] = pelvis_origin.getY();
+        q_[valkyrie_joint::virtual_Z] = pelvis_origin.getZ();
+
+        // convert pelvis orientation to dynacore (Eigen) quaternion
+        dynacore::Quaternion pelvis_rotation;
+        dynacore::convert(pelvis_tfrotation, pelvis_rotation);
+
+        // set pelvis rotation
+        q_[valkyrie_joint::virtual_Rx] = pelvis_rotation.x();
+        q_[valkyrie_joint::virtual_Ry] = pelvis_rotation.y();
+        q_[valkyrie_joint::virtual_Rz] = pelvis_rotation.z();
+        q_[valkyrie_joint::virtual_Rw] = pelvis_rotation.w();
+
+        // set joints
+        for( int i = 0 ; i < q_joint_.size() ; i++ ) {
+            // set index for joint, add offset to account for virtual joints
+            int jidx = i + valkyrie::num_virtual;
+            q_[jidx] = q_joint_[i];
+        }
+
+        return;
+    }
+
+} // end namespace IHMCMsgUtils
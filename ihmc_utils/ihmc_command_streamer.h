@@ -0,0 +1,351 @@
+/**
+ * IHMC Command Streamer
+ * Emily Sheetz, NSTGRO VTE 2021
+ **/
+
+#ifndef _IHMC_COMMAND_STREAMER_H_
+#define _IHMC_COMMAND_STREAMER_H_
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+#include <std_msgs/Bool.h>
+#include <std_msgs/Int32MultiArray.h>
+#include <std_msgs/String.h>
+#include <sensor_msgs/JointState.h>
+#include <geometry_msgs/Pose.h>
+#include <geometry_msgs/TransformStamped.h>
+#include <tf/tf.h>
+#include <ihmc_utils/ihmc_msg_utilities.h>
+#include <ihmc_utils/ihmc_input_log.h>
+#include <ihmc_utils/ihmc_tracking_monitor.h>
+#include <ihmc_utils/ihmc_command_filter.h>
+#include <ihmc_utils/ihmc_pose_library.h>
+#include <ihmc_utils/ihmc_partial_msgs.h>
+#include <ihmc_utils/ihmc_transition_blender.h>
+#include <IHMCMsgInterface/BimanualHandGoal.h>
+#include <IHMCMsgInterface/FingerPositionCommand.h>
+
+namespace IHMCMsgUtils {
+
+    /*
+     * transport-free core of the IHMC Interface Node:
+     * takes controller inputs, tracks stream state, and builds IHMC messages, which are handed to output sinks;
+     * inputs are given by method calls and time comes from an injectable clock, so the same logic can run
+     * inside a ROS node, be replayed offline from an input capture log, or be embedded in a controller
+     * (with IHMCCommandPublisher as sinks, so commands go straight to IHMC without passing through the node);
+     * nothing in the streamer blocks (e.g., hand goals are sent in their given frame rather than waiting on TF),
+     * so multi-step operations are driven by flags checked in update() and never stall the streaming path
+     */
+    class IHMCCommandStreamer
+    {
+    public:
+        // TYPES FOR OUTPUT SINKS AND CLOCK
+        typedef std::function<void(const controller_msgs::WholeBodyTrajectoryMessage&)> WholeBodyMessageSink;
+        typedef std::function<void(const controller_msgs::GoHomeMessage&)> GoHomeMessageSink;
+        typedef std::function<void(const controller_msgs::ValkyrieHandFingerTrajectoryMessage&)> HandFingerMessageSink;
+        typedef std::function<void(const controller_msgs::StopAllTrajectoryMessage&)> StopAllTrajectoryMessageSink;
+        typedef std::function<int64_t(void)> Clock; // returns current time in nanoseconds
+
+        // CONSTRUCTORS/DESTRUCTORS
+        IHMCCommandStreamer(bool commands_from_controllers);
+        ~IHMCCommandStreamer();
+
+        // OUTPUTS
+        /*
+         * sets the function called with each message that would be published; messages without a sink are dropped
+         * @param sink, the function to call with each message
+         * @return none
+         */
+        void setWholeBodyMessageSink(WholeBodyMessageSink sink);
+        void setGoHomeMessageSink(GoHomeMessageSink sink);
+        void setHandFingerMessageSink(HandFingerMessageSink sink);
+        void setStopAllTrajectoryMessageSink(StopAllTrajectoryMessageSink sink);
+
+        /*
+         * sets the clock used to timestamp captured inputs (default is the system clock)
+         * @param clock, the function returning current time in nanoseconds
+         * @return none
+         */
+        void setClock(Clock clock);
+
+        /*
+         * sets whether status changes and published messages are reported
+         * @param verbose, the flag indicating whether to report
+         * @return none
+         */
+        void setVerbose(bool verbose);
+
+        // INPUT CAPTURE
+        bool openInputLog(std::string filename, int keyframe_interval);
+        void closeInputLog();
+
+        // COMMAND FILTERING
+        /*
+         * sets the filter applied to joint commands and pelvis transforms as they are received (default is no filtering)
+         * @param filter_params, the filter parameters
+         * @return none
+         */
+        void setCommandFilterParams(IHMCCommandFilterParams filter_params);
+
+        /*
+         * sets the stream integration duration of streamed whole-body messages (default 0.13 s);
+         * should be equal to or slightly longer than the interval between messages
+         * @param stream_integration_duration, the duration (s)
+         * @return none
+         */
+        void setStreamIntegrationDuration(double stream_integration_duration);
+
+        /*
+         * sets how often a controlled link is included in streamed whole-body messages, so slowly changing body parts
+         * (e.g., pelvis, torso) are sent less often than the arms; links without a rate are in every streamed message
+         * @param link_id, the controlled link (e.g., valkyrie_link::pelvis)
+         * @param rate, the rate (Hz) the link is streamed at; 0 or less removes the link's rate
+         * @param stream_integration_duration, the stream integration duration (s) of the link; 0 or less uses 1.3 periods
+         * @return none
+         */
+        void setBodyPartStreamRate(int link_id, double rate, double stream_integration_duration = 0.0);
+        void clearBodyPartStreamRates();
+
+        /*
+         * sets how streamed finger position commands are sent: each hand is published at most once per interval,
+         * with the latest command for each hand kept until it can be sent (defaults 0.02 s interval, 0.05 s duration)
+         * @param min_interval, the minimum time (s) between finger messages for the same hand
+         * @param stream_integration_duration, the stream integration duration (s) of streamed finger messages
+         * @return none
+         */
+        void setFingerStreamParameters(double min_interval, double stream_integration_duration);
+
+        /*
+         * sets how long streamed commands are blended in from the last pose or go home message (default 0 s, no blending);
+         * without blending, the first streamed message jumps from wherever the discrete trajectory is to the streamed configuration
+         * @param blend_duration, the duration (s) of the blend
+         * @return none
+         */
+        void setTransitionBlendDuration(double blend_duration);
+
+        // STOPPING
+        /*
+         * sets whether a prebuilt stop message is published as soon as STOP-LISTENING is received while streaming
+         * (default true); otherwise the robot follows the last streamed command until the stream times out
+         * @param stop_on_stop_listening, the flag indicating whether to publish stop message
+         * @return none
+         */
+        void setStopOnStopListening(bool stop_on_stop_listening);
+
+        /*
+         * gets time from receiving STOP-LISTENING to publishing stop message, for the last stop and worst stop
+         * @return latency (s), or 0 if no stop message has been published
+         */
+        double getLastStopLatency();
+        double getMaxStopLatency();
+        int getNumStops();
+
+        // TRACKING MONITOR
+        /*
+         * sets whether published configurations are compared against measured robot configurations
+         * @param enabled, the flag indicating whether to monitor tracking error
+         * @return none
+         */
+        void setTrackingMonitorEnabled(bool enabled);
+        IHMCTrackingMonitor& getTrackingMonitor();
+
+        // POSE LIBRARY
+        /*
+         * loads named poses, whose whole-body messages are prebuilt and published on status "POSE:<name>"
+         * @param filename, the pose library file (see ihmc_pose_library.h)
+         * @return bool indicating if pose library was read without errors
+         */
+        bool loadPoseLibrary(std::string filename);
+        IHMCPoseLibrary& getPoseLibrary();
+
+        // INPUTS
+        void processPelvisTransform(const geometry_msgs::TransformStamped& tf_msg);
+        void processControlledLinkIds(const std_msgs::Int32MultiArray& arr_msg);
+        void processJointCommand(const sensor_msgs::JointState& js_msg);
+        void processStatus(const std_msgs::String& status_msg);
+        /*
+         * same as processStatus, for a status that arrived before it is processed (e.g., waited in a callback queue)
+         * @param status_msg, the status
+         * @param receipt_time, the time the status arrived; stop latency is measured from this time
+         * @return none
+         */
+        void processStatus(const std_msgs::String& status_msg, std::chrono::steady_clock::time_point receipt_time);
+        void processHandPoseCommand(const geometry_msgs::TransformStamped& tf_msg);
+        void processBimanualHandPoseCommand(const IHMCMsgInterface::BimanualHandGoal& goal_msg);
+        void processReceiveCartesianGoals(const std_msgs::Bool& bool_msg);
+        void processRobotConfigurationData(const controller_msgs::RobotConfigurationData& config_msg);
+        void processFingerPositionCommand(const IHMCMsgInterface::FingerPositionCommand& finger_msg);
+        /*
+         * same as processJointCommand and processPelvisTransform, for inputs that were only partially deserialized
+         * (see ihmc_partial_msgs.h); joint positions are already in configuration order
+         */
+        void processPartialJointCommand(const IHMCPartialJointState& js_msg);
+        void processPartialPelvisTransform(const IHMCPartialTransformStamped& tf_msg);
+        /*
+         * processes a recorded input as if it had just been received
+         * @param record, the input read from an input capture log
+         * @return none
+         */
+        void processInputLogRecord(const IHMCInputLogRecord& record);
+
+        // CONTROLLER API
+        /*
+         * sets the commanded configuration directly, for controllers that embed the streamer;
+         * same as receiving the pelvis transform and joint command, without building or parsing messages
+         * @param q, the configuration vector, including virtual joints for the pelvis pose
+         * @return none
+         */
+        void setCommandedConfiguration(const dynacore::Vector& q);
+        /*
+         * same as receiving controlled link ids and statuses (e.g., "START-LISTENING") on topics
+         */
+        void setControlledLinks(const std::vector<int>& controlled_links);
+        void setStatus(const std::string& status);
+
+        // UPDATE
+        /*
+         * runs one cycle of the streaming loop, publishing any messages that are ready; never blocks
+         * @return bool indicating if the streamer should keep running
+         *         (false once the single whole-body message has been published when not streaming from controllers)
+         */
+        bool update();
+
+        // PUBLISH MESSAGE
+        void publishWholeBodyMessage();
+        void publishWholeBodyMessageCartesianHandGoals();
+        bool publishPoseMessage(const std::string& pose_name);
+        void publishGoHomeMessage();
+        void publishHandFingerMessage();
+        void publishFingerOpenLeftMessage();
+        void publishFingerCloseLeftMessage();
+        void publishFingerOpenRightMessage();
+        void publishFingerCloseRightMessage();
+        void publishFingerPositionMessage(int robot_side);
+        void publishStopMessage(std::chrono::steady_clock::time_point receipt_time);
+
+        // HELPER FUNCTIONS
+        std::string getStatus();
+        bool getCommandsFromControllersFlag();
+        bool getPublishCommandsFlag();
+        void updatePublishCommandsFlag();
+        bool getStopNodeFlag();
+        void updateStopNodeFlag();
+        bool getPublishGoHomeCommandFlag();
+        void updatePublishGoHomeCommandFlag();
+        bool getPublishFingerCommandFlag();
+        void updatePublishFingerCommandFlag();
+        bool getPublishHandCommandFlag();
+        void updatePublishHandCommandFlag();
+        void prepareEmptyPose(dynacore::Vect3& pos, dynacore::Quaternion& quat);
+        void preparePoseFromTransform(dynacore::Vect3& pos, dynacore::Quaternion& quat,
+                                      geometry_msgs::TransformStamped tf_msg);
+        void preparePoseFromPoseMessage(dynacore::Vect3& pos, dynacore::Quaternion& quat,
+                                        geometry_msgs::Pose pose_msg);
+        bool prepareCartesianHandGoals(dynacore::Vect3& left_pos, dynacore::Quaternion& left_quat,
+                                       dynacore::Vect3& right_pos, dynacore::Quaternion& right_quat,
+                                       std::string& frame_id, std::vector<int>& controlled_links);
+        bool prepareBimanualHandGoals(dynacore::Vect3& left_pos, dynacore::Quaternion& left_quat,
+                                      dynacore::Vect3& right_pos, dynacore::Quaternion& right_quat,
+                                      std::string& frame_id, std::vector<int>& controlled_links);
+        void prepareConfigurationVector();
+
+    private:
+        // STRUCT FOR BODY PART STREAM SCHEDULE
+        struct BodyPartStream {
+            int64_t period; // time (ns) between messages including body part
+            double stream_integration_duration; // stream integration duration (s) of body part
+            int64_t next_publish_time; // time (ns) body part is next due
+        };
+
+        void scheduleBodyParts(std::vector<int>& due_links);
+        void applyBodyPartStreamIntegrationDurations(const std::vector<int>& links,
+                                                     controller_msgs::WholeBodyTrajectoryMessage& wholebody_msg);
+        void applyStreamedVelocities(const std::vector<int>& links, const dynacore::Vector& qdot,
+                                     controller_msgs::WholeBodyTrajectoryMessage& wholebody_msg);
+        void applyPelvisPose(Eigen::VectorXd pelvis_pos, dynacore::Quaternion pelvis_quat);
+        void applyJointCommand();
+        void recordGoHomeCommand(int link_id, double trajectory_time);
+        void makeInputMessagesFromConfiguration(const dynacore::Vector& q,
+                                                geometry_msgs::TransformStamped& tf_msg,
+                                                sensor_msgs::JointState& js_msg);
+
+        WholeBodyMessageSink wholebody_sink_; // output for wholebody messages
+        GoHomeMessageSink go_home_sink_; // output for go home messages
+        HandFingerMessageSink finger_sink_; // output for finger messages
+        StopAllTrajectoryMessageSink stop_sink_; // output for stop messages
+        Clock clock_; // clock for timestamping captured inputs
+        bool verbose_; // flag indicating whether to report status changes and published messages
+
+        IHMCInputLogWriter input_log_; // writer for input capture log
+
+        IHMCVectorFilter joint_filter_; // filter for commanded joint positions
+        IHMCVectorFilter pelvis_position_filter_; // filter for pelvis position
+        IHMCQuaternionFilter pelvis_orientation_filter_; // filter for pelvis orientation
+        double stream_integration_duration_; // stream integration duration (s) of streamed whole-body messages
+        std::map<int, BodyPartStream> body_part_streams_; // stream schedule of body parts with their own rates, by link id
+        int64_t last_schedule_time_; // time (ns) body parts were last scheduled, for measuring stream period
+        int64_t stream_period_; // average time (ns) between schedules of body parts
+        bool schedule_reset_; // flag indicating whether a new stream started since body parts were last scheduled
+
+        bool stop_on_stop_listening_; // flag indicating whether to publish stop message when controllers stop
+        bool streaming_; // flag indicating whether whole-body messages have been streamed since last stop
+        controller_msgs::StopAllTrajectoryMessage stop_msg_; // prebuilt stop message
+        int num_stops_; // number of stop messages published
+        double last_stop_latency_; // time (s) from receiving status to publishing last stop message
+        double max_stop_latency_; // longest time (s) from receiving status to publishing stop message
+
+        bool monitor_tracking_; // flag indicating whether to compare commands against measured configurations
+        IHMCTrackingMonitor tracking_monitor_; // tracking error between commanded and measured configurations
+
+        IHMCPoseLibrary pose_library_; // named poses with prebuilt whole-body messages
+        IHMCTransitionBlender transition_blender_; // blends streamed commands in from poses and go home messages
+
+        std::string status_; // string indicating current status
+
+        bool commands_from_controllers_; // flag indicating whether joint commands are coming from controllers (affects queueing properties of messages)
+        bool cartesian_hand_goals_; // flag indicating whether arm commands are in Cartesian space or joint space (affects which fields of messages get set)
+        bool receive_pelvis_transform_; // flag indicating whether to accept pelvis transforms
+        bool received_pelvis_transform_; // flag indicating whether pelvis transform has been received
+        bool receive_link_ids_; // flag indicating whether to accept link ids
+        bool received_link_ids_; // flag indicating whether link ids have been received
+        bool receive_joint_command_; // flag indicating whether to accept new joint commands
+        bool received_joint_command_; // flag indicating whether joint command has been received
+        bool received_left_hand_goal_; // flag indicating whether Cartesian left hand goal has been received
+        bool received_right_hand_goal_; // flag indicating whether Cartesian right hand goal has been received
+        bool received_bimanual_hand_goal_; // flag indicating whether Cartesian goal pair for both hands has been received
+        bool publish_commands_; // flag indicating if joint and pelvis information has been received and whole body message can be published
+        bool stop_node_; // flag indicating when to publish whole body messages
+
+        bool home_left_arm_; // flag indicating if homing message for left arm should be published
+        bool home_right_arm_; // flag indicating if homing message for right arm should be published
+        bool home_chest_; // flag indicating if homing message for ches should be published
+        bool home_pelvis_; // flag indicating if homing message for pelvis should be published
+        bool publish_go_home_command_; // flag indicating if any homing messages need to be published
+
+        bool open_left_hand_; // flag indicating if open left hand message should be published
+        bool close_left_hand_; // flag indicating if close left hand message should be published
+        bool open_right_hand_; // flag indicating if open right hand message should be published
+        bool close_right_hand_; // flag indicating if close right hand message should be published
+        bool received_finger_position_[2]; // flags indicating if streamed finger positions are waiting to be published for left/right hand
+        bool publish_finger_command_; // flag indicating if any finger messages need to be published
+        bool publish_hand_command_; // flag indicating if any hand messages need to be published
+
+        dynacore::Vector q_joint_; // vector of commanded joint positions
+        tf::Transform tf_pelvis_wrt_world_; // transform of pelvis in world frame
+        dynacore::Vector q_; // full configuration vector, including virtual joints
+        std::vector<int> controlled_links_; // vector of controlled links
+        geometry_msgs::TransformStamped left_hand_target_; // target pose for left hand
+        geometry_msgs::TransformStamped right_hand_target_; // target pose for right hand
+        IHMCMsgInterface::BimanualHandGoal bimanual_hand_target_; // target poses for both hands in a shared frame
+        IHMCMsgInterface::FingerPositionCommand finger_position_target_[2]; // latest streamed finger positions for left/right hand
+        int64_t finger_publish_time_[2]; // time (ns) finger message for left/right hand was last published
+        double finger_stream_min_interval_; // minimum time (s) between streamed finger messages for the same hand
+        double finger_stream_integration_duration_; // stream integration duration (s) of streamed finger messages
+    };
+
+} // end namespace IHMCMsgUtils
+
+#endif
@@ -0,0 +1,94 @@
+/**
+ * IHMC Fan-Out Publisher
+ * Emily Sheetz, NSTGRO VTE 2021
+ **/
+
+#ifndef _IHMC_FANOUT_PUBLISHER_H_
+#define _IHMC_FANOUT_PUBLISHER_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <ros/ros.h>
+#include <ros/serialization.h>
+#include <boost/function.hpp>
+
+/*
+ * publishes the same message to any number of output targets (topics);
+ * each message is serialized once into a SerializedMessage, whose reference-counted buffer is handed to every target,
+ * so the serialized bytes are shared by all targets' outgoing queues rather than copied per target;
+ * publishing keeps no state between messages, so concurrent calls do not share a buffer
+ */
+template <class M>
+class IHMCFanOutPublisher
+{
+public:
+    // CONSTRUCTORS/DESTRUCTORS
+    IHMCFanOutPublisher() {}
+    ~IHMCFanOutPublisher() {}
+
+    // CONNECTIONS
+    /*
+     * advertises one publisher for each output target
+     * @param nh, the node handle used to advertise
+     * @param topics, the vector of output topics
+     * @param queue_size, the queue size for each publisher
+     * @return bool indicating if at least one output target was advertised
+     */
+    bool advertise(ros::NodeHandle& nh, const std::vector<std::string>& topics, uint32_t queue_size) {
+        // clear any existing targets
+        publishers_.clear();
+
+        // advertise each output target
+        for( int i = 0 ; i < topics.size() ; i++ ) {
+            publishers_.push_back(nh.advertise<M>(topics[i], queue_size));
+        }
+
+        return !publishers_.empty();
+    }
+
+    // PUBLISH MESSAGE
+    /*
+     * serializes the given message once and publishes the shared serialized buffer to every output target
+     * @param msg, the message to publish
+     * @return none
+     */
+    void publish(const M& msg) const {
+        // nobody is listening on any target, skip serialization entirely
+        if( getNumSubscribers() == 0 ) {
+            return;
+        }
+
+        // serialize message once into a new reference-counted buffer, since targets may still be queueing the last one
+        ros::SerializedMessage serialized_msg = ros::serialization::serializeMessage(msg);
+        boost::function<ros::SerializedMessage(void)> serialize_func = [&serialized_msg]() { return serialized_msg; };
+
+        // each output target shares serialized buffer instead of serializing message again
+        for( int i = 0 ; i < publishers_.size() ; i++ ) {
+            ros::SerializedMessage target_msg;
+            publishers_[i].publish(serialize_func, target_msg);
+        }
+
+        return;
+    }
+
+    // HELPER FUNCTIONS
+    uint32_t getNumSubscribers() const {
+        // count subscribers across all output targets
+        uint32_t num_subscribers = 0;
+        for( int i = 0 ; i < publishers_.size() ; i++ ) {
+            num_subscribers += publishers_[i].getNumSubscribers();
+        }
+
+        return num_subscribers;
+    }
+
+    int getNumTargets() const {
+        return publishers_.size();
+    }
+
+private:
+    std::vector<ros::Publisher> publishers_; // publishers for each output target
+};
+
+#endif
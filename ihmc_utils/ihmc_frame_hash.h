@@ -0,0 +1,83 @@
+/**
+ * Compile-Time Hash Ids for IHMC Reference Frames
+ * Emily Sheetz, NSTGRO VTE 2021
+ **/
+
+#ifndef _IHMC_FRAME_HASH_H_
+#define _IHMC_FRAME_HASH_H_
+
+#include <cstdint>
+#include <string>
+
+namespace IHMCMsgUtils {
+
+    /*
+     * IHMC identifies reference frames in FrameInformation messages by a hash of the frame's name id;
+     * the hash is Java's String.hashCode() (s[0]*31^(n-1) + ... + s[n-1] with 32-bit wraparound),
+     * and the name id of a frame is the name id of its parent, a ':' separator, and the frame's name
+     * (the root world frame has name id "World")
+     */
+
+    // separator used by IHMC between parent and child frame names in a frame name id
+    constexpr char IHMC_FRAME_NAME_SEPARATOR = ':';
+
+    /*
+     * computes the IHMC hash id of a reference frame from its full name id
+     * @param name_id, the null-terminated full name id of the frame (e.g. "World")
+     * @return the hash id to use as trajectory_reference_frame_id or data_reference_frame_id
+     */
+    constexpr int32_t hashIHMCFrameNameId(const char* name_id) {
+        // Java ints wrap around, so accumulate in unsigned arithmetic to avoid signed overflow
+        uint32_t hash = 0;
+        for( int i = 0 ; name_id[i] != '\0' ; i++ ) {
+            hash = 31u * hash + static_cast<uint32_t>(static_cast<unsigned char>(name_id[i]));
+        }
+
+        return static_cast<int32_t>(hash);
+    }
+
+    inline int32_t hashIHMCFrameNameId(const std::string& name_id) {
+        return hashIHMCFrameNameId(name_id.c_str());
+    }
+
+    /*
+     * checks whether a name is a full IHMC frame name id, i.e., the world frame "World" or a frame below it
+     * ("World:<frame>..."); ROS frame names such as "/world" or "leftPalm" are not IHMC frame name ids
+     * @param name_id, the name to check
+     * @return true if the name can be hashed into an IHMC frame id
+     */
+    inline bool isIHMCFrameNameId(const std::string& name_id) {
+        const std::string world_name_id("World");
+        return (name_id.compare(0, world_name_id.size(), world_name_id) == 0) &&
+               ((name_id.size() == world_name_id.size()) || (name_id[world_name_id.size()] == IHMC_FRAME_NAME_SEPARATOR));
+    }
+
+    /*
+     * computes the IHMC hash id of a reference frame given by its parent's name id and its own name,
+     * without building the full name id string
+     * @param parent_name_id, the null-terminated full name id of the parent frame (e.g. "World")
+     * @param frame_name, the null-terminated name of the frame
+     * @return the hash id of the frame with name id parent_name_id + ':' + frame_name
+     */
+    constexpr int32_t hashIHMCChildFrameNameId(const char* parent_name_id, const char* frame_name) {
+        // continue the parent's hash over the separator and the frame name
+        uint32_t hash = static_cast<uint32_t>(hashIHMCFrameNameId(parent_name_id));
+        hash = 31u * hash + static_cast<uint32_t>(IHMC_FRAME_NAME_SEPARATOR);
+        for( int i = 0 ; frame_name[i] != '\0' ; i++ ) {
+            hash = 31u * hash + static_cast<uint32_t>(static_cast<unsigned char>(frame_name[i]));
+        }
+
+        return static_cast<int32_t>(hash);
+    }
+
+    // hash ids of frames used by default in IHMC messages
+    constexpr int32_t IHMC_WORLD_FRAME_ID = hashIHMCFrameNameId("World");
+    // pelvis zup is one of IHMC's common frames, which use fixed ids rather than name hashes
+    constexpr int32_t IHMC_PELVIS_ZUP_FRAME_ID = -101;
+
+    // sanity check against the world frame id used by IHMC
+    static_assert(IHMC_WORLD_FRAME_ID == 83766130, "IHMC world frame hash id does not match IHMC");
+
+} // end namespace IHMCMsgUtils
+
+#endif
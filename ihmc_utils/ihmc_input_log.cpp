@@ -0,0 +1,976 @@
+/**
+ * Input Capture Log for IHMC Interface Node
+ * Emily Sheetz, NSTGRO VTE 2021
+ **/
+
+#include <ihmc_utils/ihmc_input_log.h>
+
+#include <cstring>
+#include <iostream>
+
+namespace IHMCMsgUtils {
+
+    namespace {
+
+        const char INPUT_LOG_MAGIC[8] = {'I', 'H', 'M', 'C', 'I', 'L', 'G', '1'};
+        const char INPUT_LOG_INDEX_MAGIC[8] = {'I', 'H', 'M', 'C', 'I', 'D', 'X', '1'};
+        const uint32_t INPUT_LOG_VERSION = 1;
+        const uint64_t INPUT_LOG_HEADER_SIZE = 16;
+        const uint64_t INPUT_LOG_TRAILER_SIZE = 16;
+
+        // ENCODING HELPERS (values are written little-endian; the log is read on the same machines that write it)
+        void writeFixed64(std::vector<uint8_t>& buf, uint64_t value) {
+            for( int i = 0 ; i < 8 ; i++ ) {
+                buf.push_back(static_cast<uint8_t>(value >> (8*i)));
+            }
+            return;
+        }
+
+        void writeVarint(std::vector<uint8_t>& buf, uint64_t value) {
+            // 7 bits per byte, high bit set on all but the last byte
+            while( value >= 0x80 ) {
+                buf.push_back(static_cast<uint8_t>(value | 0x80));
+                value >>= 7;
+            }
+            buf.push_back(static_cast<uint8_t>(value));
+            return;
+        }
+
+        void writeSignedVarint(std::vector<uint8_t>& buf, int64_t value) {
+            // zigzag encoding keeps small negative values small
+            writeVarint(buf, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+            return;
+        }
+
+        void writeString(std::vector<uint8_t>& buf, const std::string& str) {
+            writeVarint(buf, str.size());
+            buf.insert(buf.end(), str.begin(), str.end());
+            return;
+        }
+
+        uint64_t doubleToBits(double value) {
+            uint64_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            return bits;
+        }
+
+        double bitsToDouble(uint64_t bits) {
+            double value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+
+        void writeDeltaDoubles(std::vector<uint8_t>& buf, const std::vector<double>& values,
+                               std::vector<uint64_t>& baseline_bits, bool use_baseline) {
+            // each value is stored as the difference between its bit pattern and the baseline bit pattern
+            std::vector<uint64_t> bits(values.size());
+            for( int i = 0 ; i < values.size() ; i++ ) {
+                bits[i] = doubleToBits(values[i]);
+                uint64_t base = use_baseline ? baseline_bits[i] : 0;
+                writeSignedVarint(buf, static_cast<int64_t>(bits[i] - base));
+            }
+
+            // update baseline for next sample
+            baseline_bits.swap(bits);
+
+            return;
+        }
+
+        void writeTransform(std::vector<uint8_t>& buf, const geometry_msgs::TransformStamped& tf_msg,
+                            std::vector<uint64_t>* baseline_bits) {
+            writeString(buf, tf_msg.header.frame_id);
+            writeString(buf, tf_msg.child_frame_id);
+
+            std::vector<double> values{tf_msg.transform.translation.x,
+                                       tf_msg.transform.translation.y,
+                                       tf_msg.transform.translation.z,
+                                       tf_msg.transform.rotation.x,
+                                       tf_msg.transform.rotation.y,
+                                       tf_msg.transform.rotation.z,
+                                       tf_msg.transform.rotation.w};
+            if( baseline_bits != nullptr ) {
+                // delta encode against previous transform
+                writeDeltaDoubles(buf, values, *baseline_bits, baseline_bits->size() == values.size());
+            }
+            else {
+                std::vector<uint64_t> unused_bits;
+                writeDeltaDoubles(buf, values, unused_bits, false);
+            }
+
+            return;
+        }
+
+        void writePose(std::vector<uint8_t>& buf, const geometry_msgs::Pose& pose_msg) {
+            std::vector<double> values{pose_msg.position.x, pose_msg.position.y, pose_msg.position.z,
+                                       pose_msg.orientation.x, pose_msg.orientation.y,
+                                       pose_msg.orientation.z, pose_msg.orientation.w};
+            std::vector<uint64_t> unused_bits;
+            writeDeltaDoubles(buf, values, unused_bits, false);
+            return;
+        }
+
+        // DECODING HELPERS (all return false on truncated or malformed payloads)
+        class PayloadReader
+        {
+        public:
+            PayloadReader(const std::vector<uint8_t>& buf) : buf_(buf), pos_(0) {}
+
+            bool readFixed64(uint64_t& value) {
+                if( pos_ + 8 > buf_.size() ) {
+                    return false;
+                }
+                value = 0;
+                for( int i = 0 ; i < 8 ; i++ ) {
+                    value |= static_cast<uint64_t>(buf_[pos_ + i]) << (8*i);
+                }
+                pos_ += 8;
+                return true;
+            }
+
+            bool readVarint(uint64_t& value) {
+                value = 0;
+                for( int shift = 0 ; shift < 64 ; shift += 7 ) {
+                    if( pos_ >= buf_.size() ) {
+                        return false;
+                    }
+                    uint8_t byte = buf_[pos_++];
+                    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+                    if( (byte & 0x80) == 0 ) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            bool readSignedVarint(int64_t& value) {
+                uint64_t zigzag;
+                if( !readVarint(zigzag) ) {
+                    return false;
+                }
+                value = static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+                return true;
+            }
+
+            bool readString(std::string& str) {
+                uint64_t len;
+                if( !readVarint(len) || pos_ + len > buf_.size() ) {
+                    return false;
+                }
+                str.assign(reinterpret_cast<const char*>(&buf_[pos_]), len);
+                pos_ += len;
+                return true;
+            }
+
+            bool readBytes(std::vector<uint8_t>& bytes, uint64_t len) {
+                if( pos_ + len > buf_.size() ) {
+                    return false;
+                }
+                bytes.assign(buf_.begin() + pos_, buf_.begin() + pos_ + len);
+                pos_ += len;
+                return true;
+            }
+
+            bool readDeltaDoubles(std::vector<double>& values, int num_values,
+                                  std::vector<uint64_t>& baseline_bits, bool use_baseline) {
+                std::vector<uint64_t> bits(num_values);
+                values.resize(num_values);
+                for( int i = 0 ; i < num_values ; i++ ) {
+                    int64_t delta;
+                    if( !readSignedVarint(delta) ) {
+                        return false;
+                    }
+                    uint64_t base = use_baseline ? baseline_bits[i] : 0;
+                    bits[i] = base + static_cast<uint64_t>(delta);
+                    values[i] = bitsToDouble(bits[i]);
+                }
+
+                // update baseline for next sample
+                baseline_bits.swap(bits);
+
+                return true;
+            }
+
+            bool readTransform(geometry_msgs::TransformStamped& tf_msg, std::vector<uint64_t>* baseline_bits) {
+                if( !readString(tf_msg.header.frame_id) || !readString(tf_msg.child_frame_id) ) {
+                    return false;
+                }
+
+                std::vector<double> values;
+                bool ok;
+                if( baseline_bits != nullptr ) {
+                    ok = readDeltaDoubles(values, 7, *baseline_bits, baseline_bits->size() == 7);
+                }
+                else {
+                    std::vector<uint64_t> unused_bits;
+                    ok = readDeltaDoubles(values, 7, unused_bits, false);
+                }
+                if( !ok ) {
+                    return false;
+                }
+
+                tf_msg.transform.translation.x = values[0];
+                tf_msg.transform.translation.y = values[1];
+                tf_msg.transform.translation.z = values[2];
+                tf_msg.transform.rotation.x = values[3];
+                tf_msg.transform.rotation.y = values[4];
+                tf_msg.transform.rotation.z = values[5];
+                tf_msg.transform.rotation.w = values[6];
+
+                return true;
+            }
+
+            bool readPose(geometry_msgs::Pose& pose_msg) {
+                std::vector<double> values;
+                std::vector<uint64_t> unused_bits;
+                if( !readDeltaDoubles(values, 7, unused_bits, false) ) {
+                    return false;
+                }
+
+                pose_msg.position.x = values[0];
+                pose_msg.position.y = values[1];
+                pose_msg.position.z = values[2];
+                pose_msg.orientation.x = values[3];
+                pose_msg.orientation.y = values[4];
+                pose_msg.orientation.z = values[5];
+                pose_msg.orientation.w = values[6];
+
+                return true;
+            }
+
+            bool done() {
+                return pos_ >= buf_.size();
+            }
+
+        private:
+            const std::vector<uint8_t>& buf_;
+            uint64_t pos_;
+        };
+
+        /*
+         * encodes the body of an input record (everything after the timestamp);
+         * joint commands and pelvis transforms are delta encoded against the given state, which is updated
+         */
+        void encodeRecordBody(std::vector<uint8_t>& buf, const IHMCInputLogRecord& record,
+                              IHMCInputLogDeltaState& delta_state) {
+            switch( record.type ) {
+                case INPUT_LOG_JOINT_COMMAND: {
+                    // only store names when they change
+                    bool names_changed = (record.joint_command.name != delta_state.joint_names);
+                    buf.push_back(names_changed ? 1 : 0);
+                    if( names_changed ) {
+                        writeVarint(buf, record.joint_command.name.size());
+                        for( int i = 0 ; i < record.joint_command.name.size() ; i++ ) {
+                            writeString(buf, record.joint_command.name[i]);
+                        }
+                        delta_state.joint_names = record.joint_command.name;
+                    }
+
+                    // positions are delta encoded against previous positions for the same joints
+                    const std::vector<double>& positions = record.joint_command.position;
+                    bool use_baseline = !names_changed && (positions.size() == delta_state.joint_position_bits.size());
+                    writeVarint(buf, positions.size());
+                    writeDeltaDoubles(buf, positions, delta_state.joint_position_bits, use_baseline);
+                    break;
+                }
+                case INPUT_LOG_PELVIS_TRANSFORM:
+                    writeTransform(buf, record.transform, &(delta_state.pelvis_bits));
+                    break;
+                case INPUT_LOG_CONTROLLED_LINK_IDS:
+                    writeVarint(buf, record.controlled_link_ids.data.size());
+                    for( int i = 0 ; i < record.controlled_link_ids.data.size() ; i++ ) {
+                        writeSignedVarint(buf, record.controlled_link_ids.data[i]);
+                    }
+                    break;
+                case INPUT_LOG_STATUS:
+                    writeString(buf, record.status.data);
+                    break;
+                case INPUT_LOG_HAND_POSE_COMMAND:
+                    writeTransform(buf, record.transform, nullptr);
+                    break;
+                case INPUT_LOG_BIMANUAL_HAND_POSE_COMMAND:
+                    writeString(buf, record.bimanual_hand_goal.header.frame_id);
+                    writeVarint(buf, record.bimanual_hand_goal.cycle_id);
+                    buf.push_back((record.bimanual_hand_goal.left_hand_goal_valid ? 1 : 0) |
+                                  (record.bimanual_hand_goal.right_hand_goal_valid ? 2 : 0));
+                    writePose(buf, record.bimanual_hand_goal.left_hand_pose);
+                    writePose(buf, record.bimanual_hand_goal.right_hand_pose);
+                    break;
+                case INPUT_LOG_RECEIVE_CARTESIAN_GOALS:
+                    buf.push_back(record.receive_cartesian_goals.data ? 1 : 0);
+                    break;
+                case INPUT_LOG_FINGER_POSITION_COMMAND: {
+                    buf.push_back(record.finger_position_command.robot_side);
+                    writeVarint(buf, record.finger_position_command.valkyrie_finger_motor_names.size());
+                    buf.insert(buf.end(), record.finger_position_command.valkyrie_finger_motor_names.begin(),
+                               record.finger_position_command.valkyrie_finger_motor_names.end());
+                    std::vector<uint64_t> bits;
+                    writeVarint(buf, record.finger_position_command.motor_positions.size());
+                    writeDeltaDoubles(buf, record.finger_position_command.motor_positions, bits, false);
+                    break;
+                }
+                default:
+                    break;
+            }
+
+            return;
+        }
+
+        /*
+         * decodes the body of an input record written by encodeRecordBody
+         */
+        bool decodeRecordBody(PayloadReader& reader, IHMCInputLogRecord& record,
+                              IHMCInputLogDeltaState& delta_state) {
+            uint64_t value;
+            switch( record.type ) {
+                case INPUT_LOG_JOINT_COMMAND: {
+                    std::vector<uint8_t> flags;
+                    if( !reader.readBytes(flags, 1) ) {
+                        return false;
+                    }
+                    bool names_changed = (flags[0] != 0);
+                    if( names_changed ) {
+                        if( !reader.readVarint(value) ) {
+                            return false;
+                        }
+                        delta_state.joint_names.resize(value);
+                        for( int i = 0 ; i < value ; i++ ) {
+                            if( !reader.readString(delta_state.joint_names[i]) ) {
+                                return false;
+                            }
+                        }
+                    }
+                    record.joint_command.name = delta_state.joint_names;
+
+                    if( !reader.readVarint(value) ) {
+                        return false;
+                    }
+                    bool use_baseline = !names_changed && (value == delta_state.joint_position_bits.size());
+                    return reader.readDeltaDoubles(record.joint_command.position, value,
+                                                   delta_state.joint_position_bits, use_baseline);
+                }
+                case INPUT_LOG_PELVIS_TRANSFORM:
+                    return reader.readTransform(record.transform, &(delta_state.pelvis_bits));
+                case INPUT_LOG_CONTROLLED_LINK_IDS:
+                    if( !reader.readVarint(value) ) {
+                        return false;
+                    }
+                    record.controlled_link_ids.data.resize(value);
+                    for( int i = 0 ; i < value ; i++ ) {
+                        int64_t link_id;
+                        if( !reader.readSignedVarint(link_id) ) {
+                            return false;
+                        }
+                        record.controlled_link_ids.data[i] = link_id;
+                    }
+                    return true;
+                case INPUT_LOG_STATUS:
+                    return reader.readString(record.status.data);
+                case INPUT_LOG_HAND_POSE_COMMAND:
+                    return reader.readTransform(record.transform, nullptr);
+                case INPUT_LOG_BIMANUAL_HAND_POSE_COMMAND: {
+                    std::vector<uint8_t> flags;
+                    if( !reader.readString(record.bimanual_hand_goal.header.frame_id) ||
+                        !reader.readVarint(value) || !reader.readBytes(flags, 1) ) {
+                        return false;
+                    }
+                    record.bimanual_hand_goal.cycle_id = value;
+                    record.bimanual_hand_goal.left_hand_goal_valid = ((flags[0] & 1) != 0);
+                    record.bimanual_hand_goal.right_hand_goal_valid = ((flags[0] & 2) != 0);
+                    return reader.readPose(record.bimanual_hand_goal.left_hand_pose) &&
+                           reader.readPose(record.bimanual_hand_goal.right_hand_pose);
+                }
+                case INPUT_LOG_RECEIVE_CARTESIAN_GOALS: {
+                    std::vector<uint8_t> flags;
+                    if( !reader.readBytes(flags, 1) ) {
+                        return false;
+                    }
+                    record.receive_cartesian_goals.data = (flags[0] != 0);
+                    return true;
+                }
+                case INPUT_LOG_FINGER_POSITION_COMMAND: {
+                    std::vector<uint8_t> side;
+                    if( !reader.readBytes(side, 1) || !reader.readVarint(value) ||
+                        !reader.readBytes(record.finger_position_command.valkyrie_finger_motor_names, value) ||
+                        !reader.readVarint(value) ) {
+                        return false;
+                    }
+                    record.finger_position_command.robot_side = side[0];
+                    std::vector<uint64_t> bits;
+                    return reader.readDeltaDoubles(record.finger_position_command.motor_positions, value, bits, false);
+                }
+                default:
+                    // unknown input type
+                    return false;
+            }
+        }
+
+        /*
+         * key for the latest input of each type in a keyframe snapshot;
+         * keys sort in the order the snapshot should be replayed (status and flags before commands);
+         * listening statuses are state and one-shot statuses (go home, hands, poses) are events,
+         * so a one-shot status never replaces the listening state in a snapshot
+         */
+        std::string getSnapshotKey(const IHMCInputLogRecord& record) {
+            switch( record.type ) {
+                case INPUT_LOG_STATUS:
+                    if( (record.status.data == std::string("START-LISTENING")) || (record.status.data == std::string("STOP-LISTENING")) ) {
+                        return std::string("0");
+                    }
+                    return std::string("1");
+                case INPUT_LOG_RECEIVE_CARTESIAN_GOALS:    return std::string("2");
+                case INPUT_LOG_CONTROLLED_LINK_IDS:        return std::string("3");
+                case INPUT_LOG_PELVIS_TRANSFORM:           return std::string("4");
+                // left and right hand goals are kept separately
+                case INPUT_LOG_HAND_POSE_COMMAND:          return std::string("5") + record.transform.child_frame_id;
+                case INPUT_LOG_BIMANUAL_HAND_POSE_COMMAND: return std::string("6");
+                case INPUT_LOG_JOINT_COMMAND:              return std::string("7");
+                // left and right finger commands are kept separately
+                case INPUT_LOG_FINGER_POSITION_COMMAND:    return std::string("8") + std::to_string(record.finger_position_command.robot_side);
+                default:                                   return std::string("9");
+            }
+        }
+
+    } // end anonymous namespace
+
+    // WRITER
+    // CONSTRUCTORS/DESTRUCTORS
+    IHMCInputLogWriter::IHMCInputLogWriter() {
+        keyframe_interval_ = 100;
+        records_since_keyframe_ = 0;
+    }
+
+    IHMCInputLogWriter::~IHMCInputLogWriter() {
+        close();
+    }
+
+    // FILE
+    bool IHMCInputLogWriter::open(std::string filename, int keyframe_interval) {
+        // close any previously opened log
+        close();
+
+        file_.open(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+        if( !file_.is_open() ) {
+            std::cout << "[IHMC Input Log] Could not open " << filename << " for writing" << std::endl;
+            return false;
+        }
+
+        // reset state
+        keyframe_interval_ = (keyframe_interval > 0) ? keyframe_interval : 1;
+        records_since_keyframe_ = keyframe_interval_; // first input is preceded by a keyframe
+        delta_state_ = IHMCInputLogDeltaState();
+        index_.clear();
+        latest_inputs_.clear();
+
+        // write header
+        std::vector<uint8_t> header(INPUT_LOG_MAGIC, INPUT_LOG_MAGIC + 8);
+        for( int i = 0 ; i < 4 ; i++ ) {
+            header.push_back(static_cast<uint8_t>(INPUT_LOG_VERSION >> (8*i)));
+        }
+        for( int i = 0 ; i < 4 ; i++ ) {
+            header.push_back(static_cast<uint8_t>(static_cast<uint32_t>(keyframe_interval_) >> (8*i)));
+        }
+        file_.write(reinterpret_cast<const char*>(header.data()), header.size());
+
+        return file_.good();
+    }
+
+    void IHMCInputLogWriter::close() {
+        if( !file_.is_open() ) {
+            return;
+        }
+
+        // write seek index as a record, so readers that scan the file can skip it
+        uint64_t index_offset = file_.tellp();
+        payload_.clear();
+        writeVarint(payload_, index_.size());
+        for( int i = 0 ; i < index_.size() ; i++ ) {
+            writeFixed64(payload_, static_cast<uint64_t>(index_[i].timestamp));
+            writeFixed64(payload_, index_[i].offset);
+        }
+        writeRecord(INPUT_LOG_INDEX);
+
+        // write trailer pointing at index
+        std::vector<uint8_t> trailer;
+        writeFixed64(trailer, index_offset);
+        trailer.insert(trailer.end(), INPUT_LOG_INDEX_MAGIC, INPUT_LOG_INDEX_MAGIC + 8);
+        file_.write(reinterpret_cast<const char*>(trailer.data()), trailer.size());
+
+        file_.close();
+
+        return;
+    }
+
+    bool IHMCInputLogWriter::isOpen() {
+        return file_.is_open();
+    }
+
+    // LOG INPUTS
+    void IHMCInputLogWriter::logJointCommand(int64_t timestamp, const sensor_msgs::JointState& js_msg) {
+        IHMCInputLogRecord record;
+        record.type = INPUT_LOG_JOINT_COMMAND;
+        // only names and positions are consumed by the node
+        record.joint_command.name = js_msg.name;
+        record.joint_command.position = js_msg.position;
+        logRecord(timestamp, record);
+        return;
+    }
+
+    void IHMCInputLogWriter::logPelvisTransform(int64_t timestamp, const geometry_msgs::TransformStamped& tf_msg) {
+        IHMCInputLogRecord record;
+        record.type = INPUT_LOG_PELVIS_TRANSFORM;
+        record.transform = tf_msg;
+        logRecord(timestamp, record);
+        return;
+    }
+
+    void IHMCInputLogWriter::logControlledLinkIds(int64_t timestamp, const std_msgs::Int32MultiArray& arr_msg) {
+        IHMCInputLogRecord record;
+        record.type = INPUT_LOG_CONTROLLED_LINK_IDS;
+        record.controlled_link_ids.data = arr_msg.data;
+        logRecord(timestamp, record);
+        return;
+    }
+
+    void IHMCInputLogWriter::logStatus(int64_t timestamp, const std_msgs::String& status_msg) {
+        IHMCInputLogRecord record;
+        record.type = INPUT_LOG_STATUS;
+        record.status = status_msg;
+        logRecord(timestamp, record);
+        return;
+    }
+
+    void IHMCInputLogWriter::logHandPoseCommand(int64_t timestamp, const geometry_msgs::TransformStamped& tf_msg) {
+        IHMCInputLogRecord record;
+        record.type = INPUT_LOG_HAND_POSE_COMMAND;
+        record.transform = tf_msg;
+        logRecord(timestamp, record);
+        return;
+    }
+
+    void IHMCInputLogWriter::logBimanualHandPoseCommand(int64_t timestamp, const IHMCMsgInterface::BimanualHandGoal& goal_msg) {
+        IHMCInputLogRecord record;
+        record.type = INPUT_LOG_BIMANUAL_HAND_POSE_COMMAND;
+        record.bimanual_hand_goal = goal_msg;
+        logRecord(timestamp, record);
+        return;
+    }
+
+    void IHMCInputLogWriter::logReceiveCartesianGoals(int64_t timestamp, const std_msgs::Bool& bool_msg) {
+        IHMCInputLogRecord record;
+        record.type = INPUT_LOG_RECEIVE_CARTESIAN_GOALS;
+        record.receive_cartesian_goals = bool_msg;
+        logRecord(timestamp, record);
+        return;
+    }
+
+    void IHMCInputLogWriter::logFingerPositionCommand(int64_t timestamp, const IHMCMsgInterface::FingerPositionCommand& finger_msg) {
+        IHMCInputLogRecord record;
+        record.type = INPUT_LOG_FINGER_POSITION_COMMAND;
+        record.finger_position_command = finger_msg;
+        logRecord(timestamp, record);
+        return;
+    }
+
+    // HELPER FUNCTIONS
+    void IHMCInputLogWriter::logRecord(int64_t timestamp, const IHMCInputLogRecord& record) {
+        if( !file_.is_open() ) {
+            return;
+        }
+
+        // start a new keyframe when interval has elapsed
+        if( records_since_keyframe_ >= keyframe_interval_ ) {
+            writeKeyframe(timestamp);
+        }
+
+        // encode timestamp relative to previous record, then delta encoded body
+        payload_.clear();
+        writeSignedVarint(payload_, timestamp - delta_state_.last_timestamp);
+        delta_state_.last_timestamp = timestamp;
+        encodeRecordBody(payload_, record, delta_state_);
+        writeRecord(record.type);
+        records_since_keyframe_++;
+
+        // keep latest input of each type for next keyframe
+        IHMCInputLogRecord& latest = latest_inputs_[getSnapshotKey(record)];
+        latest = record;
+        latest.timestamp = timestamp;
+
+        return;
+    }
+
+    void IHMCInputLogWriter::writeRecord(IHMCInputLogRecordType type) {
+        // record framing: type, payload length, payload
+        std::vector<uint8_t> framing;
+        framing.push_back(static_cast<uint8_t>(type));
+        writeVarint(framing, payload_.size());
+        file_.write(reinterpret_cast<const char*>(framing.data()), framing.size());
+        file_.write(reinterpret_cast<const char*>(payload_.data()), payload_.size());
+        return;
+    }
+
+    void IHMCInputLogWriter::writeKeyframe(int64_t timestamp) {
+        // add keyframe to seek index
+        IHMCInputLogIndexEntry entry;
+        entry.timestamp = timestamp;
+        entry.offset = file_.tellp();
+        index_.push_back(entry);
+
+        // keyframe starts from empty delta state, so decoding can begin here
+        delta_state_ = IHMCInputLogDeltaState();
+        delta_state_.last_timestamp = timestamp;
+
+        // absolute timestamp followed by full snapshot of latest inputs; each entry is type, length, body
+        payload_.clear();
+        writeFixed64(payload_, static_cast<uint64_t>(timestamp));
+        writeVarint(payload_, latest_inputs_.size());
+        std::vector<uint8_t> body;
+        std::map<std::string, IHMCInputLogRecord>::iterator it;
+        for( it = latest_inputs_.begin() ; it != latest_inputs_.end() ; it++ ) {
+            body.clear();
+            encodeRecordBody(body, it->second, delta_state_);
+            payload_.push_back(static_cast<uint8_t>(it->second.type));
+            writeVarint(payload_, body.size());
+            payload_.insert(payload_.end(), body.begin(), body.end());
+        }
+        writeRecord(INPUT_LOG_KEYFRAME);
+        records_since_keyframe_ = 0;
+
+        // make everything up to the keyframe durable
+        file_.flush();
+
+        return;
+    }
+
+    // READER
+    // CONSTRUCTORS/DESTRUCTORS
+    IHMCInputLogReader::IHMCInputLogReader() {
+        data_start_ = INPUT_LOG_HEADER_SIZE;
+        data_end_ = INPUT_LOG_HEADER_SIZE;
+        keyframe_interval_ = 0;
+        at_end_ = false;
+        read_error_ = false;
+        truncated_ = false;
+    }
+
+    IHMCInputLogReader::~IHMCInputLogReader() {
+        close();
+    }
+
+    // FILE
+    bool IHMCInputLogReader::open(std::string filename) {
+        close();
+
+        file_.open(filename.c_str(), std::ios::in | std::ios::binary);
+        if( !file_.is_open() ) {
+            std::cout << "[IHMC Input Log] Could not open " << filename << " for reading" << std::endl;
+            return false;
+        }
+
+        // check header
+        char header[INPUT_LOG_HEADER_SIZE];
+        file_.read(header, INPUT_LOG_HEADER_SIZE);
+        if( !file_.good() || std::memcmp(header, INPUT_LOG_MAGIC, 8) != 0 ) {
+            std::cout << "[IHMC Input Log] " << filename << " is not an input log" << std::endl;
+            file_.close();
+            return false;
+        }
+        uint32_t keyframe_interval = 0;
+        for( int i = 0 ; i < 4 ; i++ ) {
+            keyframe_interval |= static_cast<uint32_t>(static_cast<uint8_t>(header[12 + i])) << (8*i);
+        }
+        keyframe_interval_ = keyframe_interval;
+        at_end_ = false;
+        read_error_ = false;
+        truncated_ = false;
+
+        // load seek index from trailer, or rebuild it if log was not closed cleanly
+        if( !buildIndexFromTrailer() ) {
+            std::cout << "[IHMC Input Log] No index found in " << filename << ", scanning log" << std::endl;
+            buildIndexByScanning();
+        }
+
+        // position reader at first record; index building may have read to end of records
+        file_.clear();
+        file_.seekg(data_start_);
+        delta_state_ = IHMCInputLogDeltaState();
+        at_end_ = false;
+        read_error_ = false;
+
+        return true;
+    }
+
+    void IHMCInputLogReader::close() {
+        if( file_.is_open() ) {
+            file_.close();
+        }
+        index_.clear();
+        return;
+    }
+
+    bool IHMCInputLogReader::isOpen() {
+        return file_.is_open();
+    }
+
+    // READ INPUTS
+    bool IHMCInputLogReader::readNext(IHMCInputLogRecord& record) {
+        uint8_t type;
+        std::vector<uint8_t> payload;
+        uint64_t offset;
+        while( readRawRecord(type, payload, offset) ) {
+            PayloadReader reader(payload);
+            if( type == INPUT_LOG_KEYFRAME ) {
+                // keyframes only reset decoding state; their snapshot repeats inputs already returned
+                std::vector<IHMCInputLogRecord> unused_snapshot;
+                if( !decodeKeyframe(payload, unused_snapshot) ) {
+                    read_error_ = true;
+                    return false;
+                }
+                continue;
+            }
+
+            // decode timestamp and body
+            int64_t delta_time;
+            if( !reader.readSignedVarint(delta_time) ) {
+                read_error_ = true;
+                return false;
+            }
+            record = IHMCInputLogRecord();
+            record.type = static_cast<IHMCInputLogRecordType>(type);
+            record.timestamp = delta_state_.last_timestamp + delta_time;
+            delta_state_.last_timestamp = record.timestamp;
+            if( !decodeRecordBody(reader, record, delta_state_) ) {
+                std::cout << "[IHMC Input Log] Could not decode record at offset " << offset << std::endl;
+                read_error_ = true;
+                return false;
+            }
+
+            return true;
+        }
+
+        return false;
+    }
+
+    bool IHMCInputLogReader::readToCleanEnd() {
+        return at_end_ && !read_error_ && !truncated_;
+    }
+
+    bool IHMCInputLogReader::seek(int64_t timestamp, std::vector<IHMCInputLogRecord>& snapshot) {
+        snapshot.clear();
+        if( !file_.is_open() || index_.empty() ) {
+            return false;
+        }
+
+        // binary search for latest keyframe at or before time; times before first keyframe use first keyframe
+        int lo = 0;
+        int hi = index_.size() - 1;
+        while( lo < hi ) {
+            int mid = (lo + hi + 1) / 2;
+            if( index_[mid].timestamp <= timestamp ) {
+                lo = mid;
+            }
+            else {
+                hi = mid - 1;
+            }
+        }
+
+        // read and decode keyframe
+        file_.clear();
+        file_.seekg(index_[lo].offset);
+        uint8_t type;
+        std::vector<uint8_t> payload;
+        uint64_t offset;
+        if( !readRawRecord(type, payload, offset) || type != INPUT_LOG_KEYFRAME ) {
+            std::cout << "[IHMC Input Log] Index does not point at keyframe" << std::endl;
+            return false;
+        }
+
+        return decodeKeyframe(payload, snapshot);
+    }
+
+    // HELPER FUNCTIONS
+    const std::vector<IHMCInputLogIndexEntry>& IHMCInputLogReader::getIndex() {
+        return index_;
+    }
+
+    int IHMCInputLogReader::getKeyframeInterval() {
+        return keyframe_interval_;
+    }
+
+    bool IHMCInputLogReader::readRawRecord(uint8_t& type, std::vector<uint8_t>& payload, uint64_t& offset) {
+        // stop at end of records; the index and trailer are not inputs
+        if( !file_.good() ) {
+            read_error_ = true;
+            return false;
+        }
+        offset = file_.tellg();
+        if( offset >= data_end_ ) {
+            at_end_ = true;
+            return false;
+        }
+
+        // read type and payload length
+        char type_byte;
+        if( !file_.get(type_byte) ) {
+            read_error_ = true;
+            return false;
+        }
+        type = static_cast<uint8_t>(type_byte);
+        uint64_t len = 0;
+        for( int shift = 0 ; ; shift += 7 ) {
+            char byte;
+            if( shift >= 64 || !file_.get(byte) ) {
+                read_error_ = true;
+                return false;
+            }
+            len |= static_cast<uint64_t>(static_cast<uint8_t>(byte) & 0x7f) << shift;
+            if( (static_cast<uint8_t>(byte) & 0x80) == 0 ) {
+                break;
+            }
+        }
+
+        // read payload; a truncated final record (e.g., node killed mid-write) ends the log
+        if( static_cast<uint64_t>(file_.tellg()) + len > data_end_ ) {
+            read_error_ = true;
+            return false;
+        }
+        payload.resize(len);
+        if( len > 0 ) {
+            file_.read(reinterpret_cast<char*>(payload.data()), len);
+        }
+        if( (len > 0) && (static_cast<uint64_t>(file_.gcount()) != len) ) {
+            read_error_ = true;
+            return false;
+        }
+
+        return true;
+    }
+
+    bool IHMCInputLogReader::decodeKeyframe(const std::vector<uint8_t>& payload, std::vector<IHMCInputLogRecord>& snapshot) {
+        PayloadReader reader(payload);
+
+        // keyframe starts from empty delta state, same as the writer
+        uint64_t timestamp_bits;
+        uint64_t num_entries;
+        if( !reader.readFixed64(timestamp_bits) || !reader.readVarint(num_entries) ) {
+            return false;
+        }
+        delta_state_ = IHMCInputLogDeltaState();
+        delta_state_.last_timestamp = static_cast<int64_t>(timestamp_bits);
+
+        // decode snapshot of latest inputs
+        for( int i = 0 ; i < num_entries ; i++ ) {
+            std::vector<uint8_t> type;
+            uint64_t len;
+            std::vector<uint8_t> body;
+            if( !reader.readBytes(type, 1) || !reader.readVarint(len) || !reader.readBytes(body, len) ) {
+                return false;
+            }
+
+            IHMCInputLogRecord record;
+            record.type = static_cast<IHMCInputLogRecordType>(type[0]);
+            record.timestamp = delta_state_.last_timestamp;
+            PayloadReader body_reader(body);
+            if( !decodeRecordBody(body_reader, record, delta_state_) ) {
+                return false;
+            }
+            snapshot.push_back(record);
+        }
+
+        return true;
+    }
+
+    bool IHMCInputLogReader::buildIndexFromTrailer() {
+        // find file size
+        file_.clear();
+        file_.seekg(0, std::ios::end);
+        uint64_t file_size = file_.tellg();
+        if( file_size < INPUT_LOG_HEADER_SIZE + INPUT_LOG_TRAILER_SIZE ) {
+            return false;
+        }
+
+        // read trailer
+        std::vector<uint8_t> trailer(INPUT_LOG_TRAILER_SIZE);
+        file_.seekg(file_size - INPUT_LOG_TRAILER_SIZE);
+        file_.read(reinterpret_cast<char*>(trailer.data()), trailer.size());
+        if( !file_.good() || std::memcmp(trailer.data() + 8, INPUT_LOG_INDEX_MAGIC, 8) != 0 ) {
+            return false;
+        }
+        uint64_t index_offset;
+        PayloadReader trailer_reader(trailer);
+        trailer_reader.readFixed64(index_offset);
+        if( index_offset < INPUT_LOG_HEADER_SIZE || index_offset >= file_size - INPUT_LOG_TRAILER_SIZE ) {
+            return false;
+        }
+
+        // read index record
+        data_end_ = file_size - INPUT_LOG_TRAILER_SIZE;
+        file_.seekg(index_offset);
+        uint8_t type;
+        std::vector<uint8_t> payload;
+        uint64_t offset;
+        if( !readRawRecord(type, payload, offset) || type != INPUT_LOG_INDEX ) {
+            data_end_ = file_size;
+            return false;
+        }
+
+        PayloadReader reader(payload);
+        uint64_t num_entries;
+        if( !reader.readVarint(num_entries) ) {
+            data_end_ = file_size;
+            return false;
+        }
+        index_.clear();
+        for( int i = 0 ; i < num_entries ; i++ ) {
+            IHMCInputLogIndexEntry entry;
+            uint64_t timestamp_bits;
+            if( !reader.readFixed64(timestamp_bits) || !reader.readFixed64(entry.offset) ) {
+                index_.clear();
+                data_end_ = file_size;
+                return false;
+            }
+            entry.timestamp = static_cast<int64_t>(timestamp_bits);
+            index_.push_back(entry);
+        }
+
+        // records end where index begins
+        data_end_ = index_offset;
+
+        return true;
+    }
+
+    void IHMCInputLogReader::buildIndexByScanning() {
+        // find file size; without a trailer every byte after the header may hold records
+        file_.clear();
+        file_.seekg(0, std::ios::end);
+        data_end_ = file_.tellg();
+        file_.seekg(data_start_);
+
+        // visit every record, collecting keyframes
+        index_.clear();
+        uint8_t type;
+        std::vector<uint8_t> payload;
+        uint64_t offset;
+        uint64_t last_complete = data_start_;
+        while( readRawRecord(type, payload, offset) ) {
+            if( type == INPUT_LOG_KEYFRAME ) {
+                PayloadReader reader(payload);
+                uint64_t timestamp_bits;
+                if( !reader.readFixed64(timestamp_bits) ) {
+                    break;
+                }
+                IHMCInputLogIndexEntry entry;
+                entry.timestamp = static_cast<int64_t>(timestamp_bits);
+                entry.offset = offset;
+                index_.push_back(entry);
+            }
+            last_complete = file_.tellg();
+        }
+
+        // ignore any partially written record at end of log
+        truncated_ = (last_complete < data_end_);
+        data_end_ = last_complete;
+
+        return;
+    }
+
+} // end namespace IHMCMsgUtils
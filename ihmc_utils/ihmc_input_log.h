@@ -0,0 +1,213 @@
+/**
+ * Input Capture Log for IHMC Interface Node
+ * Emily Sheetz, NSTGRO VTE 2021
+ **/
+
+#ifndef _IHMC_INPUT_LOG_H_
+#define _IHMC_INPUT_LOG_H_
+
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+#include <std_msgs/Bool.h>
+#include <std_msgs/Int32MultiArray.h>
+#include <std_msgs/String.h>
+#include <sensor_msgs/JointState.h>
+#include <geometry_msgs/TransformStamped.h>
+#include <IHMCMsgInterface/BimanualHandGoal.h>
+#include <IHMCMsgInterface/FingerPositionCommand.h>
+
+/*
+ * The input capture log is a compact binary log of every input consumed by the IHMC Interface Node.
+ *
+ * FILE LAYOUT (all fixed-width values little-endian):
+ *   header:  "IHMCILG1", uint32 version, uint32 keyframe interval
+ *   records: uint8 type, varint payload length, payload
+ *   index:   one INDEX record listing (timestamp, file offset) of every keyframe
+ *   trailer: uint64 file offset of INDEX record, "IHMCIDX1"
+ *
+ * Every record payload starts with its timestamp (ns) as a zigzag varint delta from the previous record.
+ * Joint positions and pelvis transforms are delta encoded against the previous sample:
+ * each double is stored as the zigzag varint difference between its bit pattern and the previous bit pattern,
+ * so unchanged values take one byte and small changes take a few bytes, without losing precision.
+ * Joint names are only stored when they change.  Finger positions are stored in full, since fingers are commanded
+ * one hand at a time.
+ *
+ * Every keyframe interval records, a KEYFRAME record stores an absolute timestamp and a full (non-delta) snapshot
+ * of the latest input of each type; the listening status and the latest other status are kept separately, so a go home,
+ * hand, or pose status does not hide whether controllers were streaming.  Decoding can start at any keyframe, so the index
+ * allows replay from any point without scanning the file.  If the file was not closed cleanly (no trailer), the reader
+ * rebuilds the index by scanning.
+ */
+
+namespace IHMCMsgUtils {
+
+    // TYPES OF RECORDS IN INPUT LOG
+    enum IHMCInputLogRecordType {
+        INPUT_LOG_KEYFRAME = 0,
+        INPUT_LOG_INDEX = 1,
+        INPUT_LOG_JOINT_COMMAND = 2,
+        INPUT_LOG_PELVIS_TRANSFORM = 3,
+        INPUT_LOG_CONTROLLED_LINK_IDS = 4,
+        INPUT_LOG_STATUS = 5,
+        INPUT_LOG_HAND_POSE_COMMAND = 6,
+        INPUT_LOG_BIMANUAL_HAND_POSE_COMMAND = 7,
+        INPUT_LOG_RECEIVE_CARTESIAN_GOALS = 8,
+        INPUT_LOG_FINGER_POSITION_COMMAND = 9
+    };
+
+    // STRUCT FOR ONE DECODED INPUT
+    struct IHMCInputLogRecord {
+        // type of input; only the field matching the type is populated
+        IHMCInputLogRecordType type;
+
+        // time (ns) at which the input was consumed
+        int64_t timestamp;
+
+        sensor_msgs::JointState joint_command;
+        geometry_msgs::TransformStamped transform; // pelvis transform or hand pose command
+        std_msgs::Int32MultiArray controlled_link_ids;
+        std_msgs::String status;
+        IHMCMsgInterface::BimanualHandGoal bimanual_hand_goal;
+        std_msgs::Bool receive_cartesian_goals;
+        IHMCMsgInterface::FingerPositionCommand finger_position_command;
+    };
+
+    // STRUCT FOR SEEK INDEX ENTRY
+    struct IHMCInputLogIndexEntry {
+        int64_t timestamp; // absolute time (ns) of keyframe
+        uint64_t offset; // file offset of keyframe record
+    };
+
+    // STRUCT FOR DELTA ENCODING STATE, SHARED BY WRITER AND READER
+    struct IHMCInputLogDeltaState {
+        int64_t last_timestamp;
+        std::vector<std::string> joint_names;
+        std::vector<uint64_t> joint_position_bits;
+        std::vector<uint64_t> pelvis_bits;
+
+        IHMCInputLogDeltaState() {
+            last_timestamp = 0;
+        }
+    };
+
+    class IHMCInputLogWriter
+    {
+    public:
+        // CONSTRUCTORS/DESTRUCTORS
+        IHMCInputLogWriter();
+        ~IHMCInputLogWriter();
+
+        // FILE
+        /*
+         * opens a new input log, overwriting any existing file
+         * @param filename, the path of the log file
+         * @param keyframe_interval, the number of records between keyframes
+         * @return bool indicating if the log was opened
+         */
+        bool open(std::string filename, int keyframe_interval);
+        /*
+         * writes the seek index and trailer, then closes the log
+         */
+        void close();
+        bool isOpen();
+
+        // LOG INPUTS
+        /*
+         * appends an input to the log
+         * @param timestamp, the time (ns) at which the input was consumed
+         * @param msg, the consumed input message
+         * @return none
+         */
+        void logJointCommand(int64_t timestamp, const sensor_msgs::JointState& js_msg);
+        void logPelvisTransform(int64_t timestamp, const geometry_msgs::TransformStamped& tf_msg);
+        void logControlledLinkIds(int64_t timestamp, const std_msgs::Int32MultiArray& arr_msg);
+        void logStatus(int64_t timestamp, const std_msgs::String& status_msg);
+        void logHandPoseCommand(int64_t timestamp, const geometry_msgs::TransformStamped& tf_msg);
+        void logBimanualHandPoseCommand(int64_t timestamp, const IHMCMsgInterface::BimanualHandGoal& goal_msg);
+        void logReceiveCartesianGoals(int64_t timestamp, const std_msgs::Bool& bool_msg);
+        void logFingerPositionCommand(int64_t timestamp, const IHMCMsgInterface::FingerPositionCommand& finger_msg);
+
+    private:
+        void logRecord(int64_t timestamp, const IHMCInputLogRecord& record);
+        void writeRecord(IHMCInputLogRecordType type);
+        void writeKeyframe(int64_t timestamp);
+
+        std::ofstream file_; // output log file
+        int keyframe_interval_; // number of records between keyframes
+        int records_since_keyframe_; // number of records written since last keyframe
+        std::vector<uint8_t> payload_; // scratch buffer for payload of current record
+        IHMCInputLogDeltaState delta_state_; // state for delta encoding
+        std::vector<IHMCInputLogIndexEntry> index_; // seek index of keyframes
+
+        std::map<std::string, IHMCInputLogRecord> latest_inputs_; // latest input of each type, used to write keyframe snapshots
+    };
+
+    class IHMCInputLogReader
+    {
+    public:
+        // CONSTRUCTORS/DESTRUCTORS
+        IHMCInputLogReader();
+        ~IHMCInputLogReader();
+
+        // FILE
+        /*
+         * opens an input log and loads its seek index (rebuilding the index by scanning if the log has no trailer)
+         * @param filename, the path of the log file
+         * @return bool indicating if the log was opened
+         */
+        bool open(std::string filename);
+        void close();
+        bool isOpen();
+
+        // READ INPUTS
+        /*
+         * reads the next input in the log; keyframes are consumed internally
+         * @param record, the record that will be populated
+         * @return bool indicating if a record was read (false at end of log)
+         */
+        bool readNext(IHMCInputLogRecord& record);
+
+        /*
+         * checks whether reading stopped at the end of the log, rather than at a record that could not be read or decoded,
+         * or at a partially written record of a log that was not closed (e.g., node killed mid-write)
+         * @return bool indicating if every record in the log was read
+         */
+        bool readToCleanEnd();
+
+        /*
+         * positions the reader at the latest keyframe at or before the given time
+         * @param timestamp, the absolute time (ns) to seek to
+         * @param snapshot, the latest input of each type as of the keyframe, in an order suitable for replay
+         * @return bool indicating if a keyframe was found
+         * @post readNext returns inputs following the keyframe; callers replay the snapshot,
+         *       then replay (or skip) inputs until reaching the requested time
+         */
+        bool seek(int64_t timestamp, std::vector<IHMCInputLogRecord>& snapshot);
+
+        // HELPER FUNCTIONS
+        const std::vector<IHMCInputLogIndexEntry>& getIndex();
+        int getKeyframeInterval();
+
+    private:
+        bool readRawRecord(uint8_t& type, std::vector<uint8_t>& payload, uint64_t& offset);
+        bool decodeKeyframe(const std::vector<uint8_t>& payload, std::vector<IHMCInputLogRecord>& snapshot);
+        bool buildIndexFromTrailer();
+        void buildIndexByScanning();
+
+        std::ifstream file_; // input log file
+        uint64_t data_start_; // file offset of first record
+        uint64_t data_end_; // file offset after last record (start of index, if any)
+        int keyframe_interval_; // number of records between keyframes
+        IHMCInputLogDeltaState delta_state_; // state for delta decoding
+        std::vector<IHMCInputLogIndexEntry> index_; // seek index of keyframes
+        bool at_end_; // flag indicating whether reading reached end of records
+        bool read_error_; // flag indicating whether a record could not be read or decoded
+        bool truncated_; // flag indicating whether log ends in a partially written record
+    };
+
+} // end namespace IHMCMsgUtils
+
+#endif
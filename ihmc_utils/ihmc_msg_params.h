@@ -3,7 +3,13 @@
  * Emily Sheetz, NSTGRO VTE 2021
  **/
 
+#ifndef _IHMC_MSG_PARAMS_H_
+#define _IHMC_MSG_PARAMS_H_
+
 #include <vector>
+#include <string>
+
+#include <ihmc_utils/ihmc_frame_hash.h>
 
 namespace IHMCMsgUtils {
 
@@ -32,15 +38,16 @@ namespace IHMCMsgUtils {
         // id of pelvis zup reference frame for data in a packet; default same as trajectory_reference_frame_id
         int data_reference_frame_id_pelviszup;
 
-        // name of refernce frame
+        // name of refernce frame; "world" and "pelvis" map to the frames above,
+        // IHMC frame name ids ("World:...") are hashed (see ihmc_frame_hash.h), and any other name falls back to world
         std::string cartesian_goal_reference_frame_name;
 
         // DEFAULT CONSTRUCTOR; sets all parameters to default values
         IHMCFrameParams() {
-            trajectory_reference_frame_id_world = 83766130; // world frame
-            data_reference_frame_id_world = 83766130; // 1 indicates same as trajectory_reference_frame_id, but we set explicitly
-            trajectory_reference_frame_id_pelviszup = -101; // pelvis zup
-            data_reference_frame_id_pelviszup = -101; // 1 indicates same as trajectory_reference_frame_id, but we set explicitly
+            trajectory_reference_frame_id_world = IHMC_WORLD_FRAME_ID; // world frame
+            data_reference_frame_id_world = IHMC_WORLD_FRAME_ID; // 1 indicates same as trajectory_reference_frame_id, but we set explicitly
+            trajectory_reference_frame_id_pelviszup = IHMC_PELVIS_ZUP_FRAME_ID; // pelvis zup
+            data_reference_frame_id_pelviszup = IHMC_PELVIS_ZUP_FRAME_ID; // 1 indicates same as trajectory_reference_frame_id, but we set explicitly
             cartesian_goal_reference_frame_name = std::string("world");
         }
     };
@@ -254,3 +261,5 @@ namespace IHMCMsgUtils {
     };
 
 } // end namespace IHMCMsgUtils
+
+#endif
@@ -12,18 +12,373 @@ namespace IHMCMsgUtils {
         return;
     }
 
+    // HELPER FUNCTIONS FOR BUILDING MESSAGES
+    // messages are built without sequence ids or stamps, so the message that contains them can stamp all of them at once;
+    // the public make functions build a message, then stamp it
+    namespace {
+        void buildIHMCFrameInformationMessage(controller_msgs::FrameInformation& frame_msg,
+                                              int trajectory_reference_frame_id,
+                                              int data_reference_frame_id,
+                                              IHMCMessageParameters msg_params) {
+            // set trajectory reference frame and data reference frame
+            frame_msg.trajectory_reference_frame_id = trajectory_reference_frame_id;
+            frame_msg.data_reference_frame_id = data_reference_frame_id;
+
+            return;
+        }
+
+        void buildIHMCQueueableMessage(controller_msgs::QueueableMessage& q_msg,
+                                       IHMCMessageParameters msg_params) {
+            // set execution mode
+            q_msg.execution_mode = msg_params.queueable_params.execution_mode;
+
+            // if queueing messages, set previous message id
+            if( msg_params.queueable_params.execution_mode == 1 ) {
+                q_msg.previous_message_id = msg_params.queueable_params.previous_message_id;
+            }
+
+            // if streaming messages, set integration duration
+            if( msg_params.queueable_params.execution_mode == 2 ) {
+                q_msg.stream_integration_duration = msg_params.queueable_params.stream_integration_duration;
+            }
+
+            return;
+        }
+
+        void buildIHMCSelectionMatrix3DMessage(controller_msgs::SelectionMatrix3DMessage& selmat_msg,
+                                               IHMCMessageParameters msg_params) {
+            // set selection frame id and axes to select
+            selmat_msg.selection_frame_id = msg_params.selection_matrix_params.selection_frame_id;
+            selmat_msg.x_selected = msg_params.selection_matrix_params.x_selected;
+            selmat_msg.y_selected = msg_params.selection_matrix_params.y_selected;
+            selmat_msg.z_selected = msg_params.selection_matrix_params.z_selected;
+
+            return;
+        }
+
+        void buildIHMCWeightMatrix3DMessage(controller_msgs::WeightMatrix3DMessage& wmat_msg,
+                                            IHMCMessageParameters msg_params) {
+            // set weight frame id and axis weights
+            wmat_msg.weight_frame_id = msg_params.weight_matrix_params.weight_frame_id;
+            wmat_msg.x_weight = msg_params.weight_matrix_params.x_weight;
+            wmat_msg.y_weight = msg_params.weight_matrix_params.y_weight;
+            wmat_msg.z_weight = msg_params.weight_matrix_params.z_weight;
+
+            return;
+        }
+
+        void buildIHMCTrajectoryPoint1DMessage(double q_joint,
+                                               controller_msgs::TrajectoryPoint1DMessage& point_msg,
+                                               IHMCMessageParameters msg_params) {
+            // set time
+            point_msg.time = msg_params.traj_point_params.time;
+
+            // set desired position based on input
+            point_msg.position = q_joint;
+
+            // set desired velocity to 0
+            point_msg.velocity = 0.0;
+
+            return;
+        }
+
+        void buildIHMCOneDoFJointTrajectoryMessage(double q_joint,
+                                                   controller_msgs::OneDoFJointTrajectoryMessage& j_msg,
+                                                   IHMCMessageParameters msg_params) {
+            // set weight
+            j_msg.weight = msg_params.onedof_joint_params.weight;
+
+            // clear vector of trajectory points
+            j_msg.trajectory_points.clear();
+
+            // construct TrajectoryPoint1DMessage
+            controller_msgs::TrajectoryPoint1DMessage point_msg;
+            buildIHMCTrajectoryPoint1DMessage(q_joint, point_msg, msg_params);
+
+            // add TrajectoryPoint1DMessage to vector
+            j_msg.trajectory_points.push_back(point_msg);
+
+            return;
+        }
+
+        void buildIHMCJointspaceTrajectoryMessage(dynacore::Vector q_joints,
+                                                  controller_msgs::JointspaceTrajectoryMessage& js_msg,
+                                                  IHMCMessageParameters msg_params) {
+            // construct and set queueing properties message
+            buildIHMCQueueableMessage(js_msg.queueing_properties, msg_params);
+
+            // clear vector of joint trajectory messages
+            js_msg.joint_trajectory_messages.clear();
+
+            // set trajectory for each joint
+            for( int i = 0 ; i < q_joints.size() ; i++ ) {
+                // construct OneDoFJointTrajectoryMessage for joint
+                controller_msgs::OneDoFJointTrajectoryMessage j_msg;
+                buildIHMCOneDoFJointTrajectoryMessage(q_joints[i], j_msg, msg_params);
+
+                // add OneDoFJointTrajectoryMessage to vector
+                js_msg.joint_trajectory_messages.push_back(j_msg);
+            }
+
+            return;
+        }
+
+        void buildIHMCJointspaceTrajectoryMessage(std::vector<double> q_joints_vector,
+                                                  controller_msgs::JointspaceTrajectoryMessage& js_msg,
+                                                  IHMCMessageParameters msg_params) {
+            // create dynacore::Vector for joints
+            dynacore::Vector q_joints;
+
+            // resize and clear vector
+            q_joints.resize(q_joints_vector.size());
+            q_joints.setZero();
+
+            // convert from std::vector to dynacore::Vector
+            for( int i = 0 ; i < q_joints_vector.size() ; i++ ) {
+                // set corresponding entry in dynacore::Vector
+                q_joints[i] = q_joints_vector[i];
+            }
+
+            // construct and set JointspaceTrajectoryMessage
+            buildIHMCJointspaceTrajectoryMessage(q_joints, js_msg, msg_params);
+
+            return;
+        }
+
+        void buildIHMCSE3TrajectoryPointMessage(dynacore::Vect3 pos, dynacore::Quaternion quat,
+                                                controller_msgs::SE3TrajectoryPointMessage& se3_point_msg,
+                                                IHMCMessageParameters msg_params) {
+            // set time
+            se3_point_msg.time = msg_params.traj_point_params.time;
+
+            // set position based on given position
+            ROSMsgUtils::makePointMessage(pos, se3_point_msg.position);
+
+            // set orientation based on given orientation
+            ROSMsgUtils::makeQuaternionMessage(quat, se3_point_msg.orientation);
+
+            // set linear and angular velocity to zero
+            ROSMsgUtils::makeZeroVector3Message(se3_point_msg.linear_velocity);
+            ROSMsgUtils::makeZeroVector3Message(se3_point_msg.angular_velocity);
+
+            return;
+        }
+
+        void buildIHMCSE3TrajectoryMessage(dynacore::Vect3 pos, dynacore::Quaternion quat,
+                                           controller_msgs::SE3TrajectoryMessage& se3_msg,
+                                           int trajectory_reference_frame_id,
+                                           int data_reference_frame_id,
+                                           IHMCMessageParameters msg_params) {
+            // set custom control frame flag
+            se3_msg.use_custom_control_frame = msg_params.se3so3_params.use_custom_control_frame;
+
+            // construct and set custom control frame pose (setting pose to all zeros)
+            ROSMsgUtils::makeZeroPoseMessage(se3_msg.control_frame_pose);
+
+            // construct and set queueing properties message
+            buildIHMCQueueableMessage(se3_msg.queueing_properties, msg_params);
+
+            // construct and set frame information
+            buildIHMCFrameInformationMessage(se3_msg.frame_information,
+                                            trajectory_reference_frame_id,
+                                            data_reference_frame_id,
+                                            msg_params);
+
+            // construct and set selection matrices
+            buildIHMCSelectionMatrix3DMessage(se3_msg.angular_selection_matrix, msg_params);
+            buildIHMCSelectionMatrix3DMessage(se3_msg.linear_selection_matrix, msg_params);
+
+            // construct and set weight matrices
+            buildIHMCWeightMatrix3DMessage(se3_msg.angular_weight_matrix, msg_params);
+            buildIHMCWeightMatrix3DMessage(se3_msg.linear_weight_matrix, msg_params);
+
+            // clear vector of trajectory points
+            se3_msg.taskspace_trajectory_points.clear();
+
+            // construct SE3TrajectoryPointMessage
+            controller_msgs::SE3TrajectoryPointMessage se3_point_msg;
+            buildIHMCSE3TrajectoryPointMessage(pos, quat, se3_point_msg, msg_params);
+
+            // add SE3TrajectoryPointMessage to vector
+            se3_msg.taskspace_trajectory_points.push_back(se3_point_msg);
+
+            return;
+        }
+
+        void buildIHMCSO3TrajectoryPointMessage(dynacore::Quaternion quat,
+                                                controller_msgs::SO3TrajectoryPointMessage& so3_point_msg,
+                                                IHMCMessageParameters msg_params) {
+            // set time
+            so3_point_msg.time = msg_params.traj_point_params.time;
+
+            // set quaternion based on given orientation
+            ROSMsgUtils::makeQuaternionMessage(quat, so3_point_msg.orientation);
+
+            // set angular velocity to zero
+            ROSMsgUtils::makeZeroVector3Message(so3_point_msg.angular_velocity);
+
+            return;
+        }
+
+        void buildIHMCSO3TrajectoryMessage(dynacore::Quaternion quat,
+                                           controller_msgs::SO3TrajectoryMessage& so3_msg,
+                                           int trajectory_reference_frame_id,
+                                           int data_reference_frame_id,
+                                           IHMCMessageParameters msg_params) {
+            // set custom control frame flag
+            so3_msg.use_custom_control_frame = msg_params.se3so3_params.use_custom_control_frame;
+
+            // construct and set custom control frame pose (setting pose to all zeros)
+            ROSMsgUtils::makeZeroPoseMessage(so3_msg.control_frame_pose);
+
+            // construct and set queueing properties message
+            buildIHMCQueueableMessage(so3_msg.queueing_properties, msg_params);
+
+            // construct and set frame information
+            buildIHMCFrameInformationMessage(so3_msg.frame_information,
+                                            trajectory_reference_frame_id,
+                                            data_reference_frame_id,
+                                            msg_params);
+
+            // construct and set selection matrix
+            buildIHMCSelectionMatrix3DMessage(so3_msg.selection_matrix, msg_params);
+
+            // construct and set weight matrix
+            buildIHMCWeightMatrix3DMessage(so3_msg.weight_matrix, msg_params);
+
+            // clear vector of trajectory points
+            so3_msg.taskspace_trajectory_points.clear();
+
+            // construct SO3TrajectoryPointMessage
+            controller_msgs::SO3TrajectoryPointMessage so3_point_msg;
+            buildIHMCSO3TrajectoryPointMessage(quat, so3_point_msg, msg_params);
+
+            // add SO3TrajectoryPointMessage to vector
+            so3_msg.taskspace_trajectory_points.push_back(so3_point_msg);
+
+            return;
+        }
+
+        void buildIHMCArmTrajectoryMessage(dynacore::Vector q_joints,
+                                           controller_msgs::ArmTrajectoryMessage& arm_msg,
+                                           int robot_side,
+                                           IHMCMessageParameters msg_params) {
+            // set robot side and force execution
+            arm_msg.robot_side = robot_side;
+            arm_msg.force_execution = msg_params.arm_params.force_execution;
+
+            // construct and set JointspaceTrajectoryMessage for arm
+            buildIHMCJointspaceTrajectoryMessage(q_joints, arm_msg.jointspace_trajectory, msg_params);
+
+            return;
+        }
+
+        void buildIHMCChestTrajectoryMessage(dynacore::Quaternion quat,
+                                             controller_msgs::ChestTrajectoryMessage& chest_msg,
+                                             IHMCMessageParameters msg_params) {
+            // construct and set SO3TrajectoryMessage for chest
+            buildIHMCSO3TrajectoryMessage(quat,
+                                         chest_msg.so3_trajectory,
+                                         msg_params.frame_params.trajectory_reference_frame_id_pelviszup,
+                                         msg_params.frame_params.data_reference_frame_id_world,
+                                         msg_params);
+
+            return;
+        }
+
+        void buildIHMCFootTrajectoryMessage(dynacore::Vect3 pos,
+                                            dynacore::Quaternion quat,
+                                            controller_msgs::FootTrajectoryMessage& foot_msg,
+                                            int robot_side,
+                                            IHMCMessageParameters msg_params) {
+            // set robot side
+            foot_msg.robot_side = robot_side;
+
+            // construct and set SE3TrajectoryMessage for foot
+            buildIHMCSE3TrajectoryMessage(pos, quat,
+                                         foot_msg.se3_trajectory,
+                                         msg_params.frame_params.trajectory_reference_frame_id_world,
+                                         msg_params.frame_params.data_reference_frame_id_world,
+                                         msg_params);
+
+            return;
+        }
+
+        void buildIHMCHandTrajectoryMessage(dynacore::Vect3 pos,
+                                            dynacore::Quaternion quat,
+                                            controller_msgs::HandTrajectoryMessage& hand_msg,
+                                            int robot_side,
+                                            IHMCMessageParameters msg_params) {
+            // set robot side
+            hand_msg.robot_side = robot_side;
+
+            // set frame information based on reference frame
+            int trajectory_reference_frame;
+            int data_reference_frame;
+            getReferenceFrameIds(msg_params.frame_params.cartesian_goal_reference_frame_name,
+                                 trajectory_reference_frame, data_reference_frame,
+                                 msg_params);
+
+            // construct and set SE3TrajectoryMessage for hand
+            buildIHMCSE3TrajectoryMessage(pos, quat,
+                                         hand_msg.se3_trajectory,
+                                         trajectory_reference_frame,
+                                         data_reference_frame,
+                                         msg_params);
+
+            return;
+        }
+
+        void buildIHMCNeckTrajectoryMessage(dynacore::Vector q_joints,
+                                            controller_msgs::NeckTrajectoryMessage& neck_msg,
+                                            IHMCMessageParameters msg_params) {
+            // construct and set JointspaceTrajectoryMessage for neck
+            buildIHMCJointspaceTrajectoryMessage(q_joints, neck_msg.jointspace_trajectory, msg_params);
+
+            return;
+        }
+
+        void buildIHMCPelvisTrajectoryMessage(dynacore::Vector q_joints,
+                                              controller_msgs::PelvisTrajectoryMessage& pelvis_msg,
+                                              IHMCMessageParameters msg_params) {
+            // set force execution, user mode, user mode during walking
+            pelvis_msg.force_execution = msg_params.pelvis_params.force_execution;
+            pelvis_msg.enable_user_pelvis_control = msg_params.pelvis_params.enable_user_pelvis_control;
+            pelvis_msg.enable_user_pelvis_control_during_walking = msg_params.pelvis_params.enable_user_pelvis_control_during_walking;
+
+            // get pose from given configuration
+            dynacore::Vect3 pelvis_pos;
+            dynacore::Quaternion pelvis_quat;
+            getPelvisPose(q_joints, pelvis_pos, pelvis_quat);
+
+            // construct and set SE3TrajectoryMessage for pelvis
+            buildIHMCSE3TrajectoryMessage(pelvis_pos, pelvis_quat,
+                                         pelvis_msg.se3_trajectory,
+                                         msg_params.frame_params.trajectory_reference_frame_id_world,
+                                         msg_params.frame_params.data_reference_frame_id_world,
+                                         msg_params);
+
+            return;
+        }
+
+        void buildIHMCSpineTrajectoryMessage(dynacore::Vector q_joints,
+                                             controller_msgs::SpineTrajectoryMessage& spine_msg,
+                                             IHMCMessageParameters msg_params) {
+            // construct and set JointspaceTrajectoryMessage for spine
+            buildIHMCJointspaceTrajectoryMessage(q_joints, spine_msg.jointspace_trajectory, msg_params);
+
+            return;
+        }
+    } // end anonymous namespace
+
     // FUNCTIONS FOR MAKING IHMC MESSAGES
     void makeIHMCArmTrajectoryMessage(dynacore::Vector q_joints,
                                       controller_msgs::ArmTrajectoryMessage& arm_msg,
                                       int robot_side,
                                       IHMCMessageParameters msg_params) {
-        // set sequence id, robot side, and force execution
-        arm_msg.sequence_id = msg_params.sequence_id;
-        arm_msg.robot_side = robot_side;
-        arm_msg.force_execution = msg_params.arm_params.force_execution;
-
-        // construct and set JointspaceTrajectoryMessage for arm
-        makeIHMCJointspaceTrajectoryMessage(q_joints, arm_msg.jointspace_trajectory, msg_params);
+        // build message, then set sequence ids and stamps in one pass
+        buildIHMCArmTrajectoryMessage(q_joints, arm_msg, robot_side, msg_params);
+        stampIHMCMessage(arm_msg, msg_params);
 
         return;
     }
@@ -31,15 +386,9 @@ namespace IHMCMsgUtils {
     void makeIHMCChestTrajectoryMessage(dynacore::Quaternion quat,
                                         controller_msgs::ChestTrajectoryMessage& chest_msg,
                                         IHMCMessageParameters msg_params) {
-        // set sequence id
-        chest_msg.sequence_id = msg_params.sequence_id;
-
-        // construct and set SO3TrajectoryMessage for chest
-        makeIHMCSO3TrajectoryMessage(quat,
-                                     chest_msg.so3_trajectory,
-                                     msg_params.frame_params.trajectory_reference_frame_id_pelviszup,
-                                     msg_params.frame_params.data_reference_frame_id_world,
-                                     msg_params);
+        // build message, then set sequence ids and stamps in one pass
+        buildIHMCChestTrajectoryMessage(quat, chest_msg, msg_params);
+        stampIHMCMessage(chest_msg, msg_params);
 
         return;
     }
@@ -49,16 +398,9 @@ namespace IHMCMsgUtils {
                                        controller_msgs::FootTrajectoryMessage& foot_msg,
                                        int robot_side,
                                        IHMCMessageParameters msg_params) {
-        // set sequence id and robot side
-        foot_msg.sequence_id = msg_params.sequence_id;
-        foot_msg.robot_side = robot_side;
-
-        // construct and set SE3TrajectoryMessage for foot
-        makeIHMCSE3TrajectoryMessage(pos, quat,
-                                     foot_msg.se3_trajectory,
-                                     msg_params.frame_params.trajectory_reference_frame_id_world,
-                                     msg_params.frame_params.data_reference_frame_id_world,
-                                     msg_params);
+        // build message, then set sequence ids and stamps in one pass
+        buildIHMCFootTrajectoryMessage(pos, quat, foot_msg, robot_side, msg_params);
+        stampIHMCMessage(foot_msg, msg_params);
 
         return;
     }
@@ -67,10 +409,9 @@ namespace IHMCMsgUtils {
                                          int trajectory_reference_frame_id,
                                          int data_reference_frame_id,
                                          IHMCMessageParameters msg_params) {
-        // set sequence id, trajectory reference frame, and data reference frame
-        frame_msg.sequence_id = msg_params.sequence_id;
-        frame_msg.trajectory_reference_frame_id = trajectory_reference_frame_id;
-        frame_msg.data_reference_frame_id = data_reference_frame_id;
+        // build message, then set sequence ids and stamps in one pass
+        buildIHMCFrameInformationMessage(frame_msg, trajectory_reference_frame_id, data_reference_frame_id, msg_params);
+        stampIHMCMessage(frame_msg, msg_params);
 
         return;
     }
@@ -80,30 +421,9 @@ namespace IHMCMsgUtils {
                                        controller_msgs::HandTrajectoryMessage& hand_msg,
                                        int robot_side,
                                        IHMCMessageParameters msg_params) {
-        // set sequence id and robot side
-        hand_msg.sequence_id = msg_params.sequence_id;
-        hand_msg.robot_side = robot_side;
-
-        // set frame information based on reference frame
-        int trajectory_reference_frame;
-        int data_reference_frame;
-        if( msg_params.frame_params.cartesian_goal_reference_frame_name == std::string("pelvis") ) {
-            // pelvis frame
-            trajectory_reference_frame = msg_params.frame_params.trajectory_reference_frame_id_pelviszup;
-            data_reference_frame = msg_params.frame_params.data_reference_frame_id_pelviszup;
-        }
-        else {
-            // world frame
-            trajectory_reference_frame = msg_params.frame_params.trajectory_reference_frame_id_world;
-            data_reference_frame = msg_params.frame_params.data_reference_frame_id_world;
-        }
-
-        // construct and set SE3TrajectoryMessage for hand
-        makeIHMCSE3TrajectoryMessage(pos, quat,
-                                     hand_msg.se3_trajectory,
-                                     trajectory_reference_frame,
-                                     data_reference_frame,
-                                     msg_params);
+        // build message, then set sequence ids and stamps in one pass
+        buildIHMCHandTrajectoryMessage(pos, quat, hand_msg, robot_side, msg_params);
+        stampIHMCMessage(hand_msg, msg_params);
 
         return;
     }
@@ -111,24 +431,9 @@ namespace IHMCMsgUtils {
     void makeIHMCJointspaceTrajectoryMessage(dynacore::Vector q_joints,
                                              controller_msgs::JointspaceTrajectoryMessage& js_msg,
                                              IHMCMessageParameters msg_params) {
-        // set sequence id
-        js_msg.sequence_id = msg_params.sequence_id;
-
-        // construct and set queueing properties message
-        makeIHMCQueueableMessage(js_msg.queueing_properties, msg_params);
-
-        // clear vector of joint trajectory messages
-        js_msg.joint_trajectory_messages.clear();
-
-        // set trajectory for each joint
-        for( int i = 0 ; i < q_joints.size() ; i++ ) {
-            // construct OneDoFJointTrajectoryMessage for joint
-            controller_msgs::OneDoFJointTrajectoryMessage j_msg;
-            makeIHMCOneDoFJointTrajectoryMessage(q_joints[i], j_msg, msg_params);
-
-            // add OneDoFJointTrajectoryMessage to vector
-            js_msg.joint_trajectory_messages.push_back(j_msg);
-        }
+        // build message, then set sequence ids and stamps in one pass
+        buildIHMCJointspaceTrajectoryMessage(q_joints, js_msg, msg_params);
+        stampIHMCMessage(js_msg, msg_params);
 
         return;
     }
@@ -136,21 +441,9 @@ namespace IHMCMsgUtils {
     void makeIHMCJointspaceTrajectoryMessage(std::vector<double> q_joints_vector,
                                              controller_msgs::JointspaceTrajectoryMessage& js_msg,
                                              IHMCMessageParameters msg_params) {
-        // create dynacore::Vector for joints
-        dynacore::Vector q_joints;
-
-        // resize and clear vector
-        q_joints.resize(q_joints_vector.size());
-        q_joints.setZero();
-
-        // convert from std::vector to dynacore::Vector
-        for( int i = 0 ; i < q_joints_vector.size() ; i++ ) {
-            // set corresponding entry in dynacore::Vector
-            q_joints[i] = q_joints_vector[i];
-        }
-
-        // construct and set JointspaceTrajectoryMessage
-        makeIHMCJointspaceTrajectoryMessage(q_joints, js_msg, msg_params);
+        // build message, then set sequence ids and stamps in one pass
+        buildIHMCJointspaceTrajectoryMessage(q_joints_vector, js_msg, msg_params);
+        stampIHMCMessage(js_msg, msg_params);
 
         return;
     }
@@ -158,11 +451,9 @@ namespace IHMCMsgUtils {
     void makeIHMCNeckTrajectoryMessage(dynacore::Vector q_joints,
                                        controller_msgs::NeckTrajectoryMessage& neck_msg,
                                        IHMCMessageParameters msg_params) {
-        // set sequence id
-        neck_msg.sequence_id = msg_params.sequence_id;
-
-        // construct and set JointspaceTrajectoryMessage for neck
-        makeIHMCJointspaceTrajectoryMessage(q_joints, neck_msg.jointspace_trajectory, msg_params);
+        // build message, then set sequence ids and stamps in one pass
+        buildIHMCNeckTrajectoryMessage(q_joints, neck_msg, msg_params);
+        stampIHMCMessage(neck_msg, msg_params);
 
         return;
     }
@@ -170,19 +461,9 @@ namespace IHMCMsgUtils {
     void makeIHMCOneDoFJointTrajectoryMessage(double q_joint,
                                               controller_msgs::OneDoFJointTrajectoryMessage& j_msg,
                                               IHMCMessageParameters msg_params) {
-        // set sequence id and weight
-        j_msg.sequence_id = msg_params.sequence_id;
-        j_msg.weight = msg_params.onedof_joint_params.weight;
-
-        // clear vector of trajectory points
-        j_msg.trajectory_points.clear();
-
-        // construct TrajectoryPoint1DMessage
-        controller_msgs::TrajectoryPoint1DMessage point_msg;
-        makeIHMCTrajectoryPoint1DMessage(q_joint, point_msg, msg_params);
-
-        // add TrajectoryPoint1DMessage to vector
-        j_msg.trajectory_points.push_back(point_msg);
+        // build message, then set sequence ids and stamps in one pass
+        buildIHMCOneDoFJointTrajectoryMessage(q_joint, j_msg, msg_params);
+        stampIHMCMessage(j_msg, msg_params);
 
         return;
     }
@@ -190,48 +471,18 @@ namespace IHMCMsgUtils {
     void makeIHMCPelvisTrajectoryMessage(dynacore::Vector q_joints,
                                          controller_msgs::PelvisTrajectoryMessage& pelvis_msg,
                                          IHMCMessageParameters msg_params) {
-        // set sequence id, force execution, user mode, user mode during walking
-        pelvis_msg.sequence_id = msg_params.sequence_id;
-        pelvis_msg.force_execution = msg_params.pelvis_params.force_execution;
-        pelvis_msg.enable_user_pelvis_control = msg_params.pelvis_params.enable_user_pelvis_control;
-        pelvis_msg.enable_user_pelvis_control_during_walking = msg_params.pelvis_params.enable_user_pelvis_control_during_walking;
-
-        // get pose from given configuration
-        dynacore::Vect3 pelvis_pos;
-        dynacore::Quaternion pelvis_quat;
-        getPelvisPose(q_joints, pelvis_pos, pelvis_quat);
-
-        // construct and set SE3TrajectoryMessage for pelvis
-        makeIHMCSE3TrajectoryMessage(pelvis_pos, pelvis_quat,
-                                     pelvis_msg.se3_trajectory,
-                                     msg_params.frame_params.trajectory_reference_frame_id_world,
-                                     msg_params.frame_params.data_reference_frame_id_world,
-                                     msg_params);
+        // build message, then set sequence ids and stamps in one pass
+        buildIHMCPelvisTrajectoryMessage(q_joints, pelvis_msg, msg_params);
+        stampIHMCMessage(pelvis_msg, msg_params);
 
         return;
     }
 
     void makeIHMCQueueableMessage(controller_msgs::QueueableMessage& q_msg,
                                   IHMCMessageParameters msg_params) {
-        // set sequence id, execution mode, and message id
-        q_msg.sequence_id = msg_params.sequence_id;
-        q_msg.execution_mode = msg_params.queueable_params.execution_mode;
-        q_msg.message_id = msg_params.queueable_params.message_id;
-
-        // if queueing messages, set previous message id
-        if( msg_params.queueable_params.execution_mode == 1 ) {
-            q_msg.previous_message_id = msg_params.queueable_params.previous_message_id;
-        }
-
-        // if streaming messages, set integration duration
-        if( msg_params.queueable_params.execution_mode == 2 ) {
-            q_msg.stream_integration_duration = msg_params.queueable_params.stream_integration_duration;
-        }
-
-        // get current time for timestamp
-        auto t = std::chrono::system_clock::now();
-        // set timestamp in nanoseconds when the message was created
-        q_msg.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+        // build message, then set sequence ids and stamps in one pass
+        buildIHMCQueueableMessage(q_msg, msg_params);
+        stampIHMCMessage(q_msg, msg_params);
 
         return;
     }
@@ -241,39 +492,9 @@ namespace IHMCMsgUtils {
                                       int trajectory_reference_frame_id,
                                       int data_reference_frame_id,
                                       IHMCMessageParameters msg_params) {
-        // set sequence id and custom control frame flag
-        se3_msg.sequence_id = msg_params.sequence_id;
-        se3_msg.use_custom_control_frame = msg_params.se3so3_params.use_custom_control_frame;
-
-        // construct and set custom control frame pose (setting pose to all zeros)
-        ROSMsgUtils::makeZeroPoseMessage(se3_msg.control_frame_pose);
-
-        // construct and set queueing properties message
-        makeIHMCQueueableMessage(se3_msg.queueing_properties, msg_params);
-
-        // construct and set frame information
-        makeIHMCFrameInformationMessage(se3_msg.frame_information,
-                                        trajectory_reference_frame_id,
-                                        data_reference_frame_id,
-                                        msg_params);
-
-        // construct and set selection matrices
-        makeIHMCSelectionMatrix3DMessage(se3_msg.angular_selection_matrix, msg_params);
-        makeIHMCSelectionMatrix3DMessage(se3_msg.linear_selection_matrix, msg_params);
-
-        // construct and set weight matrices
-        makeIHMCWeightMatrix3DMessage(se3_msg.angular_weight_matrix, msg_params);
-        makeIHMCWeightMatrix3DMessage(se3_msg.linear_weight_matrix, msg_params);
-
-        // clear vector of trajectory points
-        se3_msg.taskspace_trajectory_points.clear();
-
-        // construct SE3TrajectoryPointMessage
-        controller_msgs::SE3TrajectoryPointMessage se3_point_msg;
-        makeIHMCSE3TrajectoryPointMessage(pos, quat, se3_point_msg, msg_params);
-
-        // add SE3TrajectoryPointMessage to vector
-        se3_msg.taskspace_trajectory_points.push_back(se3_point_msg);
+        // build message, then set sequence ids and stamps in one pass
+        buildIHMCSE3TrajectoryMessage(pos, quat, se3_msg, trajectory_reference_frame_id, data_reference_frame_id, msg_params);
+        stampIHMCMessage(se3_msg, msg_params);
 
         return;
     }
@@ -281,31 +502,18 @@ namespace IHMCMsgUtils {
     void makeIHMCSE3TrajectoryPointMessage(dynacore::Vect3 pos, dynacore::Quaternion quat,
                                            controller_msgs::SE3TrajectoryPointMessage& se3_point_msg,
                                            IHMCMessageParameters msg_params) {
-        // set sequence id and time
-        se3_point_msg.sequence_id = msg_params.sequence_id;
-        se3_point_msg.time = msg_params.traj_point_params.time;
-
-        // set position based on given position
-        ROSMsgUtils::makePointMessage(pos, se3_point_msg.position);
-
-        // set orientation based on given orientation
-        ROSMsgUtils::makeQuaternionMessage(quat, se3_point_msg.orientation);
-
-        // set linear and angular velocity to zero
-        ROSMsgUtils::makeZeroVector3Message(se3_point_msg.linear_velocity);
-        ROSMsgUtils::makeZeroVector3Message(se3_point_msg.angular_velocity);
+        // build message, then set sequence ids and stamps in one pass
+        buildIHMCSE3TrajectoryPointMessage(pos, quat, se3_point_msg, msg_params);
+        stampIHMCMessage(se3_point_msg, msg_params);
 
         return;
     }
 
     void makeIHMCSelectionMatrix3DMessage(controller_msgs::SelectionMatrix3DMessage& selmat_msg,
                                           IHMCMessageParameters msg_params) {
-        // set sequence id, selection frame id, and axes to select
-        selmat_msg.sequence_id = msg_params.sequence_id;
-        selmat_msg.selection_frame_id = msg_params.selection_matrix_params.selection_frame_id;
-        selmat_msg.x_selected = msg_params.selection_matrix_params.x_selected;
-        selmat_msg.y_selected = msg_params.selection_matrix_params.y_selected;
-        selmat_msg.z_selected = msg_params.selection_matrix_params.z_selected;
+        // build message, then set sequence ids and stamps in one pass
+        buildIHMCSelectionMatrix3DMessage(selmat_msg, msg_params);
+        stampIHMCMessage(selmat_msg, msg_params);
 
         return;
     }
@@ -315,37 +523,9 @@ namespace IHMCMsgUtils {
                                       int trajectory_reference_frame_id,
                                       int data_reference_frame_id,
                                       IHMCMessageParameters msg_params) {
-        // set sequence id and custom control frame flag
-        so3_msg.sequence_id = msg_params.sequence_id;
-        so3_msg.use_custom_control_frame = msg_params.se3so3_params.use_custom_control_frame;
-
-        // construct and set custom control frame pose (setting pose to all zeros)
-        ROSMsgUtils::makeZeroPoseMessage(so3_msg.control_frame_pose);
-
-        // construct and set queueing properties message
-        makeIHMCQueueableMessage(so3_msg.queueing_properties, msg_params);
-
-        // construct and set frame information
-        makeIHMCFrameInformationMessage(so3_msg.frame_information,
-                                        trajectory_reference_frame_id,
-                                        data_reference_frame_id,
-                                        msg_params);
-
-        // construct and set selection matrix
-        makeIHMCSelectionMatrix3DMessage(so3_msg.selection_matrix, msg_params);
-
-        // construct and set weight matrix
-        makeIHMCWeightMatrix3DMessage(so3_msg.weight_matrix, msg_params);
-
-        // clear vector of trajectory points
-        so3_msg.taskspace_trajectory_points.clear();
-
-        // construct SO3TrajectoryPointMessage
-        controller_msgs::SO3TrajectoryPointMessage so3_point_msg;
-        makeIHMCSO3TrajectoryPointMessage(quat, so3_point_msg, msg_params);
-
-        // add SO3TrajectoryPointMessage to vector
-        so3_msg.taskspace_trajectory_points.push_back(so3_point_msg);
+        // build message, then set sequence ids and stamps in one pass
+        buildIHMCSO3TrajectoryMessage(quat, so3_msg, trajectory_reference_frame_id, data_reference_frame_id, msg_params);
+        stampIHMCMessage(so3_msg, msg_params);
 
         return;
     }
@@ -353,15 +533,9 @@ namespace IHMCMsgUtils {
     void makeIHMCSO3TrajectoryPointMessage(dynacore::Quaternion quat,
                                            controller_msgs::SO3TrajectoryPointMessage& so3_point_msg,
                                            IHMCMessageParameters msg_params) {
-        // set sequence id and time
-        so3_point_msg.sequence_id = msg_params.sequence_id;
-        so3_point_msg.time = msg_params.traj_point_params.time;
-
-        // set quaternion based on given orientation
-        ROSMsgUtils::makeQuaternionMessage(quat, so3_point_msg.orientation);
-
-        // set angular velocity to zero
-        ROSMsgUtils::makeZeroVector3Message(so3_point_msg.angular_velocity);
+        // build message, then set sequence ids and stamps in one pass
+        buildIHMCSO3TrajectoryPointMessage(quat, so3_point_msg, msg_params);
+        stampIHMCMessage(so3_point_msg, msg_params);
 
         return;
     }
@@ -369,11 +543,9 @@ namespace IHMCMsgUtils {
     void makeIHMCSpineTrajectoryMessage(dynacore::Vector q_joints,
                                         controller_msgs::SpineTrajectoryMessage& spine_msg,
                                         IHMCMessageParameters msg_params) {
-        // set sequence id
-        spine_msg.sequence_id = msg_params.sequence_id;
-
-        // construct and set JointspaceTrajectoryMessage for spine
-        makeIHMCJointspaceTrajectoryMessage(q_joints, spine_msg.jointspace_trajectory, msg_params);
+        // build message, then set sequence ids and stamps in one pass
+        buildIHMCSpineTrajectoryMessage(q_joints, spine_msg, msg_params);
+        stampIHMCMessage(spine_msg, msg_params);
 
         return;
     }
@@ -381,27 +553,18 @@ namespace IHMCMsgUtils {
     void makeIHMCTrajectoryPoint1DMessage(double q_joint,
                                           controller_msgs::TrajectoryPoint1DMessage& point_msg,
                                           IHMCMessageParameters msg_params) {
-        // set sequence id and time
-        point_msg.sequence_id = msg_params.sequence_id;
-        point_msg.time = msg_params.traj_point_params.time;
-
-        // set desired position based on input
-        point_msg.position = q_joint;
-
-        // set desired velocity to 0
-        point_msg.velocity = 0.0;
+        // build message, then set sequence ids and stamps in one pass
+        buildIHMCTrajectoryPoint1DMessage(q_joint, point_msg, msg_params);
+        stampIHMCMessage(point_msg, msg_params);
 
         return;
     }
 
     void makeIHMCWeightMatrix3DMessage(controller_msgs::WeightMatrix3DMessage& wmat_msg,
                                        IHMCMessageParameters msg_params) {
-        // set sequence id, weight frame id, and axis weights
-        wmat_msg.sequence_id = msg_params.sequence_id;
-        wmat_msg.weight_frame_id = msg_params.weight_matrix_params.weight_frame_id;
-        wmat_msg.x_weight = msg_params.weight_matrix_params.x_weight;
-        wmat_msg.y_weight = msg_params.weight_matrix_params.y_weight;
-        wmat_msg.z_weight = msg_params.weight_matrix_params.z_weight;
+        // build message, then set sequence ids and stamps in one pass
+        buildIHMCWeightMatrix3DMessage(wmat_msg, msg_params);
+        stampIHMCMessage(wmat_msg, msg_params);
 
         return;
     }
@@ -409,8 +572,9 @@ namespace IHMCMsgUtils {
     void makeIHMCWholeBodyTrajectoryMessage(dynacore::Vector q,
                                             controller_msgs::WholeBodyTrajectoryMessage& wholebody_msg,
                                             IHMCMessageParameters msg_params) {
-        // set sequence id
+        // set sequence id; built body part messages are stamped with one stamper, so they share one creation timestamp
         wholebody_msg.sequence_id = msg_params.sequence_id;
+        IHMCMessageStamper stamper = makeIHMCMessageStamper(msg_params);
 
         // check what links given configuration is controlling
         // we will not set whole-body message information for not controlled links
@@ -438,9 +602,10 @@ namespace IHMCMsgUtils {
             dynacore::Vector q_larm;
             selectRelevantJointsConfiguration(q, larm_joint_indices, q_larm);
             // construct and set arm message for left arm
-            makeIHMCArmTrajectoryMessage(q_larm,
-                                         wholebody_msg.left_arm_trajectory_message,
-                                         0, msg_params);
+            buildIHMCArmTrajectoryMessage(q_larm,
+                                          wholebody_msg.left_arm_trajectory_message,
+                                          0, msg_params);
+            visitFields(stamper, wholebody_msg.left_arm_trajectory_message);
         }
 
         if( control_rarm ) {
@@ -451,9 +616,10 @@ namespace IHMCMsgUtils {
             dynacore::Vector q_rarm;
             selectRelevantJointsConfiguration(q, rarm_joint_indices, q_rarm);
             // construct and set arm message for right arm
-            makeIHMCArmTrajectoryMessage(q_rarm,
-                                         wholebody_msg.right_arm_trajectory_message,
-                                         1, msg_params);
+            buildIHMCArmTrajectoryMessage(q_rarm,
+                                          wholebody_msg.right_arm_trajectory_message,
+                                          1, msg_params);
+            visitFields(stamper, wholebody_msg.right_arm_trajectory_message);
         }
 
         // CHEST TRAJECTORY
@@ -462,7 +628,8 @@ namespace IHMCMsgUtils {
             dynacore::Quaternion chest_quat;
             getChestOrientation(q, chest_quat);
             // construct and set chest message
-            makeIHMCChestTrajectoryMessage(chest_quat, wholebody_msg.chest_trajectory_message, msg_params);
+            buildIHMCChestTrajectoryMessage(chest_quat, wholebody_msg.chest_trajectory_message, msg_params);
+            visitFields(stamper, wholebody_msg.chest_trajectory_message);
         }
 
         // SPINE TRAJECTORY
@@ -493,7 +660,8 @@ namespace IHMCMsgUtils {
             dynacore::Vector q_pelvis;
             selectRelevantJointsConfiguration(q, pelvis_joint_indices, q_pelvis);
             // construct and set pelvis message
-            makeIHMCPelvisTrajectoryMessage(q_pelvis, wholebody_msg.pelvis_trajectory_message, msg_params);
+            buildIHMCPelvisTrajectoryMessage(q_pelvis, wholebody_msg.pelvis_trajectory_message, msg_params);
+            visitFields(stamper, wholebody_msg.pelvis_trajectory_message);
         }
 
         // FOOT TRAJECTORIES
@@ -535,7 +703,8 @@ namespace IHMCMsgUtils {
             dynacore::Vector q_neck;
             selectRelevantJointsConfiguration(q, neck_joint_indices, q_neck);
             // construct and set neck message
-            makeIHMCNeckTrajectoryMessage(q_neck, wholebody_msg.neck_trajectory_message, msg_params);
+            buildIHMCNeckTrajectoryMessage(q_neck, wholebody_msg.neck_trajectory_message, msg_params);
+            visitFields(stamper, wholebody_msg.neck_trajectory_message);
         }
 
         // HEAD TRAJECTORY
@@ -548,9 +717,10 @@ namespace IHMCMsgUtils {
                                             dynacore::Vect3 left_hand_pos, dynacore::Quaternion left_hand_quat,
                                             dynacore::Vect3 right_hand_pos, dynacore::Quaternion right_hand_quat,
                                             controller_msgs::WholeBodyTrajectoryMessage& wholebody_msg,
-                                            IHMCMessageParameters msg_params, tf::Transform tf_hand_goal_frame_wrt_world) {
-        // set sequence id
+                                            IHMCMessageParameters msg_params) {
+        // set sequence id; built body part messages are stamped with one stamper, so they share one creation timestamp
         wholebody_msg.sequence_id = msg_params.sequence_id;
+        IHMCMessageStamper stamper = makeIHMCMessageStamper(msg_params);
 
         // check what links given configuration is controlling
         // we will not set whole-body message information for not controlled links
@@ -574,22 +744,22 @@ namespace IHMCMsgUtils {
             dynacore::Vect3 offset_right_hand_pos(right_hand_pos);
             dynacore::Quaternion offset_right_hand_quat(right_hand_quat);
             applyHandOffset(offset_left_hand_pos, offset_left_hand_quat,
-                            offset_right_hand_pos, offset_right_hand_quat,
-                            msg_params.frame_params.cartesian_goal_reference_frame_name,
-                            tf_hand_goal_frame_wrt_world);
+                            offset_right_hand_pos, offset_right_hand_quat);
 
             if( control_larm ) {
                 // construct and set hand message for left hand
-                makeIHMCHandTrajectoryMessage(offset_left_hand_pos, offset_left_hand_quat,
-                                              wholebody_msg.left_hand_trajectory_message,
-                                              0, msg_params);
+                buildIHMCHandTrajectoryMessage(offset_left_hand_pos, offset_left_hand_quat,
+                                               wholebody_msg.left_hand_trajectory_message,
+                                               0, msg_params);
+                visitFields(stamper, wholebody_msg.left_hand_trajectory_message);
             }
 
             if( control_rarm ) {
                 // construct and set hand message for right hand
-                makeIHMCHandTrajectoryMessage(offset_right_hand_pos, offset_right_hand_quat,
-                                              wholebody_msg.right_hand_trajectory_message,
-                                              1, msg_params);
+                buildIHMCHandTrajectoryMessage(offset_right_hand_pos, offset_right_hand_quat,
+                                               wholebody_msg.right_hand_trajectory_message,
+                                               1, msg_params);
+                visitFields(stamper, wholebody_msg.right_hand_trajectory_message);
             }
         }
         else { // jointspace goals for arms
@@ -602,9 +772,10 @@ namespace IHMCMsgUtils {
                 dynacore::Vector q_larm;
                 selectRelevantJointsConfiguration(q, larm_joint_indices, q_larm);
                 // construct and set arm message for left arm
-                makeIHMCArmTrajectoryMessage(q_larm,
-                                             wholebody_msg.left_arm_trajectory_message,
-                                             0, msg_params);
+                buildIHMCArmTrajectoryMessage(q_larm,
+                                              wholebody_msg.left_arm_trajectory_message,
+                                              0, msg_params);
+                visitFields(stamper, wholebody_msg.left_arm_trajectory_message);
             }
 
             if( control_rarm ) {
@@ -615,9 +786,10 @@ namespace IHMCMsgUtils {
                 dynacore::Vector q_rarm;
                 selectRelevantJointsConfiguration(q, rarm_joint_indices, q_rarm);
                 // construct and set arm message for right arm
-                makeIHMCArmTrajectoryMessage(q_rarm,
-                                             wholebody_msg.right_arm_trajectory_message,
-                                             1, msg_params);
+                buildIHMCArmTrajectoryMessage(q_rarm,
+                                              wholebody_msg.right_arm_trajectory_message,
+                                              1, msg_params);
+                visitFields(stamper, wholebody_msg.right_arm_trajectory_message);
             }
         }
 
@@ -627,7 +799,8 @@ namespace IHMCMsgUtils {
             dynacore::Quaternion chest_quat;
             getChestOrientation(q, chest_quat);
             // construct and set chest message
-            makeIHMCChestTrajectoryMessage(chest_quat, wholebody_msg.chest_trajectory_message, msg_params);
+            buildIHMCChestTrajectoryMessage(chest_quat, wholebody_msg.chest_trajectory_message, msg_params);
+            visitFields(stamper, wholebody_msg.chest_trajectory_message);
         }
 
         // SPINE TRAJECTORY
@@ -658,7 +831,8 @@ namespace IHMCMsgUtils {
             dynacore::Vector q_pelvis;
             selectRelevantJointsConfiguration(q, pelvis_joint_indices, q_pelvis);
             // construct and set pelvis message
-            makeIHMCPelvisTrajectoryMessage(q_pelvis, wholebody_msg.pelvis_trajectory_message, msg_params);
+            buildIHMCPelvisTrajectoryMessage(q_pelvis, wholebody_msg.pelvis_trajectory_message, msg_params);
+            visitFields(stamper, wholebody_msg.pelvis_trajectory_message);
         }
 
         // FOOT TRAJECTORIES
@@ -700,7 +874,8 @@ namespace IHMCMsgUtils {
             dynacore::Vector q_neck;
             selectRelevantJointsConfiguration(q, neck_joint_indices, q_neck);
             // construct and set neck message
-            makeIHMCNeckTrajectoryMessage(q_neck, wholebody_msg.neck_trajectory_message, msg_params);
+            buildIHMCNeckTrajectoryMessage(q_neck, wholebody_msg.neck_trajectory_message, msg_params);
+            visitFields(stamper, wholebody_msg.neck_trajectory_message);
         }
 
         // HEAD TRAJECTORY
@@ -792,8 +967,7 @@ namespace IHMCMsgUtils {
                                                      std::vector<double> finger_positions,
                                                      IHMCMessageParameters msg_params)
     {
-        // set sequence id and robot side
-        finger_msg.sequence_id = msg_params.sequence_id;
+        // set robot side
         finger_msg.robot_side = robot_side;
 
         // set motor names
@@ -802,11 +976,33 @@ namespace IHMCMsgUtils {
         }
 
         // construct and set JointspaceTrajectoryMessage for hand
-        makeIHMCJointspaceTrajectoryMessage(finger_positions, finger_msg.jointspace_trajectory, msg_params);
+        buildIHMCJointspaceTrajectoryMessage(finger_positions, finger_msg.jointspace_trajectory, msg_params);
+
+        // set sequence ids and stamps of finger message and its jointspace trajectory
+        stampIHMCMessage(finger_msg, msg_params);
+
+        return;
+    }
+
+    void makeIHMCStopAllTrajectoryMessage(controller_msgs::StopAllTrajectoryMessage& stop_msg,
+                                          IHMCMessageParameters msg_params)
+    {
+        // set sequence id; message has no other fields
+        stop_msg.sequence_id = msg_params.sequence_id;
 
         return;
     }
 
+    // FUNCTIONS FOR STAMPING IHMC MESSAGES
+    IHMCMessageStamper makeIHMCMessageStamper(IHMCMessageParameters msg_params) {
+        // get current time for timestamp
+        auto t = std::chrono::system_clock::now();
+        // timestamp in nanoseconds when the message was created
+        int64_t timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+
+        return IHMCMessageStamper(msg_params.sequence_id, msg_params.queueable_params.message_id, timestamp);
+    }
+
     // HELPER FUNCTIONS
     void selectRelevantJointsConfiguration(dynacore::Vector q,
                                            std::vector<int> joint_indices,
@@ -940,6 +1136,34 @@ namespace IHMCMsgUtils {
         return;
     }
 
+    void getRelevantJointIndicesControlledLinks(const std::vector<int>& controlled_links, std::vector<int>& joint_indices) {
+        // clear joint index vector
+        joint_indices.clear();
+
+        // append joints of each controlled link
+        std::vector<int> link_indices;
+        for( int i = 0 ; i < controlled_links.size() ; i++ ) {
+            switch( controlled_links[i] ) {
+                case valkyrie_link::pelvis: getRelevantJointIndicesPelvis(link_indices); break;
+                case valkyrie_link::torso: getRelevantJointIndicesTorso(link_indices); break;
+                case valkyrie_link::rightCOP_Frame: getRelevantJointIndicesRightLeg(link_indices); break;
+                case valkyrie_link::leftCOP_Frame: getRelevantJointIndicesLeftLeg(link_indices); break;
+                case valkyrie_link::rightPalm: getRelevantJointIndicesRightArm(link_indices); break;
+                case valkyrie_link::leftPalm: getRelevantJointIndicesLeftArm(link_indices); break;
+                case valkyrie_link::head: getRelevantJointIndicesNeck(link_indices); break;
+                default: link_indices.clear(); break;
+            }
+            for( int j = 0 ; j < link_indices.size() ; j++ ) {
+                // special index -1 (wrist joints) is not in valkyrie definition
+                if( link_indices[j] != -1 ) {
+                    joint_indices.push_back(link_indices[j]);
+                }
+            }
+        }
+
+        return;
+    }
+
     void getChestOrientation(dynacore::Vector q, dynacore::Quaternion& chest_quat) {
         // construct robot model
         std::shared_ptr<Valkyrie_Model> robot_model(new Valkyrie_Model);
@@ -1006,9 +1230,50 @@ namespace IHMCMsgUtils {
         return (it != controlled_links.end());
     }
 
+    bool getControlledLinkId(const std::string& name, int& link_id) {
+        if( name == "pelvis" ) { link_id = valkyrie_link::pelvis; }
+        else if( name == "torso" ) { link_id = valkyrie_link::torso; }
+        else if( name == "rightCOP_Frame" ) { link_id = valkyrie_link::rightCOP_Frame; }
+        else if( name == "leftCOP_Frame" ) { link_id = valkyrie_link::leftCOP_Frame; }
+        else if( name == "rightPalm" ) { link_id = valkyrie_link::rightPalm; }
+        else if( name == "leftPalm" ) { link_id = valkyrie_link::leftPalm; }
+        else if( name == "head" ) { link_id = valkyrie_link::head; }
+        else { return false; }
+
+        return true;
+    }
+
+    void getReferenceFrameIds(std::string frame_name,
+                              int& trajectory_reference_frame_id,
+                              int& data_reference_frame_id,
+                              IHMCMessageParameters msg_params) {
+        if( frame_name == std::string("world") ) {
+            // world frame
+            trajectory_reference_frame_id = msg_params.frame_params.trajectory_reference_frame_id_world;
+            data_reference_frame_id = msg_params.frame_params.data_reference_frame_id_world;
+        }
+        else if( frame_name == std::string("pelvis") ) {
+            // pelvis frame
+            trajectory_reference_frame_id = msg_params.frame_params.trajectory_reference_frame_id_pelviszup;
+            data_reference_frame_id = msg_params.frame_params.data_reference_frame_id_pelviszup;
+        }
+        else if( isIHMCFrameNameId(frame_name) ) {
+            // named IHMC reference frame; use hash of frame name id directly
+            trajectory_reference_frame_id = hashIHMCFrameNameId(frame_name);
+            data_reference_frame_id = trajectory_reference_frame_id;
+        }
+        else {
+            // not a frame IHMC knows; hashing it would give an id IHMC cannot resolve
+            ROS_WARN("[IHMC Msg Utilities] Unknown reference frame %s, using world frame", frame_name.c_str());
+            trajectory_reference_frame_id = msg_params.frame_params.trajectory_reference_frame_id_world;
+            data_reference_frame_id = msg_params.frame_params.data_reference_frame_id_world;
+        }
+
+        return;
+    }
+
     void applyHandOffset(dynacore::Vect3& left_hand_pos, dynacore::Quaternion& left_hand_quat,
-                         dynacore::Vect3& right_hand_pos, dynacore::Quaternion& right_hand_quat,
-                         std::string frame_id, tf::Transform tf_frameid_wrt_world) {
+                         dynacore::Vect3& right_hand_pos, dynacore::Quaternion& right_hand_quat) {
         // NOTE: dynacore::Transforms are Eigen affine transforms
         //       in a d-dimensional space, affine transforms are (d+1)x(d+1) matrices
         //       where the last row is [0 ... 0 1]
@@ -1019,43 +1284,18 @@ namespace IHMCMsgUtils {
         //       the linear part of the transform represents the rotation and
         //       the translation part of the transform represents the translation
 
-        // GET INPUT POSES IN WORLD FRAME
-        // initialize targets in world frame
-        dynacore::Vect3 left_hand_pos_wrt_world;
-        dynacore::Quaternion left_hand_quat_wrt_world;
-        dynacore::Vect3 right_hand_pos_wrt_world;
-        dynacore::Quaternion right_hand_quat_wrt_world;
-
-        // check target hand pose frame ID and transform into world, if necessary
-        bool transformed_targets = false;
-        if( frame_id.compare(std::string("world")) != 0 ) {
-            // transformation needed, set flag
-            transformed_targets = true;
-
-            // transform targets into world frame
-            transformDynacorePose(left_hand_pos, left_hand_quat,
-                                  left_hand_pos_wrt_world, left_hand_quat_wrt_world,
-                                  tf_frameid_wrt_world);
-            transformDynacorePose(right_hand_pos, right_hand_quat,
-                                  right_hand_pos_wrt_world, right_hand_quat_wrt_world,
-                                  tf_frameid_wrt_world);
-        }
-        else {
-            // already in world frame, set targets
-            left_hand_pos_wrt_world = left_hand_pos;
-            left_hand_quat_wrt_world = left_hand_quat;
-            right_hand_pos_wrt_world = right_hand_pos;
-            right_hand_quat_wrt_world = right_hand_quat;
-        }
+        // NOTE: the hand offset is expressed in the hand frame and applied on the right,
+        //       so for any frame F, T_world_F^-1 * (T_world_F * T_F_hand) * offset = T_F_hand * offset;
+        //       the offset can be applied directly in the frame of the given goals without going through world
 
         // APPLY HAND OFFSET
         // initialize hand transforms
-        dynacore::Transform left_pose_wrt_world;
-        left_pose_wrt_world.translation() = left_hand_pos_wrt_world;
-        left_pose_wrt_world.linear() = left_hand_quat_wrt_world.normalized().toRotationMatrix();
-        dynacore::Transform right_pose_wrt_world;
-        right_pose_wrt_world.translation() = right_hand_pos_wrt_world;
-        right_pose_wrt_world.linear() = right_hand_quat_wrt_world.normalized().toRotationMatrix();
+        dynacore::Transform left_pose;
+        left_pose.translation() = left_hand_pos;
+        left_pose.linear() = left_hand_quat.normalized().toRotationMatrix();
+        dynacore::Transform right_pose;
+        right_pose.translation() = right_hand_pos;
+        right_pose.linear() = right_hand_quat.normalized().toRotationMatrix();
 
         // initialize hand offset transform
         dynacore::Vect3 hand_translation_offset;
@@ -1068,48 +1308,16 @@ namespace IHMCMsgUtils {
         hand_offset.linear() = hand_rotational_offset.toRotationMatrix();
 
         // compute transformed poses
-        dynacore::Transform offset_left_pose_wrt_world = left_pose_wrt_world * hand_offset;
-        dynacore::Transform offset_right_pose_wrt_world = right_pose_wrt_world * hand_offset;
-
-        // initialize offsets in world frame
-        dynacore::Vect3 offset_left_hand_pos_wrt_world(offset_left_pose_wrt_world.translation());
-        dynacore::Quaternion offset_left_hand_quat_wrt_world(offset_left_pose_wrt_world.linear());
-        dynacore::Vect3 offset_right_hand_pos_wrt_world(offset_right_pose_wrt_world.translation());
-        dynacore::Quaternion offset_right_hand_quat_wrt_world(offset_right_pose_wrt_world.linear());
-
-        // GET POSES IN GIVEN FRAME
-        // initialize targets in given frame
-        dynacore::Vect3 left_hand_pos_offset;
-        dynacore::Quaternion left_hand_quat_offset;
-        dynacore::Vect3 right_hand_pos_offset;
-        dynacore::Quaternion right_hand_quat_offset;
-
-        // transform back to original frame, if necessary
-        if( transformed_targets ) {
-            tf::Transform tf_world_wrt_frameid = tf_frameid_wrt_world.inverse();
-            // transform targets into given frame
-            transformDynacorePose(offset_left_hand_pos_wrt_world, offset_left_hand_quat_wrt_world,
-                                  left_hand_pos_offset, left_hand_quat_offset,
-                                  tf_world_wrt_frameid);
-            transformDynacorePose(offset_right_hand_pos_wrt_world, offset_right_hand_quat_wrt_world,
-                                  right_hand_pos_offset, right_hand_quat_offset,
-                                  tf_world_wrt_frameid);
-        }
-        else {
-            // already in world frame, set targets
-            left_hand_pos_offset = offset_left_hand_pos_wrt_world;
-            left_hand_quat_offset = offset_left_hand_quat_wrt_world;
-            right_hand_pos_offset = offset_right_hand_pos_wrt_world;
-            right_hand_quat_offset = offset_right_hand_quat_wrt_world;
-        }
+        dynacore::Transform offset_left_pose = left_pose * hand_offset;
+        dynacore::Transform offset_right_pose = right_pose * hand_offset;
 
         // UPDATE GIVEN POSES WITH OFFSET
         // update given hand poses to be offset poses
-        left_hand_pos = left_hand_pos_offset;
-        left_hand_quat = left_hand_quat_offset;
+        left_hand_pos = offset_left_pose.translation();
+        left_hand_quat = dynacore::Quaternion(offset_left_pose.linear());
         left_hand_quat.normalize();
-        right_hand_pos = right_hand_pos_offset;
-        right_hand_quat = right_hand_quat_offset;
+        right_hand_pos = offset_right_pose.translation();
+        right_hand_quat = dynacore::Quaternion(offset_right_pose.linear());
         right_hand_quat.normalize();
 
         return;
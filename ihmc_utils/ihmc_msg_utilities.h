@@ -3,6 +3,9 @@
  * Emily Sheetz, NSTGRO VTE 2021
  **/
 
+#ifndef _IHMC_MSG_UTILITIES_H_
+#define _IHMC_MSG_UTILITIES_H_
+
 #include <iostream>
 #include <memory>
 #include <chrono>
@@ -14,6 +17,7 @@
 #include <geometry_msgs/PoseStamped.h>
 
 #include <ihmc_utils/ihmc_msg_params.h>
+#include <ihmc_utils/ihmc_msg_visitor.h>
 
 #include <Utils/wrap_eigen.hpp>
 #include <Utils/rosmsg_utils.hpp>
@@ -41,12 +45,19 @@
 #include <controller_msgs/WholeBodyTrajectoryMessage.h>
 #include <controller_msgs/GoHomeMessage.h>
 #include <controller_msgs/ValkyrieHandFingerTrajectoryMessage.h>
+#include <controller_msgs/StopAllTrajectoryMessage.h>
 
 namespace IHMCMsgUtils {
 
     void testFunction();
 
     // FUNCTIONS FOR MAKING IHMC MESSAGES
+    /*
+     * NOTE: sequence ids, message ids, and creation timestamps are not set field by field;
+     * each make function builds its message, then stamps the message and every message it contains in one pass
+     * (see stampIHMCMessage), so contained messages are stamped once and share one creation timestamp
+     */
+
     /*
      * makes an ArmTrajectoryMessage from the given configuration vector
      * @param q_joints, the vector containing the desired configuration for the relevant joints
@@ -174,7 +185,7 @@ namespace IHMCMsgUtils {
                                          IHMCMessageParameters msg_params);
 
     /*
-     * makes a QueueableMessage // TODO parameters will likely change
+     * makes a QueueableMessage
      * @param q_msg, the message to be populated
      * @param msg_params, the IHMCMessageParameters struct containing parameters for populating the message
      * @return none
@@ -294,7 +305,6 @@ namespace IHMCMsgUtils {
      * @param right_hand_quat, the quaternion containing the desired right hand orientation
      * @param wholebody_msg, the message to be populated
      * @param msg_params, the IHMCMessageParameters struct containing parameters for populating the message
-     * @param tf_hand_goal_frame_wrt_world, the transform of the hand goal frame to world
      * @return none
      * @post wholebody_msg populated based on the given configuration
      */
@@ -305,7 +315,7 @@ namespace IHMCMsgUtils {
                                             dynacore::Vect3 left_hand_pos, dynacore::Quaternion left_hand_quat,
                                             dynacore::Vect3 right_hand_pos, dynacore::Quaternion right_hand_quat,
                                             controller_msgs::WholeBodyTrajectoryMessage& wholebody_msg,
-                                            IHMCMessageParameters msg_params, tf::Transform tf_hand_goal_frame_wrt_world);
+                                            IHMCMessageParameters msg_params);
 
     /*
      * makes a GoHomeMessage for the corresponding humanoid body part
@@ -351,6 +361,39 @@ namespace IHMCMsgUtils {
                                                      std::vector<double> finger_positions,
                                                      IHMCMessageParameters msg_params);
 
+    /*
+     * makes a StopAllTrajectoryMessage, which stops all trajectories and holds the robot at its current configuration
+     * @param stop_msg, the message to be populated
+     * @param msg_params, the IHMCMessageParameters struct containing parameters for populating the message
+     * @return none
+     * @post stop_msg populated
+     */
+    void makeIHMCStopAllTrajectoryMessage(controller_msgs::StopAllTrajectoryMessage& stop_msg,
+                                          IHMCMessageParameters msg_params);
+
+    // FUNCTIONS FOR STAMPING IHMC MESSAGES
+    /*
+     * makes a stamper for the given parameters, with creation timestamp taken from the current time
+     * @param msg_params, the IHMCMessageParameters struct containing the sequence id and message id
+     * @return the stamper, which can stamp several messages with the same timestamp
+     */
+    IHMCMessageStamper makeIHMCMessageStamper(IHMCMessageParameters msg_params);
+
+    /*
+     * stamps a message in one pass: sets the sequence id of the message and every message it contains,
+     * and the message id and creation timestamp of every queueable message it contains
+     * @param msg, the message to be stamped
+     * @param msg_params, the IHMCMessageParameters struct containing the sequence id and message id
+     * @return none
+     * @post every sequence id in msg is msg_params.sequence_id, and all queueable messages share one timestamp
+     */
+    template <class M>
+    void stampIHMCMessage(M& msg, IHMCMessageParameters msg_params) {
+        IHMCMessageStamper stamper = makeIHMCMessageStamper(msg_params);
+        visitFields(stamper, msg);
+        return;
+    }
+
     // HELPER FUNCTIONS
     /*
      * select the joint positions for the relevant joints
@@ -378,6 +421,16 @@ namespace IHMCMsgUtils {
     void getRelevantJointIndicesNeck(std::vector<int>& joint_indices);
     void getRelevantJointIndicesRightArm(std::vector<int>& joint_indices);
 
+    /*
+     * get the configuration indices of the joints moved by the given controlled links
+     * (pelvis: virtual joints; torso; feet: legs; palms: arms; head: neck); wrist joints (special index -1) are skipped
+     * @param controlled_links, the vector of controlled links
+     * @param joint_indices, a reference to the vector of indices that will be updated
+     * @return none
+     * @post joint_indices updated to contain the indices of the joints of every controlled link
+     */
+    void getRelevantJointIndicesControlledLinks(const std::vector<int>& controlled_links, std::vector<int>& joint_indices);
+
     /*
      * get the {orientation/poses} of the {chest/pelvis/feet} induced by the given configuration
      * @param q, the vector containing the robot configuration
@@ -405,20 +458,40 @@ namespace IHMCMsgUtils {
      */
     bool checkControlledLink(std::vector<int> controlled_links, int link_id);
 
+    /*
+     * gets the link id of a link that whole-body messages control from its name
+     * @param name, the name of the link (pelvis, torso, rightCOP_Frame, leftCOP_Frame, rightPalm, leftPalm, head)
+     * @param link_id, the link id that will be updated
+     * @return bool indicating if name is a controllable link
+     */
+    bool getControlledLinkId(const std::string& name, int& link_id);
+
+    /*
+     * gets the IHMC reference frame ids for the given frame name
+     * @param frame_name, the name of the frame; "world" and "pelvis" map to the world and pelvis zup frames,
+     *        IHMC frame name ids ("World:...") are hashed, and any other name falls back to the world frame with a warning
+     * @param trajectory_reference_frame_id, the reference frame id that will be updated
+     * @param data_reference_frame_id, the reference frame id for data in a packet that will be updated
+     * @param msg_params, the IHMCMessageParameters struct containing parameters for populating the message
+     * @return none
+     * @post frame ids updated to reflect the given frame
+     */
+    void getReferenceFrameIds(std::string frame_name,
+                              int& trajectory_reference_frame_id,
+                              int& data_reference_frame_id,
+                              IHMCMessageParameters msg_params);
+
     /*
      * applies the fixed hand offset to given hand goals
      * @param left_hand_pos, the vector containing the desired left hand position
      * @param left_hand_quat, the quaternion containing the desired left hand orientation
      * @param right_hand_pos, the vector containing the desired right hand position
      * @param right_hand_quat, the quaternion containing the desired right hand orientation
-     * @param frame_id, a string representing the frame id for the given hand goals
-     * @param tf_frameid_wrt_world, the transform from the given frame id to world
      * @return none
-     * @post poses updated to reflect hand offset
+     * @post poses updated to reflect hand offset, expressed in the same frame as the given hand goals
      */
     void applyHandOffset(dynacore::Vect3& left_hand_pos, dynacore::Quaternion& left_hand_quat,
-                         dynacore::Vect3& right_hand_pos, dynacore::Quaternion& right_hand_quat,
-                         std::string frame_id, tf::Transform tf_frameid_wrt_world);
+                         dynacore::Vect3& right_hand_pos, dynacore::Quaternion& right_hand_quat);
 
     /*
      * transforms a pose from one frame to another
@@ -435,3 +508,5 @@ namespace IHMCMsgUtils {
                                tf::Transform tf_input_wrt_output);
 
 } // end namespace IHMCMsgUtils
+
+#endif
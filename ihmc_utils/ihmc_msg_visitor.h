@@ -0,0 +1,458 @@
+/**
+ * Recursive Visitor for IHMC Message Fields
+ * Emily Sheetz, NSTGRO VTE 2021
+ **/
+
+#ifndef _IHMC_MSG_VISITOR_H_
+#define _IHMC_MSG_VISITOR_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <type_traits>
+
+#include <geometry_msgs/Point.h>
+#include <geometry_msgs/Pose.h>
+#include <geometry_msgs/Quaternion.h>
+#include <geometry_msgs/Vector3.h>
+
+#include <controller_msgs/ArmTrajectoryMessage.h>
+#include <controller_msgs/ChestTrajectoryMessage.h>
+#include <controller_msgs/FootTrajectoryMessage.h>
+#include <controller_msgs/FrameInformation.h>
+#include <controller_msgs/HandTrajectoryMessage.h>
+#include <controller_msgs/HeadTrajectoryMessage.h>
+#include <controller_msgs/JointspaceTrajectoryMessage.h>
+#include <controller_msgs/NeckTrajectoryMessage.h>
+#include <controller_msgs/OneDoFJointTrajectoryMessage.h>
+#include <controller_msgs/PelvisTrajectoryMessage.h>
+#include <controller_msgs/QueueableMessage.h>
+#include <controller_msgs/SE3TrajectoryMessage.h>
+#include <controller_msgs/SE3TrajectoryPointMessage.h>
+#include <controller_msgs/SelectionMatrix3DMessage.h>
+#include <controller_msgs/SO3TrajectoryMessage.h>
+#include <controller_msgs/SO3TrajectoryPointMessage.h>
+#include <controller_msgs/SpineTrajectoryMessage.h>
+#include <controller_msgs/TrajectoryPoint1DMessage.h>
+#include <controller_msgs/WeightMatrix3DMessage.h>
+#include <controller_msgs/WholeBodyTrajectoryMessage.h>
+#include <controller_msgs/GoHomeMessage.h>
+#include <controller_msgs/ValkyrieHandFingerTrajectoryMessage.h>
+
+namespace IHMCMsgUtils {
+
+    /*
+     * recursive visitor over the controller_msgs messages used by this package;
+     * the fields of each message type are resolved at compile time, and visitFields(visitor, msg) walks the message tree once
+     * and calls the visitor on every leaf field (numbers, including elements of arrays and components of geometry_msgs)
+     * together with the path of the field,
+     * so nested fields can be read (const message) or updated (non-const message) without naming every level
+     *
+     * a visitor is any object with
+     *     template <class T, class F> void operator()(const IHMCFieldPath& path, T& value, F field)
+     * where T is the arithmetic type of the field, const if the message is const, and F is the tag type of the field;
+     * stamp fields have their own tags (below) and every other field is tagged IHMCOtherField, so a visitor that only
+     * sets some fields overloads operator() on their tags and the choice is made at compile time, not by comparing names
+     */
+
+    // TAGS FOR FIELDS THAT VISITORS SELECT
+    struct IHMCOtherField {};
+    struct IHMCSequenceIdField {};
+    struct IHMCMessageIdField {};
+    struct IHMCTimestampField {};
+    struct IHMCStreamIntegrationDurationField {};
+
+    // PATH OF A FIELD IN A MESSAGE TREE
+    // paths live on the stack while visiting, so the string form is only built when asked for
+    struct IHMCFieldPath {
+        const IHMCFieldPath* parent; // path of enclosing message or array, nullptr for the root message
+        const char* name; // name of field, nullptr for array elements
+        int index; // index of array element
+
+        // CONSTRUCTORS
+        IHMCFieldPath() : parent(nullptr), name(nullptr), index(-1) {}
+        IHMCFieldPath(const IHMCFieldPath& parent_path, const char* field_name) : parent(&parent_path), name(field_name), index(-1) {}
+        IHMCFieldPath(const IHMCFieldPath& parent_path, int element_index) : parent(&parent_path), name(nullptr), index(element_index) {}
+
+        // name of field, or of the array for array elements ("" for the root message)
+        const char* getFieldName() const {
+            const IHMCFieldPath* path = this;
+            while( path->parent != nullptr && path->name == nullptr ) {
+                path = path->parent;
+            }
+            return (path->name != nullptr) ? path->name : "";
+        }
+
+        // full path, e.g. "left_arm_trajectory_message.jointspace_trajectory.joint_trajectory_messages[2].weight"
+        std::string toString() const {
+            std::string path_string;
+            appendTo(path_string);
+            return path_string;
+        }
+
+        void appendTo(std::string& path_string) const {
+            if( parent == nullptr ) {
+                return;
+            }
+            parent->appendTo(path_string);
+            if( name != nullptr ) {
+                if( !path_string.empty() ) {
+                    path_string += '.';
+                }
+                path_string += name;
+            }
+            else {
+                path_string += '[';
+                path_string += std::to_string(index);
+                path_string += ']';
+            }
+            return;
+        }
+    };
+
+    /*
+     * visits every leaf field of a message
+     * @param visitor, the visitor called on each leaf field
+     * @param path, the path of the message (omit for the root message)
+     * @param msg, the message (or leaf field or array) to visit
+     * @return none
+     */
+    template <class V, class M>
+    void visitFields(V& visitor, const IHMCFieldPath& path, M& msg) {
+        // dispatch on the message type without const, so one overload handles const and non-const messages
+        visitTypeFields(visitor, path, msg, static_cast<typename std::remove_const<M>::type*>(nullptr));
+        return;
+    }
+
+    template <class V, class M>
+    void visitFields(V& visitor, M& msg) {
+        visitFields(visitor, IHMCFieldPath(), msg);
+        return;
+    }
+
+    /*
+     * visits a leaf field with its tag
+     * @param visitor, the visitor called on the field
+     * @param path, the path of the field
+     * @param value, the field
+     * @param field, the tag of the field
+     * @return none
+     */
+    template <class V, class M, class F>
+    void visitFields(V& visitor, const IHMCFieldPath& path, M& value, F field) {
+        static_assert(std::is_arithmetic<typename std::remove_const<M>::type>::value, "only leaf fields have tags");
+        visitor(path, value, field);
+        return;
+    }
+
+    // OVERLOADS FOR EACH TYPE; selected by the null pointer to the type, and found when visiting through the path argument
+    // LEAF FIELDS
+    template <class V, class M>
+    void visitTypeFields(V& visitor, const IHMCFieldPath& path, M& value, void*) {
+        static_assert(std::is_arithmetic<typename std::remove_const<M>::type>::value,
+                      "visitFields has no overload for this message type");
+        visitor(path, value, IHMCOtherField());
+        return;
+    }
+
+    // ARRAYS
+    template <class V, class M, class T, class A>
+    void visitTypeFields(V& visitor, const IHMCFieldPath& path, M& array, std::vector<T, A>*) {
+        for( int i = 0 ; i < array.size() ; i++ ) {
+            visitFields(visitor, IHMCFieldPath(path, i), array[i]);
+        }
+        return;
+    }
+
+    // GEOMETRY MESSAGES
+    template <class V, class M>
+    void visitTypeFields(V& visitor, const IHMCFieldPath& path, M& msg, geometry_msgs::Point*) {
+        visitFields(visitor, IHMCFieldPath(path, "x"), msg.x);
+        visitFields(visitor, IHMCFieldPath(path, "y"), msg.y);
+        visitFields(visitor, IHMCFieldPath(path, "z"), msg.z);
+        return;
+    }
+
+    template <class V, class M>
+    void visitTypeFields(V& visitor, const IHMCFieldPath& path, M& msg, geometry_msgs::Vector3*) {
+        visitFields(visitor, IHMCFieldPath(path, "x"), msg.x);
+        visitFields(visitor, IHMCFieldPath(path, "y"), msg.y);
+        visitFields(visitor, IHMCFieldPath(path, "z"), msg.z);
+        return;
+    }
+
+    template <class V, class M>
+    void visitTypeFields(V& visitor, const IHMCFieldPath& path, M& msg, geometry_msgs::Quaternion*) {
+        visitFields(visitor, IHMCFieldPath(path, "x"), msg.x);
+        visitFields(visitor, IHMCFieldPath(path, "y"), msg.y);
+        visitFields(visitor, IHMCFieldPath(path, "z"), msg.z);
+        visitFields(visitor, IHMCFieldPath(path, "w"), msg.w);
+        return;
+    }
+
+    template <class V, class M>
+    void visitTypeFields(V& visitor, const IHMCFieldPath& path, M& msg, geometry_msgs::Pose*) {
+        visitFields(visitor, IHMCFieldPath(path, "position"), msg.position);
+        visitFields(visitor, IHMCFieldPath(path, "orientation"), msg.orientation);
+        return;
+    }
+
+    // COMMON IHMC MESSAGES
+    template <class V, class M>
+    void visitTypeFields(V& visitor, const IHMCFieldPath& path, M& msg, controller_msgs::QueueableMessage*) {
+        visitFields(visitor, IHMCFieldPath(path, "sequence_id"), msg.sequence_id, IHMCSequenceIdField());
+        visitFields(visitor, IHMCFieldPath(path, "execution_mode"), msg.execution_mode);
+        visitFields(visitor, IHMCFieldPath(path, "message_id"), msg.message_id, IHMCMessageIdField());
+        visitFields(visitor, IHMCFieldPath(path, "previous_message_id"), msg.previous_message_id);
+        visitFields(visitor, IHMCFieldPath(path, "execution_delay_time"), msg.execution_delay_time);
+        visitFields(visitor, IHMCFieldPath(path, "stream_integration_duration"), msg.stream_integration_duration, IHMCStreamIntegrationDurationField());
+        visitFields(visitor, IHMCFieldPath(path, "timestamp"), msg.timestamp, IHMCTimestampField());
+        return;
+    }
+
+    template <class V, class M>
+    void visitTypeFields(V& visitor, const IHMCFieldPath& path, M& msg, controller_msgs::FrameInformation*) {
+        visitFields(visitor, IHMCFieldPath(path, "sequence_id"), msg.sequence_id, IHMCSequenceIdField());
+        visitFields(visitor, IHMCFieldPath(path, "trajectory_reference_frame_id"), msg.trajectory_reference_frame_id);
+        visitFields(visitor, IHMCFieldPath(path, "data_reference_frame_id"), msg.data_reference_frame_id);
+        return;
+    }
+
+    template <class V, class M>
+    void visitTypeFields(V& visitor, const IHMCFieldPath& path, M& msg, controller_msgs::SelectionMatrix3DMessage*) {
+        visitFields(visitor, IHMCFieldPath(path, "sequence_id"), msg.sequence_id, IHMCSequenceIdField());
+        visitFields(visitor, IHMCFieldPath(path, "selection_frame_id"), msg.selection_frame_id);
+        visitFields(visitor, IHMCFieldPath(path, "x_selected"), msg.x_selected);
+        visitFields(visitor, IHMCFieldPath(path, "y_selected"), msg.y_selected);
+        visitFields(visitor, IHMCFieldPath(path, "z_selected"), msg.z_selected);
+        return;
+    }
+
+    template <class V, class M>
+    void visitTypeFields(V& visitor, const IHMCFieldPath& path, M& msg, controller_msgs::WeightMatrix3DMessage*) {
+        visitFields(visitor, IHMCFieldPath(path, "sequence_id"), msg.sequence_id, IHMCSequenceIdField());
+        visitFields(visitor, IHMCFieldPath(path, "weight_frame_id"), msg.weight_frame_id);
+        visitFields(visitor, IHMCFieldPath(path, "x_weight"), msg.x_weight);
+        visitFields(visitor, IHMCFieldPath(path, "y_weight"), msg.y_weight);
+        visitFields(visitor, IHMCFieldPath(path, "z_weight"), msg.z_weight);
+        return;
+    }
+
+    // JOINTSPACE MESSAGES
+    template <class V, class M>
+    void visitTypeFields(V& visitor, const IHMCFieldPath& path, M& msg, controller_msgs::TrajectoryPoint1DMessage*) {
+        visitFields(visitor, IHMCFieldPath(path, "sequence_id"), msg.sequence_id, IHMCSequenceIdField());
+        visitFields(visitor, IHMCFieldPath(path, "time"), msg.time);
+        visitFields(visitor, IHMCFieldPath(path, "position"), msg.position);
+        visitFields(visitor, IHMCFieldPath(path, "velocity"), msg.velocity);
+        return;
+    }
+
+    template <class V, class M>
+    void visitTypeFields(V& visitor, const IHMCFieldPath& path, M& msg, controller_msgs::OneDoFJointTrajectoryMessage*) {
+        visitFields(visitor, IHMCFieldPath(path, "sequence_id"), msg.sequence_id, IHMCSequenceIdField());
+        visitFields(visitor, IHMCFieldPath(path, "trajectory_points"), msg.trajectory_points);
+        visitFields(visitor, IHMCFieldPath(path, "weight"), msg.weight);
+        return;
+    }
+
+    template <class V, class M>
+    void visitTypeFields(V& visitor, const IHMCFieldPath& path, M& msg, controller_msgs::JointspaceTrajectoryMessage*) {
+        visitFields(visitor, IHMCFieldPath(path, "sequence_id"), msg.sequence_id, IHMCSequenceIdField());
+        visitFields(visitor, IHMCFieldPath(path, "joint_trajectory_messages"), msg.joint_trajectory_messages);
+        visitFields(visitor, IHMCFieldPath(path, "queueing_properties"), msg.queueing_properties);
+        return;
+    }
+
+    // TASKSPACE MESSAGES
+    template <class V, class M>
+    void visitTypeFields(V& visitor, const IHMCFieldPath& path, M& msg, controller_msgs::SE3TrajectoryPointMessage*) {
+        visitFields(visitor, IHMCFieldPath(path, "sequence_id"), msg.sequence_id, IHMCSequenceIdField());
+        visitFields(visitor, IHMCFieldPath(path, "time"), msg.time);
+        visitFields(visitor, IHMCFieldPath(path, "position"), msg.position);
+        visitFields(visitor, IHMCFieldPath(path, "orientation"), msg.orientation);
+        visitFields(visitor, IHMCFieldPath(path, "linear_velocity"), msg.linear_velocity);
+        visitFields(visitor, IHMCFieldPath(path, "angular_velocity"), msg.angular_velocity);
+        return;
+    }
+
+    template <class V, class M>
+    void visitTypeFields(V& visitor, const IHMCFieldPath& path, M& msg, controller_msgs::SO3TrajectoryPointMessage*) {
+        visitFields(visitor, IHMCFieldPath(path, "sequence_id"), msg.sequence_id, IHMCSequenceIdField());
+        visitFields(visitor, IHMCFieldPath(path, "time"), msg.time);
+        visitFields(visitor, IHMCFieldPath(path, "orientation"), msg.orientation);
+        visitFields(visitor, IHMCFieldPath(path, "angular_velocity"), msg.angular_velocity);
+        return;
+    }
+
+    template <class V, class M>
+    void visitTypeFields(V& visitor, const IHMCFieldPath& path, M& msg, controller_msgs::SE3TrajectoryMessage*) {
+        visitFields(visitor, IHMCFieldPath(path, "sequence_id"), msg.sequence_id, IHMCSequenceIdField());
+        visitFields(visitor, IHMCFieldPath(path, "taskspace_trajectory_points"), msg.taskspace_trajectory_points);
+        visitFields(visitor, IHMCFieldPath(path, "angular_selection_matrix"), msg.angular_selection_matrix);
+        visitFields(visitor, IHMCFieldPath(path, "linear_selection_matrix"), msg.linear_selection_matrix);
+        visitFields(visitor, IHMCFieldPath(path, "frame_information"), msg.frame_information);
+        visitFields(visitor, IHMCFieldPath(path, "angular_weight_matrix"), msg.angular_weight_matrix);
+        visitFields(visitor, IHMCFieldPath(path, "linear_weight_matrix"), msg.linear_weight_matrix);
+        visitFields(visitor, IHMCFieldPath(path, "use_custom_control_frame"), msg.use_custom_control_frame);
+        visitFields(visitor, IHMCFieldPath(path, "control_frame_pose"), msg.control_frame_pose);
+        visitFields(visitor, IHMCFieldPath(path, "queueing_properties"), msg.queueing_properties);
+        return;
+    }
+
+    template <class V, class M>
+    void visitTypeFields(V& visitor, const IHMCFieldPath& path, M& msg, controller_msgs::SO3TrajectoryMessage*) {
+        visitFields(visitor, IHMCFieldPath(path, "sequence_id"), msg.sequence_id, IHMCSequenceIdField());
+        visitFields(visitor, IHMCFieldPath(path, "taskspace_trajectory_points"), msg.taskspace_trajectory_points);
+        visitFields(visitor, IHMCFieldPath(path, "selection_matrix"), msg.selection_matrix);
+        visitFields(visitor, IHMCFieldPath(path, "frame_information"), msg.frame_information);
+        visitFields(visitor, IHMCFieldPath(path, "weight_matrix"), msg.weight_matrix);
+        visitFields(visitor, IHMCFieldPath(path, "use_custom_control_frame"), msg.use_custom_control_frame);
+        visitFields(visitor, IHMCFieldPath(path, "control_frame_pose"), msg.control_frame_pose);
+        visitFields(visitor, IHMCFieldPath(path, "queueing_properties"), msg.queueing_properties);
+        return;
+    }
+
+    // BODY PART MESSAGES
+    template <class V, class M>
+    void visitTypeFields(V& visitor, const IHMCFieldPath& path, M& msg, controller_msgs::ArmTrajectoryMessage*) {
+        visitFields(visitor, IHMCFieldPath(path, "sequence_id"), msg.sequence_id, IHMCSequenceIdField());
+        visitFields(visitor, IHMCFieldPath(path, "force_execution"), msg.force_execution);
+        visitFields(visitor, IHMCFieldPath(path, "robot_side"), msg.robot_side);
+        visitFields(visitor, IHMCFieldPath(path, "jointspace_trajectory"), msg.jointspace_trajectory);
+        return;
+    }
+
+    template <class V, class M>
+    void visitTypeFields(V& visitor, const IHMCFieldPath& path, M& msg, controller_msgs::HandTrajectoryMessage*) {
+        visitFields(visitor, IHMCFieldPath(path, "sequence_id"), msg.sequence_id, IHMCSequenceIdField());
+        visitFields(visitor, IHMCFieldPath(path, "robot_side"), msg.robot_side);
+        visitFields(visitor, IHMCFieldPath(path, "se3_trajectory"), msg.se3_trajectory);
+        return;
+    }
+
+    template <class V, class M>
+    void visitTypeFields(V& visitor, const IHMCFieldPath& path, M& msg, controller_msgs::ChestTrajectoryMessage*) {
+        visitFields(visitor, IHMCFieldPath(path, "sequence_id"), msg.sequence_id, IHMCSequenceIdField());
+        visitFields(visitor, IHMCFieldPath(path, "so3_trajectory"), msg.so3_trajectory);
+        return;
+    }
+
+    template <class V, class M>
+    void visitTypeFields(V& visitor, const IHMCFieldPath& path, M& msg, controller_msgs::SpineTrajectoryMessage*) {
+        visitFields(visitor, IHMCFieldPath(path, "sequence_id"), msg.sequence_id, IHMCSequenceIdField());
+        visitFields(visitor, IHMCFieldPath(path, "jointspace_trajectory"), msg.jointspace_trajectory);
+        return;
+    }
+
+    template <class V, class M>
+    void visitTypeFields(V& visitor, const IHMCFieldPath& path, M& msg, controller_msgs::PelvisTrajectoryMessage*) {
+        visitFields(visitor, IHMCFieldPath(path, "sequence_id"), msg.sequence_id, IHMCSequenceIdField());
+        visitFields(visitor, IHMCFieldPath(path, "force_execution"), msg.force_execution);
+        visitFields(visitor, IHMCFieldPath(path, "enable_user_pelvis_control"), msg.enable_user_pelvis_control);
+        visitFields(visitor, IHMCFieldPath(path, "enable_user_pelvis_control_during_walking"), msg.enable_user_pelvis_control_during_walking);
+        visitFields(visitor, IHMCFieldPath(path, "se3_trajectory"), msg.se3_trajectory);
+        return;
+    }
+
+    template <class V, class M>
+    void visitTypeFields(V& visitor, const IHMCFieldPath& path, M& msg, controller_msgs::FootTrajectoryMessage*) {
+        visitFields(visitor, IHMCFieldPath(path, "sequence_id"), msg.sequence_id, IHMCSequenceIdField());
+        visitFields(visitor, IHMCFieldPath(path, "robot_side"), msg.robot_side);
+        visitFields(visitor, IHMCFieldPath(path, "se3_trajectory"), msg.se3_trajectory);
+        return;
+    }
+
+    template <class V, class M>
+    void visitTypeFields(V& visitor, const IHMCFieldPath& path, M& msg, controller_msgs::NeckTrajectoryMessage*) {
+        visitFields(visitor, IHMCFieldPath(path, "sequence_id"), msg.sequence_id, IHMCSequenceIdField());
+        visitFields(visitor, IHMCFieldPath(path, "jointspace_trajectory"), msg.jointspace_trajectory);
+        return;
+    }
+
+    template <class V, class M>
+    void visitTypeFields(V& visitor, const IHMCFieldPath& path, M& msg, controller_msgs::HeadTrajectoryMessage*) {
+        visitFields(visitor, IHMCFieldPath(path, "sequence_id"), msg.sequence_id, IHMCSequenceIdField());
+        visitFields(visitor, IHMCFieldPath(path, "so3_trajectory"), msg.so3_trajectory);
+        return;
+    }
+
+    // TOP-LEVEL MESSAGES
+    template <class V, class M>
+    void visitTypeFields(V& visitor, const IHMCFieldPath& path, M& msg, controller_msgs::WholeBodyTrajectoryMessage*) {
+        visitFields(visitor, IHMCFieldPath(path, "sequence_id"), msg.sequence_id, IHMCSequenceIdField());
+        visitFields(visitor, IHMCFieldPath(path, "left_hand_trajectory_message"), msg.left_hand_trajectory_message);
+        visitFields(visitor, IHMCFieldPath(path, "right_hand_trajectory_message"), msg.right_hand_trajectory_message);
+        visitFields(visitor, IHMCFieldPath(path, "left_arm_trajectory_message"), msg.left_arm_trajectory_message);
+        visitFields(visitor, IHMCFieldPath(path, "right_arm_trajectory_message"), msg.right_arm_trajectory_message);
+        visitFields(visitor, IHMCFieldPath(path, "chest_trajectory_message"), msg.chest_trajectory_message);
+        visitFields(visitor, IHMCFieldPath(path, "spine_trajectory_message"), msg.spine_trajectory_message);
+        visitFields(visitor, IHMCFieldPath(path, "pelvis_trajectory_message"), msg.pelvis_trajectory_message);
+        visitFields(visitor, IHMCFieldPath(path, "left_foot_trajectory_message"), msg.left_foot_trajectory_message);
+        visitFields(visitor, IHMCFieldPath(path, "right_foot_trajectory_message"), msg.right_foot_trajectory_message);
+        visitFields(visitor, IHMCFieldPath(path, "neck_trajectory_message"), msg.neck_trajectory_message);
+        visitFields(visitor, IHMCFieldPath(path, "head_trajectory_message"), msg.head_trajectory_message);
+        return;
+    }
+
+    template <class V, class M>
+    void visitTypeFields(V& visitor, const IHMCFieldPath& path, M& msg, controller_msgs::GoHomeMessage*) {
+        visitFields(visitor, IHMCFieldPath(path, "sequence_id"), msg.sequence_id, IHMCSequenceIdField());
+        visitFields(visitor, IHMCFieldPath(path, "humanoid_body_part"), msg.humanoid_body_part);
+        visitFields(visitor, IHMCFieldPath(path, "robot_side"), msg.robot_side);
+        visitFields(visitor, IHMCFieldPath(path, "trajectory_time"), msg.trajectory_time);
+        visitFields(visitor, IHMCFieldPath(path, "execution_delay_time"), msg.execution_delay_time);
+        return;
+    }
+
+    template <class V, class M>
+    void visitTypeFields(V& visitor, const IHMCFieldPath& path, M& msg, controller_msgs::ValkyrieHandFingerTrajectoryMessage*) {
+        visitFields(visitor, IHMCFieldPath(path, "sequence_id"), msg.sequence_id, IHMCSequenceIdField());
+        visitFields(visitor, IHMCFieldPath(path, "robot_side"), msg.robot_side);
+        visitFields(visitor, IHMCFieldPath(path, "valkyrie_finger_motor_names"), msg.valkyrie_finger_motor_names);
+        visitFields(visitor, IHMCFieldPath(path, "jointspace_trajectory"), msg.jointspace_trajectory);
+        return;
+    }
+
+    // VISITOR FOR STAMPING MESSAGES
+    // sets every sequence id, and the message id and creation timestamp of every queueable message, in one pass;
+    // all queueable messages in the tree get the same timestamp, so nested messages cannot disagree;
+    // the fields to set are selected by their tags at compile time, so other fields are left alone at no cost
+    class IHMCMessageStamper
+    {
+    public:
+        IHMCMessageStamper(uint32_t sequence_id, int64_t message_id, int64_t timestamp)
+            : sequence_id_(sequence_id), message_id_(message_id), timestamp_(timestamp) {}
+
+        template <class T, class F>
+        void operator()(const IHMCFieldPath& path, T& value, F field) {
+            return;
+        }
+
+        template <class T>
+        void operator()(const IHMCFieldPath& path, T& value, IHMCSequenceIdField field) {
+            value = static_cast<T>(sequence_id_);
+            return;
+        }
+
+        template <class T>
+        void operator()(const IHMCFieldPath& path, T& value, IHMCMessageIdField field) {
+            value = static_cast<T>(message_id_);
+            return;
+        }
+
+        template <class T>
+        void operator()(const IHMCFieldPath& path, T& value, IHMCTimestampField field) {
+            value = static_cast<T>(timestamp_);
+            return;
+        }
+
+    private:
+        uint32_t sequence_id_; // sequence id for every message in tree
+        int64_t message_id_; // message id for queueable messages
+        int64_t timestamp_; // creation timestamp (ns) for queueable messages
+    };
+
+} // end namespace IHMCMsgUtils
+
+#endif
@@ -0,0 +1,64 @@
+/**
+ * Partially Deserialized Input Messages
+ * Emily Sheetz, NSTGRO VTE 2021
+ **/
+
+#include <ihmc_utils/ihmc_partial_msgs.h>
+
+#include <string>
+#include <unordered_map>
+
+namespace IHMCMsgUtils {
+
+    // HELPER FUNCTIONS
+    namespace {
+        // cached permutation, with the serialized names it was decoded from
+        struct JointNamePermutation {
+            std::vector<uint8_t> names; // serialized names
+            uint32_t num_names; // number of names
+            std::shared_ptr<const std::vector<int> > permutation; // configuration index of each name
+        };
+    } // end anonymous namespace
+
+    std::shared_ptr<const std::vector<int> > getJointNamePermutation(uint64_t names_hash, const uint8_t* names, uint32_t names_len,
+                                                                     uint32_t num_names) {
+        // joint orders seen by this thread; senders rarely change joint order, so cache stays small
+        thread_local std::unordered_map<uint64_t, JointNamePermutation> permutations;
+
+        // hash only finds the entry; names are compared so a collision decodes names instead of using the wrong order
+        std::unordered_map<uint64_t, JointNamePermutation>::iterator it = permutations.find(names_hash);
+        if( (it != permutations.end()) && (it->second.num_names == num_names) && (it->second.names.size() == names_len) &&
+            ((names_len == 0) || (std::memcmp(it->second.names.data(), names, names_len) == 0)) ) {
+            return it->second.permutation;
+        }
+
+        // new joint order; decode names and look up configuration index of each
+        std::shared_ptr<std::vector<int> > permutation = std::make_shared<std::vector<int> >(num_names, -1);
+        const uint8_t* p = names;
+        for( uint32_t i = 0 ; i < num_names ; i++ ) {
+            uint32_t len;
+            std::memcpy(&len, p, sizeof(len));
+            std::string name(reinterpret_cast<const char*>(p + sizeof(len)), len);
+            p += sizeof(len) + len;
+
+            // joint state message may contain joints we don't care about, especially when coming from IHMC
+            std::map<std::string, int>::iterator jt = val::joint_names_to_indices.find(name);
+            if( jt != val::joint_names_to_indices.end() ) {
+                // add offset to ignore virtual joints
+                (*permutation)[i] = jt->second - valkyrie::num_virtual;
+            }
+        }
+
+        // bound cache in case a sender keeps changing joint order
+        if( permutations.size() >= 64 ) {
+            permutations.clear();
+        }
+        JointNamePermutation& entry = permutations[names_hash];
+        entry.names.assign(names, names + names_len);
+        entry.num_names = num_names;
+        entry.permutation = permutation;
+
+        return permutation;
+    }
+
+} // end namespace IHMCMsgUtils
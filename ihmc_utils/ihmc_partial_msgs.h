@@ -0,0 +1,201 @@
+/**
+ * Partially Deserialized Input Messages
+ * Emily Sheetz, NSTGRO VTE 2021
+ **/
+
+#ifndef _IHMC_PARTIAL_MSGS_H_
+#define _IHMC_PARTIAL_MSGS_H_
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include <ros/ros.h>
+#include <ros/serialization.h>
+#include <sensor_msgs/JointState.h>
+#include <geometry_msgs/Transform.h>
+#include <geometry_msgs/TransformStamped.h>
+#include <Utils/wrap_eigen.hpp>
+#include <Valkyrie/Valkyrie_Definition.h>
+
+namespace IHMCMsgUtils {
+
+    /*
+     * subscriber-side stand-ins for sensor_msgs/JointState and geometry_msgs/TransformStamped:
+     * they have the same ROS type and md5sum, so they can subscribe to the same topics, but deserialization only reads
+     * the fields the IHMC Interface Node uses and skips everything else in place
+     *
+     * joint states: header strings, velocities, and efforts are skipped without being allocated; joint names are hashed
+     * in place and looked up in a per-thread cache of name permutations, so names are only decoded when a new joint
+     * order is seen; positions are written straight into configuration order
+     * transforms: header and child frame strings are skipped, only the transform is read
+     */
+
+    // JOINT STATE WITH ONLY POSITIONS, IN CONFIGURATION ORDER
+    struct IHMCPartialJointState {
+        dynacore::Vector q_joint; // positions of actuated joints in configuration order; joints not in message are 0
+        int num_joints; // number of joints in message, including joints that are not actuated joints (e.g., fingers)
+    };
+
+    // TRANSFORM STAMPED WITH ONLY THE TRANSFORM
+    struct IHMCPartialTransformStamped {
+        geometry_msgs::Transform transform;
+    };
+
+    /*
+     * gets the configuration index of each joint name in a serialized name array (-1 for joints that are not actuated joints);
+     * permutations are cached per thread by hash of the names, with the serialized names kept and compared on a hit,
+     * so each joint order is only decoded once and a hash collision cannot return another order's permutation
+     * @param names_hash, the hash of the serialized name array
+     * @param names, pointer to the first serialized name (uint32 length followed by characters, for each name)
+     * @param names_len, the number of bytes of serialized names
+     * @param num_names, the number of names
+     * @return the permutation
+     */
+    std::shared_ptr<const std::vector<int> > getJointNamePermutation(uint64_t names_hash, const uint8_t* names, uint32_t names_len,
+                                                                     uint32_t num_names);
+
+    // FNV-1a hash of serialized bytes
+    inline uint64_t hashBytes(uint64_t hash, const uint8_t* bytes, uint32_t len) {
+        for( uint32_t i = 0 ; i < len ; i++ ) {
+            hash = (hash ^ bytes[i]) * 1099511628211ULL;
+        }
+        return hash;
+    }
+
+} // end namespace IHMCMsgUtils
+
+namespace ros {
+namespace message_traits {
+
+    // same ROS type as the full messages
+    template <> struct MD5Sum<IHMCMsgUtils::IHMCPartialJointState> {
+        static const char* value() { return MD5Sum<sensor_msgs::JointState>::value(); }
+        static const char* value(const IHMCMsgUtils::IHMCPartialJointState&) { return value(); }
+    };
+    template <> struct DataType<IHMCMsgUtils::IHMCPartialJointState> {
+        static const char* value() { return DataType<sensor_msgs::JointState>::value(); }
+        static const char* value(const IHMCMsgUtils::IHMCPartialJointState&) { return value(); }
+    };
+    template <> struct Definition<IHMCMsgUtils::IHMCPartialJointState> {
+        static const char* value() { return Definition<sensor_msgs::JointState>::value(); }
+        static const char* value(const IHMCMsgUtils::IHMCPartialJointState&) { return value(); }
+    };
+
+    template <> struct MD5Sum<IHMCMsgUtils::IHMCPartialTransformStamped> {
+        static const char* value() { return MD5Sum<geometry_msgs::TransformStamped>::value(); }
+        static const char* value(const IHMCMsgUtils::IHMCPartialTransformStamped&) { return value(); }
+    };
+    template <> struct DataType<IHMCMsgUtils::IHMCPartialTransformStamped> {
+        static const char* value() { return DataType<geometry_msgs::TransformStamped>::value(); }
+        static const char* value(const IHMCMsgUtils::IHMCPartialTransformStamped&) { return value(); }
+    };
+    template <> struct Definition<IHMCMsgUtils::IHMCPartialTransformStamped> {
+        static const char* value() { return Definition<geometry_msgs::TransformStamped>::value(); }
+        static const char* value(const IHMCMsgUtils::IHMCPartialTransformStamped&) { return value(); }
+    };
+
+} // end namespace message_traits
+
+namespace serialization {
+
+    // skips a serialized header (seq, stamp, frame_id) in place
+    template <typename Stream>
+    inline void skipHeader(Stream& stream) {
+        stream.advance(12); // seq, stamp
+        uint32_t len;
+        stream.next(len);
+        stream.advance(len); // frame_id
+        return;
+    }
+
+    // subscriber only: reads names and positions, skips everything else
+    template <> struct Serializer<IHMCMsgUtils::IHMCPartialJointState> {
+        template <typename Stream>
+        inline static void read(Stream& stream, IHMCMsgUtils::IHMCPartialJointState& m) {
+            skipHeader(stream);
+
+            // hash names in place; names are only decoded when joint order has not been seen before
+            uint32_t num_names;
+            stream.next(num_names);
+            const uint8_t* names = stream.getData();
+            uint64_t names_hash = IHMCMsgUtils::hashBytes(14695981039346656037ULL,
+                                                          reinterpret_cast<const uint8_t*>(&num_names), sizeof(num_names));
+            for( uint32_t i = 0 ; i < num_names ; i++ ) {
+                uint32_t len;
+                stream.next(len);
+                names_hash = IHMCMsgUtils::hashBytes(names_hash, stream.advance(len), len);
+            }
+            uint32_t names_len = static_cast<uint32_t>(stream.getData() - names);
+            std::shared_ptr<const std::vector<int> > permutation = IHMCMsgUtils::getJointNamePermutation(names_hash, names, names_len,
+                                                                                                          num_names);
+
+            // write positions straight into configuration order
+            uint32_t num_positions;
+            stream.next(num_positions);
+            const uint8_t* positions = stream.advance(num_positions * sizeof(double));
+            m.q_joint.setZero(valkyrie::num_act_joint);
+            m.num_joints = num_names;
+            for( uint32_t i = 0 ; (i < num_positions) && (i < num_names) ; i++ ) {
+                int jidx = (*permutation)[i];
+                if( jidx >= 0 ) {
+                    std::memcpy(&(m.q_joint[jidx]), positions + i * sizeof(double), sizeof(double));
+                }
+            }
+
+            // skip velocities and efforts
+            uint32_t len;
+            stream.next(len);
+            stream.advance(len * sizeof(double));
+            stream.next(len);
+            stream.advance(len * sizeof(double));
+
+            return;
+        }
+
+        template <typename Stream>
+        inline static void write(Stream& stream, const IHMCMsgUtils::IHMCPartialJointState& m) {
+            // never published; partial messages only exist on the subscriber side
+            ROS_ERROR("[IHMC Partial Messages] Partial joint states cannot be serialized");
+            return;
+        }
+
+        inline static uint32_t serializedLength(const IHMCMsgUtils::IHMCPartialJointState& m) {
+            return 0;
+        }
+    };
+
+    // subscriber only: reads the transform, skips the header and child frame
+    template <> struct Serializer<IHMCMsgUtils::IHMCPartialTransformStamped> {
+        template <typename Stream>
+        inline static void read(Stream& stream, IHMCMsgUtils::IHMCPartialTransformStamped& m) {
+            skipHeader(stream);
+            uint32_t len;
+            stream.next(len);
+            stream.advance(len); // child_frame_id
+            stream.next(m.transform.translation.x);
+            stream.next(m.transform.translation.y);
+            stream.next(m.transform.translation.z);
+            stream.next(m.transform.rotation.x);
+            stream.next(m.transform.rotation.y);
+            stream.next(m.transform.rotation.z);
+            stream.next(m.transform.rotation.w);
+            return;
+        }
+
+        template <typename Stream>
+        inline static void write(Stream& stream, const IHMCMsgUtils::IHMCPartialTransformStamped& m) {
+            // never published; partial messages only exist on the subscriber side
+            ROS_ERROR("[IHMC Partial Messages] Partial transforms cannot be serialized");
+            return;
+        }
+
+        inline static uint32_t serializedLength(const IHMCMsgUtils::IHMCPartialTransformStamped& m) {
+            return 0;
+        }
+    };
+
+} // end namespace serialization
+} // end namespace ros
+
+#endif
@@ -0,0 +1,220 @@
+/**
+ * IHMC Pose Library
+ * Emily Sheetz, NSTGRO VTE 2021
+ **/
+
+#include <ihmc_utils/ihmc_pose_library.h>
+
+#include <fstream>
+#include <sstream>
+
+namespace IHMCMsgUtils {
+
+    // HELPER FUNCTIONS
+    namespace {
+        // sets creation timestamp of queueable messages that were stamped when built, leaving uncontrolled body parts unset
+        class TimestampRefresher
+        {
+        public:
+            TimestampRefresher(int64_t timestamp) : timestamp_(timestamp) {}
+
+            template <class T, class F>
+            void operator()(const IHMCFieldPath& path, T& value, F field) {
+                return;
+            }
+
+            template <class T>
+            void operator()(const IHMCFieldPath& path, T& value, IHMCTimestampField field) {
+                if( value != 0 ) {
+                    value = static_cast<T>(timestamp_);
+                }
+                return;
+            }
+
+        private:
+            int64_t timestamp_; // creation timestamp (ns)
+        };
+    } // end anonymous namespace
+
+    // CONSTRUCTORS/DESTRUCTORS
+    IHMCPoseLibrary::IHMCPoseLibrary() {
+    }
+
+    IHMCPoseLibrary::~IHMCPoseLibrary() {
+    }
+
+    bool IHMCPoseLibrary::load(std::string filename, IHMCMessageParameters msg_params) {
+        std::ifstream file(filename);
+        if( !file.is_open() ) {
+            ROS_WARN("[IHMC Pose Library] Could not open pose library %s", filename.c_str());
+            return false;
+        }
+
+        // pose currently being read
+        std::string name;
+        dynacore::Vector q;
+        bool pelvis_given = false;
+        bool links_given = false;
+        IHMCMessageParameters pose_params;
+
+        // builds pose that has been read, if any
+        auto finishPose = [&]() {
+            if( name.empty() ) {
+                return;
+            }
+            if( !links_given ) {
+                pose_params.controlled_links.clear();
+                if( pelvis_given ) {
+                    pose_params.controlled_links.push_back(valkyrie_link::pelvis);
+                    pose_params.controlled_links.push_back(valkyrie_link::rightCOP_Frame);
+                    pose_params.controlled_links.push_back(valkyrie_link::leftCOP_Frame);
+                }
+                pose_params.controlled_links.push_back(valkyrie_link::torso);
+                pose_params.controlled_links.push_back(valkyrie_link::rightPalm);
+                pose_params.controlled_links.push_back(valkyrie_link::leftPalm);
+                pose_params.controlled_links.push_back(valkyrie_link::head);
+            }
+            addPose(name, q, pose_params);
+            name.clear();
+            return;
+        };
+
+        std::string line;
+        int line_number = 0;
+        while( std::getline(file, line) ) {
+            line_number++;
+            std::istringstream tokens(line);
+            std::string key;
+            if( !(tokens >> key) || key[0] == '#' ) {
+                continue;
+            }
+
+            bool valid = true;
+            if( key == "pose" ) {
+                // start next pose
+                finishPose();
+                double trajectory_time;
+                valid = (tokens >> name >> trajectory_time) && (trajectory_time >= 0.0);
+                if( !valid ) {
+                    name.clear();
+                }
+                else {
+                    q.resize(valkyrie::num_q);
+                    q.setZero();
+                    q[valkyrie_joint::virtual_Rw] = 1.0;
+                    pelvis_given = false;
+                    links_given = false;
+                    pose_params = msg_params;
+                    pose_params.traj_point_params.time = trajectory_time;
+                }
+            }
+            else if( name.empty() ) {
+                // everything else belongs to a pose
+                valid = false;
+            }
+            else if( key == "pelvis" ) {
+                // pelvis pose, orientation as quaternion
+                double x, y, z, qx, qy, qz, qw;
+                valid = static_cast<bool>(tokens >> x >> y >> z >> qx >> qy >> qz >> qw);
+                if( valid ) {
+                    dynacore::Quaternion pelvis_quat(qw, qx, qy, qz);
+                    pelvis_quat.normalize();
+                    q[valkyrie_joint::virtual_X] = x;
+                    q[valkyrie_joint::virtual_Y] = y;
+                    q[valkyrie_joint::virtual_Z] = z;
+                    q[valkyrie_joint::virtual_Rx] = pelvis_quat.x();
+                    q[valkyrie_joint::virtual_Ry] = pelvis_quat.y();
+                    q[valkyrie_joint::virtual_Rz] = pelvis_quat.z();
+                    q[valkyrie_joint::virtual_Rw] = pelvis_quat.w();
+                    pelvis_given = true;
+                }
+            }
+            else if( key == "links" ) {
+                // explicitly controlled links
+                pose_params.controlled_links.clear();
+                std::string link_name;
+                int link_id;
+                while( valid && (tokens >> link_name) ) {
+                    valid = getControlledLinkId(link_name, link_id);
+                    if( valid ) {
+                        pose_params.controlled_links.push_back(link_id);
+                    }
+                }
+                links_given = true;
+            }
+            else {
+                // joint position; joint names index the configuration vector, including virtual joints
+                std::map<std::string, int>::iterator it = val::joint_names_to_indices.find(key);
+                double position;
+                valid = (it != val::joint_names_to_indices.end()) && (tokens >> position);
+                if( valid ) {
+                    q[it->second] = position;
+                }
+            }
+
+            if( !valid ) {
+                ROS_WARN("[IHMC Pose Library] Could not read line %d of pose library %s: %s", line_number, filename.c_str(), line.c_str());
+                // pose being read is incomplete, so it is discarded rather than sent with unread joints at 0
+                return false;
+            }
+        }
+        finishPose();
+
+        return true;
+    }
+
+    void IHMCPoseLibrary::addPose(std::string name, dynacore::Vector q, IHMCMessageParameters msg_params) {
+        // build message once; poses are sent as discrete trajectories, never streamed
+        Pose& pose = poses_[name];
+        pose.q = q;
+        pose.controlled_links = msg_params.controlled_links;
+        pose.trajectory_time = msg_params.traj_point_params.time;
+        pose.wholebody_msg = controller_msgs::WholeBodyTrajectoryMessage();
+        makeIHMCWholeBodyTrajectoryMessage(q, pose.wholebody_msg, msg_params);
+
+        return;
+    }
+
+    bool IHMCPoseLibrary::getPoseMessage(const std::string& name, controller_msgs::WholeBodyTrajectoryMessage& wholebody_msg) const {
+        std::map<std::string, Pose>::const_iterator it = poses_.find(name);
+        if( it == poses_.end() ) {
+            return false;
+        }
+
+        // copy prebuilt message, with creation time of now rather than when library was loaded
+        wholebody_msg = it->second.wholebody_msg;
+        int64_t timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        TimestampRefresher refresher(timestamp);
+        visitFields(refresher, wholebody_msg);
+
+        return true;
+    }
+
+    // HELPER FUNCTIONS
+    const IHMCPoseLibrary::Pose* IHMCPoseLibrary::getPose(const std::string& name) const {
+        std::map<std::string, Pose>::const_iterator it = poses_.find(name);
+        if( it == poses_.end() ) {
+            return nullptr;
+        }
+        return &(it->second);
+    }
+
+    std::vector<std::string> IHMCPoseLibrary::getPoseNames() const {
+        std::vector<std::string> names;
+        for( std::map<std::string, Pose>::const_iterator it = poses_.begin() ; it != poses_.end() ; ++it ) {
+            names.push_back(it->first);
+        }
+        return names;
+    }
+
+    int IHMCPoseLibrary::getNumPoses() const {
+        return static_cast<int>(poses_.size());
+    }
+
+    void IHMCPoseLibrary::clear() {
+        poses_.clear();
+        return;
+    }
+
+} // end namespace IHMCMsgUtils
@@ -0,0 +1,82 @@
+/**
+ * IHMC Pose Library
+ * Emily Sheetz, NSTGRO VTE 2021
+ **/
+
+#ifndef _IHMC_POSE_LIBRARY_H_
+#define _IHMC_POSE_LIBRARY_H_
+
+#include <map>
+#include <string>
+#include <vector>
+#include <ihmc_utils/ihmc_msg_utilities.h>
+
+namespace IHMCMsgUtils {
+
+    /*
+     * library of named robot configurations (e.g., ready, stow, hands-up), each built into a whole-body message once
+     * when the library is loaded, so a pose can be sent without a controller streaming configurations to the node;
+     * prebuilt messages only need fresh creation timestamps when they are sent
+     *
+     * pose library files are plain text, one pose per block; lines starting with # are comments:
+     *     pose <name> <trajectory_time>
+     *     pelvis <x> <y> <z> <qx> <qy> <qz> <qw>   (optional; pelvis pose in world frame)
+     *     links <link_name> ...                    (optional; pelvis, torso, rightCOP_Frame, leftCOP_Frame,
+     *                                               rightPalm, leftPalm, head)
+     *     <joint_name> <position>                  (one line per joint; joints not listed are 0)
+     * without a links line, the torso, palms, and head are controlled, plus the pelvis and feet if a pelvis pose is given
+     */
+    class IHMCPoseLibrary
+    {
+    public:
+        // STRUCT FOR PREBUILT POSE
+        struct Pose {
+            dynacore::Vector q; // configuration vector of pose, including virtual joints
+            std::vector<int> controlled_links; // links controlled by pose
+            double trajectory_time; // time (s) to reach pose
+            controller_msgs::WholeBodyTrajectoryMessage wholebody_msg; // prebuilt whole-body message
+        };
+
+        // CONSTRUCTORS/DESTRUCTORS
+        IHMCPoseLibrary();
+        ~IHMCPoseLibrary();
+
+        /*
+         * loads poses from a pose library file and prebuilds their whole-body messages
+         * @param filename, the pose library file
+         * @param msg_params, the IHMCMessageParameters struct used for every pose (trajectory time is set per pose)
+         * @return bool indicating if file was read without errors; poses completed before an error are kept,
+         *         and the pose being read when the error occurs is discarded
+         */
+        bool load(std::string filename, IHMCMessageParameters msg_params = IHMCMessageParameters());
+
+        /*
+         * adds a pose and prebuilds its whole-body message, replacing any pose with the same name
+         * @param name, the name of the pose
+         * @param q, the configuration vector of the pose, including virtual joints
+         * @param msg_params, the IHMCMessageParameters struct, including controlled links and trajectory time
+         * @return none
+         */
+        void addPose(std::string name, dynacore::Vector q, IHMCMessageParameters msg_params);
+
+        /*
+         * gets the prebuilt whole-body message of a pose, with creation timestamps set to the current time
+         * @param name, the name of the pose
+         * @param wholebody_msg, the message that will be updated
+         * @return bool indicating if pose is in library
+         */
+        bool getPoseMessage(const std::string& name, controller_msgs::WholeBodyTrajectoryMessage& wholebody_msg) const;
+
+        // HELPER FUNCTIONS
+        const Pose* getPose(const std::string& name) const;
+        std::vector<std::string> getPoseNames() const;
+        int getNumPoses() const;
+        void clear();
+
+    private:
+        std::map<std::string, Pose> poses_; // poses by name
+    };
+
+} // end namespace IHMCMsgUtils
+
+#endif
@@ -0,0 +1,305 @@
+/**
+ * IHMC Tracking Monitor
+ * Emily Sheetz, NSTGRO VTE 2021
+ **/
+
+#include <ihmc_utils/ihmc_tracking_monitor.h>
+#include <ihmc_utils/ihmc_msg_utilities.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace IHMCMsgUtils {
+
+    // smoothing factor for lag estimate
+    const double LAG_SMOOTHING = 0.1;
+    // minimum spread of command distances needed to estimate lag (commands must differ to find the closest)
+    const double LAG_MIN_DISTANCE_SPREAD = 1e-8;
+    // number of wrist joints after each forearm yaw joint in robot configuration data
+    const int NUM_WRIST_JOINTS = 2;
+
+    // CONSTRUCTORS/DESTRUCTORS
+    IHMCTrackingMonitor::IHMCTrackingMonitor(int window_size, int history_size) {
+        window_size_ = std::max(1, window_size);
+        history_size_ = std::max(1, history_size);
+
+        // configuration indices of jointspace body parts
+        part_indices_.resize(NUM_TRACKING_BODY_PARTS);
+        getRelevantJointIndicesTorso(part_indices_[TRACKING_TORSO]);
+        getRelevantJointIndicesLeftArm(part_indices_[TRACKING_LEFT_ARM]);
+        getRelevantJointIndicesRightArm(part_indices_[TRACKING_RIGHT_ARM]);
+        getRelevantJointIndicesNeck(part_indices_[TRACKING_NECK]);
+        joint_mask_ = Eigen::VectorXd::Zero(valkyrie::num_q);
+        for( int part = 0 ; part < NUM_TRACKING_BODY_PARTS ; part++ ) {
+            // special index -1 (wrist joints) is not in valkyrie definition and is never measured
+            part_indices_[part].erase(std::remove(part_indices_[part].begin(), part_indices_[part].end(), -1),
+                                      part_indices_[part].end());
+            for( int i = 0 ; i < part_indices_[part].size() ; i++ ) {
+                joint_mask_[part_indices_[part][i]] = 1.0;
+            }
+        }
+
+        reset();
+    }
+
+    IHMCTrackingMonitor::~IHMCTrackingMonitor() {
+    }
+
+    void IHMCTrackingMonitor::reset() {
+        command_history_ = Eigen::MatrixXd::Zero(valkyrie::num_q, history_size_);
+        command_times_.assign(history_size_, 0);
+        num_commands_ = 0;
+        q_command_ = dynacore::Vector::Zero(valkyrie::num_q);
+        command_mask_ = Eigen::VectorXd::Zero(valkyrie::num_q);
+
+        error_window_ = Eigen::MatrixXd::Zero(NUM_TRACKING_BODY_PARTS, window_size_);
+        num_measurements_ = 0;
+
+        lag_estimate_ = -1.0;
+
+        return;
+    }
+
+    // COMMANDS AND MEASUREMENTS
+    void IHMCTrackingMonitor::addCommand(int64_t time, const dynacore::Vector& q, const std::vector<int>& joint_indices) {
+        // update commanded joints only, so uncommanded joints are not compared against values nobody sent
+        for( int i = 0 ; i < joint_indices.size() ; i++ ) {
+            if( joint_indices[i] >= 0 && joint_indices[i] < valkyrie::num_q ) {
+                q_command_[joint_indices[i]] = q[joint_indices[i]];
+                command_mask_[joint_indices[i]] = 1.0;
+            }
+        }
+
+        // add to ring buffer of recent commands
+        int col = num_commands_ % history_size_;
+        command_history_.col(col) = q_command_;
+        command_times_[col] = time;
+        num_commands_++;
+
+        return;
+    }
+
+    void IHMCTrackingMonitor::addCommand(int64_t time, const dynacore::Vector& q) {
+        // every joint is commanded
+        std::vector<int> joint_indices(valkyrie::num_q);
+        for( int i = 0 ; i < valkyrie::num_q ; i++ ) {
+            joint_indices[i] = i;
+        }
+
+        addCommand(time, q, joint_indices);
+
+        return;
+    }
+
+    bool IHMCTrackingMonitor::addMeasurement(int64_t time, const dynacore::Vector& q) {
+        // nothing to compare against until a command is sent
+        if( num_commands_ == 0 ) {
+            return false;
+        }
+
+        // jointspace errors against latest command in one pass, over commanded joints
+        Eigen::VectorXd sq_error = (q - q_command_).cwiseProduct(joint_mask_).cwiseProduct(command_mask_).cwiseAbs2();
+        Eigen::VectorXd errors(NUM_TRACKING_BODY_PARTS);
+        for( int part = TRACKING_TORSO ; part < NUM_TRACKING_BODY_PARTS ; part++ ) {
+            // root-mean-square error over commanded joints of body part
+            double sum = 0.0;
+            int num_commanded = 0;
+            for( int i = 0 ; i < part_indices_[part].size() ; i++ ) {
+                sum += sq_error[part_indices_[part][i]];
+                num_commanded += (command_mask_[part_indices_[part][i]] > 0.0) ? 1 : 0;
+            }
+            errors[part] = (num_commanded == 0) ? 0.0 : std::sqrt(sum / num_commanded);
+        }
+
+        // pelvis errors, only if pelvis has been commanded
+        if( command_mask_[valkyrie_joint::virtual_X] > 0.0 ) {
+            // pelvis position error
+            errors[TRACKING_PELVIS_POSITION] = (q.segment<3>(valkyrie_joint::virtual_X) - q_command_.segment<3>(valkyrie_joint::virtual_X)).norm();
+
+            // pelvis orientation error, angle of rotation between commanded and measured orientations
+            dynacore::Quaternion quat_command(q_command_[valkyrie_joint::virtual_Rw], q_command_[valkyrie_joint::virtual_Rx],
+                                              q_command_[valkyrie_joint::virtual_Ry], q_command_[valkyrie_joint::virtual_Rz]);
+            dynacore::Quaternion quat_measured(q[valkyrie_joint::virtual_Rw], q[valkyrie_joint::virtual_Rx],
+                                               q[valkyrie_joint::virtual_Ry], q[valkyrie_joint::virtual_Rz]);
+            dynacore::Quaternion quat_error = quat_command.conjugate() * quat_measured;
+            errors[TRACKING_PELVIS_ORIENTATION] = 2.0 * std::atan2(quat_error.vec().norm(), std::fabs(quat_error.w()));
+        }
+        else {
+            errors[TRACKING_PELVIS_POSITION] = 0.0;
+            errors[TRACKING_PELVIS_ORIENTATION] = 0.0;
+        }
+
+        // add to ring buffer of recent errors
+        error_window_.col(num_measurements_ % window_size_) = errors;
+        num_measurements_++;
+
+        updateLagEstimate(time, q);
+
+        return true;
+    }
+
+    bool IHMCTrackingMonitor::addMeasurement(int64_t time, const controller_msgs::RobotConfigurationData& config_msg) {
+        dynacore::Vector q;
+        if( !getConfigurationFromRobotConfigurationData(config_msg, q) ) {
+            return false;
+        }
+
+        return addMeasurement(time, q);
+    }
+
+    void IHMCTrackingMonitor::updateLagEstimate(int64_t time, const dynacore::Vector& q) {
+        // distance from measurement to each recent command, over monitored joints that have been commanded
+        int num_cols = std::min(num_commands_, history_size_);
+        Eigen::MatrixXd diff = command_history_.leftCols(num_cols).colwise() - q;
+        Eigen::VectorXd mask = joint_mask_.cwiseProduct(command_mask_);
+        Eigen::VectorXd distances = (mask.asDiagonal() * diff).colwise().squaredNorm().transpose();
+
+        // commands that do not differ (e.g., holding a pose) say nothing about lag
+        int closest;
+        double min_distance = distances.minCoeff(&closest);
+        if( distances.maxCoeff() - min_distance < LAG_MIN_DISTANCE_SPREAD ) {
+            return;
+        }
+
+        // measured configuration is closest to command sent one lag ago
+        double lag = (time - command_times_[closest]) / 1e9;
+        if( lag < 0.0 ) {
+            return;
+        }
+        lag_estimate_ = (lag_estimate_ < 0.0) ? lag : (1.0 - LAG_SMOOTHING) * lag_estimate_ + LAG_SMOOTHING * lag;
+
+        return;
+    }
+
+    // STATISTICS
+    IHMCTrackingErrorStats IHMCTrackingMonitor::getStats(int body_part) {
+        IHMCTrackingErrorStats stats;
+        stats.num_samples = std::min(num_measurements_, window_size_);
+        if( stats.num_samples == 0 ) {
+            stats.latest = 0.0;
+            stats.rms = 0.0;
+            stats.max = 0.0;
+            return stats;
+        }
+
+        Eigen::VectorXd window = error_window_.row(body_part).head(stats.num_samples).transpose();
+        stats.latest = error_window_(body_part, (num_measurements_ - 1) % window_size_);
+        stats.rms = std::sqrt(window.squaredNorm() / stats.num_samples);
+        stats.max = window.maxCoeff();
+
+        return stats;
+    }
+
+    double IHMCTrackingMonitor::getEstimatedLag() {
+        return lag_estimate_;
+    }
+
+    int IHMCTrackingMonitor::getNumMeasurements() {
+        return num_measurements_;
+    }
+
+    void IHMCTrackingMonitor::makeStatsMessage(std_msgs::Float64MultiArray& stats_msg) {
+        // describe layout: [latest, rms, max] per body part, then lag
+        stats_msg.layout.dim.resize(2);
+        stats_msg.layout.dim[0].label = "body_part";
+        stats_msg.layout.dim[0].size = NUM_TRACKING_BODY_PARTS;
+        stats_msg.layout.dim[0].stride = NUM_TRACKING_BODY_PARTS * 3;
+        stats_msg.layout.dim[1].label = "latest_rms_max";
+        stats_msg.layout.dim[1].size = 3;
+        stats_msg.layout.dim[1].stride = 3;
+        stats_msg.layout.data_offset = 0;
+
+        stats_msg.data.clear();
+        for( int part = 0 ; part < NUM_TRACKING_BODY_PARTS ; part++ ) {
+            IHMCTrackingErrorStats stats = getStats(part);
+            stats_msg.data.push_back(stats.latest);
+            stats_msg.data.push_back(stats.rms);
+            stats_msg.data.push_back(stats.max);
+        }
+        stats_msg.data.push_back(lag_estimate_);
+
+        return;
+    }
+
+    const char* IHMCTrackingMonitor::getBodyPartName(int body_part) {
+        switch( body_part ) {
+            case TRACKING_PELVIS_POSITION:
+                return "pelvis_position";
+            case TRACKING_PELVIS_ORIENTATION:
+                return "pelvis_orientation";
+            case TRACKING_TORSO:
+                return "torso";
+            case TRACKING_LEFT_ARM:
+                return "left_arm";
+            case TRACKING_RIGHT_ARM:
+                return "right_arm";
+            case TRACKING_NECK:
+                return "neck";
+            default:
+                return "unknown";
+        }
+    }
+
+    // ROBOT CONFIGURATION DATA
+    bool getConfigurationFromRobotConfigurationData(const controller_msgs::RobotConfigurationData& config_msg, dynacore::Vector& q) {
+        // check whether joint angles include wrist joints
+        bool with_wrists;
+        if( config_msg.joint_angles.size() == valkyrie::num_act_joint + 2 * NUM_WRIST_JOINTS ) {
+            with_wrists = true;
+        }
+        else if( config_msg.joint_angles.size() == valkyrie::num_act_joint ) {
+            with_wrists = false;
+        }
+        else {
+            return false;
+        }
+
+        q.resize(valkyrie::num_q);
+        q.setZero();
+
+        // pelvis pose
+        q[valkyrie_joint::virtual_X] = config_msg.root_translation.x;
+        q[valkyrie_joint::virtual_Y] = config_msg.root_translation.y;
+        q[valkyrie_joint::virtual_Z] = config_msg.root_translation.z;
+        q[valkyrie_joint::virtual_Rx] = config_msg.root_orientation.x;
+        q[valkyrie_joint::virtual_Ry] = config_msg.root_orientation.y;
+        q[valkyrie_joint::virtual_Rz] = config_msg.root_orientation.z;
+        q[valkyrie_joint::virtual_Rw] = config_msg.root_orientation.w;
+
+        // joint angles, skipping wrist joints
+        int msg_idx = 0;
+        for( int i = valkyrie::num_virtual ; i < valkyrie::num_virtual + valkyrie::num_act_joint ; i++ ) {
+            q[i] = config_msg.joint_angles[msg_idx++];
+            if( with_wrists && (i == valkyrie_joint::leftForearmYaw || i == valkyrie_joint::rightForearmYaw) ) {
+                msg_idx += NUM_WRIST_JOINTS;
+            }
+        }
+
+        return true;
+    }
+
+    void makeRobotConfigurationData(const dynacore::Vector& q, controller_msgs::RobotConfigurationData& config_msg) {
+        // pelvis pose
+        config_msg.root_translation.x = q[valkyrie_joint::virtual_X];
+        config_msg.root_translation.y = q[valkyrie_joint::virtual_Y];
+        config_msg.root_translation.z = q[valkyrie_joint::virtual_Z];
+        config_msg.root_orientation.x = q[valkyrie_joint::virtual_Rx];
+        config_msg.root_orientation.y = q[valkyrie_joint::virtual_Ry];
+        config_msg.root_orientation.z = q[valkyrie_joint::virtual_Rz];
+        config_msg.root_orientation.w = q[valkyrie_joint::virtual_Rw];
+
+        // joint angles, with wrist joints at zero
+        config_msg.joint_angles.clear();
+        for( int i = valkyrie::num_virtual ; i < valkyrie::num_virtual + valkyrie::num_act_joint ; i++ ) {
+            config_msg.joint_angles.push_back(q[i]);
+            if( i == valkyrie_joint::leftForearmYaw || i == valkyrie_joint::rightForearmYaw ) {
+                for( int j = 0 ; j < NUM_WRIST_JOINTS ; j++ ) {
+                    config_msg.joint_angles.push_back(0.0);
+                }
+            }
+        }
+
+        return;
+    }
+
+} // end namespace IHMCMsgUtils
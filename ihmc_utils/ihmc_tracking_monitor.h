@@ -0,0 +1,138 @@
+/**
+ * IHMC Tracking Monitor
+ * Emily Sheetz, NSTGRO VTE 2021
+ **/
+
+#ifndef _IHMC_TRACKING_MONITOR_H_
+#define _IHMC_TRACKING_MONITOR_H_
+
+#include <cstdint>
+#include <vector>
+#include <std_msgs/Float64MultiArray.h>
+#include <controller_msgs/RobotConfigurationData.h>
+#include <Valkyrie/Valkyrie_Definition.h>
+#include <Utils/wrap_eigen.hpp>
+
+namespace IHMCMsgUtils {
+
+    /*
+     * closed-loop tracking error between commanded configurations (as sent in whole-body messages) and measured
+     * configurations (from IHMC's RobotConfigurationData, or the mock endpoint);
+     * each measurement is compared against the latest command in one vectorized pass over the configuration,
+     * per-body-part errors are kept over a sliding window, and the lag between command and measurement is estimated
+     * by finding the recent command closest to each measurement
+     */
+
+    // BODY PARTS MONITORED (parts commanded by whole-body messages)
+    enum IHMCTrackingBodyPart {
+        TRACKING_PELVIS_POSITION = 0, // error in m
+        TRACKING_PELVIS_ORIENTATION, // error in rad
+        TRACKING_TORSO, // errors in rad for remaining parts
+        TRACKING_LEFT_ARM,
+        TRACKING_RIGHT_ARM,
+        TRACKING_NECK,
+        NUM_TRACKING_BODY_PARTS
+    };
+
+    // STRUCT FOR ERROR STATISTICS OF ONE BODY PART
+    struct IHMCTrackingErrorStats {
+        int num_samples; // number of measurements in window
+        double latest; // error of latest measurement
+        double rms; // root-mean-square error over window
+        double max; // maximum error over window
+    };
+
+    class IHMCTrackingMonitor
+    {
+    public:
+        // CONSTRUCTORS/DESTRUCTORS
+        /*
+         * @param window_size, the number of measurements kept for error statistics
+         * @param history_size, the number of commands kept for lag estimation
+         */
+        IHMCTrackingMonitor(int window_size = 100, int history_size = 50);
+        ~IHMCTrackingMonitor();
+
+        /*
+         * clears commands, measurements, and statistics
+         * @return none
+         */
+        void reset();
+
+        // COMMANDS AND MEASUREMENTS
+        /*
+         * records a commanded configuration; only the given joints are commanded, and other joints keep their last command
+         * (joints never commanded are left out of error statistics and lag estimation)
+         * @param time, the time (ns) at which the command was sent
+         * @param q, the commanded configuration vector (valkyrie::num_q values)
+         * @param joint_indices, the configuration indices of the joints commanded; every joint if not given
+         * @return none
+         */
+        void addCommand(int64_t time, const dynacore::Vector& q, const std::vector<int>& joint_indices);
+        void addCommand(int64_t time, const dynacore::Vector& q);
+
+        /*
+         * compares a measured configuration against the latest command
+         * @param time, the time (ns) at which the measurement was received
+         * @param q, the measured configuration vector (valkyrie::num_q values)
+         * @return bool indicating if measurement was compared (false if no command has been recorded)
+         */
+        bool addMeasurement(int64_t time, const dynacore::Vector& q);
+        bool addMeasurement(int64_t time, const controller_msgs::RobotConfigurationData& config_msg);
+
+        // STATISTICS
+        IHMCTrackingErrorStats getStats(int body_part);
+
+        /*
+         * gets estimated lag between sending a command and measuring the commanded configuration
+         * @return the smoothed lag estimate (s), or -1 if not yet estimated
+         */
+        double getEstimatedLag();
+
+        int getNumMeasurements();
+
+        /*
+         * makes a message with error statistics, for publishing;
+         * data is [latest, rms, max] for each body part in IHMCTrackingBodyPart order, followed by estimated lag (s)
+         * @param stats_msg, the message that will be updated
+         * @return none
+         */
+        void makeStatsMessage(std_msgs::Float64MultiArray& stats_msg);
+
+        static const char* getBodyPartName(int body_part);
+
+    private:
+        void updateLagEstimate(int64_t time, const dynacore::Vector& q);
+
+        int window_size_; // number of measurements kept for statistics
+        int history_size_; // number of commands kept for lag estimation
+        std::vector<std::vector<int>> part_indices_; // configuration indices of joints in each jointspace body part
+        Eigen::VectorXd joint_mask_; // 1 for configuration indices in a monitored body part, 0 otherwise
+
+        Eigen::MatrixXd command_history_; // recent commands, one column per command (ring buffer)
+        std::vector<int64_t> command_times_; // times (ns) of recent commands
+        int num_commands_; // total number of commands recorded
+        dynacore::Vector q_command_; // latest command of each joint
+        Eigen::VectorXd command_mask_; // 1 for configuration indices that have been commanded, 0 otherwise
+
+        Eigen::MatrixXd error_window_; // recent errors, one row per body part, one column per measurement (ring buffer)
+        int num_measurements_; // total number of measurements compared
+
+        double lag_estimate_; // smoothed lag estimate (s); negative until estimated
+    };
+
+    // ROBOT CONFIGURATION DATA
+    /*
+     * converts between a configuration vector and RobotConfigurationData;
+     * IHMC orders joint angles as in the valkyrie definition, with wrist joints (not in the valkyrie definition)
+     * after each forearm yaw joint; data without wrist joints is also accepted
+     * @param config_msg, the robot configuration data message
+     * @param q, the configuration vector
+     * @return bool indicating if the number of joint angles was recognized
+     */
+    bool getConfigurationFromRobotConfigurationData(const controller_msgs::RobotConfigurationData& config_msg, dynacore::Vector& q);
+    void makeRobotConfigurationData(const dynacore::Vector& q, controller_msgs::RobotConfigurationData& config_msg);
+
+} // end namespace IHMCMsgUtils
+
+#endif
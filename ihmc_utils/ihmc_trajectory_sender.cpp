@@ -0,0 +1,278 @@
+/**
+ * IHMC Chunked Trajectory Sender
+ * Emily Sheetz, NSTGRO VTE 2021
+ **/
+
+#include <ihmc_utils/ihmc_trajectory_sender.h>
+#include <ihmc_utils/ihmc_tracking_monitor.h>
+
+namespace IHMCMsgUtils {
+
+    // HELPER FUNCTIONS
+    namespace {
+        // appends trajectory points of each joint in src to the same joint in dst
+        void appendJointspacePoints(controller_msgs::JointspaceTrajectoryMessage& dst,
+                                    const controller_msgs::JointspaceTrajectoryMessage& src) {
+            for( int j = 0 ; j < dst.joint_trajectory_messages.size() && j < src.joint_trajectory_messages.size() ; j++ ) {
+                std::vector<controller_msgs::TrajectoryPoint1DMessage>& points = dst.joint_trajectory_messages[j].trajectory_points;
+                const std::vector<controller_msgs::TrajectoryPoint1DMessage>& new_points = src.joint_trajectory_messages[j].trajectory_points;
+                points.insert(points.end(), new_points.begin(), new_points.end());
+            }
+            return;
+        }
+
+        // appends taskspace trajectory points (SE3 or SO3) in src to dst
+        template <class M>
+        void appendTaskspacePoints(M& dst, const M& src) {
+            dst.taskspace_trajectory_points.insert(dst.taskspace_trajectory_points.end(),
+                                                   src.taskspace_trajectory_points.begin(), src.taskspace_trajectory_points.end());
+            return;
+        }
+
+        // appends trajectory points of every body part in src to dst; body parts missing from either message are unchanged
+        void appendWholeBodyPoints(controller_msgs::WholeBodyTrajectoryMessage& dst,
+                                   const controller_msgs::WholeBodyTrajectoryMessage& src) {
+            appendJointspacePoints(dst.left_arm_trajectory_message.jointspace_trajectory,
+                                   src.left_arm_trajectory_message.jointspace_trajectory);
+            appendJointspacePoints(dst.right_arm_trajectory_message.jointspace_trajectory,
+                                   src.right_arm_trajectory_message.jointspace_trajectory);
+            appendJointspacePoints(dst.neck_trajectory_message.jointspace_trajectory,
+                                   src.neck_trajectory_message.jointspace_trajectory);
+            appendTaskspacePoints(dst.left_hand_trajectory_message.se3_trajectory, src.left_hand_trajectory_message.se3_trajectory);
+            appendTaskspacePoints(dst.right_hand_trajectory_message.se3_trajectory, src.right_hand_trajectory_message.se3_trajectory);
+            appendTaskspacePoints(dst.chest_trajectory_message.so3_trajectory, src.chest_trajectory_message.so3_trajectory);
+            appendTaskspacePoints(dst.pelvis_trajectory_message.se3_trajectory, src.pelvis_trajectory_message.se3_trajectory);
+            return;
+        }
+    } // end anonymous namespace
+
+    // CONSTRUCTORS/DESTRUCTORS
+    IHMCTrajectorySender::IHMCTrajectorySender(IHMCTrajectorySenderParams params) {
+        params_ = params;
+        params_.points_per_segment = std::max(1, params_.points_per_segment);
+        params_.segments_ahead = std::max(1, params_.segments_ahead);
+        params_.expected_latency = std::max(0.0, params_.expected_latency);
+        params_.feedback_match_window = std::max(0.0, params_.feedback_match_window);
+
+        // default clock is system clock, same as message timestamps
+        clock_ = []() {
+            return static_cast<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count());
+        };
+
+        num_segments_ = 0;
+        num_segments_sent_ = 0;
+        num_segments_executed_ = 0;
+        active_ = false;
+        start_time_ = 0;
+        progress_waypoint_ = -1;
+    }
+
+    IHMCTrajectorySender::~IHMCTrajectorySender() {
+    }
+
+    // OUTPUTS
+    void IHMCTrajectorySender::setWholeBodyMessageSink(WholeBodyMessageSink sink) {
+        wholebody_sink_ = sink;
+        return;
+    }
+
+    void IHMCTrajectorySender::setClock(Clock clock) {
+        clock_ = clock;
+        return;
+    }
+
+    // TRAJECTORY
+    bool IHMCTrajectorySender::sendTrajectory(const std::vector<dynacore::Vector>& waypoints, const std::vector<double>& times,
+                                              IHMCMessageParameters msg_params) {
+        // check trajectory
+        if( waypoints.empty() || waypoints.size() != times.size() ) {
+            ROS_WARN("[IHMC Trajectory Sender] Trajectory needs one time per waypoint, not sending");
+            return false;
+        }
+        for( int i = 0 ; i < waypoints.size() ; i++ ) {
+            if( waypoints[i].size() != valkyrie::num_q ) {
+                ROS_WARN("[IHMC Trajectory Sender] Waypoint %d has %d values, expected %d; not sending",
+                         i, static_cast<int>(waypoints[i].size()), valkyrie::num_q);
+                return false;
+            }
+            if( (times[i] < 0.0) || ((i > 0) && (times[i] <= times[i-1])) ) {
+                ROS_WARN("[IHMC Trajectory Sender] Waypoint times must be nonnegative and increasing, not sending");
+                return false;
+            }
+        }
+
+        // replace any trajectory being sent
+        waypoints_ = waypoints;
+        times_ = times;
+        msg_params_ = msg_params;
+        if( msg_params_.queueable_params.message_id <= 0 ) {
+            msg_params_.queueable_params.message_id = 1;
+        }
+        num_segments_ = (waypoints_.size() + params_.points_per_segment - 1) / params_.points_per_segment;
+        num_segments_sent_ = 0;
+        num_segments_executed_ = 0;
+        progress_waypoint_ = -1;
+        active_ = true;
+
+        // first segments go out right away; IHMC starts executing when first segment arrives
+        start_time_ = clock_();
+        for( int i = 0 ; i < std::min(num_segments_, params_.segments_ahead) ; i++ ) {
+            sendSegment(i);
+        }
+
+        return true;
+    }
+
+    bool IHMCTrajectorySender::update() {
+        if( !active_ ) {
+            return false;
+        }
+
+        updateProgress();
+
+        // just in time: a segment stops counting as in flight once execution is within the expected latency of its last
+        // waypoint; progress is only observed after the latency and a segment sent now only arrives after it,
+        // so waiting until the last waypoint is reached would leave the IHMC queue empty for a round trip
+        double release_time = getProgressTime() + params_.expected_latency;
+        int num_segments_released = num_segments_executed_;
+        while( num_segments_sent_ < num_segments_ ) {
+            while( (num_segments_released < num_segments_sent_) &&
+                   (release_time >= times_[getSegmentLastWaypoint(num_segments_released)]) ) {
+                num_segments_released++;
+            }
+            if( num_segments_sent_ - num_segments_released >= params_.segments_ahead ) {
+                break;
+            }
+            sendSegment(num_segments_sent_);
+        }
+
+        // done once last segment has executed
+        if( num_segments_executed_ >= num_segments_ ) {
+            active_ = false;
+        }
+
+        return active_;
+    }
+
+    void IHMCTrajectorySender::cancel() {
+        active_ = false;
+        return;
+    }
+
+    // FEEDBACK
+    void IHMCTrajectorySender::addMeasuredConfiguration(const dynacore::Vector& q) {
+        if( !active_ || num_segments_sent_ == 0 ) {
+            return;
+        }
+
+        // closest waypoint among those sent and within match window; searching from last waypoint reached keeps progress
+        // from moving backward, and the window keeps a later return to a nearby configuration from being matched
+        int last_sent_waypoint = getSegmentLastWaypoint(num_segments_sent_ - 1);
+        int closest_start = std::max(0, progress_waypoint_);
+        int closest = closest_start;
+        double window_end_time = ((progress_waypoint_ >= 0) ? times_[progress_waypoint_] : 0.0) + params_.feedback_match_window;
+        double min_distance = (waypoints_[closest] - q).squaredNorm();
+        for( int i = closest_start + 1 ; i <= last_sent_waypoint ; i++ ) {
+            // next waypoint is always matched, so progress can advance past waypoints spaced wider than the window
+            if( (i > closest_start + 1) && (times_[i] > window_end_time) ) {
+                break;
+            }
+            double distance = (waypoints_[i] - q).squaredNorm();
+            if( distance < min_distance ) {
+                min_distance = distance;
+                closest = i;
+            }
+        }
+        progress_waypoint_ = std::max(progress_waypoint_, closest);
+
+        return;
+    }
+
+    void IHMCTrajectorySender::processRobotConfigurationData(const controller_msgs::RobotConfigurationData& config_msg) {
+        dynacore::Vector q;
+        if( getConfigurationFromRobotConfigurationData(config_msg, q) ) {
+            addMeasuredConfiguration(q);
+        }
+        return;
+    }
+
+    // HELPER FUNCTIONS
+    bool IHMCTrajectorySender::isActive() {
+        return active_;
+    }
+
+    int IHMCTrajectorySender::getNumSegments() {
+        return num_segments_;
+    }
+
+    int IHMCTrajectorySender::getNumSegmentsSent() {
+        return num_segments_sent_;
+    }
+
+    int IHMCTrajectorySender::getNumSegmentsExecuted() {
+        return num_segments_executed_;
+    }
+
+    int IHMCTrajectorySender::getSegmentsAhead() {
+        return params_.segments_ahead;
+    }
+
+    double IHMCTrajectorySender::getProgressTime() {
+        if( params_.progress_source == TRAJECTORY_PROGRESS_FEEDBACK ) {
+            return (progress_waypoint_ >= 0) ? times_[progress_waypoint_] : 0.0;
+        }
+        return (clock_() - start_time_) / 1e9;
+    }
+
+    void IHMCTrajectorySender::sendSegment(int segment) {
+        int first_waypoint = segment * params_.points_per_segment;
+        int last_waypoint = getSegmentLastWaypoint(segment);
+        // times of points are relative to start of segment, which is the end of the previous segment
+        double segment_start_time = (segment > 0) ? times_[first_waypoint - 1] : 0.0;
+
+        // first segment overrides whatever is executing, following segments are queued after the previous one
+        IHMCMessageParameters msg_params = msg_params_;
+        msg_params.sequence_id = msg_params_.sequence_id + segment;
+        msg_params.queueable_params.execution_mode = (segment == 0) ? 0 : 1;
+        msg_params.queueable_params.message_id = msg_params_.queueable_params.message_id + segment;
+        msg_params.queueable_params.previous_message_id = (segment == 0) ? 0 : (msg_params.queueable_params.message_id - 1);
+        msg_params.queueable_params.stream_integration_duration = 0.0;
+
+        // one message per waypoint, with points merged into the first message; stamps of the first message are kept
+        controller_msgs::WholeBodyTrajectoryMessage wholebody_msg;
+        for( int i = first_waypoint ; i <= last_waypoint ; i++ ) {
+            msg_params.traj_point_params.time = times_[i] - segment_start_time;
+            if( i == first_waypoint ) {
+                makeIHMCWholeBodyTrajectoryMessage(waypoints_[i], wholebody_msg, msg_params);
+            }
+            else {
+                controller_msgs::WholeBodyTrajectoryMessage waypoint_msg;
+                makeIHMCWholeBodyTrajectoryMessage(waypoints_[i], waypoint_msg, msg_params);
+                appendWholeBodyPoints(wholebody_msg, waypoint_msg);
+            }
+        }
+
+        if( wholebody_sink_ ) {
+            wholebody_sink_(wholebody_msg);
+        }
+        num_segments_sent_++;
+
+        return;
+    }
+
+    void IHMCTrajectorySender::updateProgress() {
+        // a segment has executed once its last waypoint has been reached
+        double progress_time = getProgressTime();
+        while( (num_segments_executed_ < num_segments_sent_) &&
+               (progress_time >= times_[getSegmentLastWaypoint(num_segments_executed_)]) ) {
+            num_segments_executed_++;
+        }
+        return;
+    }
+
+    int IHMCTrajectorySender::getSegmentLastWaypoint(int segment) {
+        return std::min(static_cast<int>(waypoints_.size()) - 1, (segment + 1) * params_.points_per_segment - 1);
+    }
+
+} // end namespace IHMCMsgUtils
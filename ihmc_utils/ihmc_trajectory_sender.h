@@ -0,0 +1,150 @@
+/**
+ * IHMC Chunked Trajectory Sender
+ * Emily Sheetz, NSTGRO VTE 2021
+ **/
+
+#ifndef _IHMC_TRAJECTORY_SENDER_H_
+#define _IHMC_TRAJECTORY_SENDER_H_
+
+#include <functional>
+#include <vector>
+#include <controller_msgs/RobotConfigurationData.h>
+#include <ihmc_utils/ihmc_msg_utilities.h>
+
+namespace IHMCMsgUtils {
+
+    /*
+     * sends long planned trajectories that cannot go out as one whole-body message:
+     * waypoints are split into segments of a few trajectory points each, and segments are chained as queued messages
+     * (first segment overrides, each following segment is queued after the previous message id);
+     * only a limited number of segments are sent ahead of execution, so the IHMC queue is not flooded, and the next
+     * segment is sent once the sent segments have less trajectory time left than the expected latency of sending and
+     * observing a segment, so the queue never runs dry;
+     * execution is tracked by elapsed trajectory time since the first segment was sent, or by matching measured
+     * robot configurations to waypoints just past the current progress; like IHMCCommandStreamer, messages are handed
+     * to an output sink, time comes from an injectable clock, and nothing blocks
+     */
+
+    // HOW EXECUTION OF SEGMENTS IS TRACKED
+    enum IHMCTrajectoryProgressSource {
+        TRAJECTORY_PROGRESS_ELAPSED_TIME = 0, // segments execute on schedule from when first segment was sent
+        TRAJECTORY_PROGRESS_FEEDBACK // measured configurations are matched to the closest waypoint just past progress
+    };
+
+    // STRUCT FOR CHUNKED TRAJECTORY PARAMETERS
+    struct IHMCTrajectorySenderParams {
+        // number of waypoints (trajectory points per body part) in each segment
+        int points_per_segment;
+
+        // number of sent segments that are not yet within the expected latency of finishing, and so are expected to
+        // still be executing or queued when a newly sent segment arrives; the next segment is sent once fewer remain,
+        // and 2 or more keeps the next segment queued while one executes;
+        // this is not a cap on the IHMC queue: segments within the expected latency of finishing are still queued,
+        // so IHMC can hold up to about ceil(expected_latency / segment duration) more segments (more again when
+        // tracking by elapsed time, which starts when the first segment is sent rather than when it arrives)
+        int segments_ahead;
+
+        // how execution of segments is tracked (IHMCTrajectoryProgressSource)
+        int progress_source;
+
+        // time (s) from sending a segment until its execution is observed (transport delay, plus feedback delay when
+        // tracking by feedback); a segment stops counting as in flight this long before it finishes executing,
+        // so the next segment arrives before the IHMC queue runs dry
+        double expected_latency;
+
+        // when tracking by feedback, time (s) past the current progress within which waypoints are matched to measured
+        // configurations, so a trajectory that returns near an earlier configuration is not matched to the later visit;
+        // the waypoint after the current progress is always matched
+        double feedback_match_window;
+
+        // DEFAULT CONSTRUCTOR; sets all parameters to default values
+        IHMCTrajectorySenderParams() {
+            points_per_segment = 10;
+            segments_ahead = 2;
+            progress_source = TRAJECTORY_PROGRESS_ELAPSED_TIME;
+            expected_latency = 0.2;
+            feedback_match_window = 0.5;
+        }
+    };
+
+    class IHMCTrajectorySender
+    {
+    public:
+        // TYPES FOR OUTPUT SINK AND CLOCK
+        typedef std::function<void(const controller_msgs::WholeBodyTrajectoryMessage&)> WholeBodyMessageSink;
+        typedef std::function<int64_t(void)> Clock; // returns current time in nanoseconds
+
+        // CONSTRUCTORS/DESTRUCTORS
+        IHMCTrajectorySender(IHMCTrajectorySenderParams params = IHMCTrajectorySenderParams());
+        ~IHMCTrajectorySender();
+
+        // OUTPUTS
+        void setWholeBodyMessageSink(WholeBodyMessageSink sink);
+        void setClock(Clock clock);
+
+        // TRAJECTORY
+        /*
+         * splits a trajectory into segments and sends the first segments, replacing any trajectory being sent
+         * @param waypoints, the configuration vectors (valkyrie::num_q values) of the trajectory
+         * @param times, the time (s) from start of trajectory at which each waypoint is reached; strictly increasing
+         * @param msg_params, the IHMCMessageParameters struct, including controlled links; sequence and message ids of the
+         *        first segment are taken from it (message id 1 if not set); execution mode and times are set per segment
+         * @return bool indicating if trajectory was valid and sending started
+         */
+        bool sendTrajectory(const std::vector<dynacore::Vector>& waypoints, const std::vector<double>& times,
+                            IHMCMessageParameters msg_params);
+
+        /*
+         * sends the next segments once earlier segments have executed; never blocks
+         * @return bool indicating if trajectory is still being sent or executed
+         */
+        bool update();
+
+        /*
+         * stops sending segments; segments already sent are left to IHMC (e.g., follow with a stop message)
+         * @return none
+         */
+        void cancel();
+
+        // FEEDBACK
+        /*
+         * matches a measured configuration to the closest waypoint that has been sent, for tracking execution by feedback;
+         * only waypoints within the feedback match window past the current progress are matched, and progress never
+         * moves backward
+         * @param q, the measured configuration vector (valkyrie::num_q values)
+         * @return none
+         */
+        void addMeasuredConfiguration(const dynacore::Vector& q);
+        void processRobotConfigurationData(const controller_msgs::RobotConfigurationData& config_msg);
+
+        // HELPER FUNCTIONS
+        bool isActive();
+        int getNumSegments();
+        int getNumSegmentsSent();
+        int getNumSegmentsExecuted();
+        int getSegmentsAhead();
+        double getProgressTime(); // time (s) from start of trajectory reached by execution
+
+    private:
+        void sendSegment(int segment);
+        void updateProgress();
+        int getSegmentLastWaypoint(int segment);
+
+        IHMCTrajectorySenderParams params_; // chunking and flow control parameters
+        WholeBodyMessageSink wholebody_sink_; // output for wholebody messages
+        Clock clock_; // clock for tracking elapsed trajectory time
+
+        std::vector<dynacore::Vector> waypoints_; // configurations of trajectory
+        std::vector<double> times_; // times (s) from start of trajectory of each waypoint
+        IHMCMessageParameters msg_params_; // parameters shared by all segments
+        int num_segments_; // number of segments trajectory is split into
+        int num_segments_sent_; // number of segments handed to sink
+        int num_segments_executed_; // number of segments finished executing
+        bool active_; // flag indicating whether trajectory is being sent or executed
+        int64_t start_time_; // time (ns) first segment was sent
+        int progress_waypoint_; // index of last waypoint reached, by feedback; -1 before first waypoint
+    };
+
+} // end namespace IHMCMsgUtils
+
+#endif
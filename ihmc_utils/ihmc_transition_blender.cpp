@@ -0,0 +1,230 @@
+/**
+ * IHMC Transition Blender
+ * Emily Sheetz, NSTGRO VTE 2021
+ **/
+
+#include <ihmc_utils/ihmc_transition_blender.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace IHMCMsgUtils {
+
+    // HELPER FUNCTIONS
+    namespace {
+        // cubic interpolation with zero velocity at both ends, for s in [0, 1]
+        double getCubicProgress(double s) {
+            return s * s * (3.0 - 2.0 * s);
+        }
+
+        // derivative of cubic interpolation with respect to s
+        double getCubicRate(double s) {
+            return 6.0 * s * (1.0 - s);
+        }
+    } // end anonymous namespace
+
+    // CONSTRUCTORS/DESTRUCTORS
+    IHMCTransitionBlender::IHMCTransitionBlender(double blend_duration) {
+        blend_duration_ = std::max(0.0, blend_duration);
+        reset();
+    }
+
+    IHMCTransitionBlender::~IHMCTransitionBlender() {
+    }
+
+    void IHMCTransitionBlender::setBlendDuration(double blend_duration) {
+        blend_duration_ = std::max(0.0, blend_duration);
+        return;
+    }
+
+    double IHMCTransitionBlender::getBlendDuration() {
+        return blend_duration_;
+    }
+
+    void IHMCTransitionBlender::reset() {
+        start_q_ = dynacore::Vector::Zero(valkyrie::num_q);
+        target_q_ = dynacore::Vector::Zero(valkyrie::num_q);
+        start_times_.assign(valkyrie::num_q, 0);
+        durations_ = dynacore::Vector::Zero(valkyrie::num_q);
+        known_ = Eigen::VectorXd::Zero(valkyrie::num_q);
+        measured_q_ = dynacore::Vector::Zero(valkyrie::num_q);
+        measured_ = false;
+
+        pending_ = Eigen::VectorXd::Zero(valkyrie::num_q);
+        blend_start_times_.assign(valkyrie::num_q, 0);
+        blend_from_q_ = dynacore::Vector::Zero(valkyrie::num_q);
+        blend_mask_ = Eigen::VectorXd::Zero(valkyrie::num_q);
+
+        return;
+    }
+
+    void IHMCTransitionBlender::setMeasuredConfiguration(const dynacore::Vector& q) {
+        measured_q_ = q;
+        measured_ = true;
+        return;
+    }
+
+    // COMMANDS
+    void IHMCTransitionBlender::addDiscreteCommand(int64_t time, const dynacore::Vector& q_target,
+                                                   const std::vector<int>& joint_indices, double trajectory_time) {
+        // new trajectory of each joint starts wherever its previous trajectory is now;
+        // joints without a known previous target start where they were last measured, or at their new target
+        dynacore::Vector q_from;
+        getExpectedConfiguration(time, q_from);
+        for( int i = 0 ; i < joint_indices.size() ; i++ ) {
+            int j = joint_indices[i];
+            if( (j >= 0) && (j < valkyrie::num_q) && (known_[j] <= 0.0) ) {
+                q_from[j] = measured_ ? measured_q_[j] : q_target[j];
+            }
+        }
+        alignPelvisOrientation(q_from, q_target);
+
+        for( int i = 0 ; i < joint_indices.size() ; i++ ) {
+            int j = joint_indices[i];
+            if( (j < 0) || (j >= valkyrie::num_q) ) {
+                continue;
+            }
+            start_q_[j] = q_from[j];
+            target_q_[j] = q_target[j];
+            start_times_[j] = time;
+            durations_[j] = std::max(0.0, trajectory_time);
+            known_[j] = 1.0;
+        }
+
+        // discrete command overrides any blend; next streamed command of each joint blends in from it
+        pending_.setOnes();
+        blend_mask_.setZero();
+
+        return;
+    }
+
+    void IHMCTransitionBlender::forgetJoints(const std::vector<int>& joint_indices) {
+        for( int i = 0 ; i < joint_indices.size() ; i++ ) {
+            int j = joint_indices[i];
+            if( (j >= 0) && (j < valkyrie::num_q) ) {
+                known_[j] = 0.0;
+            }
+        }
+        return;
+    }
+
+    void IHMCTransitionBlender::blendStreamedCommand(int64_t time, dynacore::Vector& q, dynacore::Vector& qdot,
+                                                     const std::vector<int>& joint_indices) {
+        // first streamed command of each joint after a discrete command starts its blend from where the discrete trajectory is;
+        // body parts left out of this message stay pending until they are first sent
+        bool expected = false;
+        dynacore::Vector q_expected;
+        for( int i = 0 ; i < joint_indices.size() ; i++ ) {
+            int j = joint_indices[i];
+            if( (j < 0) || (j >= valkyrie::num_q) || (pending_[j] <= 0.0) ) {
+                continue;
+            }
+            pending_[j] = 0.0;
+            if( blend_duration_ <= 0.0 ) {
+                continue;
+            }
+            if( !expected ) {
+                getExpectedConfiguration(time, q_expected);
+                alignPelvisOrientation(q_expected, q);
+                expected = true;
+            }
+            blend_from_q_[j] = q_expected[j];
+            blend_start_times_[j] = time;
+            blend_mask_[j] = known_[j];
+        }
+
+        // move from blend start to streamed configuration with the same profile as discrete trajectories;
+        // streamed configurations carry no velocity, so the velocity of the blend is the rate of the blend weight
+        qdot = dynacore::Vector::Zero(valkyrie::num_q);
+        bool blended = false;
+        for( int i = 0 ; i < joint_indices.size() ; i++ ) {
+            int j = joint_indices[i];
+            if( (j < 0) || (j >= valkyrie::num_q) || (blend_mask_[j] <= 0.0) ) {
+                continue;
+            }
+            // blends end when their duration is over, or when blending is disabled
+            double s = (blend_duration_ > 0.0) ? ((time - blend_start_times_[j]) / 1e9 / blend_duration_) : 1.0;
+            if( s >= 1.0 ) {
+                blend_mask_[j] = 0.0;
+                continue;
+            }
+            s = std::max(0.0, s);
+            double offset = blend_from_q_[j] - q[j];
+            q[j] += (1.0 - getCubicProgress(s)) * offset;
+            qdot[j] = -getCubicRate(s) / blend_duration_ * offset;
+            blended = true;
+        }
+        if( blended ) {
+            normalizePelvisOrientation(q);
+        }
+
+        // streamed commands take effect immediately
+        for( int i = 0 ; i < joint_indices.size() ; i++ ) {
+            int j = joint_indices[i];
+            if( (j < 0) || (j >= valkyrie::num_q) ) {
+                continue;
+            }
+            start_q_[j] = q[j];
+            target_q_[j] = q[j];
+            start_times_[j] = time;
+            durations_[j] = 0.0;
+            known_[j] = 1.0;
+        }
+
+        return;
+    }
+
+    // HELPER FUNCTIONS
+    void IHMCTransitionBlender::getExpectedConfiguration(int64_t time, dynacore::Vector& q) {
+        q = target_q_;
+        for( int j = 0 ; j < valkyrie::num_q ; j++ ) {
+            if( (known_[j] > 0.0) && (durations_[j] > 0.0) ) {
+                double s = (time - start_times_[j]) / 1e9 / durations_[j];
+                if( s < 1.0 ) {
+                    q[j] = start_q_[j] + getCubicProgress(std::max(0.0, s)) * (target_q_[j] - start_q_[j]);
+                }
+            }
+        }
+
+        // pelvis orientation is interpolated componentwise, so it needs to be a unit quaternion again
+        normalizePelvisOrientation(q);
+
+        return;
+    }
+
+    bool IHMCTransitionBlender::isBlending() {
+        return (blend_mask_.sum() > 0.0);
+    }
+
+    void IHMCTransitionBlender::alignPelvisOrientation(dynacore::Vector& q, const dynacore::Vector& q_ref) {
+        // q and -q are the same orientation; use the sign closest to the reference so interpolation takes the short way
+        double dot = q[valkyrie_joint::virtual_Rx] * q_ref[valkyrie_joint::virtual_Rx] +
+                     q[valkyrie_joint::virtual_Ry] * q_ref[valkyrie_joint::virtual_Ry] +
+                     q[valkyrie_joint::virtual_Rz] * q_ref[valkyrie_joint::virtual_Rz] +
+                     q[valkyrie_joint::virtual_Rw] * q_ref[valkyrie_joint::virtual_Rw];
+        if( dot < 0.0 ) {
+            q[valkyrie_joint::virtual_Rx] *= -1.0;
+            q[valkyrie_joint::virtual_Ry] *= -1.0;
+            q[valkyrie_joint::virtual_Rz] *= -1.0;
+            q[valkyrie_joint::virtual_Rw] *= -1.0;
+        }
+        return;
+    }
+
+    void IHMCTransitionBlender::normalizePelvisOrientation(dynacore::Vector& q) {
+        double norm = std::sqrt(q[valkyrie_joint::virtual_Rx] * q[valkyrie_joint::virtual_Rx] +
+                                q[valkyrie_joint::virtual_Ry] * q[valkyrie_joint::virtual_Ry] +
+                                q[valkyrie_joint::virtual_Rz] * q[valkyrie_joint::virtual_Rz] +
+                                q[valkyrie_joint::virtual_Rw] * q[valkyrie_joint::virtual_Rw]);
+        // orientation never commanded
+        if( norm < 1e-9 ) {
+            return;
+        }
+        q[valkyrie_joint::virtual_Rx] /= norm;
+        q[valkyrie_joint::virtual_Ry] /= norm;
+        q[valkyrie_joint::virtual_Rz] /= norm;
+        q[valkyrie_joint::virtual_Rw] /= norm;
+        return;
+    }
+
+} // end namespace IHMCMsgUtils
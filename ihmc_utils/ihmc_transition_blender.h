@@ -0,0 +1,119 @@
+/**
+ * IHMC Transition Blender
+ * Emily Sheetz, NSTGRO VTE 2021
+ **/
+
+#ifndef _IHMC_TRANSITION_BLENDER_H_
+#define _IHMC_TRANSITION_BLENDER_H_
+
+#include <cstdint>
+#include <vector>
+#include <Valkyrie/Valkyrie_Definition.h>
+#include <Utils/wrap_eigen.hpp>
+
+namespace IHMCMsgUtils {
+
+    /*
+     * blends streamed commands in from discrete commands (poses, go home messages);
+     * a streamed message overrides whatever trajectory IHMC is executing, so the first streamed setpoint after a
+     * discrete command jumps from wherever that trajectory is to the streamed configuration;
+     * the blender keeps the last commanded target of each joint with the time and trajectory time it was sent with,
+     * estimates where the discrete trajectory is when streaming resumes (cubic with zero end velocities), and moves
+     * the first streamed setpoints from there to the streamed configuration over a short blend duration;
+     * each joint starts its blend the first time it is streamed after a discrete command, so body parts streamed at
+     * lower rates blend in from where the discrete trajectory is when they are first sent;
+     * blended setpoints come with the velocity of the blend, so IHMC integrates along the blend between
+     * streamed messages instead of stepping at the stream rate
+     */
+    class IHMCTransitionBlender
+    {
+    public:
+        // CONSTRUCTORS/DESTRUCTORS
+        /*
+         * @param blend_duration, the duration (s) of blends; 0 disables blending
+         */
+        IHMCTransitionBlender(double blend_duration = 0.0);
+        ~IHMCTransitionBlender();
+
+        void setBlendDuration(double blend_duration);
+        double getBlendDuration();
+
+        /*
+         * forgets all commanded targets and stops any blend
+         * @return none
+         */
+        void reset();
+
+        /*
+         * sets the latest measured configuration, used as the start of discrete commands for joints whose
+         * commanded target is not known (e.g., before the first command); without measurements these joints
+         * are taken to be at their new target
+         * @param q, the measured configuration vector (valkyrie::num_q values)
+         * @return none
+         */
+        void setMeasuredConfiguration(const dynacore::Vector& q);
+
+        // COMMANDS
+        /*
+         * records a discrete command; the next streamed command of each joint starts its blend
+         * @param time, the time (ns) at which the command was sent
+         * @param q_target, the commanded configuration vector (valkyrie::num_q values)
+         * @param joint_indices, the configuration indices of the joints moved by the command
+         * @param trajectory_time, the time (s) the command takes to reach its target
+         * @return none
+         */
+        void addDiscreteCommand(int64_t time, const dynacore::Vector& q_target, const std::vector<int>& joint_indices,
+                                double trajectory_time);
+
+        /*
+         * marks joints as moved to an unknown target (e.g., go home without a known home configuration,
+         * Cartesian hand goals); streamed commands are not blended for these joints until they are commanded again
+         * @param joint_indices, the configuration indices of the joints
+         * @return none
+         */
+        void forgetJoints(const std::vector<int>& joint_indices);
+
+        /*
+         * blends a streamed command in from the last discrete command, and records it as commanded
+         * @param time, the time (ns) at which the command will be sent
+         * @param q, the streamed configuration vector (valkyrie::num_q values); updated to the blended configuration
+         * @param qdot, the velocity vector that will be updated with the velocity of the blend; zero outside blends
+         * @param joint_indices, the configuration indices of the joints commanded by the streamed message
+         * @return none
+         */
+        void blendStreamedCommand(int64_t time, dynacore::Vector& q, dynacore::Vector& qdot,
+                                  const std::vector<int>& joint_indices);
+
+        // HELPER FUNCTIONS
+        /*
+         * gets where commanded trajectories are at the given time; joints never commanded are 0
+         * @param time, the time (ns)
+         * @param q, the configuration vector that will be updated
+         * @return none
+         */
+        void getExpectedConfiguration(int64_t time, dynacore::Vector& q);
+        bool isBlending();
+
+    private:
+        void alignPelvisOrientation(dynacore::Vector& q, const dynacore::Vector& q_ref);
+        void normalizePelvisOrientation(dynacore::Vector& q);
+
+        double blend_duration_; // duration (s) of blends
+
+        dynacore::Vector start_q_; // start of last commanded trajectory of each joint
+        dynacore::Vector target_q_; // target of last commanded trajectory of each joint
+        std::vector<int64_t> start_times_; // time (ns) last trajectory of each joint was commanded
+        dynacore::Vector durations_; // trajectory time (s) of last trajectory of each joint
+        Eigen::VectorXd known_; // 1 for joints whose commanded target is known, 0 otherwise
+        dynacore::Vector measured_q_; // latest measured configuration
+        bool measured_; // flag indicating whether a configuration has been measured
+
+        Eigen::VectorXd pending_; // 1 for joints not streamed since the last discrete command, 0 otherwise
+        std::vector<int64_t> blend_start_times_; // time (ns) blend of each joint started
+        dynacore::Vector blend_from_q_; // configuration blend of each joint starts from
+        Eigen::VectorXd blend_mask_; // 1 for joints being blended, 0 otherwise
+    };
+
+} // end namespace IHMCMsgUtils
+
+#endif